@@ -8,6 +8,7 @@
 #include <bluetoe/meta_types.hpp>
 
 #include <algorithm>
+#include <iterator>
 
 namespace bluetoe {
 
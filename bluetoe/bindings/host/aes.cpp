@@ -0,0 +1,289 @@
+#include <bluetoe/host_security_tool_box.hpp>
+
+#include <cassert>
+#include <algorithm>
+#include <iterator>
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+#   define BLUETOE_HOST_AES_NI 1
+#   include <wmmintrin.h>
+#   include <emmintrin.h>
+#endif
+
+namespace bluetoe
+{
+namespace host_details
+{
+    namespace {
+        using block_t = aes128::block_t;
+
+        static const std::uint8_t sbox[ 256 ] = {
+            0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+            0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+            0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+            0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+            0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+            0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+            0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+            0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+            0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+            0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+            0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+            0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+            0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+            0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+            0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+            0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
+        };
+
+        static const std::uint8_t round_constants[ 10 ] = {
+            0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36
+        };
+
+        static constexpr std::size_t rounds = 10;
+
+        std::uint8_t xtime( std::uint8_t x )
+        {
+            return static_cast< std::uint8_t >( ( x << 1 ) ^ ( ( x & 0x80 ) ? 0x1b : 0x00 ) );
+        }
+
+        void encrypt_block_software( const std::uint8_t* round_keys, const block_t& input, block_t& output )
+        {
+            std::uint8_t state[ 16 ];
+            std::uint8_t temp[ 16 ];
+
+            for ( std::size_t i = 0; i != 16; ++i )
+                state[ i ] = input[ i ] ^ round_keys[ i ];
+
+            for ( std::size_t round = 1; round <= rounds; ++round )
+            {
+                // SubBytes and ShiftRows; the state is stored column by column
+                for ( std::size_t column = 0; column != 4; ++column )
+                {
+                    for ( std::size_t row = 0; row != 4; ++row )
+                        temp[ row + 4 * column ] = sbox[ state[ row + 4 * ( ( column + row ) % 4 ) ] ];
+                }
+
+                const std::uint8_t* const round_key = &round_keys[ 16 * round ];
+
+                if ( round == rounds )
+                {
+                    for ( std::size_t i = 0; i != 16; ++i )
+                        state[ i ] = temp[ i ] ^ round_key[ i ];
+                }
+                else
+                {
+                    // MixColumns and AddRoundKey
+                    for ( std::size_t column = 0; column != 4; ++column )
+                    {
+                        const std::uint8_t* const a = &temp[ 4 * column ];
+                        std::uint8_t* const       b = &state[ 4 * column ];
+                        const std::uint8_t all = a[ 0 ] ^ a[ 1 ] ^ a[ 2 ] ^ a[ 3 ];
+
+                        b[ 0 ] = a[ 0 ] ^ all ^ xtime( a[ 0 ] ^ a[ 1 ] ) ^ round_key[ 4 * column + 0 ];
+                        b[ 1 ] = a[ 1 ] ^ all ^ xtime( a[ 1 ] ^ a[ 2 ] ) ^ round_key[ 4 * column + 1 ];
+                        b[ 2 ] = a[ 2 ] ^ all ^ xtime( a[ 2 ] ^ a[ 3 ] ) ^ round_key[ 4 * column + 2 ];
+                        b[ 3 ] = a[ 3 ] ^ all ^ xtime( a[ 3 ] ^ a[ 0 ] ) ^ round_key[ 4 * column + 3 ];
+                    }
+                }
+            }
+
+            std::copy( std::begin( state ), std::end( state ), output.begin() );
+        }
+
+#ifdef BLUETOE_HOST_AES_NI
+        __attribute__(( target( "aes,sse2" ) ))
+        void encrypt_blocks_aes_ni( const std::uint8_t* round_keys, const block_t* input, block_t* output, std::size_t count )
+        {
+            __m128i keys[ rounds + 1 ];
+            __m128i blocks[ aes128::max_parallel_blocks ];
+
+            for ( std::size_t round = 0; round <= rounds; ++round )
+                keys[ round ] = _mm_load_si128( reinterpret_cast< const __m128i* >( &round_keys[ 16 * round ] ) );
+
+            for ( std::size_t block = 0; block != count; ++block )
+                blocks[ block ] = _mm_xor_si128( _mm_loadu_si128( reinterpret_cast< const __m128i* >( input[ block ].data() ) ), keys[ 0 ] );
+
+            // the blocks are independent, so the latency of one aesenc is hidden by the others
+            for ( std::size_t round = 1; round != rounds; ++round )
+            {
+                for ( std::size_t block = 0; block != count; ++block )
+                    blocks[ block ] = _mm_aesenc_si128( blocks[ block ], keys[ round ] );
+            }
+
+            for ( std::size_t block = 0; block != count; ++block )
+                _mm_storeu_si128( reinterpret_cast< __m128i* >( output[ block ].data() ), _mm_aesenclast_si128( blocks[ block ], keys[ rounds ] ) );
+        }
+
+        bool cpu_supports_aes_ni()
+        {
+            __builtin_cpu_init();
+
+            return __builtin_cpu_supports( "aes" ) && __builtin_cpu_supports( "sse2" );
+        }
+#else
+        bool cpu_supports_aes_ni()
+        {
+            return false;
+        }
+#endif
+
+        bool& aes_ni_enabled()
+        {
+            static bool enabled = cpu_supports_aes_ni();
+
+            return enabled;
+        }
+
+        // doubling in GF(2^128), as required by the CMAC subkey generation
+        block_t dbl( const block_t& input )
+        {
+            static constexpr std::uint8_t r_b = 0x87;
+
+            block_t output;
+            std::uint8_t overflow = 0;
+
+            for ( std::size_t i = input.size(); i != 0; --i )
+            {
+                output[ i - 1 ] = static_cast< std::uint8_t >( ( input[ i - 1 ] << 1 ) | overflow );
+                overflow = ( input[ i - 1 ] & 0x80 ) ? 1 : 0;
+            }
+
+            if ( input[ 0 ] & 0x80 )
+                output.back() ^= r_b;
+
+            return output;
+        }
+
+        block_t reverse( const bluetoe::details::uint128_t& input )
+        {
+            block_t result;
+            std::reverse_copy( input.begin(), input.end(), result.begin() );
+
+            return result;
+        }
+    }
+
+    aes128::aes128( const block_t& key )
+    {
+        std::copy( key.begin(), key.end(), &round_keys_[ 0 ] );
+
+        for ( std::size_t word = 4; word != 4 * ( rounds + 1 ); ++word )
+        {
+            std::uint8_t temp[ 4 ];
+            std::copy( &round_keys_[ 4 * ( word - 1 ) ], &round_keys_[ 4 * word ], &temp[ 0 ] );
+
+            if ( word % 4 == 0 )
+            {
+                const std::uint8_t first = temp[ 0 ];
+                temp[ 0 ] = sbox[ temp[ 1 ] ] ^ round_constants[ word / 4 - 1 ];
+                temp[ 1 ] = sbox[ temp[ 2 ] ];
+                temp[ 2 ] = sbox[ temp[ 3 ] ];
+                temp[ 3 ] = sbox[ first ];
+            }
+
+            for ( std::size_t i = 0; i != 4; ++i )
+                round_keys_[ 4 * word + i ] = round_keys_[ 4 * ( word - 4 ) + i ] ^ temp[ i ];
+        }
+    }
+
+    aes128::block_t aes128::encrypt( const block_t& input ) const
+    {
+        block_t result;
+        encrypt( &input, &result, 1 );
+
+        return result;
+    }
+
+    void aes128::encrypt( const block_t* input, block_t* output, std::size_t count ) const
+    {
+        assert( count <= max_parallel_blocks );
+
+#ifdef BLUETOE_HOST_AES_NI
+        if ( aes_ni_enabled() )
+            return encrypt_blocks_aes_ni( round_keys_, input, output, count );
+#endif
+
+        for ( std::size_t block = 0; block != count; ++block )
+            encrypt_block_software( round_keys_, input[ block ], output[ block ] );
+    }
+
+    void aes_cmac( const aes128& key, const std::uint8_t* const* messages, std::size_t count, std::size_t size, aes128::block_t* macs )
+    {
+        assert( count < aes128::max_parallel_blocks );
+
+        static const block_t zero = {{ 0 }};
+        const std::size_t number_of_blocks = size == 0 ? 1 : ( size + 15 ) / 16;
+        const bool last_block_complete     = size != 0 && size % 16 == 0;
+
+        block_t input[ aes128::max_parallel_blocks ];
+        block_t output[ aes128::max_parallel_blocks ];
+
+        for ( std::size_t message = 0; message != count; ++message )
+            macs[ message ] = zero;
+
+        // L = AES(K, 0) is calculated together with the first block, unless the first block is the last block
+        block_t l = zero;
+        if ( number_of_blocks == 1 )
+            l = key.encrypt( zero );
+
+        for ( std::size_t block = 0; block != number_of_blocks; ++block )
+        {
+            const bool last  = block == number_of_blocks - 1;
+            const block_t k1 = last ? dbl( l ) : zero;
+            const block_t k2 = last ? dbl( k1 ) : zero;
+            const std::size_t offset = 16 * block;
+            const std::size_t length = std::min< std::size_t >( 16, size - offset );
+
+            for ( std::size_t message = 0; message != count; ++message )
+            {
+                block_t& in = input[ message ];
+                in = macs[ message ];
+
+                for ( std::size_t i = 0; i != length; ++i )
+                    in[ i ] ^= messages[ message ][ offset + i ];
+
+                if ( last )
+                {
+                    if ( !last_block_complete )
+                        in[ length ] ^= 0x80;
+
+                    const block_t& subkey = last_block_complete ? k1 : k2;
+
+                    for ( std::size_t i = 0; i != in.size(); ++i )
+                        in[ i ] ^= subkey[ i ];
+                }
+            }
+
+            const bool calculate_l = block == 0 && !last;
+
+            if ( calculate_l )
+                input[ count ] = zero;
+
+            key.encrypt( &input[ 0 ], &output[ 0 ], calculate_l ? count + 1 : count );
+
+            std::copy( &output[ 0 ], &output[ count ], macs );
+
+            if ( calculate_l )
+                l = output[ count ];
+        }
+    }
+
+    bluetoe::details::uint128_t aes_le( const bluetoe::details::uint128_t& key, const bluetoe::details::uint128_t& data )
+    {
+        const block_t result = aes128( reverse( key ) ).encrypt( reverse( data ) );
+
+        return reverse( result );
+    }
+
+    bool aes_ni_supported()
+    {
+        return cpu_supports_aes_ni();
+    }
+
+    void use_aes_ni( bool enable )
+    {
+        aes_ni_enabled() = enable && cpu_supports_aes_ni();
+    }
+}
+}
@@ -0,0 +1,131 @@
+#ifndef BLUETOE_BINDINGS_HOST_LINK_LAYER_ENCRYPTION_HPP
+#define BLUETOE_BINDINGS_HOST_LINK_LAYER_ENCRYPTION_HPP
+
+#include <bluetoe/host_security_tool_box.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+/**
+ * @file host_link_layer_encryption.hpp
+ *
+ * Software implementation of the AES-CCM encryption of data channel PDUs, for radios that do not
+ * have a CCM peripheral (host simulations, software radios).
+ *
+ * All PDUs are in the over the air layout: two octets of header (LLID, NESN, SN, MD; length),
+ * followed by the payload and, if encrypted, by the 4 octets of MIC.
+ */
+namespace bluetoe
+{
+    namespace host_details
+    {
+        /**
+         * @brief AES-CCM with the parameters and nonce construction of the link layer
+         *
+         * The CBC-MAC and the CTR keystream of one PDU are calculated together, two AES blocks at a time,
+         * so that the AES-NI implementation can interleave both chains.
+         */
+        class link_layer_ccm
+        {
+        public:
+            /**
+             * @brief size of the message integrity check appended to every encrypted PDU
+             */
+            static constexpr std::size_t mic_size = 4;
+
+            /**
+             * @brief constructs an engine with an all zero key
+             */
+            link_layer_ccm();
+
+            /**
+             * @brief session key (bluetoe byte order) and IV (IVm | IVs << 32)
+             */
+            link_layer_ccm( const bluetoe::details::uint128_t& session_key, std::uint64_t iv );
+
+            /**
+             * @brief encrypts pdu into output and appends the MIC
+             *
+             * The length field is incremented by mic_size. PDUs without payload are not encrypted
+             * and copied unchanged. output must have room for the PDU and the MIC.
+             *
+             * @return the size of the output PDU
+             */
+            std::size_t encrypt( const std::uint8_t* pdu, std::uint8_t* output, std::uint64_t packet_counter, bool sent_by_central ) const;
+
+            /**
+             * @brief decrypts pdu into output and checks the MIC
+             *
+             * The length field is decremented by mic_size. PDUs without payload are copied unchanged.
+             *
+             * @return false, if the PDU is too short to contain a MIC, or if the MIC does not match
+             */
+            bool decrypt( const std::uint8_t* pdu, std::uint8_t* output, std::uint64_t packet_counter, bool sent_by_central ) const;
+
+        private:
+            using block_t = aes128::block_t;
+
+            block_t crypt( const std::uint8_t* header, const std::uint8_t* input, std::size_t size, std::uint8_t* output,
+                std::uint64_t packet_counter, bool sent_by_central, bool encrypting ) const;
+
+            aes128          key_;
+            std::uint64_t   iv_;
+        };
+
+        /**
+         * @brief encryption part of a scheduled radio, implemented in software
+         *
+         * Provides the functions, that the link layer expects from a radio with
+         * hardware_supports_encryption == true, for the peripheral role. The radio implementation
+         * passes every new PDU through transmit_pdu() and every received PDU through receive_pdu(),
+         * which keep track of the packet counters. Retransmissions have to reuse the already
+         * encrypted PDU.
+         */
+        class software_radio_encryption
+        {
+        public:
+            static constexpr bool hardware_supports_encryption = true;
+
+            software_radio_encryption();
+
+            /**
+             * @brief calculates the session key and returns random SKDs and IVs
+             */
+            std::pair< std::uint64_t, std::uint32_t > setup_encryption( bluetoe::details::uint128_t key, std::uint64_t skdm, std::uint32_t ivm );
+
+            /**
+             * @brief calculates the session key from the given SKD and IV parts
+             */
+            void setup_encryption( const bluetoe::details::uint128_t& key, std::uint64_t skdm, std::uint32_t ivm, std::uint64_t skds, std::uint32_t ivs );
+
+            void start_receive_encrypted();
+            void start_transmit_encrypted();
+            void stop_receive_encrypted();
+            void stop_transmit_encrypted();
+
+            /**
+             * @brief transforms a PDU to be transmitted
+             *
+             * @return the size of the PDU to be transmitted
+             */
+            std::size_t transmit_pdu( const std::uint8_t* pdu, std::uint8_t* output );
+
+            /**
+             * @brief transforms a received PDU
+             *
+             * @return false, if the PDU failed the MIC check
+             */
+            bool receive_pdu( const std::uint8_t* pdu, std::uint8_t* output );
+
+        private:
+            link_layer_ccm  ccm_;
+            bool            receive_encrypted_;
+            bool            transmit_encrypted_;
+            std::uint64_t   receive_counter_;
+            std::uint64_t   transmit_counter_;
+        };
+    }
+}
+
+#endif
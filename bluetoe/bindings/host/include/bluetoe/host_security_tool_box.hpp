@@ -0,0 +1,193 @@
+#ifndef BLUETOE_BINDINGS_HOST_SECURITY_TOOL_BOX_HPP
+#define BLUETOE_BINDINGS_HOST_SECURITY_TOOL_BOX_HPP
+
+#include <bluetoe/security_manager.hpp>
+
+#include <array>
+#include <tuple>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file host_security_tool_box.hpp
+ *
+ * Implementation of the security tool box (the cryptographic primitives required by the security
+ * manager) for a host CPU. This is used by bindings that do not run on a microcontroller with an
+ * AES peripheral (HCI for example) and by the unit tests.
+ *
+ * If the CPU supports the AES-NI instruction set, the AES rounds are executed by the CPU. Otherwise,
+ * a portable software implementation is used. The selection is done at runtime.
+ */
+namespace bluetoe
+{
+    namespace host_details
+    {
+        /**
+         * @brief AES-128 with an expanded key schedule
+         *
+         * In contrast to the rest of bluetoe, all blocks are in the byte order of FIPS-197 (most
+         * significant byte first).
+         */
+        class aes128
+        {
+        public:
+            using block_t = std::array< std::uint8_t, 16 >;
+
+            /**
+             * @brief maximum number of blocks that can be passed to encrypt() at once
+             */
+            static constexpr std::size_t max_parallel_blocks = 4;
+
+            explicit aes128( const block_t& key );
+
+            block_t encrypt( const block_t& input ) const;
+
+            /**
+             * @brief encrypts count independent blocks
+             *
+             * With AES-NI, the rounds of all blocks are interleaved to keep the AES unit busy.
+             *
+             * @pre count <= max_parallel_blocks
+             */
+            void encrypt( const block_t* input, block_t* output, std::size_t count ) const;
+
+        private:
+            alignas( 16 ) std::uint8_t round_keys_[ 11 * 16 ];
+        };
+
+        /**
+         * @brief calculates AES-CMAC over count messages of equal size with the same key
+         *
+         * All CBC chains are independent and thus are processed together. The subkey generation
+         * is done along with the first message block.
+         *
+         * @pre count < aes128::max_parallel_blocks
+         */
+        void aes_cmac( const aes128& key, const std::uint8_t* const* messages, std::size_t count, std::size_t size, aes128::block_t* macs );
+
+        /**
+         * @brief AES-128 encryption with key, data and result in the usual bluetoe byte order (low to high)
+         */
+        bluetoe::details::uint128_t aes_le( const bluetoe::details::uint128_t& key, const bluetoe::details::uint128_t& data );
+
+        /**
+         * @brief returns true, if the CPU supports AES-NI
+         */
+        bool aes_ni_supported();
+
+        /**
+         * @brief enables / disables the use of AES-NI
+         *
+         * Intended for testing. Enabling has no effect, if the CPU does not support AES-NI.
+         */
+        void use_aes_ni( bool enable );
+
+        /**
+         * @brief seeds the random number generator of the security tool box
+         *
+         * All random numbers are taken from an AES-CTR DRBG, that seeds itself from std::random_device
+         * on first use. After seeding it with fixed seed material, all following keys, nonces and
+         * passkeys are reproducible. Intended for testing.
+         *
+         * @param seed_material 32 bytes of seed material
+         */
+        void seed_random_number_generator( const std::uint8_t* seed_material );
+
+        /**
+         * @brief fills output with size bytes from the random number generator of the security tool box
+         */
+        void random_bytes( std::uint8_t* output, std::size_t size );
+
+        /**
+         * @brief set of security tool box functions, both for legacy pairing and LESC pairing
+         *
+         * Random numbers are taken from an AES-CTR DRBG (see seed_random_number_generator()).
+         */
+        class security_tool_box
+        {
+        public:
+            /**
+             * security tool box required by legacy pairing
+             */
+            bluetoe::details::uint128_t create_srand();
+
+            bluetoe::details::longterm_key_t create_long_term_key();
+
+            bluetoe::details::uint128_t c1(
+                const bluetoe::details::uint128_t& temp_key,
+                const bluetoe::details::uint128_t& rand,
+                const bluetoe::details::uint128_t& p1,
+                const bluetoe::details::uint128_t& p2 ) const;
+
+            bluetoe::details::uint128_t s1(
+                const bluetoe::details::uint128_t& temp_key,
+                const bluetoe::details::uint128_t& srand,
+                const bluetoe::details::uint128_t& mrand );
+
+            /**
+             * security tool box required by LESC pairing
+             */
+            bool is_valid_public_key( const std::uint8_t* public_key ) const;
+
+            /**
+             * @brief generate public private key pair for DH
+             */
+            std::pair< bluetoe::details::ecdh_public_key_t, bluetoe::details::ecdh_private_key_t > generate_keys();
+
+            /**
+             * @brief random nonce required for LESC pairing
+             */
+            bluetoe::details::uint128_t select_random_nonce();
+
+            /**
+             * @brief p256() security toolbox function, as specified in the core spec
+             */
+            bluetoe::details::ecdh_shared_secret_t p256( const std::uint8_t* private_key, const std::uint8_t* public_key );
+
+            /**
+             * @brief f4() security toolbox function, as specified in the core spec
+             */
+            bluetoe::details::uint128_t f4( const std::uint8_t* u, const std::uint8_t* v, const std::array< std::uint8_t, 16 >& k, std::uint8_t z );
+
+            /**
+             * @brief f5() security toolbox function, as specified in the core spec
+             *
+             * Both MacKey and LTK are calculated in one pass.
+             */
+            std::pair< bluetoe::details::uint128_t, bluetoe::details::uint128_t > f5(
+                const bluetoe::details::ecdh_shared_secret_t dh_key,
+                const bluetoe::details::uint128_t& nonce_central,
+                const bluetoe::details::uint128_t& nonce_periperal,
+                const bluetoe::link_layer::device_address& addr_controller,
+                const bluetoe::link_layer::device_address& addr_peripheral );
+
+            /**
+             * @brief f6() security toolbox function, as specified in the core spec
+             */
+            bluetoe::details::uint128_t f6(
+                const bluetoe::details::uint128_t& key,
+                const bluetoe::details::uint128_t& n1,
+                const bluetoe::details::uint128_t& n2,
+                const bluetoe::details::uint128_t& r,
+                const bluetoe::details::io_capabilities_t& io_caps,
+                const bluetoe::link_layer::device_address& addr_controller,
+                const bluetoe::link_layer::device_address& addr_peripheral );
+
+            /**
+             * @brief g2() security toolbox function, as specified in the core spec
+             */
+            std::uint32_t g2(
+                const std::uint8_t*                 u,
+                const std::uint8_t*                 v,
+                const bluetoe::details::uint128_t&  x,
+                const bluetoe::details::uint128_t&  y );
+
+            /**
+             * Functions required by IO capabilties
+             */
+            bluetoe::details::uint128_t create_passkey();
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,248 @@
+#include <bluetoe/host_link_layer_encryption.hpp>
+#include <bluetoe/bits.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace bluetoe
+{
+namespace host_details
+{
+    /////////////////////////////////
+    // class link_layer_ccm
+
+    namespace {
+        constexpr std::size_t  block_size      = 16;
+        constexpr std::size_t  header_size     = 2;
+        constexpr std::size_t  max_payload     = 251;
+
+        // NESN, SN and MD are not authenticated
+        constexpr std::uint8_t header_aad_mask = 0xe3;
+
+        aes128::block_t reverse( const bluetoe::details::uint128_t& input )
+        {
+            aes128::block_t result;
+            std::reverse_copy( input.begin(), input.end(), result.begin() );
+
+            return result;
+        }
+
+        aes128::block_t xor_( aes128::block_t a, const aes128::block_t& b )
+        {
+            for ( std::size_t i = 0; i != a.size(); ++i )
+                a[ i ] ^= b[ i ];
+
+            return a;
+        }
+    }
+
+    link_layer_ccm::link_layer_ccm()
+        : key_( block_t{{ 0 }} )
+        , iv_( 0 )
+    {
+    }
+
+    link_layer_ccm::link_layer_ccm( const bluetoe::details::uint128_t& session_key, std::uint64_t iv )
+        : key_( reverse( session_key ) )
+        , iv_( iv )
+    {
+    }
+
+    std::size_t link_layer_ccm::encrypt( const std::uint8_t* pdu, std::uint8_t* output, std::uint64_t packet_counter, bool sent_by_central ) const
+    {
+        const std::size_t size = pdu[ 1 ];
+
+        if ( size == 0 )
+        {
+            std::copy( pdu, pdu + header_size, output );
+
+            return header_size;
+        }
+
+        const block_t mic = crypt( pdu, pdu + header_size, size, output + header_size, packet_counter, sent_by_central, true );
+
+        output[ 0 ] = pdu[ 0 ];
+        output[ 1 ] = static_cast< std::uint8_t >( size + mic_size );
+        std::copy( mic.begin(), mic.begin() + mic_size, output + header_size + size );
+
+        return header_size + size + mic_size;
+    }
+
+    bool link_layer_ccm::decrypt( const std::uint8_t* pdu, std::uint8_t* output, std::uint64_t packet_counter, bool sent_by_central ) const
+    {
+        const std::size_t size = pdu[ 1 ];
+
+        if ( size == 0 )
+        {
+            std::copy( pdu, pdu + header_size, output );
+
+            return true;
+        }
+
+        if ( size <= mic_size )
+            return false;
+
+        const std::size_t payload = size - mic_size;
+        const block_t     mic     = crypt( pdu, pdu + header_size, payload, output + header_size, packet_counter, sent_by_central, false );
+
+        // the MIC is located behind the payload and is not overwritten by the decrypted payload
+        const std::uint8_t* const received_mic = pdu + header_size + payload;
+        std::uint8_t difference = 0;
+
+        for ( std::size_t i = 0; i != mic_size; ++i )
+            difference |= mic[ i ] ^ received_mic[ i ];
+
+        output[ 0 ] = pdu[ 0 ];
+        output[ 1 ] = static_cast< std::uint8_t >( payload );
+
+        return difference == 0;
+    }
+
+    link_layer_ccm::block_t link_layer_ccm::crypt( const std::uint8_t* header, const std::uint8_t* input, std::size_t size, std::uint8_t* output,
+        std::uint64_t packet_counter, bool sent_by_central, bool encrypting ) const
+    {
+        assert( size <= max_payload );
+
+        // B0 and the counter blocks A_i share the nonce (39 bit packet counter, direction bit and IV)
+        block_t b0;
+        b0[ 0 ] = 0x49;
+        bluetoe::details::write_32bit( &b0[ 1 ], static_cast< std::uint32_t >( packet_counter ) );
+        b0[ 5 ] = static_cast< std::uint8_t >( ( ( packet_counter >> 32 ) & 0x7f ) | ( sent_by_central ? 0x80 : 0x00 ) );
+        bluetoe::details::write_64bit( &b0[ 6 ], iv_ );
+        b0[ 14 ] = 0;
+        b0[ 15 ] = static_cast< std::uint8_t >( size );
+
+        block_t counter_block = b0;
+        counter_block[ 0 ]  = 0x01;
+        counter_block[ 15 ] = 0;
+
+        // CBC-MAC chain in slot 0, CTR keystream in slot 1
+        block_t in[ 2 ] = { b0, counter_block };
+        block_t out[ 2 ];
+
+        key_.encrypt( in, out, 2 );
+        const block_t s0 = out[ 1 ];
+
+        // additional authenticated data: the first header octet
+        block_t b1 = {{ 0 }};
+        b1[ 1 ] = 0x01;
+        b1[ 2 ] = header[ 0 ] & header_aad_mask;
+
+        in[ 0 ] = xor_( out[ 0 ], b1 );
+        ++counter_block[ 15 ];
+        in[ 1 ] = counter_block;
+
+        key_.encrypt( in, out, 2 );
+
+        for ( std::size_t offset = 0; offset < size; offset += block_size )
+        {
+            const std::size_t chunk     = std::min( block_size, size - offset );
+            const block_t     keystream = out[ 1 ];
+            block_t           plain     = {{ 0 }};
+
+            for ( std::size_t i = 0; i != chunk; ++i )
+            {
+                const std::uint8_t in_byte = input[ offset + i ];
+
+                plain[ i ]           = encrypting ? in_byte : static_cast< std::uint8_t >( in_byte ^ keystream[ i ] );
+                output[ offset + i ] = static_cast< std::uint8_t >( in_byte ^ keystream[ i ] );
+            }
+
+            in[ 0 ] = xor_( out[ 0 ], plain );
+            ++counter_block[ 15 ];
+            in[ 1 ] = counter_block;
+
+            key_.encrypt( in, out, offset + block_size < size ? 2 : 1 );
+        }
+
+        return xor_( out[ 0 ], s0 );
+    }
+
+    /////////////////////////////////
+    // class software_radio_encryption
+
+    software_radio_encryption::software_radio_encryption()
+        : receive_encrypted_( false )
+        , transmit_encrypted_( false )
+        , receive_counter_( 0 )
+        , transmit_counter_( 0 )
+    {
+    }
+
+    std::pair< std::uint64_t, std::uint32_t > software_radio_encryption::setup_encryption( bluetoe::details::uint128_t key, std::uint64_t skdm, std::uint32_t ivm )
+    {
+        std::uint8_t random[ 8 + 4 ];
+        random_bytes( random, sizeof( random ) );
+
+        const std::uint64_t skds = bluetoe::details::read_64bit( &random[ 0 ] );
+        const std::uint32_t ivs  = bluetoe::details::read_32bit( &random[ 8 ] );
+
+        setup_encryption( key, skdm, ivm, skds, ivs );
+
+        return { skds, ivs };
+    }
+
+    void software_radio_encryption::setup_encryption( const bluetoe::details::uint128_t& key, std::uint64_t skdm, std::uint32_t ivm, std::uint64_t skds, std::uint32_t ivs )
+    {
+        bluetoe::details::uint128_t session_descriminator;
+        bluetoe::details::write_64bit( &session_descriminator[ 0 ], skdm );
+        bluetoe::details::write_64bit( &session_descriminator[ 8 ], skds );
+
+        ccm_ = link_layer_ccm(
+            aes_le( key, session_descriminator ),
+            static_cast< std::uint64_t >( ivm ) | ( static_cast< std::uint64_t >( ivs ) << 32 ) );
+
+        receive_counter_  = 0;
+        transmit_counter_ = 0;
+    }
+
+    void software_radio_encryption::start_receive_encrypted()
+    {
+        receive_encrypted_ = true;
+    }
+
+    void software_radio_encryption::start_transmit_encrypted()
+    {
+        transmit_encrypted_ = true;
+    }
+
+    void software_radio_encryption::stop_receive_encrypted()
+    {
+        receive_encrypted_ = false;
+    }
+
+    void software_radio_encryption::stop_transmit_encrypted()
+    {
+        transmit_encrypted_ = false;
+    }
+
+    std::size_t software_radio_encryption::transmit_pdu( const std::uint8_t* pdu, std::uint8_t* output )
+    {
+        if ( !transmit_encrypted_ || pdu[ 1 ] == 0 )
+        {
+            std::copy( pdu, pdu + header_size + pdu[ 1 ], output );
+
+            return header_size + pdu[ 1 ];
+        }
+
+        return ccm_.encrypt( pdu, output, transmit_counter_++, false );
+    }
+
+    bool software_radio_encryption::receive_pdu( const std::uint8_t* pdu, std::uint8_t* output )
+    {
+        if ( !receive_encrypted_ || pdu[ 1 ] == 0 )
+        {
+            std::copy( pdu, pdu + header_size + pdu[ 1 ], output );
+
+            return true;
+        }
+
+        if ( !ccm_.decrypt( pdu, output, receive_counter_, true ) )
+            return false;
+
+        ++receive_counter_;
+
+        return true;
+    }
+}
+}
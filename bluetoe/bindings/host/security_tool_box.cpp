@@ -0,0 +1,406 @@
+#include <cassert>
+#include <bluetoe/host_security_tool_box.hpp>
+#include <bluetoe/ctr_drbg.hpp>
+
+#include <algorithm>
+#include <random>
+#include <iterator>
+
+#if defined BLUETOE_P256_COMB
+#   include <bluetoe/p256.hpp>
+#else
+#   include "uECC.h"
+#endif
+
+namespace bluetoe
+{
+namespace host_details
+{
+    /////////////////////////////////
+    // class security_tool_box
+
+    namespace {
+        using block_t = aes128::block_t;
+
+        struct drbg_traits
+        {
+            static bluetoe::details::uint128_t aes( const bluetoe::details::uint128_t& key, const bluetoe::details::uint128_t& data )
+            {
+                return aes_le( key, data );
+            }
+
+            static void entropy( std::uint8_t* buffer, std::size_t size )
+            {
+                std::random_device source;
+                std::generate( buffer, buffer + size, [&source]() {
+                    return static_cast< std::uint8_t >( source() );
+                } );
+            }
+        };
+
+        using drbg_t = bluetoe::details::ctr_drbg< drbg_traits >;
+
+        drbg_t& random_source()
+        {
+            static drbg_t source;
+
+            return source;
+        }
+
+        std::uint16_t random_number16()
+        {
+            return random_source().random_number< std::uint16_t >();
+        }
+
+        std::uint32_t random_number32()
+        {
+            return random_source().random_number< std::uint32_t >();
+        }
+
+        std::uint64_t random_number64()
+        {
+            return random_source().random_number< std::uint64_t >();
+        }
+
+        bluetoe::details::uint128_t random_number128()
+        {
+            bluetoe::details::uint128_t result;
+            random_source().generate( result.data(), result.size() );
+
+            return result;
+        }
+
+        // All functions above the link layer use low to high byte order, while AES-CMAC is
+        // specified with the most significant octet first. The messages are assembled in
+        // the order used by the core spec and all input and output values are reversed.
+        template < class Iterator >
+        std::uint8_t* append_reversed( std::uint8_t* message, Iterator begin, Iterator end )
+        {
+            return std::reverse_copy( begin, end, message );
+        }
+
+        std::uint8_t* append_address( std::uint8_t* message, const bluetoe::link_layer::device_address& address )
+        {
+            *message++ = address.is_random() ? 1 : 0;
+
+            return append_reversed( message, address.begin(), address.end() );
+        }
+
+        block_t reverse( const bluetoe::details::uint128_t& input )
+        {
+            block_t result;
+            std::reverse_copy( input.begin(), input.end(), result.begin() );
+
+            return result;
+        }
+
+        bluetoe::details::uint128_t aes_cmac_le( const bluetoe::details::uint128_t& key, const std::uint8_t* message, std::size_t size )
+        {
+            block_t mac;
+            aes_cmac( aes128( reverse( key ) ), &message, 1, size, &mac );
+
+            return reverse( mac );
+        }
+
+        bluetoe::details::uint128_t xor_( bluetoe::details::uint128_t a, const bluetoe::details::uint128_t& b )
+        {
+            std::transform(
+                a.begin(), a.end(),
+                b.begin(),
+                a.begin(),
+                []( std::uint8_t x, std::uint8_t y ) -> std::uint8_t
+                {
+                    return x xor y;
+                }
+            );
+
+            return a;
+        }
+    }
+
+    void seed_random_number_generator( const std::uint8_t* seed_material )
+    {
+        random_source().seed( seed_material );
+    }
+
+    void random_bytes( std::uint8_t* output, std::size_t size )
+    {
+        random_source().generate( output, size );
+    }
+
+    bluetoe::details::uint128_t security_tool_box::create_srand()
+    {
+        return random_number128();
+    }
+
+    bluetoe::details::longterm_key_t security_tool_box::create_long_term_key()
+    {
+        const details::longterm_key_t result = {
+            create_srand(),
+            random_number64(),
+            random_number16()
+        };
+
+        return result;
+    }
+
+    bluetoe::details::uint128_t security_tool_box::c1(
+        const bluetoe::details::uint128_t& temp_key,
+        const bluetoe::details::uint128_t& rand,
+        const bluetoe::details::uint128_t& p1,
+        const bluetoe::details::uint128_t& p2 ) const
+    {
+        // c1 (k, r, preq, pres, iat, rat, ia, ra) = e(k, e(k, r XOR p1) XOR p2)
+        const aes128 aes( reverse( temp_key ) );
+
+        const block_t p1_ = aes.encrypt( reverse( xor_( rand, p1 ) ) );
+        const block_t p2_ = reverse( p2 );
+
+        block_t input;
+        std::transform( p1_.begin(), p1_.end(), p2_.begin(), input.begin(), []( std::uint8_t x, std::uint8_t y ) -> std::uint8_t
+        {
+            return x xor y;
+        } );
+
+        return reverse( aes.encrypt( input ) );
+    }
+
+    bluetoe::details::uint128_t security_tool_box::s1(
+        const bluetoe::details::uint128_t& temp_key,
+        const bluetoe::details::uint128_t& srand,
+        const bluetoe::details::uint128_t& mrand )
+    {
+        bluetoe::details::uint128_t r;
+        std::copy( &srand[ 0 ], &srand[ 8 ], &r[ 8 ] );
+        std::copy( &mrand[ 0 ], &mrand[ 8 ], &r[ 0 ] );
+
+        return aes_le( temp_key, r );
+    }
+
+#if defined BLUETOE_P256_COMB
+    bool security_tool_box::is_valid_public_key( const std::uint8_t* public_key ) const
+    {
+        return bluetoe::p256::valid_public_key( public_key );
+    }
+
+    std::pair< bluetoe::details::ecdh_public_key_t, bluetoe::details::ecdh_private_key_t > security_tool_box::generate_keys()
+    {
+        bluetoe::details::ecdh_public_key_t  public_key;
+        bluetoe::details::ecdh_private_key_t private_key;
+
+        do
+        {
+            random_source().generate( private_key.data(), private_key.size() );
+        }
+        while ( !bluetoe::p256::public_key( private_key.data(), public_key.data() ) );
+
+        return { public_key, private_key };
+    }
+#else
+    bool security_tool_box::is_valid_public_key( const std::uint8_t* public_key ) const
+    {
+        bluetoe::details::ecdh_public_key_t key;
+        std::reverse_copy(public_key, public_key + 32, key.begin());
+        std::reverse_copy(public_key + 32, public_key + 64, key.begin() + 32);
+
+        return uECC_valid_public_key( key.data() );
+    }
+
+    std::pair< bluetoe::details::ecdh_public_key_t, bluetoe::details::ecdh_private_key_t > security_tool_box::generate_keys()
+    {
+        uECC_set_rng( []( uint8_t *dest, unsigned size )->int {
+            random_source().generate( dest, size );
+
+            return 1;
+        } );
+
+        bluetoe::details::ecdh_public_key_t  public_key;
+        bluetoe::details::ecdh_private_key_t private_key;
+
+        const auto rc = uECC_make_key( public_key.data(), private_key.data() );
+        static_cast< void >( rc );
+        assert( rc == 1 );
+
+        std::reverse( public_key.begin(), public_key.begin() + 32 );
+        std::reverse( public_key.begin() + 32, public_key.end() );
+        std::reverse( private_key.begin(), private_key.end() );
+
+        return { public_key, private_key };
+    }
+#endif
+
+    bluetoe::details::uint128_t security_tool_box::select_random_nonce()
+    {
+        return random_number128();
+    }
+
+#if defined BLUETOE_P256_COMB
+    bluetoe::details::ecdh_shared_secret_t security_tool_box::p256( const std::uint8_t* private_key, const std::uint8_t* public_key )
+    {
+        bluetoe::details::ecdh_shared_secret_t result;
+
+        const bool rc = bluetoe::p256::shared_secret( private_key, public_key, result.data() );
+        static_cast< void >( rc );
+        assert( rc );
+
+        return result;
+    }
+#else
+    bluetoe::details::ecdh_shared_secret_t security_tool_box::p256( const std::uint8_t* private_key, const std::uint8_t* public_key )
+    {
+        bluetoe::details::ecdh_private_key_t shared_secret;
+        bluetoe::details::ecdh_private_key_t priv_key;
+        bluetoe::details::ecdh_public_key_t  pub_key;
+        std::reverse_copy( public_key, public_key + 32, pub_key.begin() );
+        std::reverse_copy( public_key + 32, public_key + 64, pub_key.begin() + 32 );
+        std::reverse_copy( private_key, private_key + 32, priv_key.begin() );
+
+        const int rc = uECC_shared_secret( pub_key.data(), priv_key.data(), shared_secret.data() );
+        static_cast< void >( rc );
+        assert( rc == 1 );
+
+        bluetoe::details::ecdh_shared_secret_t result;
+        static_assert(shared_secret.size() == result.size(), "");
+
+        std::reverse_copy( shared_secret.begin(), shared_secret.end(), result.begin() );
+
+        return result;
+    }
+#endif
+
+    bluetoe::details::uint128_t security_tool_box::f4( const std::uint8_t* u, const std::uint8_t* v, const std::array< std::uint8_t, 16 >& k, std::uint8_t z )
+    {
+        // U || V || Z
+        std::uint8_t message[ 32 + 32 + 1 ];
+        std::uint8_t* m = &message[ 0 ];
+
+        m = append_reversed( m, u, u + 32 );
+        m = append_reversed( m, v, v + 32 );
+        *m++ = z;
+
+        assert( m == std::end( message ) );
+
+        return aes_cmac_le( k, message, sizeof( message ) );
+    }
+
+    std::pair< bluetoe::details::uint128_t, bluetoe::details::uint128_t > security_tool_box::f5(
+        const bluetoe::details::ecdh_shared_secret_t dh_key,
+        const bluetoe::details::uint128_t& nonce_central,
+        const bluetoe::details::uint128_t& nonce_periperal,
+        const bluetoe::link_layer::device_address& addr_controller,
+        const bluetoe::link_layer::device_address& addr_peripheral )
+    {
+        static const block_t salt = {{
+            0x6C, 0x88, 0x83, 0x91, 0xAA, 0xF5, 0xA5, 0x38,
+            0x60, 0x37, 0x0B, 0xDB, 0x5A, 0x60, 0x83, 0xBE
+        }};
+
+        static const std::uint8_t key_id[] = {
+            0x62, 0x74, 0x6c, 0x65
+        };
+
+        static const std::uint8_t length[] = {
+            0x01, 0x00
+        };
+
+        // T = AES-CMAC(SALT, W)
+        std::uint8_t w[ 32 ];
+        append_reversed( &w[ 0 ], dh_key.begin(), dh_key.end() );
+
+        const std::uint8_t* const w_ptr = &w[ 0 ];
+        block_t t;
+        aes_cmac( aes128( salt ), &w_ptr, 1, sizeof( w ), &t );
+
+        // Counter || keyID || N1 || N2 || A1 || A2 || Length
+        std::uint8_t mac_key_message[ 1 + 4 + 16 + 16 + 7 + 7 + 2 ];
+        std::uint8_t* m = &mac_key_message[ 0 ];
+
+        *m++ = 0;
+        m = std::copy( std::begin( key_id ), std::end( key_id ), m );
+        m = append_reversed( m, nonce_central.begin(), nonce_central.end() );
+        m = append_reversed( m, nonce_periperal.begin(), nonce_periperal.end() );
+        m = append_address( m, addr_controller );
+        m = append_address( m, addr_peripheral );
+        m = std::copy( std::begin( length ), std::end( length ), m );
+
+        assert( m == std::end( mac_key_message ) );
+
+        // The LTK message differs only in the counter. Both MACs are calculated in parallel.
+        std::uint8_t ltk_message[ sizeof( mac_key_message ) ];
+        std::copy( std::begin( mac_key_message ), std::end( mac_key_message ), std::begin( ltk_message ) );
+        ltk_message[ 0 ] = 1;
+
+        const std::uint8_t* const messages[] = { mac_key_message, ltk_message };
+        block_t macs[ 2 ];
+
+        aes_cmac( aes128( t ), messages, 2, sizeof( mac_key_message ), macs );
+
+        return { reverse( macs[ 0 ] ), reverse( macs[ 1 ] ) };
+    }
+
+    bluetoe::details::uint128_t security_tool_box::f6(
+        const bluetoe::details::uint128_t& key,
+        const bluetoe::details::uint128_t& n1,
+        const bluetoe::details::uint128_t& n2,
+        const bluetoe::details::uint128_t& r,
+        const bluetoe::details::io_capabilities_t& io_caps,
+        const bluetoe::link_layer::device_address& addr_controller,
+        const bluetoe::link_layer::device_address& addr_peripheral )
+    {
+        // N1 || N2 || R || IOcap || A1 || A2
+        std::uint8_t message[ 16 + 16 + 16 + 3 + 7 + 7 ];
+        std::uint8_t* m = &message[ 0 ];
+
+        m = append_reversed( m, n1.begin(), n1.end() );
+        m = append_reversed( m, n2.begin(), n2.end() );
+        m = append_reversed( m, r.begin(), r.end() );
+        m = append_reversed( m, io_caps.begin(), io_caps.end() );
+        m = append_address( m, addr_controller );
+        m = append_address( m, addr_peripheral );
+
+        assert( m == std::end( message ) );
+
+        return aes_cmac_le( key, message, sizeof( message ) );
+    }
+
+    std::uint32_t security_tool_box::g2(
+        const std::uint8_t*                 u,
+        const std::uint8_t*                 v,
+        const bluetoe::details::uint128_t&  x,
+        const bluetoe::details::uint128_t&  y )
+    {
+        // U || V || Y
+        std::uint8_t message[ 32 + 32 + 16 ];
+        std::uint8_t* m = &message[ 0 ];
+
+        m = append_reversed( m, u, u + 32 );
+        m = append_reversed( m, v, v + 32 );
+        m = append_reversed( m, y.begin(), y.end() );
+
+        assert( m == std::end( message ) );
+
+        const auto mac = aes_cmac_le( x, message, sizeof( message ) );
+
+        return bluetoe::details::read_32bit( mac.data() );
+    }
+
+    bluetoe::details::uint128_t security_tool_box::create_passkey()
+    {
+        static constexpr std::uint32_t max_passkey = 999999;
+
+        // rejection sampling to get uniformly distributed passkeys
+        static constexpr std::uint32_t limit = 0xffffffff - 0xffffffff % ( max_passkey + 1 );
+
+        std::uint32_t random = random_number32();
+        while ( random >= limit )
+            random = random_number32();
+
+        const std::uint32_t passkey = random % ( max_passkey + 1 );
+
+        bluetoe::details::uint128_t result{{ 0 }};
+        bluetoe::details::write_32bit( result.data(), passkey );
+
+        return result;
+    }
+}
+}
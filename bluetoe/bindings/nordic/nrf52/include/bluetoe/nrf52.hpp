@@ -572,6 +572,14 @@ namespace bluetoe
                 Hardware::set_phy( receiving_encoding, transmiting_c_encoding );
             }
 
+            /**
+             * @brief elapsed time since the anchor of the current connection event
+             */
+            link_layer::delta_time time_since_anchor() const
+            {
+                return link_layer::delta_time( Hardware::now() );
+            }
+
             using lock_guard = typename Hardware::lock_guard;
 
             // no native white list implementation atm
@@ -587,6 +595,11 @@ namespace bluetoe
              */
             static constexpr bool hardware_supports_synchronized_user_timer = true;
 
+            /**
+             * @brief indicates support for time_since_anchor()
+             */
+            static constexpr bool hardware_supports_time_since_anchor = true;
+
             static constexpr unsigned connection_event_setup_time_us = nrf52_radio_base::start_event_safety_margin_us;
 
         private:
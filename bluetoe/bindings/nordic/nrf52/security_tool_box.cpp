@@ -1,8 +1,15 @@
 #include <cassert>
 #include <bluetoe/security_tool_box.hpp>
 #include <bluetoe/nrf.hpp>
+#include <bluetoe/ctr_drbg.hpp>
 
-#include "uECC.h"
+#include <algorithm>
+
+#if defined BLUETOE_P256_COMB
+#   include <bluetoe/p256.hpp>
+#else
+#   include "uECC.h"
+#endif
 
 namespace bluetoe
 {
@@ -13,13 +20,9 @@ namespace nrf52_details
     /////////////////////////////////
     // class security_tool_box
 
-    // TODO: Entropie-Pool to not block here too much
-    // How much random numbers do we need:
-    //  - without encryption?
-    //  - encrytped but already paired? <-- this might be the sweetspot
-    //  - leagacy pairing?
-    //  - LESC pairing?
-    static std::uint8_t random_number8()
+    // The hardware RNG is slow (and the link layer would have to wait for every value). It is only
+    // used to seed an AES-CTR DRBG that serves all random numbers.
+    static std::uint8_t hardware_random_number8()
     {
         nrf_random->TASKS_START = 1;
 
@@ -31,24 +34,6 @@ namespace nrf52_details
         return nrf_random->VALUE;
     }
 
-    static std::uint16_t random_number16()
-    {
-        return static_cast< std::uint16_t >( random_number8() )
-            | ( static_cast< std::uint16_t >( random_number8() ) << 8 );
-    }
-
-    std::uint32_t random_number32()
-    {
-        return static_cast< std::uint32_t >( random_number16() )
-            | ( static_cast< std::uint32_t >( random_number16() ) << 16 );
-    }
-
-    std::uint64_t random_number64()
-    {
-        return static_cast< std::uint64_t >( random_number32() )
-            | ( static_cast< std::uint64_t >( random_number32() ) << 32 );
-    }
-
     // Note: While every function above the link layer uses low to high byte order inputs to the
     // EAS function, the CCM, that encrypts the link layer trafic, uses high to low byte order.
     // That's why the intput and output in aes_le() changeing the byte order. The result of the
@@ -88,6 +73,76 @@ namespace nrf52_details
         return aes_le( key, data.data() );
     }
 
+    namespace {
+        struct drbg_traits
+        {
+            static bluetoe::details::uint128_t aes( const bluetoe::details::uint128_t& key, const bluetoe::details::uint128_t& data )
+            {
+                return aes_le( key, data );
+            }
+
+            static void entropy( std::uint8_t* buffer, std::size_t size )
+            {
+                std::generate( buffer, buffer + size, hardware_random_number8 );
+            }
+        };
+
+        bluetoe::details::ctr_drbg< drbg_traits > random_source;
+
+        // The DRBG is not thread safe, but is used by the security manager and by the encryption setup of the
+        // link layer, which runs in interrupt context. So the DRBG is only accessed with interrupts disabled. Note,
+        // that this includes the one time seeding from the hardware RNG on the first request.
+        class random_source_lock
+        {
+        public:
+            random_source_lock()
+                : context_( __get_PRIMASK() )
+            {
+                __disable_irq();
+            }
+
+            ~random_source_lock()
+            {
+                __set_PRIMASK( context_ );
+            }
+
+            random_source_lock( const random_source_lock& ) = delete;
+            random_source_lock& operator=( const random_source_lock& ) = delete;
+        private:
+            const std::uint32_t context_;
+        };
+    }
+
+    static void random_bytes( std::uint8_t* output, std::size_t size )
+    {
+        const random_source_lock lock;
+        random_source.generate( output, size );
+    }
+
+    static std::uint8_t random_number8()
+    {
+        const random_source_lock lock;
+        return random_source.random_number< std::uint8_t >();
+    }
+
+    static std::uint16_t random_number16()
+    {
+        const random_source_lock lock;
+        return random_source.random_number< std::uint16_t >();
+    }
+
+    std::uint32_t random_number32()
+    {
+        const random_source_lock lock;
+        return random_source.random_number< std::uint32_t >();
+    }
+
+    std::uint64_t random_number64()
+    {
+        const random_source_lock lock;
+        return random_source.random_number< std::uint64_t >();
+    }
+
     static bluetoe::details::uint128_t xor_( bluetoe::details::uint128_t a, const std::uint8_t* b )
     {
         std::transform(
@@ -111,7 +166,7 @@ namespace nrf52_details
     bluetoe::details::uint128_t security_tool_box::create_srand()
     {
         details::uint128_t result;
-        std::generate( result.begin(), result.end(), random_number8 );
+        random_bytes( result.data(), result.size() );
 
         return result;
     }
@@ -151,6 +206,26 @@ namespace nrf52_details
         return aes_le( temp_key, r );
     }
 
+#if defined BLUETOE_P256_COMB
+    bool security_tool_box::is_valid_public_key( const std::uint8_t* public_key ) const
+    {
+        return bluetoe::p256::valid_public_key( public_key );
+    }
+
+    std::pair< bluetoe::details::ecdh_public_key_t, bluetoe::details::ecdh_private_key_t > security_tool_box::generate_keys()
+    {
+        bluetoe::details::ecdh_public_key_t  public_key;
+        bluetoe::details::ecdh_private_key_t private_key;
+
+        do
+        {
+            random_bytes( private_key.data(), private_key.size() );
+        }
+        while ( !bluetoe::p256::public_key( private_key.data(), public_key.data() ) );
+
+        return { public_key, private_key };
+    }
+#else
     bool security_tool_box::is_valid_public_key( const std::uint8_t* public_key ) const
     {
         bluetoe::details::ecdh_public_key_t key;
@@ -163,7 +238,7 @@ namespace nrf52_details
     std::pair< bluetoe::details::ecdh_public_key_t, bluetoe::details::ecdh_private_key_t > security_tool_box::generate_keys()
     {
         uECC_set_rng( []( uint8_t *dest, unsigned size )->int {
-            std::generate( dest, dest + size, random_number8 );
+            random_bytes( dest, size );
 
             return 1;
         } );
@@ -181,15 +256,28 @@ namespace nrf52_details
 
         return { public_key, private_key };
     }
+#endif
 
     bluetoe::details::uint128_t security_tool_box::select_random_nonce()
     {
         bluetoe::details::uint128_t result;
-        std::generate( result.begin(), result.end(), random_number8 );
+        random_bytes( result.data(), result.size() );
 
         return result;
     }
 
+#if defined BLUETOE_P256_COMB
+    bluetoe::details::ecdh_shared_secret_t security_tool_box::p256( const std::uint8_t* private_key, const std::uint8_t* public_key )
+    {
+        bluetoe::details::ecdh_shared_secret_t result;
+
+        const bool rc = bluetoe::p256::shared_secret( private_key, public_key, result.data() );
+        static_cast< void >( rc );
+        assert( rc );
+
+        return result;
+    }
+#else
     bluetoe::details::ecdh_shared_secret_t security_tool_box::p256( const std::uint8_t* private_key, const std::uint8_t* public_key )
     {
         bluetoe::details::ecdh_private_key_t shared_secret;
@@ -210,6 +298,7 @@ namespace nrf52_details
 
         return result;
     }
+#endif
 
     static bluetoe::details::uint128_t left_shift(const bluetoe::details::uint128_t& input)
     {
@@ -0,0 +1,94 @@
+#ifndef BLUETOE_BINDINGS_P256_HPP
+#define BLUETOE_BINDINGS_P256_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file p256.hpp
+ *
+ * Elliptic curve Diffie-Hellman over NIST P-256, as required by LE Secure Connections pairing.
+ *
+ * This is an alternative to the generic uECC implementation, optimized for the two operations
+ * required by LESC:
+ * - The public key is a multiple of the fixed base point G and is calculated with a fixed-base
+ *   comb and a precomputed table (stored in flash), which takes about a sixth of the point
+ *   doublings of a generic scalar multiplication.
+ * - The DH key is a multiple of the remote public key, calculated with a width-5 windowed
+ *   non-adjacent form (wNAF) of the private key.
+ *
+ * All keys use the byte order of the security manager protocol (low to high): the 32 bytes of a
+ * private key or shared secret are little endian, a public key is the little endian X coordinate,
+ * followed by the little endian Y coordinate.
+ *
+ * The implementation is not hardened against timing side channels. LESC key pairs are
+ * ephemeral and used for a single pairing.
+ *
+ * A binding selects this backend at build time by defining BLUETOE_P256_COMB and linking
+ * against bluetoe::bindings::p256.
+ */
+namespace bluetoe
+{
+    namespace p256
+    {
+        /**
+         * @brief returns true, if the given private key is in the range [1, n-1]
+         */
+        bool valid_private_key( const std::uint8_t* private_key );
+
+        /**
+         * @brief returns true, if the given public key is a point on the curve
+         */
+        bool valid_public_key( const std::uint8_t* public_key );
+
+        /**
+         * @brief calculates the public key to the given private key
+         *
+         * @return false, if the private key is not valid.
+         */
+        bool public_key( const std::uint8_t* private_key, std::uint8_t* public_key );
+
+        /**
+         * @brief calculates the X coordinate of private_key * public_key
+         *
+         * The public key is expected to be validated by the caller.
+         *
+         * @return false, if the private key is not valid, or the result is the point at infinity.
+         */
+        bool shared_secret( const std::uint8_t* private_key, const std::uint8_t* public_key, std::uint8_t* secret );
+    }
+
+    /** @cond HIDDEN_SYMBOLS */
+    namespace p256_details
+    {
+        // 256 bit numbers as little endian 32 bit limbs
+        using field_element = std::array< std::uint32_t, 8 >;
+
+        struct affine_point
+        {
+            field_element x;
+            field_element y;
+        };
+
+        // the comb splits the scalar into comb_teeth parts of comb_spacing bits
+        static constexpr std::size_t comb_teeth      = 6;
+        static constexpr std::size_t comb_spacing    = 43;
+        static constexpr std::size_t comb_table_size = ( 1 << comb_teeth ) - 1;
+
+        static_assert( comb_teeth * comb_spacing >= 256, "comb has to cover all scalar bits" );
+
+        /*
+         * comb_table[ i - 1 ] = sum( 2^(j * comb_spacing) * G ) for all bits j set in i
+         */
+        extern const affine_point comb_table[ comb_table_size ];
+
+        /*
+         * calculates the content of comb_table; used to generate and to verify the table
+         */
+        void calculate_comb_table( affine_point* table );
+    }
+    /** @endcond */
+}
+
+#endif
@@ -0,0 +1,734 @@
+#include <bluetoe/p256.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace bluetoe
+{
+namespace p256_details
+{
+    namespace {
+        using limb_t = std::uint32_t;
+
+        static constexpr std::size_t limbs = 8;
+
+        // p = 2^256 - 2^224 + 2^192 + 2^96 - 1
+        static const field_element prime = {{
+            0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x00000000,
+            0x00000000, 0x00000000, 0x00000001, 0xFFFFFFFF
+        }};
+
+        // order of the base point
+        static const field_element order = {{
+            0xFC632551, 0xF3B9CAC2, 0xA7179E84, 0xBCE6FAAD,
+            0xFFFFFFFF, 0xFFFFFFFF, 0x00000000, 0xFFFFFFFF
+        }};
+
+        static const field_element curve_b = {{
+            0x27D2604B, 0x3BCE3C3E, 0xCC53B0F6, 0x651D06B0,
+            0x769886BC, 0xB3EBBD55, 0xAA3A93E7, 0x5AC635D8
+        }};
+
+        static const affine_point base_point = {
+            {{
+                0xD898C296, 0xF4A13945, 0x2DEB33A0, 0x77037D81,
+                0x63A440F2, 0xF8BCE6E5, 0xE12C4247, 0x6B17D1F2
+            }},
+            {{
+                0x37BF51F5, 0xCBB64068, 0x6B315ECE, 0x2BCE3357,
+                0x7C0F9E16, 0x8EE7EB4A, 0xFE1A7F9B, 0x4FE342E2
+            }}
+        };
+
+        static const field_element one = {{ 1 }};
+
+        /*
+         * Number and field arithmetic
+         */
+        field_element read_number( const std::uint8_t* input )
+        {
+            field_element result;
+
+            for ( auto& limb : result )
+            {
+                limb = static_cast< limb_t >( input[ 0 ] )
+                    | ( static_cast< limb_t >( input[ 1 ] ) << 8 )
+                    | ( static_cast< limb_t >( input[ 2 ] ) << 16 )
+                    | ( static_cast< limb_t >( input[ 3 ] ) << 24 );
+
+                input += 4;
+            }
+
+            return result;
+        }
+
+        std::uint8_t* write_number( std::uint8_t* output, const field_element& number )
+        {
+            for ( const auto limb : number )
+            {
+                *output++ = static_cast< std::uint8_t >( limb );
+                *output++ = static_cast< std::uint8_t >( limb >> 8 );
+                *output++ = static_cast< std::uint8_t >( limb >> 16 );
+                *output++ = static_cast< std::uint8_t >( limb >> 24 );
+            }
+
+            return output;
+        }
+
+        bool is_zero( const field_element& a )
+        {
+            return std::all_of( a.begin(), a.end(), []( limb_t l ){ return l == 0; } );
+        }
+
+        bool less( const field_element& a, const field_element& b )
+        {
+            for ( std::size_t i = limbs; i != 0; --i )
+            {
+                if ( a[ i - 1 ] != b[ i - 1 ] )
+                    return a[ i - 1 ] < b[ i - 1 ];
+            }
+
+            return false;
+        }
+
+        bool bit( const field_element& a, std::size_t index )
+        {
+            return index < 256 && ( a[ index / 32 ] >> ( index % 32 ) ) & 1;
+        }
+
+        limb_t add( field_element& r, const field_element& a, const field_element& b )
+        {
+            std::uint64_t carry = 0;
+
+            for ( std::size_t i = 0; i != limbs; ++i )
+            {
+                carry += static_cast< std::uint64_t >( a[ i ] ) + b[ i ];
+                r[ i ] = static_cast< limb_t >( carry );
+                carry >>= 32;
+            }
+
+            return static_cast< limb_t >( carry );
+        }
+
+        limb_t sub( field_element& r, const field_element& a, const field_element& b )
+        {
+            limb_t borrow = 0;
+
+            for ( std::size_t i = 0; i != limbs; ++i )
+            {
+                const std::uint64_t diff = static_cast< std::uint64_t >( a[ i ] ) - b[ i ] - borrow;
+                r[ i ]  = static_cast< limb_t >( diff );
+                borrow  = static_cast< limb_t >( diff >> 32 ) & 1;
+            }
+
+            return borrow;
+        }
+
+        void mod_add( field_element& r, const field_element& a, const field_element& b )
+        {
+            if ( add( r, a, b ) || !less( r, prime ) )
+                sub( r, r, prime );
+        }
+
+        void mod_sub( field_element& r, const field_element& a, const field_element& b )
+        {
+            if ( sub( r, a, b ) )
+                add( r, r, prime );
+        }
+
+        /*
+         * Fast reduction of a 512 bit product, using the special form of p (FIPS 186-4, D.2.3)
+         */
+        void reduce( field_element& r, const limb_t* c )
+        {
+            const std::int64_t c0 = c[ 0 ], c1 = c[ 1 ], c2 = c[ 2 ], c3 = c[ 3 ];
+            const std::int64_t c4 = c[ 4 ], c5 = c[ 5 ], c6 = c[ 6 ], c7 = c[ 7 ];
+            const std::int64_t c8 = c[ 8 ], c9 = c[ 9 ], c10 = c[ 10 ], c11 = c[ 11 ];
+            const std::int64_t c12 = c[ 12 ], c13 = c[ 13 ], c14 = c[ 14 ], c15 = c[ 15 ];
+
+            std::int64_t words[ limbs ] = {
+                c0 + c8 + c9 - c11 - c12 - c13 - c14,
+                c1 + c9 + c10 - c12 - c13 - c14 - c15,
+                c2 + c10 + c11 - c13 - c14 - c15,
+                c3 + 2 * c11 + 2 * c12 + c13 - c15 - c8 - c9,
+                c4 + 2 * c12 + 2 * c13 + c14 - c9 - c10,
+                c5 + 2 * c13 + 2 * c14 + c15 - c10 - c11,
+                c6 + 3 * c14 + 2 * c15 + c13 - c8 - c9,
+                c7 + 3 * c15 + c8 - c10 - c11 - c12 - c13
+            };
+
+            for ( ;; )
+            {
+                std::int64_t carry = 0;
+
+                for ( std::size_t i = 0; i != limbs; ++i )
+                {
+                    const std::int64_t sum = words[ i ] + carry;
+                    r[ i ]  = static_cast< limb_t >( sum );
+                    carry   = ( sum - static_cast< std::int64_t >( r[ i ] ) ) / ( std::int64_t( 1 ) << 32 );
+                }
+
+                if ( carry == 0 )
+                    break;
+
+                // carry * 2^256 = carry * ( 2^224 - 2^192 - 2^96 + 1 ) (mod p)
+                for ( std::size_t i = 0; i != limbs; ++i )
+                    words[ i ] = r[ i ];
+
+                words[ 0 ] += carry;
+                words[ 3 ] -= carry;
+                words[ 6 ] -= carry;
+                words[ 7 ] += carry;
+            }
+
+            while ( !less( r, prime ) )
+                sub( r, r, prime );
+        }
+
+        void mod_mul( field_element& r, const field_element& a, const field_element& b )
+        {
+            limb_t product[ 2 * limbs ] = { 0 };
+
+            for ( std::size_t i = 0; i != limbs; ++i )
+            {
+                std::uint64_t carry = 0;
+
+                for ( std::size_t j = 0; j != limbs; ++j )
+                {
+                    carry += static_cast< std::uint64_t >( a[ i ] ) * b[ j ] + product[ i + j ];
+                    product[ i + j ] = static_cast< limb_t >( carry );
+                    carry >>= 32;
+                }
+
+                product[ i + limbs ] = static_cast< limb_t >( carry );
+            }
+
+            reduce( r, product );
+        }
+
+        // squaring needs only 36 instead of 64 multiplications
+        void mod_sqr( field_element& r, const field_element& a )
+        {
+            limb_t product[ 2 * limbs ] = { 0 };
+
+            for ( std::size_t i = 0; i != limbs; ++i )
+            {
+                std::uint64_t carry = 0;
+
+                for ( std::size_t j = i + 1; j != limbs; ++j )
+                {
+                    carry += static_cast< std::uint64_t >( a[ i ] ) * a[ j ] + product[ i + j ];
+                    product[ i + j ] = static_cast< limb_t >( carry );
+                    carry >>= 32;
+                }
+
+                product[ i + limbs ] = static_cast< limb_t >( carry );
+            }
+
+            limb_t top = 0;
+            for ( auto& limb : product )
+            {
+                const limb_t next = limb >> 31;
+                limb = ( limb << 1 ) | top;
+                top  = next;
+            }
+
+            std::uint64_t carry = 0;
+            for ( std::size_t i = 0; i != limbs; ++i )
+            {
+                carry += static_cast< std::uint64_t >( a[ i ] ) * a[ i ] + product[ 2 * i ];
+                product[ 2 * i ] = static_cast< limb_t >( carry );
+                carry >>= 32;
+
+                carry += product[ 2 * i + 1 ];
+                product[ 2 * i + 1 ] = static_cast< limb_t >( carry );
+                carry >>= 32;
+            }
+
+            reduce( r, product );
+        }
+
+        void mod_sqr_n( field_element& r, const field_element& a, std::size_t n )
+        {
+            r = a;
+
+            for ( ; n; --n )
+                mod_sqr( r, r );
+        }
+
+        // a^(p-2) = a^-1 (mod p); addition chain with 255 squarings and 12 multiplications
+        void mod_inv( field_element& r, const field_element& a )
+        {
+            field_element x2, x3, x6, x12, x15, x30, x32, t;
+
+            mod_sqr( x2, a );
+            mod_mul( x2, x2, a );
+            mod_sqr( x3, x2 );
+            mod_mul( x3, x3, a );
+            mod_sqr_n( x6, x3, 3 );
+            mod_mul( x6, x6, x3 );
+            mod_sqr_n( x12, x6, 6 );
+            mod_mul( x12, x12, x6 );
+            mod_sqr_n( x15, x12, 3 );
+            mod_mul( x15, x15, x3 );
+            mod_sqr_n( x30, x15, 15 );
+            mod_mul( x30, x30, x15 );
+            mod_sqr_n( x32, x30, 2 );
+            mod_mul( x32, x32, x2 );
+
+            // ffffffff 00000001
+            mod_sqr_n( t, x32, 32 );
+            mod_mul( t, t, a );
+            // 00000000 00000000 00000000 ffffffff
+            mod_sqr_n( t, t, 128 );
+            mod_mul( t, t, x32 );
+            // ffffffff
+            mod_sqr_n( t, t, 32 );
+            mod_mul( t, t, x32 );
+            // fffffffd
+            mod_sqr_n( t, t, 30 );
+            mod_mul( t, t, x30 );
+            mod_sqr_n( t, t, 2 );
+            mod_mul( r, t, a );
+        }
+
+        /*
+         * Point arithmetic in Jacobian coordinates (x = X/Z^2, y = Y/Z^3); Z == 0 is the point at infinity
+         */
+        struct jacobian_point
+        {
+            field_element x;
+            field_element y;
+            field_element z;
+        };
+
+        jacobian_point infinity()
+        {
+            return jacobian_point{ one, one, field_element{{ 0 }} };
+        }
+
+        bool is_infinity( const jacobian_point& p )
+        {
+            return is_zero( p.z );
+        }
+
+        // "dbl-2001-b" for a = -3
+        void point_double( jacobian_point& p )
+        {
+            if ( is_infinity( p ) )
+                return;
+
+            field_element delta, gamma, beta, alpha, t1, t2;
+
+            mod_sqr( delta, p.z );
+            mod_sqr( gamma, p.y );
+            mod_mul( beta, p.x, gamma );
+
+            // alpha = 3 * ( X - delta ) * ( X + delta )
+            mod_sub( t1, p.x, delta );
+            mod_add( t2, p.x, delta );
+            mod_mul( t1, t1, t2 );
+            mod_add( alpha, t1, t1 );
+            mod_add( alpha, alpha, t1 );
+
+            // Z3 = ( Y + Z )^2 - gamma - delta
+            mod_add( t1, p.y, p.z );
+            mod_sqr( t1, t1 );
+            mod_sub( t1, t1, gamma );
+            mod_sub( p.z, t1, delta );
+
+            // X3 = alpha^2 - 8 * beta
+            mod_add( beta, beta, beta );
+            mod_add( beta, beta, beta );
+            mod_add( t2, beta, beta );
+            mod_sqr( p.x, alpha );
+            mod_sub( p.x, p.x, t2 );
+
+            // Y3 = alpha * ( 4 * beta - X3 ) - 8 * gamma^2
+            mod_sub( t1, beta, p.x );
+            mod_mul( t1, alpha, t1 );
+            mod_sqr( gamma, gamma );
+            mod_add( gamma, gamma, gamma );
+            mod_add( gamma, gamma, gamma );
+            mod_add( gamma, gamma, gamma );
+            mod_sub( p.y, t1, gamma );
+        }
+
+        // "madd-2007-bl": p += q, with q in affine coordinates
+        void point_add( jacobian_point& p, const field_element& qx, const field_element& qy )
+        {
+            if ( is_infinity( p ) )
+            {
+                p = jacobian_point{ qx, qy, one };
+                return;
+            }
+
+            field_element z1z1, u2, s2, h, r, hh, hhh, v;
+
+            mod_sqr( z1z1, p.z );
+            mod_mul( u2, qx, z1z1 );
+            mod_mul( s2, qy, p.z );
+            mod_mul( s2, s2, z1z1 );
+            mod_sub( h, u2, p.x );
+            mod_sub( r, s2, p.y );
+
+            if ( is_zero( h ) )
+            {
+                if ( is_zero( r ) )
+                    point_double( p );
+                else
+                    p = infinity();
+
+                return;
+            }
+
+            mod_sqr( hh, h );
+            mod_mul( hhh, h, hh );
+            mod_mul( v, p.x, hh );
+
+            // Z3 = Z1 * H
+            mod_mul( p.z, p.z, h );
+
+            // X3 = r^2 - HHH - 2 * V
+            mod_sqr( p.x, r );
+            mod_sub( p.x, p.x, hhh );
+            mod_sub( p.x, p.x, v );
+            mod_sub( p.x, p.x, v );
+
+            // Y3 = r * ( V - X3 ) - Y1 * HHH
+            mod_sub( v, v, p.x );
+            mod_mul( v, r, v );
+            mod_mul( hhh, p.y, hhh );
+            mod_sub( p.y, v, hhh );
+        }
+
+        // "add-1998-cmo-2": p += q
+        void point_add( jacobian_point& p, const jacobian_point& q )
+        {
+            if ( is_infinity( q ) )
+                return;
+
+            if ( is_infinity( p ) )
+            {
+                p = q;
+                return;
+            }
+
+            field_element z1z1, z2z2, u1, u2, s1, s2, h, r, hh, hhh, v;
+
+            mod_sqr( z1z1, p.z );
+            mod_sqr( z2z2, q.z );
+            mod_mul( u1, p.x, z2z2 );
+            mod_mul( u2, q.x, z1z1 );
+            mod_mul( s1, p.y, q.z );
+            mod_mul( s1, s1, z2z2 );
+            mod_mul( s2, q.y, p.z );
+            mod_mul( s2, s2, z1z1 );
+            mod_sub( h, u2, u1 );
+            mod_sub( r, s2, s1 );
+
+            if ( is_zero( h ) )
+            {
+                if ( is_zero( r ) )
+                    point_double( p );
+                else
+                    p = infinity();
+
+                return;
+            }
+
+            mod_sqr( hh, h );
+            mod_mul( hhh, h, hh );
+            mod_mul( v, u1, hh );
+
+            // Z3 = Z1 * Z2 * H
+            mod_mul( p.z, p.z, q.z );
+            mod_mul( p.z, p.z, h );
+
+            // X3 = r^2 - HHH - 2 * V
+            mod_sqr( p.x, r );
+            mod_sub( p.x, p.x, hhh );
+            mod_sub( p.x, p.x, v );
+            mod_sub( p.x, p.x, v );
+
+            // Y3 = r * ( V - X3 ) - S1 * HHH
+            mod_sub( v, v, p.x );
+            mod_mul( v, r, v );
+            mod_mul( hhh, s1, hhh );
+            mod_sub( p.y, v, hhh );
+        }
+
+        void point_add( jacobian_point& p, const affine_point& q )
+        {
+            point_add( p, q.x, q.y );
+        }
+
+        void point_sub( jacobian_point& p, const affine_point& q )
+        {
+            field_element neg_y;
+            sub( neg_y, prime, q.y );
+
+            point_add( p, q.x, neg_y );
+        }
+
+        affine_point to_affine( const jacobian_point& p )
+        {
+            field_element z_inv, z_inv2;
+            mod_inv( z_inv, p.z );
+            mod_sqr( z_inv2, z_inv );
+
+            affine_point result;
+            mod_mul( result.x, p.x, z_inv2 );
+            mod_mul( z_inv2, z_inv2, z_inv );
+            mod_mul( result.y, p.y, z_inv2 );
+
+            return result;
+        }
+
+        // converts count points to affine coordinates, with a single inversion (Montgomery's trick)
+        void to_affine( const jacobian_point* points, affine_point* result, std::size_t count, field_element* scratch )
+        {
+            assert( count > 0 );
+
+            scratch[ 0 ] = points[ 0 ].z;
+
+            for ( std::size_t i = 1; i != count; ++i )
+                mod_mul( scratch[ i ], scratch[ i - 1 ], points[ i ].z );
+
+            field_element inv;
+            mod_inv( inv, scratch[ count - 1 ] );
+
+            for ( std::size_t i = count; i != 0; --i )
+            {
+                const std::size_t index = i - 1;
+                field_element z_inv = inv;
+
+                if ( index != 0 )
+                {
+                    mod_mul( z_inv, inv, scratch[ index - 1 ] );
+                    mod_mul( inv, inv, points[ index ].z );
+                }
+
+                field_element z_inv2;
+                mod_sqr( z_inv2, z_inv );
+                mod_mul( result[ index ].x, points[ index ].x, z_inv2 );
+                mod_mul( z_inv2, z_inv2, z_inv );
+                mod_mul( result[ index ].y, points[ index ].y, z_inv2 );
+            }
+        }
+
+        bool on_curve( const affine_point& p )
+        {
+            if ( !less( p.x, prime ) || !less( p.y, prime ) )
+                return false;
+
+            // y^2 = x^3 - 3x + b
+            field_element left, right, three_x;
+            mod_sqr( left, p.y );
+
+            mod_sqr( right, p.x );
+            mod_mul( right, right, p.x );
+            mod_add( three_x, p.x, p.x );
+            mod_add( three_x, three_x, p.x );
+            mod_sub( right, right, three_x );
+            mod_add( right, right, curve_b );
+
+            return left == right;
+        }
+
+        /*
+         * Scalar multiplication with a fixed base (comb)
+         */
+        jacobian_point multiply_base_point( const field_element& scalar )
+        {
+            jacobian_point result = infinity();
+
+            for ( std::size_t i = comb_spacing; i != 0; --i )
+            {
+                point_double( result );
+
+                std::size_t index = 0;
+                for ( std::size_t tooth = 0; tooth != comb_teeth; ++tooth )
+                    index |= static_cast< std::size_t >( bit( scalar, tooth * comb_spacing + i - 1 ) ) << tooth;
+
+                if ( index )
+                    point_add( result, comb_table[ index - 1 ] );
+            }
+
+            return result;
+        }
+
+        /*
+         * Scalar multiplication with a variable base (wNAF)
+         */
+        static constexpr int         wnaf_width      = 5;
+        static constexpr std::size_t wnaf_table_size = 1 << ( wnaf_width - 2 );
+        static constexpr std::size_t max_wnaf_digits = 257;
+
+        // returns the number of digits
+        std::size_t wnaf_recode( field_element scalar, std::int8_t* digits )
+        {
+            // one additional limb, as adding a digit can overflow 256 bits
+            limb_t top = 0;
+            std::size_t length = 0;
+
+            while ( top != 0 || !is_zero( scalar ) )
+            {
+                assert( length < max_wnaf_digits );
+                int digit = 0;
+
+                if ( scalar[ 0 ] & 1 )
+                {
+                    digit = static_cast< int >( scalar[ 0 ] & ( ( 1 << wnaf_width ) - 1 ) );
+
+                    if ( digit >= ( 1 << ( wnaf_width - 1 ) ) )
+                        digit -= 1 << wnaf_width;
+
+                    field_element d{{ static_cast< limb_t >( digit < 0 ? -digit : digit ) }};
+
+                    if ( digit < 0 )
+                        top += add( scalar, scalar, d );
+                    else
+                        sub( scalar, scalar, d );
+                }
+
+                digits[ length++ ] = static_cast< std::int8_t >( digit );
+
+                for ( std::size_t i = 0; i != limbs - 1; ++i )
+                    scalar[ i ] = ( scalar[ i ] >> 1 ) | ( scalar[ i + 1 ] << 31 );
+
+                scalar[ limbs - 1 ] = ( scalar[ limbs - 1 ] >> 1 ) | ( top << 31 );
+                top >>= 1;
+            }
+
+            return length;
+        }
+
+        jacobian_point multiply_point( const field_element& scalar, const affine_point& point )
+        {
+            // odd multiples P, 3P, 5P, ... 15P; converted to affine coordinates with a single inversion
+            affine_point  table[ wnaf_table_size ];
+            {
+                jacobian_point twice = jacobian_point{ point.x, point.y, one };
+                point_double( twice );
+
+                jacobian_point multiples[ wnaf_table_size - 1 ];
+                jacobian_point current = jacobian_point{ point.x, point.y, one };
+
+                for ( auto& multiple : multiples )
+                {
+                    point_add( current, twice );
+                    multiple = current;
+                }
+
+                field_element scratch[ wnaf_table_size - 1 ];
+                table[ 0 ] = point;
+                to_affine( multiples, &table[ 1 ], wnaf_table_size - 1, scratch );
+            }
+
+            std::int8_t digits[ max_wnaf_digits ];
+            const std::size_t length = wnaf_recode( scalar, digits );
+
+            jacobian_point result = infinity();
+
+            for ( std::size_t i = length; i != 0; --i )
+            {
+                point_double( result );
+
+                const int digit = digits[ i - 1 ];
+
+                if ( digit > 0 )
+                    point_add( result, table[ ( digit - 1 ) / 2 ] );
+                else if ( digit < 0 )
+                    point_sub( result, table[ ( -digit - 1 ) / 2 ] );
+            }
+
+            return result;
+        }
+    }
+
+    void calculate_comb_table( affine_point* table )
+    {
+        // teeth[ j ] = 2^(j * comb_spacing) * G
+        affine_point teeth[ comb_teeth ];
+        teeth[ 0 ] = base_point;
+
+        for ( std::size_t j = 1; j != comb_teeth; ++j )
+        {
+            jacobian_point p{ teeth[ j - 1 ].x, teeth[ j - 1 ].y, one };
+
+            for ( std::size_t i = 0; i != comb_spacing; ++i )
+                point_double( p );
+
+            teeth[ j ] = to_affine( p );
+        }
+
+        jacobian_point entries[ comb_table_size ];
+
+        for ( std::size_t index = 1; index <= comb_table_size; ++index )
+        {
+            std::size_t highest = comb_teeth - 1;
+            while ( ( index & ( 1u << highest ) ) == 0 )
+                --highest;
+
+            const std::size_t rest = index & ~( 1u << highest );
+
+            entries[ index - 1 ] = rest == 0
+                ? infinity()
+                : entries[ rest - 1 ];
+
+            point_add( entries[ index - 1 ], teeth[ highest ] );
+        }
+
+        field_element scratch[ comb_table_size ];
+        to_affine( entries, table, comb_table_size, scratch );
+    }
+}
+
+namespace p256
+{
+    using namespace p256_details;
+
+    bool valid_private_key( const std::uint8_t* private_key )
+    {
+        const field_element key = read_number( private_key );
+
+        return !is_zero( key ) && less( key, order );
+    }
+
+    bool valid_public_key( const std::uint8_t* public_key )
+    {
+        const affine_point point{ read_number( public_key ), read_number( public_key + 32 ) };
+
+        return on_curve( point );
+    }
+
+    bool public_key( const std::uint8_t* private_key, std::uint8_t* public_key )
+    {
+        if ( !valid_private_key( private_key ) )
+            return false;
+
+        const affine_point point = to_affine( multiply_base_point( read_number( private_key ) ) );
+
+        write_number( write_number( public_key, point.x ), point.y );
+
+        return true;
+    }
+
+    bool shared_secret( const std::uint8_t* private_key, const std::uint8_t* public_key, std::uint8_t* secret )
+    {
+        if ( !valid_private_key( private_key ) )
+            return false;
+
+        const affine_point point{ read_number( public_key ), read_number( public_key + 32 ) };
+        const jacobian_point product = multiply_point( read_number( private_key ), point );
+
+        if ( is_infinity( product ) )
+            return false;
+
+        write_number( secret, to_affine( product ).x );
+
+        return true;
+    }
+}
+}
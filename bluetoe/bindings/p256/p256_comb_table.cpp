@@ -0,0 +1,643 @@
+#include <bluetoe/p256.hpp>
+
+namespace bluetoe
+{
+namespace p256_details
+{
+    /*
+     * Generated with calculate_comb_table(); comb_table[ i - 1 ] = sum( 2^(43 * j) * G ) for all bits j set in i
+     */
+    const affine_point comb_table[ comb_table_size ] = {
+        {
+            {{
+                0xD898C296, 0xF4A13945, 0x2DEB33A0, 0x77037D81,
+                0x63A440F2, 0xF8BCE6E5, 0xE12C4247, 0x6B17D1F2
+            }},
+            {{
+                0x37BF51F5, 0xCBB64068, 0x6B315ECE, 0x2BCE3357,
+                0x7C0F9E16, 0x8EE7EB4A, 0xFE1A7F9B, 0x4FE342E2
+            }}
+        },
+        {
+            {{
+                0xB049E7CD, 0xCD013F88, 0xE57FDC00, 0xE8F9257A,
+                0xFC3A9301, 0x3BE71969, 0x58CFF937, 0x987F256D
+            }},
+            {{
+                0x6EFA35D6, 0xB7254BBC, 0x07AAFFDB, 0x47B46052,
+                0x0007E39E, 0xE860EBD6, 0x94EC505C, 0x8E926956
+            }}
+        },
+        {
+            {{
+                0x5A1C3FB1, 0x59DB167C, 0xBF318EB2, 0x98B3CE2A,
+                0xD2BC2FA6, 0x2DF1C41E, 0x6ED1B2AF, 0xEFCC2C43
+            }},
+            {{
+                0x97B25513, 0x17FE07F1, 0x3734A589, 0x46824533,
+                0xED34F543, 0xA5384A77, 0x8D9F3863, 0xF3684F9C
+            }}
+        },
+        {
+            {{
+                0xBF780C2C, 0xFDC73E83, 0x2D666817, 0xFFDC6794,
+                0x02436893, 0xC14B66DD, 0x0D54650C, 0x6EEC9567
+            }},
+            {{
+                0xEDBFCD32, 0x089EC1A1, 0x3A07FF89, 0x79AB6615,
+                0x65EA0105, 0xFC281DE0, 0x997732C2, 0x14BB5350
+            }}
+        },
+        {
+            {{
+                0x7318188E, 0xAEC90264, 0xCA167099, 0x410BEC28,
+                0x099C202B, 0xBF664D2F, 0x55FA625C, 0x13CCCA34
+            }},
+            {{
+                0x05421C0C, 0xAA84C231, 0x6CDB0D71, 0x6B647521,
+                0xFB216A5E, 0xE90446B1, 0xAF46893D, 0x4B5BA5A5
+            }}
+        },
+        {
+            {{
+                0x4862C5DB, 0xACA2FA08, 0xA1717F8A, 0xDDFFC222,
+                0xE4E09FD2, 0xAB839A14, 0x980330F5, 0xF86A9078
+            }},
+            {{
+                0xC1DD7DCC, 0x6890F24C, 0xEA6EFD98, 0xF75DCCFA,
+                0xFF9A093B, 0xBA2612B8, 0x2568653C, 0x20347D0C
+            }}
+        },
+        {
+            {{
+                0xCBDB1C78, 0xD3B22809, 0x30F6CDA4, 0x5591C8EB,
+                0xBFE80F8B, 0xB6E28740, 0x40E7E7E7, 0x0F74342A
+            }},
+            {{
+                0x351C51F2, 0xD2968E87, 0xF5E17B5E, 0x65C5C581,
+                0x9D994E2E, 0x6F58F02A, 0xF5C1EC07, 0x531C0B00
+            }}
+        },
+        {
+            {{
+                0x1A6B665E, 0xEB042121, 0xA7F6803A, 0x802F779E,
+                0x3C0804C3, 0x47501F2A, 0x4945A1D4, 0xA263919B
+            }},
+            {{
+                0x30BCDCFB, 0x9EE40400, 0x4C00EFE2, 0xAC3F83DF,
+                0xE60D60C5, 0x2E9D3C9D, 0x2AED20FC, 0x873200BD
+            }}
+        },
+        {
+            {{
+                0x8B21AA51, 0x2B52C47D, 0x5A7E870D, 0x0F503629,
+                0x88B45127, 0xBAA92814, 0xC402E050, 0x27D6451E
+            }},
+            {{
+                0x5567432D, 0x5C96EC14, 0x0F4150C7, 0xCDEB9829,
+                0xCDEEF566, 0x5D91740C, 0x1BE9E583, 0x2A58FA5E
+            }}
+        },
+        {
+            {{
+                0x5788C0F6, 0xD8142DFF, 0x247FDE25, 0x89BF5229,
+                0x14E2280F, 0x5C971DDB, 0x09904E3F, 0x785B7E91
+            }},
+            {{
+                0x2E7E6F0B, 0x445E4519, 0x4CE293DD, 0x8789440E,
+                0xC797BE30, 0x96B84F57, 0xFA3EA32D, 0x6B44059D
+            }}
+        },
+        {
+            {{
+                0x2195A979, 0x73B7C550, 0xB8DD5813, 0x2D7ED474,
+                0xE104E9AC, 0xC0B9ECD2, 0xA2BD0ED8, 0xDC90D975
+            }},
+            {{
+                0x4DD6EB2E, 0x9FB55203, 0xC01DFDE8, 0x50D554BB,
+                0xF0977A30, 0x4CFD3277, 0x815374C4, 0xC87CE232
+            }}
+        },
+        {
+            {{
+                0xCF9A3CA9, 0xE4B541B6, 0x08B49B2F, 0x1C650587,
+                0xF552641E, 0xB95F91B3, 0x5C301277, 0xBDDC23AC
+            }},
+            {{
+                0x04DABA43, 0x519D0700, 0x8450CFA2, 0xC003DCC3,
+                0x4E48EFDE, 0x73A1C8F5, 0x5B04F761, 0x7D0CA942
+            }}
+        },
+        {
+            {{
+                0x1703406D, 0xCB4DC35B, 0x75DAC54C, 0x4FD3AFC9,
+                0x29F02878, 0x112321EB, 0xAD6B225F, 0xAFB18D2F
+            }},
+            {{
+                0xF1776A67, 0xDDF58273, 0xF6B96C2F, 0x96889755,
+                0x22208FFB, 0x31A8D663, 0xFCCA4877, 0x5ED81C10
+            }}
+        },
+        {
+            {{
+                0xE834A3C4, 0xFF0E1F34, 0x1C4AB236, 0x0D59B6AE,
+                0x015A211B, 0x10EB194A, 0x3892DDC5, 0xED6E13E0
+            }},
+            {{
+                0xFB3F678D, 0xAC88DF04, 0x544026A9, 0x6F0FBF44,
+                0x619CECBA, 0xCDE8CD7A, 0x80D9A8CC, 0x02F322E5
+            }}
+        },
+        {
+            {{
+                0x336AAF40, 0x2DC61E1B, 0x4251F5B7, 0x897E87BD,
+                0x6511B370, 0x2FB32023, 0x2341F499, 0x460FA9CF
+            }},
+            {{
+                0xCBAF01A7, 0x03E63B79, 0x44157434, 0x937E123F,
+                0x809E4A1A, 0x9D59226E, 0x41775E62, 0x18D6F63A
+            }}
+        },
+        {
+            {{
+                0xA9AA52DF, 0x3CD5F4E4, 0xB42A627F, 0x18C452B1,
+                0xD991ECE6, 0x6DBC4189, 0x7F608BF7, 0x45A511C9
+            }},
+            {{
+                0x125EC16C, 0x7B52BD12, 0xD22955CE, 0x5A919B27,
+                0xCB625AD2, 0x3FE3337F, 0x73EA9B6D, 0x73BE0EC7
+            }}
+        },
+        {
+            {{
+                0x016476EA, 0xC6E4B6D0, 0xD4EC2510, 0x71B9A7E5,
+                0xCBE490D2, 0x1975B71E, 0xB52ACD25, 0xDF6B472F
+            }},
+            {{
+                0x784055EB, 0xF1738716, 0xB87D399E, 0xCCC7B0B3,
+                0x1BB51119, 0x3C9A1337, 0xA88FD593, 0xB42639E1
+            }}
+        },
+        {
+            {{
+                0xC219C20B, 0x86A38D54, 0xB50A4733, 0xAFCDD2CA,
+                0x72096638, 0xF4CF8797, 0x24CE0E94, 0xD949CAA2
+            }},
+            {{
+                0x96F9AE13, 0x678664AE, 0xC984DE46, 0x00EF5BA9,
+                0x8D549567, 0x622ABC7F, 0x57DB924D, 0x673ED500
+            }}
+        },
+        {
+            {{
+                0x20B4D697, 0x41E94206, 0x29FA0DF9, 0xA10FD0D9,
+                0x76022C38, 0xF11EB0A7, 0xA5621C63, 0xFFCB7DDC
+            }},
+            {{
+                0x0927965A, 0x24E37B1B, 0xBD2C199E, 0x8D9FC102,
+                0x907F3F85, 0x862DE75E, 0x5A9C778E, 0xD3985129
+            }}
+        },
+        {
+            {{
+                0xB56BC451, 0x48D63748, 0xA939440A, 0x0544DE81,
+                0x664EC19C, 0xDA24EB0B, 0x41F42BF6, 0x4FB6E562
+            }},
+            {{
+                0x66BB5D6B, 0x21B2C80E, 0xD25BD41B, 0xA4123924,
+                0xBCE2D418, 0x6F95F5F2, 0x4D6D91D8, 0xA9232776
+            }}
+        },
+        {
+            {{
+                0xF119B8CC, 0x546A08E7, 0x8AFC696A, 0x03B7D523,
+                0x459F70B4, 0x0A896132, 0xA86A9116, 0x57A46257
+            }},
+            {{
+                0xBB314C65, 0xFAA56FEF, 0x74795C6D, 0xF4E61F40,
+                0x437850D6, 0x1A3C5652, 0x6621EC11, 0x7C4B127D
+            }}
+        },
+        {
+            {{
+                0xE83CFA35, 0x6DD25E26, 0x1FF3BDDC, 0x61E44DA0,
+                0x121733FA, 0xB7B67B02, 0xFCD798CA, 0x7C48F60D
+            }},
+            {{
+                0x090F5154, 0x244D234A, 0x8CAE33BB, 0x93B7F2FB,
+                0x426D1516, 0x158BF2F6, 0xA801E86E, 0xA8A947A8
+            }}
+        },
+        {
+            {{
+                0x56C8815E, 0xF41E0307, 0x7D37A2F1, 0xBAF647E3,
+                0xFEFAFBF5, 0x7791EB36, 0x35B7F606, 0x158262FB
+            }},
+            {{
+                0x32DCE9E5, 0xF6C32255, 0x361B4780, 0x6C7CD4CE,
+                0x3F85288F, 0xE5BE5E70, 0xC98E624A, 0x4C281AA3
+            }}
+        },
+        {
+            {{
+                0x7FD58AE5, 0x9D7F749E, 0x37EA57A2, 0xC78BA263,
+                0x4F5AB5B7, 0xB5C05127, 0x5F2D643B, 0x6FD3F54D
+            }},
+            {{
+                0x2116B8CE, 0x3428E311, 0x71B28987, 0xC52D1D24,
+                0x8299421F, 0x87F70BE9, 0x64F49798, 0x0A5FD098
+            }}
+        },
+        {
+            {{
+                0x4D6A3DEF, 0x5B2911DD, 0xB96008F1, 0x4BEDD07C,
+                0xE36E7D64, 0xEE748A6F, 0x4BBF5CF4, 0xBFC49934
+            }},
+            {{
+                0x8E74750F, 0x55C6F62D, 0x48919902, 0x22639F87,
+                0x958A248F, 0xFA01AA94, 0xED51AA40, 0x2743AE8A
+            }}
+        },
+        {
+            {{
+                0xE76CCBC0, 0x75EA69CB, 0xA762DEB7, 0xC9736051,
+                0xAF2BFF4C, 0xA720D4C6, 0xBE6D6DBA, 0x8E4C7B10
+            }},
+            {{
+                0x2F128433, 0xAF5C0EFE, 0xA1FE85EC, 0x834CBF1F,
+                0x2685F018, 0xD321C5A6, 0x717A5340, 0xB5B09CF6
+            }}
+        },
+        {
+            {{
+                0x86EB7815, 0x9CDDA821, 0xCE413265, 0x8C003612,
+                0x91B577F5, 0x8BCE1FAB, 0x488F730C, 0x0F3F29FF
+            }},
+            {{
+                0xE6960D55, 0xEBB08063, 0xAECBF467, 0x1A9699E2,
+                0x4CE5761B, 0x6B1564A4, 0x81382996, 0x08F00EA5
+            }}
+        },
+        {
+            {{
+                0x96BF8EA5, 0x6C10CDD2, 0xE8CD868F, 0xE28C488A,
+                0x46442D00, 0xBA9226C3, 0xFA1F864B, 0x9125CAED
+            }},
+            {{
+                0x2E21B4AF, 0xF33BD66E, 0x68DBE58C, 0x12DC5537,
+                0xE5353044, 0xD9B85123, 0x07BC6B60, 0xF4925BDE
+            }}
+        },
+        {
+            {{
+                0x70514A21, 0x0D17FF39, 0xDADD80EE, 0xD2A7B5BA,
+                0x8126C8C4, 0x941E33C3, 0x1D57C1DE, 0xB9E156D0
+            }},
+            {{
+                0xEA8105AD, 0x220D500D, 0x0202F3AE, 0x6A2AA462,
+                0x3DC96356, 0x450056AB, 0x452142C3, 0x506AB6AA
+            }}
+        },
+        {
+            {{
+                0x1B20D599, 0xE0CB1029, 0x10A5FBA0, 0x7B1ED83D,
+                0x04007713, 0x7D5FB32B, 0x79C82639, 0x93BAB590
+            }},
+            {{
+                0x49B97D9D, 0x977FA5A6, 0x3551254A, 0xA3592333,
+                0xA9F7A3EB, 0x8F277388, 0xE3026E2C, 0x36ABA935
+            }}
+        },
+        {
+            {{
+                0xC05131CD, 0xF197735B, 0x22BEB567, 0x05650768,
+                0xF7F55B1F, 0xDBF2B189, 0x132C2614, 0xAA144C82
+            }},
+            {{
+                0xB3822251, 0xF41CBE14, 0xFFD0AFBE, 0xB1CE72B2,
+                0x844743FA, 0x01A14D18, 0x923739B8, 0xC1D89FE3
+            }}
+        },
+        {
+            {{
+                0x0B79847D, 0xF0F679F1, 0x6BB19BE6, 0x3719A8B6,
+                0xDC7F43D5, 0x2DDB6C3D, 0xDA0982E2, 0x2800043A
+            }},
+            {{
+                0x908D9EDA, 0xFE5B0083, 0xB8513AE9, 0xA87058DB,
+                0x84A4DC3B, 0xB6C07965, 0x67E82909, 0x0F991746
+            }}
+        },
+        {
+            {{
+                0x5F3F5B80, 0x12416A5C, 0xDA522422, 0x58E903DB,
+                0x4291867E, 0x18CC80F1, 0x7A152C2B, 0xB2035CF8
+            }},
+            {{
+                0x95C80EDE, 0x71125691, 0xAF97C5B0, 0xBFE02568,
+                0x8A14E493, 0x603E1DC5, 0x749680DE, 0xF12F359C
+            }}
+        },
+        {
+            {{
+                0x6AA2B49D, 0x1CAAB0BA, 0x6F7FC502, 0x6A75A768,
+                0x57EA120F, 0x6A5EA5A8, 0xDB6BDF96, 0x998CD5F9
+            }},
+            {{
+                0x467184A9, 0xD2D7BA4C, 0x25C03723, 0xBE178E54,
+                0xBC389EF3, 0x6BFC1707, 0x7B7D9FB3, 0x3256A8A0
+            }}
+        },
+        {
+            {{
+                0xFEA77B0C, 0x40429D1B, 0x595E9A31, 0x4651A4DC,
+                0xE712693A, 0x8900AAB1, 0x84BF612D, 0x90EA7767
+            }},
+            {{
+                0x0D02F2B6, 0xBDD10425, 0xFB4D594F, 0xF5583BCC,
+                0x5BA7B6A1, 0x75754462, 0x101E86F4, 0xD1A321D3
+            }}
+        },
+        {
+            {{
+                0x5AC0B3DB, 0x7A2F10B2, 0xF0B98928, 0xE6DEFFA0,
+                0xE6B0B01A, 0xB4B2939B, 0x0A3F2CA8, 0xA03E1D52
+            }},
+            {{
+                0x2CBEAD24, 0xFC779531, 0xD30FA3F9, 0xE8362908,
+                0xF23B00BB, 0x6F29D6F4, 0xEBB82E0A, 0xEA1AD22F
+            }}
+        },
+        {
+            {{
+                0xE62DA069, 0x6890B26C, 0x7C586265, 0xA5702319,
+                0x865672AB, 0xE64E19BF, 0xA07D9893, 0xA66503F5
+            }},
+            {{
+                0x21FE4743, 0xE4DEB7C0, 0x7D7100BE, 0x3BAE847D,
+                0xE17B1D29, 0x1769FCA7, 0x320AFC60, 0xADBA60EC
+            }}
+        },
+        {
+            {{
+                0x89806E19, 0x74814E1C, 0xF9EC85DE, 0x9135FC8D,
+                0x09AFD25B, 0x0EE660A6, 0x6740A284, 0x943DE3B7
+            }},
+            {{
+                0x622227D9, 0xDBA0327F, 0xD4C486E8, 0xA524C6D6,
+                0x7134581A, 0x217FB779, 0xE4254A7E, 0xAFA3B65F
+            }}
+        },
+        {
+            {{
+                0xC4E48158, 0xA3C9D614, 0xAE8FC508, 0xB26B4A98,
+                0x38B68E18, 0x44EF8BE0, 0xDB271FCD, 0xBE9CF596
+            }},
+            {{
+                0x8E6F95AD, 0x737B653E, 0x9B9E4D0A, 0x73DBE6FF,
+                0xA4139F59, 0x4B772A8C, 0x66C67E8A, 0xA1F335E5
+            }}
+        },
+        {
+            {{
+                0x2D00715B, 0x0ABFA3EE, 0xC8297B47, 0xF3F65DC1,
+                0x00669E85, 0x4199B659, 0x23C09567, 0x7588DF7F
+            }},
+            {{
+                0x868D3227, 0xABDF62FA, 0x8099A8FC, 0xA0844D34,
+                0x3BABBC72, 0x3361B9C0, 0x6D5BF03B, 0xBB0357A4
+            }}
+        },
+        {
+            {{
+                0xF77CF152, 0xC0B161FB, 0x8CE30043, 0x243C4FED,
+                0x050E20DF, 0xB1B4A2D0, 0xC34999AE, 0x5A61A286
+            }},
+            {{
+                0x70214EB7, 0x8C7BAF68, 0xF2C261FE, 0x975BCA7D,
+                0x1ED91AE8, 0x03C6DF31, 0xA1380D38, 0xE8CFAAAD
+            }}
+        },
+        {
+            {{
+                0x016F613C, 0xA6BCC84D, 0xC2EC4E56, 0xAE5CE038,
+                0xF8BE76B4, 0xAD80F035, 0x84642DD4, 0x00456C5C
+            }},
+            {{
+                0xDE3648C8, 0x0EF7079F, 0x68D0A170, 0x7BF0B3AB,
+                0x56C684E3, 0xA85C96B8, 0x91D65C88, 0xFD39B0F2
+            }}
+        },
+        {
+            {{
+                0x966D28DD, 0xC79E3178, 0x89F8A2C1, 0x67BA8686,
+                0x4ACF8D42, 0xAF1F9C6D, 0xE0847F7D, 0x2D2B4273
+            }},
+            {{
+                0x69130CEC, 0x1D9E1A90, 0x9383E7B5, 0x95CB10FD,
+                0x44CC71AE, 0x73438A26, 0x1EE4EA49, 0x37EAEB10
+            }}
+        },
+        {
+            {{
+                0x620C767B, 0x2A675B54, 0x5AE6598E, 0xF1235F08,
+                0x48A35E9B, 0x3CF6A1CD, 0xD8A1B5F8, 0xF11A113E
+            }},
+            {{
+                0x1742A887, 0xA401985D, 0xB6A73D9B, 0x3F83BD07,
+                0x82736067, 0x3C7307A0, 0x1F12FBB6, 0x64A1A66D
+            }}
+        },
+        {
+            {{
+                0xD84A37DE, 0x1C12B5CB, 0xC7B1EA1A, 0x56D66DB4,
+                0x2CE31E9A, 0x852BE420, 0xE40FAF48, 0x17BE9C2D
+            }},
+            {{
+                0x38CC8797, 0x735B3CCB, 0x34B1093E, 0x1F8D9D80,
+                0xE75B81C0, 0xD8CC6E86, 0x3FDBE697, 0x6914BF94
+            }}
+        },
+        {
+            {{
+                0x0CCF3981, 0x422618C9, 0x8DAB3936, 0x7F5F9610,
+                0x8E0A6A28, 0xCA4AB750, 0xD5BAB133, 0x8266E2FE
+            }},
+            {{
+                0xAB5500F6, 0xFAA7545B, 0x5D994D86, 0xA91EDAEB,
+                0x67FB462D, 0x0A5B194B, 0x287178CE, 0x089CFD68
+            }}
+        },
+        {
+            {{
+                0x00B16F35, 0x54B44D33, 0x002D5707, 0x59988EF3,
+                0xD0494F94, 0x256FE1EB, 0x7F710DE4, 0xAEF84169
+            }},
+            {{
+                0x8BD49604, 0xCA38FB1F, 0xBFA0B15C, 0xAEC9DAAE,
+                0x642CF6DD, 0x1551365E, 0x160E8FFF, 0x75B8B0FA
+            }}
+        },
+        {
+            {{
+                0x01FEEA35, 0xB2466027, 0x317C61F1, 0xEA17F580,
+                0x786AACEB, 0x8D71EABA, 0x1CC47DAB, 0x7DE7454A
+            }},
+            {{
+                0xFF1B1266, 0x10B69D62, 0xB9AB079C, 0xE22CC59B,
+                0x42B2D441, 0x9A57E43F, 0xE8C85F85, 0x22340FEC
+            }}
+        },
+        {
+            {{
+                0xEDAB9CB9, 0x6033D113, 0xE69D45EE, 0x1DF87BA3,
+                0xE4D65A03, 0x93436236, 0x3F98A508, 0x5893F6F9
+            }},
+            {{
+                0xAAD54FAB, 0xB3832E15, 0x6BC7365E, 0x3277FF0D,
+                0x200C4FB8, 0xE8301118, 0xD4E9384D, 0x26E471BC
+            }}
+        },
+        {
+            {{
+                0x68C28F39, 0x1C1DD91A, 0xF35669CA, 0xFA494334,
+                0x51ABB743, 0x77B40ABD, 0xE7873A25, 0xEE7400BA
+            }},
+            {{
+                0xED2309D9, 0xF15D9BF5, 0x3DA8785A, 0x8A90D13F,
+                0x1BE8B67D, 0x7E4FB96C, 0xCAE9ED81, 0x196C1BA4
+            }}
+        },
+        {
+            {{
+                0xC52427D8, 0x3276C5A4, 0xF5A34B64, 0x66958243,
+                0xF36E0D92, 0x04166798, 0xC6E9E63F, 0x43E33927
+            }},
+            {{
+                0xF0CA8D2B, 0x899AED76, 0x0AF50DD8, 0x43B89CDE,
+                0x5951E13B, 0x805EA21E, 0x28413043, 0xE210DAA4
+            }}
+        },
+        {
+            {{
+                0x98A174FC, 0xE17F627B, 0x4DFA285E, 0x5EBCE1FF,
+                0x54C5F925, 0xC95FE23D, 0x3188BA78, 0x5EA59A09
+            }},
+            {{
+                0x2D2D8163, 0x6615BB54, 0x5DB03D95, 0x37BE4A1E,
+                0x4FC47762, 0xC51B5692, 0xD142931D, 0xB994CA42
+            }}
+        },
+        {
+            {{
+                0x0758035B, 0xCE46A165, 0xE070A0C9, 0xB33DF1AD,
+                0x686934C9, 0xBF01FB38, 0xF0F16ED0, 0x1CBA6257
+            }},
+            {{
+                0xEE93409C, 0xE538A9B6, 0x4A6B38DA, 0xD82429A1,
+                0xA5C215B1, 0x1488770D, 0x891D7658, 0x4ADE1F8E
+            }}
+        },
+        {
+            {{
+                0x51A03105, 0xBF93CDA8, 0x7BE433ED, 0xB14F4A60,
+                0xFA1C97A1, 0x0AA4C4C3, 0xBCED726E, 0xFE1A6375
+            }},
+            {{
+                0x0409C304, 0x4DB68287, 0xEBF37AF4, 0x08FB9622,
+                0xF6ABDFF4, 0x677003EC, 0x3FB7CC37, 0xE6B2E872
+            }}
+        },
+        {
+            {{
+                0x27ADE63F, 0xFE702B4B, 0xA105673A, 0x5DF11A33,
+                0xA362B9CE, 0x0D33CB80, 0x855BB209, 0xA7BB42F5
+            }},
+            {{
+                0xC95FE575, 0xFDCC6096, 0x2351DEC6, 0xFF0E08D7,
+                0xBB6A5B28, 0xA3323FF5, 0x89F7A2AB, 0x2CAA2DAE
+            }}
+        },
+        {
+            {{
+                0x51FF89BB, 0x252566B6, 0xDB973DDC, 0x453C333E,
+                0xD83F2CC2, 0xFBCD5A09, 0x3121DBD5, 0x187818EC
+            }},
+            {{
+                0x3B46B949, 0xAEA1B45F, 0x55F753E0, 0x42314623,
+                0xB09991FA, 0xD59AB00B, 0x0AE0C8D7, 0xEE05650D
+            }}
+        },
+        {
+            {{
+                0x2DA7EB49, 0x2096D676, 0xFB775E41, 0x6E04768E,
+                0xAF24F76C, 0xC3349C3D, 0xDE0C90F6, 0xE6DB6CCA
+            }},
+            {{
+                0xA416FD87, 0x98AA01F5, 0x781EC427, 0x84C3270B,
+                0x021034B2, 0x37680F04, 0x654BF735, 0xEB90FE3C
+            }}
+        },
+        {
+            {{
+                0xE4976DD8, 0xEAF7623C, 0xE29BD0B4, 0x92528B1A,
+                0x645CEC2A, 0x78158ECD, 0xB11325E9, 0x3265EAD8
+            }},
+            {{
+                0xC04780B7, 0x1CA27AF8, 0x2465867D, 0x14EF0845,
+                0x2FEEFE38, 0xB45C1887, 0x5D8730E9, 0x7C4D96BC
+            }}
+        },
+        {
+            {{
+                0xB3571976, 0x8E35BF16, 0x346864E7, 0xE2EB0C63,
+                0x7E9B6C7F, 0x2B7B57E0, 0x70B35A98, 0x3157CF6F
+            }},
+            {{
+                0x5AC49EA5, 0xFEC24C14, 0x6B1A32AE, 0xC20C5690,
+                0x345FA335, 0xEAEF7B4E, 0x4077475F, 0xB4C9655D
+            }}
+        },
+        {
+            {{
+                0x6C38B3DA, 0x3C3D8C9B, 0x754433E3, 0x80818302,
+                0xE29E542A, 0xFE68AB07, 0xD12CBB2C, 0x81A25A61
+            }},
+            {{
+                0x8F685647, 0x559948A7, 0x83A56574, 0xE14EBCF6,
+                0x7A77DB0F, 0x1A606632, 0x0892CE93, 0xF49D838F
+            }}
+        },
+        {
+            {{
+                0xFCF866B9, 0xF3F4E3FE, 0xE18B0AD5, 0x152A0807,
+                0x1B9B2E7B, 0x2EC4C706, 0xDADD006F, 0x41D7E92B
+            }},
+            {{
+                0x1D4B6EF7, 0xFF0A8A79, 0xB2AA2F47, 0x02344DFF,
+                0x357A0681, 0x1726D704, 0xC1BC85F4, 0x4CE6BB77
+            }}
+        },
+        {
+            {{
+                0x8916A00D, 0x651EBB86, 0x001E908D, 0xBA4D2DA9,
+                0x1684FCB0, 0x5F2B68E6, 0x10AC6EDF, 0xC3FF8D75
+            }},
+            {{
+                0xF5C49A61, 0x6997E3EA, 0xB1A4DC68, 0x8F4FF372,
+                0xC95C2DB2, 0xBEA7CE04, 0x9D10F761, 0x2ACCB4F4
+            }}
+        },
+        {
+            {{
+                0xAFCC2BEF, 0xB9E437F4, 0x3ADA2B53, 0x4F1FB2D6,
+                0xBB580C9A, 0xE6C0E12D, 0x33C7546D, 0x25183734
+            }},
+            {{
+                0xBFD92FB9, 0xAB12D90F, 0xA185AE46, 0x2CB9B9B3,
+                0x9CE6F49F, 0x2A0C7A7E, 0xB48F21F2, 0x531F307F
+            }}
+        }
+    };
+}
+}
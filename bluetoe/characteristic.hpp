@@ -15,6 +15,9 @@
 #include <bluetoe/meta_types.hpp>
 #include <bluetoe/encryption.hpp>
 #include <bluetoe/descriptor.hpp>
+#include <bluetoe/delivery_latency.hpp>
+#include <bluetoe/unchanged_notifications.hpp>
+#include <bluetoe/notification_rate_limit.hpp>
 
 #include <cstddef>
 #include <cassert>
@@ -134,6 +137,9 @@ namespace bluetoe {
      * @sa indicate
      * @sa higher_outgoing_priority
      * @sa lower_outgoing_priority
+     * @sa maximum_delivery_latency
+     * @sa suppress_unchanged_notifications
+     * @sa notification_rate_limit
      * @sa write_without_response
      * @sa only_write_without_response
      * @sa bind_characteristic_value
@@ -169,6 +175,22 @@ namespace bluetoe {
         static constexpr std::size_t number_of_attributes     = attribute_numbers::number_of_attributes;
         static constexpr std::size_t number_of_client_configs = attribute_numbers::number_of_client_configs;
 
+        /**
+         * maximum delivery latency of notifications and indications in ms; 0 for unbounded
+         */
+        static constexpr std::uint32_t maximum_delivery_latency_ms = details::delivery_latency< Options... >::milliseconds;
+
+        /**
+         * notifications are dropped, if the value did not change since the last notification
+         */
+        static constexpr bool suppresses_unchanged_notifications = details::has_option< suppress_unchanged_notifications, Options... >::value;
+
+        /**
+         * minimum interval between two notifications and coalescing window in ms; 0 for no rate limit
+         */
+        static constexpr std::uint32_t notification_minimum_interval_ms  = details::notification_rate< Options... >::minimum_interval_ms;
+        static constexpr std::uint32_t notification_coalescing_window_ms = details::notification_rate< Options... >::coalescing_window_ms;
+
         struct meta_type :
             details::characteristic_meta_type,
             details::valid_service_option_meta_type {};
@@ -5,6 +5,8 @@
 #include <bluetoe/attribute.hpp>
 #include <bluetoe/codes.hpp>
 #include <bluetoe/meta_types.hpp>
+#include <bluetoe/seqlock_value.hpp>
+#include <bluetoe/write_command_burst.hpp>
 #include <type_traits>
 #include <climits>
 #include <cstring>
@@ -24,6 +26,7 @@ namespace bluetoe {
         struct characteristic_value_declaration_parameter {};
         struct client_characteristic_configuration_parameter {};
         struct characteristic_subscription_call_back_meta_type {};
+        struct prepared_write_through_meta_type {};
     }
 
     /**
@@ -212,6 +215,91 @@ namespace bluetoe {
         /** @endcond */
     };
 
+    /**
+     * @brief prepared writes to the characteristic are passed directly to the write handler
+     *
+     * By default, the fragments of a "Write Long Characteristic Value" procedure are copied into the servers write
+     * queue and are written to the characteristic, when the client executes the queued writes. With this option,
+     * every fragment is passed to the write handler of the characteristic, as soon as it is received. When the client
+     * executes the queued writes, Commit is called, when the client cancels the queued writes or disconnects, Rollback
+     * is called. So the write handler has to keep received fragments in a staging area, until Commit makes them
+     * effective.
+     *
+     * A fragment does not occupy memory in the write queue, only a few bytes are used to keep track of the
+     * characteristics that received fragments. So the size of a written value is not limited by the size of the write
+     * queue and a small write queue is sufficient. The write handler has to be able to handle offsets
+     * (bluetoe::free_write_blob_handler or bluetoe::write_blob_handler for example).
+     *
+     * Errors returned by the write handler are reported in response to the "Prepare Write Request". Commit can
+     * return an error, that will be reported in response to the "Execute Write Request". In that case and for all
+     * characteristics that were not committed yet, Rollback is called.
+     *
+     * As the write handler has a single staging area, only one client at a time can write through. While fragments of
+     * one client are neither committed nor rolled back, a "Prepare Write Request" of an other client to any
+     * characteristic with this option is answered with "Prepare Queue Full" and a "Write Request" with "Insufficient
+     * Resources".
+     *
+     * A "Write Request" or "Write Command" to the characteristic is committed directly after the value was written.
+     * If the request is larger than a single link layer PDU, the request is not defragmented by the link layer, but
+     * every fragment is passed to the write handler, as soon as it is received. This saves the copy into the
+     * defragmentation buffer and allows the write handler to place the value directly in its final destination.
+     *
+     * Example:
+     * @code
+        std::uint8_t write_staged( std::size_t offset, std::size_t write_size, const std::uint8_t* value );
+        std::uint8_t commit_staged();
+        void discard_staged();
+
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid< 0xD0B10674, 0x6DDD, 0x4B59, 0x89CA, 0xA009B78C956B >,
+            bluetoe::free_write_blob_handler< &write_staged >,
+            bluetoe::prepared_write_through< &commit_staged, &discard_staged >
+        >
+     * @endcode
+     * @sa characteristic
+     * @sa shared_write_queue
+     * @sa pooled_write_queue
+     */
+    template < std::uint8_t (*Commit)(), void (*Rollback)() >
+    struct prepared_write_through {
+        /** @cond HIDDEN_SYMBOLS */
+        static constexpr bool enabled = true;
+
+        static std::uint8_t commit()
+        {
+            return Commit();
+        }
+
+        static void rollback()
+        {
+            Rollback();
+        }
+
+        struct meta_type :
+            details::prepared_write_through_meta_type,
+            details::valid_characteristic_option_meta_type {};
+        /** @endcond */
+    };
+
+    namespace details {
+        struct no_prepared_write_through {
+            static constexpr bool enabled = false;
+
+            static std::uint8_t commit()
+            {
+                return error_codes::request_not_supported;
+            }
+
+            static void rollback()
+            {
+            }
+
+            struct meta_type :
+                details::prepared_write_through_meta_type,
+                details::valid_characteristic_option_meta_type {};
+        };
+    }
+
     namespace details {
         template < bool RequiresEncryption >
         struct encryption_requirements;
@@ -248,6 +336,10 @@ namespace bluetoe {
 
     /**
      * @brief a very simple device to bind a characteristic to a global variable to provide access to the characteristic value
+     *
+     * If the variable is updated from a different context than the server runs in, bind a seqlock_value<> instead.
+     *
+     * @sa seqlock_value
      */
     template < typename T, T* Ptr >
     class bind_characteristic_value
@@ -336,6 +428,96 @@ namespace bluetoe {
         /** @endcond */
     };
 
+    /**
+     * @brief binds a characteristic to a seqlock_value<>, so that the value can not be observed torn
+     *
+     * Reads and notifications use a consistent snapshot of the value. Writes from a client are applied
+     * through seqlock_value::write().
+     *
+     * @sa seqlock_value
+     */
+    template < typename T, seqlock_value< T >* Ptr >
+    class bind_characteristic_value< seqlock_value< T >, Ptr >
+    {
+    public:
+        /** @cond HIDDEN_SYMBOLS */
+        template < typename ... Options >
+        class value_impl : public details::value_impl_base< Options... >
+        {
+        public:
+            static constexpr bool has_read_access  = !details::has_option< no_read_access, Options... >::value;
+            static constexpr bool has_write_access = !details::has_option< no_write_access, Options... >::value;
+            static constexpr bool has_write_without_response = details::has_option< write_without_response, Options... >::value;
+            static constexpr bool has_notification = details::has_option< notify, Options... >::value;
+            static constexpr bool has_indication   = details::has_option< indicate, Options... >::value;
+
+            template < class Server, std::size_t ClientCharacteristicIndex, bool RequiresEncryption >
+            static details::attribute_access_result characteristic_value_access( details::attribute_access_arguments& args, std::size_t )
+            {
+                const auto security_result = details::encryption_requirements< RequiresEncryption >::check( args.connection_security );
+
+                if ( security_result != details::attribute_access_result::success )
+                    return security_result;
+
+                if ( args.type == details::attribute_access_type::read )
+                {
+                    return characteristic_value_read_access( args, std::integral_constant< bool, has_read_access >() );
+                }
+                else if ( args.type == details::attribute_access_type::write )
+                {
+                    return characteristic_value_write_access( args, std::integral_constant< bool, has_write_access >() );
+                }
+
+                return details::attribute_access_result::write_not_permitted;
+            }
+
+            static constexpr bool is_this( const void* value )
+            {
+                return value == Ptr;
+            }
+
+        private:
+            static constexpr std::size_t size = seqlock_value< T >::size;
+
+            static details::attribute_access_result characteristic_value_read_access( details::attribute_access_arguments& args, const std::true_type& )
+            {
+                std::uint8_t snapshot[ size ];
+                Ptr->snapshot( snapshot );
+
+                return details::attribute_value_read_access( args, snapshot, size );
+            }
+
+            static constexpr details::attribute_access_result characteristic_value_read_access( details::attribute_access_arguments&, const std::false_type& )
+            {
+                return details::attribute_access_result::read_not_permitted;
+            }
+
+            static details::attribute_access_result characteristic_value_write_access( details::attribute_access_arguments& args, const std::true_type& )
+            {
+                if ( args.buffer_offset > size )
+                    return details::attribute_access_result::invalid_offset;
+
+                if ( args.buffer_size + args.buffer_offset > size )
+                    return details::attribute_access_result::invalid_attribute_value_length;
+
+                Ptr->write( args.buffer_offset, args.buffer, args.buffer_size );
+
+                return details::attribute_access_result::success;
+            }
+
+            static constexpr details::attribute_access_result characteristic_value_write_access( details::attribute_access_arguments&, const std::false_type& )
+            {
+                return details::attribute_access_result::write_not_permitted;
+            }
+        };
+
+        struct meta_type :
+            details::characteristic_value_meta_type,
+            details::characteristic_value_declaration_parameter,
+            details::valid_characteristic_option_meta_type {};
+        /** @endcond */
+    };
+
     /**
      * @brief provides a characteristic with a fixed, read-only value
      *
@@ -559,14 +741,44 @@ namespace bluetoe {
             }
         };
 
+        template < class T >
+        struct invoke_write_command_burst_handler {
+            static constexpr bool enabled = T::has_write_command_burst;
+
+            static std::uint8_t call_write_command_burst_handler( const write_command_view* writes, std::size_t count )
+            {
+                return T::call_write_command_burst_handler( writes, count );
+            }
+        };
+
+        template <>
+        struct invoke_write_command_burst_handler< no_such_type > {
+            static constexpr bool enabled = false;
+
+            static std::uint8_t call_write_command_burst_handler( const write_command_view*, std::size_t )
+            {
+                return error_codes::write_not_permitted;
+            }
+        };
+
         struct value_handler_base {
 
+            // handlers, that can receive bursts of write commands, hide these defaults
+            static constexpr bool has_write_command_burst = false;
+
+            static std::uint8_t call_write_command_burst_handler( const write_command_view*, std::size_t )
+            {
+                return error_codes::write_not_permitted;
+            }
+
             template < typename ... Options >
             class value_impl : public details::value_impl_base< Options... >
             {
             public:
                 using read_handler_type = typename find_by_meta_type< characteristic_value_read_handler_meta_type, Options... >::type;
                 using write_handler_type = typename find_by_meta_type< characteristic_value_write_handler_meta_type, Options... >::type;
+                using write_through_type = typename find_by_meta_type< prepared_write_through_meta_type, Options..., no_prepared_write_through >::type;
+                using write_burst_type = invoke_write_command_burst_handler< write_handler_type >;
                 static constexpr bool no_read          = has_option< no_read_access, Options... >::value;
                 static constexpr bool no_write         = has_option< no_write_access, Options... >::value;
 
@@ -584,6 +796,9 @@ namespace bluetoe {
 
                 static_assert( has_read_access || has_write_access || has_notification || has_indication, "Ups!");
 
+                static_assert( !write_through_type::enabled || has_write_access, "prepared_write_through<> requires a write handler" );
+                static_assert( !( write_through_type::enabled && write_burst_type::enabled ), "prepared_write_through<> can not be combined with a free_write_command_burst_handler<>" );
+
                 template < class Server, std::size_t ClientCharacteristicIndex, bool RequiresEncryption >
                 static attribute_access_result characteristic_value_access( attribute_access_arguments& args, std::size_t /* attribute_index */ )
                 {
@@ -602,6 +817,29 @@ namespace bluetoe {
                         return static_cast< attribute_access_result >(
                             invoke_write_handler< write_handler_type >::template call_write_handler< Server, ClientCharacteristicIndex >( args.buffer_offset, args.buffer_size, args.buffer, args.client_config, args.server ) );
                     }
+                    else if ( args.type == attribute_access_type::query_write_through && write_through_type::enabled )
+                    {
+                        return attribute_access_result::write_through;
+                    }
+                    else if ( args.type == attribute_access_type::commit_write )
+                    {
+                        return static_cast< attribute_access_result >( write_through_type::commit() );
+                    }
+                    else if ( args.type == attribute_access_type::rollback_write )
+                    {
+                        write_through_type::rollback();
+
+                        return attribute_access_result::success;
+                    }
+                    else if ( args.type == attribute_access_type::query_write_command_burst && write_burst_type::enabled )
+                    {
+                        return attribute_access_result::write_command_burst;
+                    }
+                    else if ( args.type == attribute_access_type::write_command_burst )
+                    {
+                        return static_cast< attribute_access_result >( write_burst_type::call_write_command_burst_handler(
+                            static_cast< const write_command_view* >( static_cast< const void* >( args.buffer ) ), args.buffer_size ) );
+                    }
                     else
                     {
                         return attribute_access_result::request_not_supported;
@@ -826,6 +1064,77 @@ namespace bluetoe {
         /** @endcond */
     };
 
+    /**
+     * @brief binds a free function as a write handler, that receives "Write Command"s in bursts
+     *
+     * Centrals, that stream data to a peripheral, often send many "Write Command"s (Write Without Response) to the same
+     * characteristic within one connection event. With this handler, the write commands to the characteristic, that arrive
+     * within one connection event, are collected and passed to F in a single call at the end of the connection event. The
+     * access permissions are checked only for the first write command of a burst.
+     *
+     * A burst ends early, if a write command to an other characteristic or any other request arrives, or if the
+     * buffer that collects the write commands overflows. The size of that buffer is defined per connection by the
+     * server option write_command_burst_buffer. Without that option, every write command is passed to F on its own.
+     *
+     * A "Write Request" is passed to F as a burst of a single write. As the handler can not cope with offsets,
+     * the characteristic value can not be written with a prepared write.
+     *
+     * @tparam F pointer to function to handle a burst of writes
+     *
+     * @param writes the written values in the order they were received
+     * @param count the number of written values, at least one.
+     *
+     * @retval If the values could be written successfully, the function should return bluetoe::error_codes::success.
+     *         The result is used as response to a "Write Request" and ignored for "Write Command"s.
+     *
+     * Example:
+     * @code
+        std::uint8_t log_samples( const bluetoe::write_command_view* writes, std::size_t count );
+
+        typedef bluetoe::server<
+            bluetoe::write_command_burst_buffer< 512, 32 >,
+            bluetoe::service<
+                bluetoe::service_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CA9 >,
+                bluetoe::characteristic<
+                    bluetoe::characteristic_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CAA >,
+                    bluetoe::free_write_command_burst_handler< &log_samples >,
+                    bluetoe::only_write_without_response
+                >
+            >
+        > logging_server;
+     * @endcode
+     *
+     * @sa characteristic
+     * @sa write_command_burst_buffer
+     * @sa write_command_view
+     * @sa free_raw_write_handler
+     */
+    template < std::uint8_t (*F)( const write_command_view* writes, std::size_t count ) >
+    struct free_write_command_burst_handler : details::value_handler_base
+    {
+        /** @cond HIDDEN_SYMBOLS */
+        template < class Server, std::size_t ClientCharacteristicIndex >
+        static std::uint8_t call_write_handler( std::size_t offset, std::size_t write_size, const std::uint8_t* value, const details::client_characteristic_configuration& , void* )
+        {
+            if ( offset != 0 )
+                return static_cast< std::uint8_t >( error_codes::attribute_not_long );
+
+            const write_command_view write = { value, write_size };
+
+            return F( &write, 1 );
+        }
+
+        static constexpr bool has_write_command_burst = true;
+
+        static std::uint8_t call_write_command_burst_handler( const write_command_view* writes, std::size_t count )
+        {
+            return F( writes, count );
+        }
+
+        struct meta_type : details::value_handler_base::meta_type, details::characteristic_value_write_handler_meta_type {};
+        /** @endcond */
+    };
+
     template < class Obj, Obj& O, std::uint8_t (Obj::*F)( std::size_t offset, std::size_t read_size, std::uint8_t* out_buffer, std::size_t& out_size ) >
     struct read_blob_handler : details::value_handler_base
     {
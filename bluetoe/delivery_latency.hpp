@@ -0,0 +1,98 @@
+#ifndef BLUETOE_DELIVERY_LATENCY_HPP
+#define BLUETOE_DELIVERY_LATENCY_HPP
+
+#include <bluetoe/meta_tools.hpp>
+#include <bluetoe/meta_types.hpp>
+
+#include <cstdint>
+
+namespace bluetoe {
+
+    namespace details {
+        struct delivery_latency_meta_type {};
+    }
+
+    /**
+     * @brief defines the maximum time, a notification or indication of a characteristic may be
+     *        delayed by peripheral latency.
+     *
+     * By default, every queued notification or indication makes a link layer that is configured to
+     * listen_if_pending_transmit_data, wake up at the very next connection event. With this option,
+     * the link layer is allowed to keep on skipping connection events for the characteristic, as long
+     * as the notification or indication is sent within the given number of milliseconds after the
+     * last connection event. If there are notifications of different characteristics pending, the
+     * earliest deadline is honored.
+     *
+     * As outgoing notifications are moved into the link layer at the end of a connection event,
+     * the latency should be at least two connection intervals long to be met.
+     *
+     * Example
+     * @code
+    std::uint8_t temperature = 0;
+    bool alarm = false;
+
+    using server = bluetoe::server<
+        bluetoe::service<
+            service_uuid,
+            // telemetry: may be delayed by up to 2 seconds
+            bluetoe::characteristic<
+                temperature_uuid,
+                bluetoe::bind_characteristic_value< decltype( temperature ), &temperature >,
+                bluetoe::notify,
+                bluetoe::maximum_delivery_latency< 2000 >
+            >,
+            // alarm: wakes up the link layer at the next connection event
+            bluetoe::characteristic<
+                alarm_uuid,
+                bluetoe::bind_characteristic_value< decltype( alarm ), &alarm >,
+                bluetoe::notify
+            >
+        >
+    >;
+     * @endcode
+     *
+     * @note this option has only an effect, when the link layer uses peripheral latency.
+     *
+     * @sa characteristic
+     * @sa link_layer::peripheral_latency::listen_if_pending_transmit_data
+     */
+    template < std::uint32_t Milliseconds >
+    struct maximum_delivery_latency
+    {
+        static_assert( Milliseconds > 0, "a maximum delivery latency of 0ms can not be met" );
+
+        /** @cond HIDDEN_SYMBOLS */
+        static constexpr std::uint32_t milliseconds = Milliseconds;
+
+        struct meta_type :
+            details::delivery_latency_meta_type,
+            details::valid_characteristic_option_meta_type {};
+        /** @endcond */
+    };
+
+    namespace details {
+        /*
+         * default for characteristics without maximum_delivery_latency<>
+         */
+        struct unbounded_delivery_latency
+        {
+            static constexpr std::uint32_t milliseconds = 0;
+
+            struct meta_type :
+                details::delivery_latency_meta_type,
+                details::valid_characteristic_option_meta_type {};
+        };
+
+        template < typename ... Options >
+        struct delivery_latency
+        {
+            static_assert( std::tuple_size< typename find_all_by_meta_type< delivery_latency_meta_type, Options... >::type >::value <= 1,
+                "Only one maximum_delivery_latency<> per characteristic allowed!" );
+
+            static constexpr std::uint32_t milliseconds =
+                find_by_meta_type< delivery_latency_meta_type, Options..., unbounded_delivery_latency >::type::milliseconds;
+        };
+    }
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define BLUETOE_FIND_NOTIFICATION_DATA_HPP
 
 #include <bluetoe/meta_tools.hpp>
+#include <bluetoe/notification_rate_limit.hpp>
 
 namespace bluetoe {
 namespace details {
@@ -113,6 +114,98 @@ namespace details {
             >::type;
         };
 
+        template < class Characteristic >
+        struct has_bounded_delivery_latency
+        {
+            static constexpr bool value = Characteristic::characteristic_t::maximum_delivery_latency_ms != 0;
+        };
+
+        struct delivery_latency_at
+        {
+            constexpr delivery_latency_at( std::uint32_t& r, std::size_t i )
+                : result( r )
+                , index( i )
+            {}
+
+            template< typename O >
+            void each()
+            {
+                if ( O::first_attribute_index + 1 == index )
+                    result = O::characteristic_t::maximum_delivery_latency_ms;
+            }
+
+            std::uint32_t&  result;
+            std::size_t     index;
+        };
+
+        template < class Characteristic >
+        struct suppresses_unchanged_notifications
+        {
+            static constexpr bool value = Characteristic::characteristic_t::suppresses_unchanged_notifications;
+        };
+
+        struct notification_digest_at
+        {
+            constexpr notification_digest_at( std::size_t& r, std::size_t i )
+                : result( r )
+                , index( i )
+                , digest( 0 )
+            {}
+
+            template< typename O >
+            void each()
+            {
+                if ( O::characteristic_t::suppresses_unchanged_notifications )
+                {
+                    if ( O::first_attribute_index + 1 == index )
+                        result = digest;
+
+                    ++digest;
+                }
+            }
+
+            std::size_t&    result;
+            std::size_t     index;
+            std::size_t     digest;
+        };
+
+        template < class Characteristic >
+        struct has_notification_rate_limit
+        {
+            static constexpr bool value =
+                Characteristic::characteristic_t::notification_minimum_interval_ms != 0
+             || Characteristic::characteristic_t::notification_coalescing_window_ms != 0;
+        };
+
+        struct notification_rate_limit_at
+        {
+            constexpr notification_rate_limit_at( notification_rate_limit_data& r, std::size_t i )
+                : result( r )
+                , index( i )
+                , slot( 0 )
+            {}
+
+            template< typename O >
+            void each()
+            {
+                if ( has_notification_rate_limit< O >::value )
+                {
+                    if ( O::first_attribute_index + 1 == index )
+                    {
+                        result.slot                 = slot;
+                        result.minimum_interval_ms  = O::characteristic_t::notification_minimum_interval_ms;
+                        result.coalescing_window_ms = O::characteristic_t::notification_coalescing_window_ms;
+                    }
+
+                    ++slot;
+                }
+            }
+
+            notification_rate_limit_data&   result;
+            std::size_t                     index;
+            std::size_t                     slot;
+        };
+
         template < class Characteristic >
         struct select_cccd_position {
             using type = std::integral_constant< std::size_t, Characteristic::cccd_position >;
@@ -195,6 +288,47 @@ namespace details {
         }
 
         using cccd_indices = typename transform_list< characteristics_with_cccd_handle, impl::select_cccd_position >::type;
+
+        static constexpr bool has_delivery_latencies = count_if< characteristics_only_with_cccd, impl::has_bounded_delivery_latency >::value != 0;
+
+        /*
+         * maximum delivery latency in ms of the characteristic with the given value attribute index; 0 for unbounded
+         */
+        static std::uint32_t delivery_latency_by_attribute_index( std::size_t attribute_index )
+        {
+            std::uint32_t result = 0;
+            for_< characteristics_only_with_cccd >::each( impl::delivery_latency_at( result, attribute_index ) );
+
+            return result;
+        }
+
+        static constexpr std::size_t number_of_notification_digests = count_if< characteristics_only_with_cccd, impl::suppresses_unchanged_notifications >::value;
+
+        /*
+         * index of the notification digest of the characteristic with the given value attribute index;
+         * number_of_notification_digests, if the characteristic does not suppress unchanged notifications
+         */
+        static std::size_t notification_digest_by_attribute_index( std::size_t attribute_index )
+        {
+            std::size_t result = number_of_notification_digests;
+            for_< characteristics_only_with_cccd >::each( impl::notification_digest_at( result, attribute_index ) );
+
+            return result;
+        }
+
+        static constexpr std::size_t number_of_notification_rate_limits = count_if< characteristics_only_with_cccd, impl::has_notification_rate_limit >::value;
+
+        /*
+         * rate limit of the characteristic with the given value attribute index; the slot is
+         * number_of_notification_rate_limits, if the characteristic has no notification_rate_limit<>
+         */
+        static notification_rate_limit_data notification_rate_limit_by_attribute_index( std::size_t attribute_index )
+        {
+            notification_rate_limit_data result = { number_of_notification_rate_limits, 0, 0 };
+            for_< characteristics_only_with_cccd >::each( impl::notification_rate_limit_at( result, attribute_index ) );
+
+            return result;
+        }
     };
 
     template <
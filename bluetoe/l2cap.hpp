@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <cstddef>
 #include <cassert>
+#include <utility>
 
 #include <bluetoe/codes.hpp>
 #include <bluetoe/meta_tools.hpp>
@@ -25,6 +26,44 @@ namespace details {
     /**
      * @brief this class documents the requirements of a single l2cap channel to satisfy
      *        the requirements of the l2cap<> class.
+     *
+     * Optional, a channel can provide a function `void l2cap_idle()`, that is called by the
+     * link layer, when there is time to do some work in the background. Currently, this is only
+     * the case between two advertising events and not while the link layer is connected.
+     *
+     * Optional, a channel can provide a function `template < typename ConnectionData > void l2cap_input_flush( ConnectionData& )`,
+     * that is called by the link layer at the end of every connection event, after all SDUs received in that
+     * connection event were passed to the channel. A channel can use this, to process input in batches.
+     *
+     * Optional, a channel can receive fragmented SDUs as a stream of fragments, instead of
+     * receiving the defragmented SDU by a call to l2cap_input(). This saves the copy of the SDU
+     * into the defragmentation buffer of the link layer:
+     *
+     * - template < typename ConnectionData >
+     *   bool l2cap_input_stream_start( const std::uint8_t* input, std::size_t in_size, std::size_t sdu_size, ConnectionData& )
+     *
+     *   Called with the first fragment of an SDU of sdu_size bytes. The first fragment contains
+     *   at least the first byte of the SDU, so the channel can peek into the header of the SDU. If
+     *   the function returns false, the SDU will be defragmented and passed to l2cap_input().
+     *   Otherwise, the channel consumed the first fragment and all remaining fragments of the SDU
+     *   are passed to l2cap_input_stream().
+     *
+     * - template < typename ConnectionData >
+     *   void l2cap_input_stream( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& )
+     *
+     *   Called with every following fragment of the SDU. Only the call with the last fragment
+     *   passes an output buffer, that can be used to respond to the SDU, just like with
+     *   l2cap_input(). For all other fragments, output is nullptr and out_size is 0.
+     *
+     * A channel has to expect, that a stream is never completed (because of a disconnect for
+     * example) and that the next SDU starts, without the previous stream being completed.
+     *
+     * Optional, a channel can define `static constexpr std::uint16_t output_deadline`. Outgoing
+     * SDUs are collected from the channels earliest deadline first: once a channel was asked for
+     * output, it should be asked again, before more than output_deadline SDUs of other channels
+     * were sent. Without this constant, a channel has a deadline of default_l2cap_output_deadline
+     * SDUs. Channels that reach their deadlines at the same time, are asked in the order of the
+     * l2cap<> channel list.
      */
     class l2cap_channel
     {
@@ -73,6 +112,103 @@ namespace details {
 
     static constexpr std::size_t l2cap_layer_header_size = 4u;
 
+    /**
+     * @brief output deadline of a channel, that does not define output_deadline
+     */
+    static constexpr std::uint16_t default_l2cap_output_deadline = 4u;
+
+    template < typename TT >
+    constexpr auto l2cap_output_deadline( int ) -> decltype( TT::output_deadline, std::uint16_t() )
+    {
+        return TT::output_deadline;
+    }
+
+    template < typename TT >
+    constexpr std::uint16_t l2cap_output_deadline( long )
+    {
+        return default_l2cap_output_deadline;
+    }
+
+    template < typename TT >
+    auto call_l2cap_idle( TT& obj ) -> decltype(&TT::l2cap_idle)
+    {
+        obj.l2cap_idle();
+
+        return nullptr;
+    }
+
+    template < typename TT >
+    void call_l2cap_idle( ... )
+    {
+    }
+
+    template < typename TT, typename ConnectionData >
+    auto call_l2cap_input_flush( TT& obj, ConnectionData& connection, int )
+        -> decltype( obj.l2cap_input_flush( connection ) )
+    {
+        return obj.l2cap_input_flush( connection );
+    }
+
+    template < typename TT, typename ConnectionData >
+    void call_l2cap_input_flush( TT&, ConnectionData&, long )
+    {
+    }
+
+    template < typename TT, typename ConnectionData >
+    auto call_l2cap_input_stream_start( TT& obj, const std::uint8_t* input, std::size_t in_size, std::size_t sdu_size, ConnectionData& connection, int )
+        -> decltype( obj.l2cap_input_stream_start( input, in_size, sdu_size, connection ) )
+    {
+        return obj.l2cap_input_stream_start( input, in_size, sdu_size, connection );
+    }
+
+    template < typename TT, typename ConnectionData >
+    bool call_l2cap_input_stream_start( TT&, const std::uint8_t*, std::size_t, std::size_t, ConnectionData&, long )
+    {
+        return false;
+    }
+
+    template < typename TT, typename ConnectionData >
+    auto call_l2cap_input_stream( TT& obj, const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& connection, int )
+        -> decltype( obj.l2cap_input_stream( input, in_size, output, out_size, connection ) )
+    {
+        return obj.l2cap_input_stream( input, in_size, output, out_size, connection );
+    }
+
+    template < typename TT, typename ConnectionData >
+    void call_l2cap_input_stream( TT&, const std::uint8_t*, std::size_t, std::uint8_t*, std::size_t& out_size, ConnectionData&, long )
+    {
+        out_size = 0;
+    }
+
+    /*
+     * used by the link layer, to support custom l2cap layers, that do not implement streaming
+     */
+    template < typename TT, typename ConnectionDetails >
+    auto call_handle_l2cap_stream_start( TT& obj, const std::uint8_t* input, std::size_t in_size, ConnectionDetails& connection, int )
+        -> decltype( obj.handle_l2cap_stream_start( input, in_size, connection ) )
+    {
+        return obj.handle_l2cap_stream_start( input, in_size, connection );
+    }
+
+    template < typename TT, typename ConnectionDetails >
+    bool call_handle_l2cap_stream_start( TT&, const std::uint8_t*, std::size_t, ConnectionDetails&, long )
+    {
+        return false;
+    }
+
+    template < typename TT, typename ConnectionDetails >
+    auto call_handle_l2cap_stream( TT& obj, const std::uint8_t* input, std::size_t in_size, bool last, ConnectionDetails& connection, int )
+        -> decltype( obj.handle_l2cap_stream( input, in_size, last, connection ) )
+    {
+        return obj.handle_l2cap_stream( input, in_size, last, connection );
+    }
+
+    template < typename TT, typename ConnectionDetails >
+    bool call_handle_l2cap_stream( TT&, const std::uint8_t*, std::size_t, bool, ConnectionDetails&, long )
+    {
+        return true;
+    }
+
     /**
      * @brief l2cap layer, as list of l2cap channels
      *
@@ -97,19 +233,60 @@ namespace details {
     class l2cap : public derive_from< std::tuple< Channels... > >
     {
     public:
+        l2cap();
+
         /**
          * @ret true, if the passed input was consumed
          */
         template < class ConnectionDetails >
         bool handle_l2cap_input( const std::uint8_t* input, std::size_t in_size, ConnectionDetails& connection );
 
+        /**
+         * @brief offers the first fragment of a fragmented SDU (including the L2CAP header) to the addressed channel
+         *
+         * @ret true, if the channel consumed the fragment and wants to receive the remaining fragments
+         *      by calls to handle_l2cap_stream().
+         */
+        template < class ConnectionDetails >
+        bool handle_l2cap_stream_start( const std::uint8_t* input, std::size_t in_size, ConnectionDetails& connection );
+
+        /**
+         * @brief passes the next fragment of a streamed SDU to the channel, that accepted the first fragment
+         *
+         * @ret true, if the passed input was consumed. If last is true, and there is no
+         *      buffer for the response, the input is not consumed.
+         */
+        template < class ConnectionDetails >
+        bool handle_l2cap_stream( const std::uint8_t* input, std::size_t in_size, bool last, ConnectionDetails& connection );
+
         /**
          * @brief function to be called one every connection event, from the link layer
          *        to collect outstanding responses.
+         *
+         * The channels are asked for output earliest deadline first.
+         *
+         * @sa l2cap_channel
          */
         template < class ConnectionDetails >
         void transmit_pending_l2cap_output( ConnectionDetails& connection );
 
+        /**
+         * @brief function to be called from the link layer, when there is time to do
+         *        some work in the background.
+         *
+         * Forwarded to all channels that implement l2cap_idle().
+         */
+        void l2cap_idle();
+
+        /**
+         * @brief function to be called once every connection event from the link layer, after all
+         *        received SDUs were passed to handle_l2cap_input().
+         *
+         * Forwarded to all channels that implement l2cap_input_flush().
+         */
+        template < class ConnectionDetails >
+        void l2cap_input_flush( ConnectionDetails& connection );
+
         /**
          * @brief the minimum MTU size, that is required by all L2CAP channels
          *
@@ -139,6 +316,12 @@ namespace details {
         template < class ConnectionDetails >
         bool transmit_single_pending_l2cap_output( ConnectionDetails& connection );
 
+        void commit_l2cap_output( std::pair< std::size_t, std::uint8_t* > output, std::size_t out_size, std::uint16_t channel_id );
+
+        static std::uint16_t output_deadline( std::size_t channel );
+
+        std::size_t next_output_channel( const bool* offered ) const;
+
         template < class ConnectionDetails >
         struct l2cap_input_handler
         {
@@ -174,6 +357,66 @@ namespace details {
             bool                        handled;
         };
 
+        template < class ConnectionDetails >
+        struct l2cap_stream_start_handler
+        {
+            l2cap_stream_start_handler( l2cap* t, std::uint16_t ci, const std::uint8_t* i, std::size_t is, std::size_t ss, ConnectionDetails& c )
+                : that( t )
+                , channel_id( ci )
+                , input( i )
+                , in_size( is )
+                , sdu_size( ss )
+                , connection( c )
+                , accepted( false )
+            {
+            }
+
+            template< typename Channel >
+            void each()
+            {
+                if ( channel_id == Channel::channel_id )
+                    accepted = call_l2cap_input_stream_start( static_cast< Channel& >( *that ), input, in_size, sdu_size, connection, 0 );
+            }
+
+            l2cap*                      that;
+            std::uint16_t               channel_id;
+            const std::uint8_t*         input;
+            std::size_t                 in_size;
+            std::size_t                 sdu_size;
+            ConnectionDetails&          connection;
+            bool                        accepted;
+        };
+
+        template < class ConnectionDetails >
+        struct l2cap_stream_handler
+        {
+            l2cap_stream_handler( l2cap* t, std::uint16_t ci, const std::uint8_t* i, std::size_t is, std::uint8_t* o, std::size_t os, ConnectionDetails& c )
+                : that( t )
+                , channel_id( ci )
+                , input( i )
+                , in_size( is )
+                , output( o )
+                , out_size( os )
+                , connection( c )
+            {
+            }
+
+            template< typename Channel >
+            void each()
+            {
+                if ( channel_id == Channel::channel_id )
+                    call_l2cap_input_stream( static_cast< Channel& >( *that ), input, in_size, output, out_size, connection, 0 );
+            }
+
+            l2cap*                      that;
+            std::uint16_t               channel_id;
+            const std::uint8_t*         input;
+            std::size_t                 in_size;
+            std::uint8_t*               output;
+            std::size_t                 out_size;
+            ConnectionDetails&          connection;
+        };
+
         template < typename ConnectionDetails >
         class l2cap_output_handler
         {
@@ -184,13 +427,21 @@ namespace details {
                 , size( s )
                 , out_size( 0 )
                 , connection( c )
+                , selected( 0 )
+                , position( 0 )
+            {
+            }
+
+            void select( std::size_t channel )
             {
+                selected = channel;
+                position = 0;
             }
 
             template< typename Channel >
             void each()
             {
-                if ( out_size == 0 )
+                if ( position++ == selected )
                 {
                     out_size = size;
                     static_cast< Channel& >( *that ).l2cap_output( output, out_size, connection );
@@ -204,16 +455,68 @@ namespace details {
             std::size_t         out_size;
             std::uint16_t       channel_id;
             ConnectionDetails&  connection;
+            std::size_t         selected;
+            std::size_t         position;
+        };
+
+        template < class ConnectionDetails >
+        struct l2cap_input_flush_handler
+        {
+            l2cap_input_flush_handler( l2cap* t, ConnectionDetails& c )
+                : that( t )
+                , connection( c )
+            {
+            }
+
+            template< typename Channel >
+            void each()
+            {
+                call_l2cap_input_flush( static_cast< Channel& >( *that ), connection, 0 );
+            }
+
+            l2cap*              that;
+            ConnectionDetails&  connection;
+        };
+
+        struct l2cap_idle_handler
+        {
+            explicit l2cap_idle_handler( l2cap* t )
+                : that( t )
+            {
+            }
+
+            template< typename Channel >
+            void each()
+            {
+                call_l2cap_idle< Channel >( static_cast< Channel& >( *that ) );
+            }
+
+            l2cap*  that;
         };
 
         LinkLayer& link_layer()
         {
             return static_cast< LinkLayer&>( *this );
         }
+
+        // channel, that accepted the currently streamed SDU
+        std::uint16_t stream_channel_id_;
+
+        // number of SDUs sent and the value of output_time_, when a channel was asked for output the last time
+        std::uint16_t output_time_;
+        std::uint16_t output_offered_[ sizeof...( Channels ) ];
     };
 
 
     // implemenation
+    template < class LinkLayer, class ChannelData, class ... Channels >
+    l2cap< LinkLayer, ChannelData, Channels... >::l2cap()
+        : stream_channel_id_( 0 )
+        , output_time_( 0 )
+        , output_offered_()
+    {
+    }
+
     template < class LinkLayer, class ChannelData, class ... Channels >
     template < class ConnectionDetails >
     bool l2cap< LinkLayer, ChannelData, Channels... >::handle_l2cap_input( const std::uint8_t* input, std::size_t in_size, ConnectionDetails& connection )
@@ -240,13 +543,63 @@ namespace details {
 
         for_< Channels... >::template each< l2cap_input_handler< ConnectionDetails >& >( handler );
 
-        if ( handler.handled && handler.out_size )
+        if ( handler.handled )
+            commit_l2cap_output( output, handler.out_size, channel_id );
+
+        return true;
+    }
+
+    template < class LinkLayer, class ChannelData, class ... Channels >
+    template < class ConnectionDetails >
+    bool l2cap< LinkLayer, ChannelData, Channels... >::handle_l2cap_stream_start( const std::uint8_t* input, std::size_t in_size, ConnectionDetails& connection )
+    {
+        // the channel should at least be able to peek at the first byte of the SDU
+        if ( in_size <= l2cap_layer_header_size )
+            return false;
+
+        const std::uint16_t size       = read_16bit( input );
+        const std::uint16_t channel_id = read_16bit( input + 2 );
+
+        if ( in_size >= size + l2cap_layer_header_size )
+            return false;
+
+        l2cap_stream_start_handler< ConnectionDetails > handler(
+            this, channel_id, input + l2cap_layer_header_size, in_size - l2cap_layer_header_size, size, connection );
+
+        for_< Channels... >::template each< l2cap_stream_start_handler< ConnectionDetails >& >( handler );
+
+        if ( handler.accepted )
+            stream_channel_id_ = channel_id;
+
+        return handler.accepted;
+    }
+
+    template < class LinkLayer, class ChannelData, class ... Channels >
+    template < class ConnectionDetails >
+    bool l2cap< LinkLayer, ChannelData, Channels... >::handle_l2cap_stream( const std::uint8_t* input, std::size_t in_size, bool last, ConnectionDetails& connection )
+    {
+        if ( !last )
         {
-            write_16bit( output.second,  handler.out_size );
-            write_16bit( output.second + 2, channel_id );
-            link_layer().commit_l2cap_output_buffer( {  handler.out_size + l2cap_layer_header_size, output.second } );
+            l2cap_stream_handler< ConnectionDetails > handler( this, stream_channel_id_, input, in_size, nullptr, 0, connection );
+            for_< Channels... >::template each< l2cap_stream_handler< ConnectionDetails >& >( handler );
+
+            return true;
         }
 
+        auto output = link_layer().allocate_l2cap_output_buffer( maximum_mtu_size );
+        if ( output.first == 0 )
+            return false;
+
+        assert( output.second );
+
+        l2cap_stream_handler< ConnectionDetails > handler(
+            this, stream_channel_id_, input, in_size,
+            output.second + l2cap_layer_header_size, maximum_mtu_size, connection );
+
+        for_< Channels... >::template each< l2cap_stream_handler< ConnectionDetails >& >( handler );
+
+        commit_l2cap_output( output, handler.out_size, stream_channel_id_ );
+
         return true;
     }
 
@@ -272,16 +625,83 @@ namespace details {
         l2cap_output_handler< ConnectionDetails > handler(
             this, output.second + l2cap_layer_header_size, output.first - l2cap_layer_header_size, connection );
 
-        for_< Channels... >::template each< l2cap_output_handler< ConnectionDetails >& >( handler );
+        bool offered[ sizeof...( Channels ) ] = {};
 
-        if ( handler.out_size )
+        for ( std::size_t offer = 0; offer != sizeof...( Channels ) && handler.out_size == 0; ++offer )
         {
-            write_16bit( output.second, handler.out_size );
-            write_16bit( output.second + 2, handler.channel_id );
-            link_layer().commit_l2cap_output_buffer( { handler.out_size + l2cap_layer_header_size, output.second } );
+            const std::size_t channel = next_output_channel( offered );
+
+            handler.select( channel );
+            for_< Channels... >::template each< l2cap_output_handler< ConnectionDetails >& >( handler );
+
+            offered[ channel ]         = true;
+            output_offered_[ channel ] = output_time_;
         }
 
-        return handler.out_size;
+        if ( handler.out_size == 0 )
+            return false;
+
+        ++output_time_;
+        commit_l2cap_output( output, handler.out_size, handler.channel_id );
+
+        return true;
+    }
+
+    template < class LinkLayer, class ChannelData, class ... Channels >
+    std::uint16_t l2cap< LinkLayer, ChannelData, Channels... >::output_deadline( std::size_t channel )
+    {
+        static constexpr std::uint16_t deadlines[] = { l2cap_output_deadline< Channels >( 0 )... };
+
+        return deadlines[ channel ];
+    }
+
+    template < class LinkLayer, class ChannelData, class ... Channels >
+    std::size_t l2cap< LinkLayer, ChannelData, Channels... >::next_output_channel( const bool* offered ) const
+    {
+        std::size_t   result = sizeof...( Channels );
+        std::int16_t  result_slack = 0;
+
+        for ( std::size_t channel = 0; channel != sizeof...( Channels ); ++channel )
+        {
+            // number of SDUs of other channels, that can still be sent before the channel has to be asked
+            // again; negative, if the deadline was missed
+            const std::int16_t slack = static_cast< std::int16_t >(
+                static_cast< std::uint16_t >( output_offered_[ channel ] + output_deadline( channel ) + 1 - output_time_ ) );
+
+            if ( !offered[ channel ] && ( result == sizeof...( Channels ) || slack < result_slack ) )
+            {
+                result       = channel;
+                result_slack = slack;
+            }
+        }
+
+        return result;
+    }
+
+    template < class LinkLayer, class ChannelData, class ... Channels >
+    void l2cap< LinkLayer, ChannelData, Channels... >::commit_l2cap_output( std::pair< std::size_t, std::uint8_t* > output, std::size_t out_size, std::uint16_t channel_id )
+    {
+        if ( out_size == 0 )
+            return;
+
+        write_16bit( output.second, out_size );
+        write_16bit( output.second + 2, channel_id );
+        link_layer().commit_l2cap_output_buffer( { out_size + l2cap_layer_header_size, output.second } );
+    }
+
+    template < class LinkLayer, class ChannelData, class ... Channels >
+    void l2cap< LinkLayer, ChannelData, Channels... >::l2cap_idle()
+    {
+        l2cap_idle_handler handler( this );
+        for_< Channels... >::template each< l2cap_idle_handler& >( handler );
+    }
+
+    template < class LinkLayer, class ChannelData, class ... Channels >
+    template < class ConnectionDetails >
+    void l2cap< LinkLayer, ChannelData, Channels... >::l2cap_input_flush( ConnectionDetails& connection )
+    {
+        l2cap_input_flush_handler< ConnectionDetails > handler( this, connection );
+        for_< Channels... >::template each< l2cap_input_flush_handler< ConnectionDetails >& >( handler );
     }
 }
 }
@@ -3,6 +3,13 @@
 
 #include <bluetoe/ll_meta_types.hpp>
 #include <bluetoe/delta_time.hpp>
+#include <bluetoe/l2cap_channels.hpp>
+#include <bluetoe/codes.hpp>
+#include <bluetoe/bits.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
 
 namespace bluetoe {
 namespace link_layer {
@@ -11,6 +18,7 @@ namespace link_layer {
         struct connection_event_callback_meta_type : details::valid_link_layer_option_meta_type {};
         struct synchronized_connection_event_callback_meta_type : details::valid_link_layer_option_meta_type {};
         struct check_synchronized_connection_event_callback_meta_type : details::valid_link_layer_option_meta_type {};
+        struct transmit_complete_callback_meta_type : details::valid_link_layer_option_meta_type {};
 
         struct default_connection_event_callback
         {
@@ -478,6 +486,154 @@ namespace link_layer {
         /** @endcond */
     };
 
+    /**
+     * @brief install a callback that will be called, when a notification was acknowledged by the peer
+     *
+     * Together with the credit API of the link layer (ll_data_pdu_buffer::transmit_credits()), this allows
+     * a data producer to keep the transmit pipeline filled, without overrunning it: Notify as long as there
+     * are credits and notify again, once the callback reported, that a notification left the device.
+     *
+     * The parameter T have to be a class type with following none static member function:
+     *
+     * void ll_notification_acknowledged( std::uint16_t value_handle );
+     *
+     * value_handle is the attribute handle of the characteristic value that was notified. The callback is
+     * called from the link layers connection event handling, once all link layer PDUs of the notification where
+     * acknowledged by the peer. The callback is called before the link layer asks the GATT server for pending
+     * outgoing data, so calling notify() from within the callback will fill the freed space within the same
+     * connection event handling.
+     *
+     * @sa no_transmit_complete_callback
+     */
+    template < typename T, T& Obj >
+    struct transmit_complete_callback
+    {
+        /** @cond HIDDEN_SYMBOLS */
+        template < class LinkLayer, std::size_t BufferSize >
+        class impl
+        {
+        public:
+            impl()
+            {
+                transmit_complete_reset();
+            }
+
+            void transmit_complete_reset()
+            {
+                first_      = 0;
+                size_       = 0;
+                unresolved_ = false;
+            }
+
+            void transmit_complete_sdu_committed( const std::uint8_t* sdu )
+            {
+                // the previous SDU might be pending in the l2cap layer
+                resolve();
+
+                // L2CAP header (length, channel id) followed by the ATT opcode and the characteristic value handle
+                if ( bluetoe::details::read_16bit( sdu + 2 ) != l2cap_channel_ids::att
+                  || sdu[ 4 ] != static_cast< std::uint8_t >( bluetoe::details::att_opcodes::notification ) )
+                    return;
+
+                unresolved_handle_  = bluetoe::details::read_16bit( sdu + 5 );
+                unresolved_         = true;
+
+                resolve();
+            }
+
+            void transmit_complete_connection_event()
+            {
+                resolve();
+
+                const std::size_t acknowledged = this_link_layer().acknowledged_transmit_pdus();
+
+                // counters are free running; compare with modulo arithmetic
+                while ( size_ != 0 && static_cast< std::ptrdiff_t >( acknowledged - pending_[ first_ ].pdus ) >= 0 )
+                {
+                    const std::uint16_t handle = pending_[ first_ ].handle;
+
+                    first_ = ( first_ + 1 ) % max_pending_notifications;
+                    --size_;
+
+                    Obj.ll_notification_acknowledged( handle );
+                }
+            }
+
+        private:
+            // Notifications are only committed during the connection event handling, after the acknowledged
+            // notifications were removed. So at least the last PDU of every pending notification still occupies
+            // the transmit buffer (with a capacity of BufferSize). The smallest PDU (the last fragment of a
+            // fragmented notification) occupies at least 3 bytes.
+            static constexpr std::size_t max_pending_notifications = BufferSize / 3 + 1;
+
+            struct pending_notification {
+                std::uint16_t   handle;
+                std::size_t     pdus;
+            };
+
+            LinkLayer& this_link_layer()
+            {
+                return static_cast< LinkLayer& >( *this );
+            }
+
+            // as soon as all fragments of a notification are committed to the link layer, the number of link layer
+            // PDUs, that have to be acknowledged, is known.
+            void resolve()
+            {
+                if ( !unresolved_ || this_link_layer().l2cap_transmit_pending() )
+                    return;
+
+                unresolved_ = false;
+
+                // see max_pending_notifications
+                assert( size_ != max_pending_notifications );
+
+                pending_[ ( first_ + size_ ) % max_pending_notifications ] = pending_notification{
+                    unresolved_handle_, this_link_layer().l2cap_sdu_committed_pdus() };
+
+                ++size_;
+            }
+
+            pending_notification    pending_[ max_pending_notifications ];
+            std::size_t             first_;
+            std::size_t             size_;
+            std::uint16_t           unresolved_handle_;
+            bool                    unresolved_;
+        };
+
+        typedef details::transmit_complete_callback_meta_type meta_type;
+        /** @endcond */
+    };
+
+    /**
+     * @brief Do not call back, when notifications are acknowledged
+     *
+     * This is the default.
+     *
+     * @sa transmit_complete_callback
+     */
+    struct no_transmit_complete_callback
+    {
+        /** @cond HIDDEN_SYMBOLS */
+        template < class LinkLayer, std::size_t BufferSize >
+        struct impl {
+            void transmit_complete_reset()
+            {
+            }
+
+            void transmit_complete_sdu_committed( const std::uint8_t* )
+            {
+            }
+
+            void transmit_complete_connection_event()
+            {
+            }
+        };
+
+        typedef details::transmit_complete_callback_meta_type meta_type;
+        /** @endcond */
+    };
+
 }
 }
 #endif
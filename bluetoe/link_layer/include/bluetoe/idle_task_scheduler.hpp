@@ -0,0 +1,176 @@
+#ifndef BLUETOE_LINK_LAYER_IDLE_TASK_SCHEDULER_HPP
+#define BLUETOE_LINK_LAYER_IDLE_TASK_SCHEDULER_HPP
+
+#include <bluetoe/ll_meta_types.hpp>
+#include <bluetoe/delta_time.hpp>
+#include <bluetoe/atomic_rmw.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+
+namespace bluetoe {
+namespace link_layer {
+
+    namespace details {
+        struct idle_task_scheduler_meta_type : details::valid_link_layer_option_meta_type {};
+    }
+
+    /**
+     * @brief runs application tasks in the radio idle time between two connection events
+     *
+     * CPU intensive work, like compressing or encrypting data, can delay the link layer so much, that it misses
+     * the next connection event. With this option, such work is split into tasks, that are run by the link layer
+     * in the gap between two connection events. A task is scheduled with schedule_task() and the worst case
+     * execution time of the task. At the end of every connection event, after all other processing of the event is done,
+     * the link layer takes the time left till the start of the next connection event from the scheduled radio and runs the
+     * scheduled tasks in the order of their numbers, as long as the sum of the worst case execution times fits into that
+     * gap. A task, that does not fit, is deferred to the next gap.
+     *
+     * The parameter T has to be a class type with following none static member function:
+     *
+     * void ll_run_task( std::size_t task );
+     *
+     * The callback is called from the context of the link layers connection event handling. GuardTimeUS is the
+     * time in µs, that is reserved in front of the next connection event, for the setup of the radio.
+     *
+     * schedule_task() can be called from any context, including the task itself, to schedule the task again. A task is
+     * run at most once per connection event. A task, that is scheduled again, before it was run, is run once, with the
+     * worst case execution time given last. Tasks are only run, while there is a connection. A task with a worst case
+     * execution time larger than every gap will never run.
+     *
+     * The scheduled radio has to provide the elapsed time since the current connection event anchor
+     * (hardware_supports_time_since_anchor).
+     *
+     * Example
+     * @code
+    struct tasks_t {
+        void ll_run_task( std::size_t task );
+    } tasks;
+
+    using link_layer = bluetoe::nrf52<
+        gatt,
+        bluetoe::link_layer::idle_task_scheduler< tasks_t, tasks, 2 >
+    >;
+
+    link_layer gatt_server;
+
+    void tasks_t::ll_run_task( std::size_t task )
+    {
+        if ( task == 0 )
+            compress_next_block();
+    }
+
+    int main()
+    {
+        // compressing a block takes up to 4ms
+        gatt_server.schedule_task( 0, bluetoe::link_layer::delta_time::msec( 4 ) );
+        ...
+    }
+     * @endcode
+     *
+     * @sa connection_event_callback
+     * @sa timer_wheel
+     */
+    template < typename T, T& Obj, std::size_t Tasks, unsigned GuardTimeUS = 500 >
+    struct idle_task_scheduler
+    {
+        static_assert( Tasks > 0 && Tasks <= 32, "up to 32 tasks are supported" );
+
+        /**
+         * @brief schedules the given task to be run in the next radio idle time, that is large enough for
+         *        the given worst case execution time.
+         *
+         * @pre task < Tasks
+         */
+        void schedule_task( std::size_t task, delta_time worst_case_execution_time );
+
+        /** @cond HIDDEN_SYMBOLS */
+        template < typename LinkLayer >
+        class impl
+        {
+        public:
+            impl()
+                : pending_( 0 )
+            {
+                static_assert( LinkLayer::hardware_supports_time_since_anchor, "choosen binding does not report the time since the connection event anchor!" );
+
+                for ( auto& wcet : worst_case_execution_time_us_ )
+                    wcet.store( 0, std::memory_order_relaxed );
+            }
+
+            void schedule_task( std::size_t task, delta_time worst_case_execution_time )
+            {
+                assert( task < Tasks );
+
+                worst_case_execution_time_us_[ task ].store( worst_case_execution_time.usec(), std::memory_order_relaxed );
+                bluetoe::details::atomic_fetch_or( pending_, std::uint32_t( 1 ) << task, std::memory_order_release );
+            }
+
+            /*
+             * to be called at the end of a connection event, with the time left till the next connection event
+             */
+            void run_idle_tasks( delta_time idle_time )
+            {
+                if ( idle_time <= delta_time( GuardTimeUS ) )
+                    return;
+
+                std::uint32_t       budget_us = idle_time.usec() - GuardTimeUS;
+                const std::uint32_t pending   = pending_.load( std::memory_order_acquire );
+
+                for ( std::size_t task = 0; task != Tasks && budget_us != 0; ++task )
+                {
+                    const std::uint32_t mask = std::uint32_t( 1 ) << task;
+
+                    if ( ( pending & mask ) == 0 )
+                        continue;
+
+                    const std::uint32_t wcet_us = worst_case_execution_time_us_[ task ].load( std::memory_order_relaxed );
+
+                    // defer to the next gap
+                    if ( wcet_us > budget_us )
+                        continue;
+
+                    // clear before running, so that the task can schedule itself again
+                    bluetoe::details::atomic_fetch_and( pending_, ~mask, std::memory_order_relaxed );
+                    budget_us -= wcet_us;
+
+                    Obj.ll_run_task( task );
+                }
+            }
+
+        private:
+            std::atomic< std::uint32_t >    pending_;
+            std::atomic< std::uint32_t >    worst_case_execution_time_us_[ Tasks ];
+        };
+
+        typedef details::idle_task_scheduler_meta_type meta_type;
+        /** @endcond */
+    };
+
+    /**
+     * @brief no application tasks are run between connection events
+     *
+     * This is the default.
+     *
+     * @sa idle_task_scheduler
+     */
+    struct no_idle_task_scheduler
+    {
+        /** @cond HIDDEN_SYMBOLS */
+        template < typename LinkLayer >
+        struct impl {
+            void run_idle_tasks( delta_time )
+            {
+            }
+        };
+
+        typedef details::idle_task_scheduler_meta_type meta_type;
+        /** @endcond */
+    };
+
+}
+}
+
+#endif
@@ -57,6 +57,9 @@ namespace l2cap {
         static constexpr std::size_t   minimum_channel_mtu_size = bluetoe::details::default_att_mtu_size;
         static constexpr std::size_t   maximum_channel_mtu_size = bluetoe::details::default_att_mtu_size;
 
+        // signaling requests are not delayed by the output of other channels
+        static constexpr std::uint16_t output_deadline          = 0;
+
         template < class PreviousData >
         using channel_data_t = PreviousData;
 
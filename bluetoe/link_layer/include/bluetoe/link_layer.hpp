@@ -23,6 +23,8 @@
 #include <bluetoe/l2cap.hpp>
 #include <bluetoe/connection_events.hpp>
 #include <bluetoe/peripheral_latency.hpp>
+#include <bluetoe/timer_wheel.hpp>
+#include <bluetoe/idle_task_scheduler.hpp>
 
 #include <algorithm>
 #include <cassert>
@@ -58,6 +60,10 @@ namespace link_layer {
 
             static constexpr std::size_t tx_size = s_type::transmit_buffer_size;
             static constexpr std::size_t rx_size = s_type::receive_buffer_size;
+
+            static constexpr bool        shared      = s_type::shared;
+            static constexpr std::size_t min_tx_size = s_type::min_transmit_buffer_size;
+            static constexpr std::size_t min_rx_size = s_type::min_receive_buffer_size;
         };
 
         template < typename SecurityFunctions, typename Server, typename ... Options >
@@ -455,6 +461,46 @@ namespace link_layer {
             Options...,
             no_synchronized_connection_event_callback
         >::type::template impl< Base >;
+
+        template < class Base, typename ...Options >
+        using select_transmit_complete_impl = typename bluetoe::details::find_by_meta_type<
+            transmit_complete_callback_meta_type,
+            Options...,
+            no_transmit_complete_callback
+        >::type::template impl< Base, buffer_sizes< Options... >::shared
+            ? buffer_sizes< Options... >::tx_size + buffer_sizes< Options... >::rx_size
+            : buffer_sizes< Options... >::tx_size >;
+
+        template < class Base, typename ...Options >
+        using select_timer_wheel_impl = typename bluetoe::details::find_by_meta_type<
+            timer_wheel_meta_type,
+            Options...,
+            no_timer_wheel
+        >::type::template impl< Base >;
+
+        template < class Base, typename ...Options >
+        using select_idle_task_scheduler_impl = typename bluetoe::details::find_by_meta_type<
+            idle_task_scheduler_meta_type,
+            Options...,
+            no_idle_task_scheduler
+        >::type::template impl< Base >;
+
+        /*
+         * time left till the given point in time (relative to the current anchor), if the radio implements time_since_anchor()
+         */
+        template < class Radio >
+        auto time_till( const Radio& radio, const delta_time& point, int ) -> decltype( radio.time_since_anchor(), delta_time() )
+        {
+            const delta_time now = radio.time_since_anchor();
+
+            return now < point ? point - now : delta_time();
+        }
+
+        template < class Radio >
+        delta_time time_till( const Radio&, const delta_time&, long )
+        {
+            return delta_time();
+        }
     }
 
     /**
@@ -511,6 +557,12 @@ namespace link_layer {
             > >,
         public details::select_user_timer_impl<
             link_layer< Server, ScheduledRadio, Options... >, Options ... >,
+        public details::select_transmit_complete_impl<
+            link_layer< Server, ScheduledRadio, Options... >, Options ... >,
+        public details::select_timer_wheel_impl<
+            link_layer< Server, ScheduledRadio, Options... >, Options ... >,
+        public details::select_idle_task_scheduler_impl<
+            link_layer< Server, ScheduledRadio, Options... >, Options ... >,
         public bluetoe::details::find_by_meta_type<
             details::ll_pdu_receive_data_callback_meta_type,
             Options...,
@@ -677,6 +729,10 @@ namespace link_layer {
         std::pair< std::size_t, std::uint8_t* > allocate_l2cap_output_buffer( std::size_t size );
         void commit_l2cap_output_buffer( std::pair< std::size_t, std::uint8_t* > buffer );
 
+        // used by the ll_l2cap_sdu_buffer to stream fragmented SDUs to the l2cap layer
+        bool l2cap_sdu_stream_start( const std::uint8_t* input, std::size_t in_size );
+        bool l2cap_sdu_stream( const std::uint8_t* input, std::size_t in_size, bool last );
+
         // will cause the link layer to inform the user callbacks that a connection event happend
         void restart_user_timer();
 
@@ -822,6 +878,8 @@ namespace link_layer {
         std::uint16_t                   timeout_value_;
         delta_time                      connection_timeout_;
         delta_time                      procedure_timeout_;
+        // start of the receive window of the next connection event, relative to the current anchor
+        delta_time                      next_event_window_start_;
         std::uint16_t                   defered_conn_event_counter_;
         write_buffer                    defered_ll_control_pdu_;
         connection_data_t               connection_data_;
@@ -901,6 +959,9 @@ namespace link_layer {
 
         compile_time_check_user_timer_parameters_t::template check< link_layer< Server, ScheduledRadio, Options... > >( user_timer_t() );
 
+        if ( details::buffer_sizes< Options... >::shared )
+            this->share_pdu_buffer( details::buffer_sizes< Options... >::min_tx_size, details::buffer_sizes< Options... >::min_rx_size );
+
         this->notification_callback( queue_lcap_notification, this );
     }
 
@@ -914,6 +975,12 @@ namespace link_layer {
         }
 
         radio_t::run();
+
+        // while advertising, there is plenty of time between two advertising events. While connected, the
+        // work done by l2cap_idle() (like generating a LESC key pair) could take longer than the time till
+        // the next connection event.
+        if ( state_ == state::advertising )
+            bluetoe::details::call_l2cap_idle< l2cap_t >( static_cast< l2cap_t& >( *this ) );
     }
 
     template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
@@ -951,6 +1018,7 @@ namespace link_layer {
                 this->set_access_address_and_crc_init( read_32bit( &body[ 12 ] ), read_24bit( &body[ 16 ] ) );
 
                 this->reset_pdu_buffer();
+                this->transmit_complete_reset();
                 this->reset_connection_parameter_request();
                 setup_next_connection_event();
 
@@ -1027,6 +1095,7 @@ namespace link_layer {
 
         if ( state_ == state::connecting )
         {
+            this->timer_wheel_new_connection();
             this->connection_established( details(), connection_data_, static_cast< radio_t& >( *this ) );
         }
         else if ( state_ == state::connection_changed )
@@ -1090,10 +1159,19 @@ namespace link_layer {
         if ( state_ == state::connected || state_ == state::connecting )
         {
             transmit_pending_control_pdus();
+            this->transmit_complete_connection_event();
+            bluetoe::details::call_l2cap_input_flush( static_cast< l2cap_t& >( *this ), connection_data_, 0 );
+            connection_data_.notification_time_base( this->connection_event_counter(), connection_interval_.usec() );
+            this->timer_wheel_connection_event( this->connection_event_counter(), connection_interval_.usec() );
             this->transmit_pending_l2cap_output( connection_data_ );
+            this->delivery_deadlines_flushed();
         }
 
         this->template handle_connection_events< link_layer< Server, ScheduledRadio, Options... > >();
+
+        // the remaining time till the next connection event is idle
+        if ( state_ == state::connected )
+            this->run_idle_tasks( details::time_till( static_cast< const radio_t& >( *this ), next_event_window_start_, 0 ) );
     }
 
     template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
@@ -1242,6 +1320,8 @@ namespace link_layer {
             window_end    = time_since_last_event + window_size;
         }
 
+        next_event_window_start_ = window_start;
+
         return this->schedule_connection_event(
                 channels_.data_channel( this->current_channel_index() ),
                 window_start,
@@ -1342,10 +1422,13 @@ namespace link_layer {
     template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
     bool link_layer< Server, ScheduledRadio, Options... >::queue_lcap_notification( const ::bluetoe::details::notification_data& item, void* that, ::bluetoe::details::notification_type type )
     {
-        auto& connection = static_cast< link_layer< Server, ScheduledRadio, Options... >* >( that )->connection_data_;
+        auto& self       = *static_cast< link_layer< Server, ScheduledRadio, Options... >* >( that );
+        auto& connection = self.connection_data_;
 
         bool new_data = false;
-        // TODO: Synchronization required!!!
+        // called in the context of server::notify() / server::indicate(), that might be an interrupt handler:
+        // the notification queue and queue_delivery_deadline() are safe to be called concurrently to the
+        // link layer, as they only use atomic operations.
         switch ( type )
         {
             case bluetoe::details::notification_type::notification:
@@ -1361,7 +1444,14 @@ namespace link_layer {
         }
 
         if ( new_data )
-            static_cast< link_layer< Server, ScheduledRadio, Options... >* >( that )->request_event_cancelation();
+        {
+            // data without a maximum delivery latency has to be send as soon as possible
+            const std::uint32_t latency = Server::has_delivery_latencies ? Server::delivery_latency( item ) : 0;
+            const bool connected        = self.state_ == state::connected || self.state_ == state::connecting;
+
+            if ( latency == 0 || !connected || self.queue_delivery_deadline( latency ) )
+                self.request_event_cancelation();
+        }
 
         return new_data;
     }
@@ -1502,6 +1592,20 @@ namespace link_layer {
         return result;
     }
 
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    bool link_layer< Server, ScheduledRadio, Options... >::l2cap_sdu_stream_start( const std::uint8_t* input, std::size_t in_size )
+    {
+        return state_ != state::disconnecting
+            && bluetoe::details::call_handle_l2cap_stream_start( static_cast< l2cap_t& >( *this ), input, in_size, connection_data_, 0 );
+    }
+
+    template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
+    bool link_layer< Server, ScheduledRadio, Options... >::l2cap_sdu_stream( const std::uint8_t* input, std::size_t in_size, bool last )
+    {
+        return state_ != state::disconnecting
+            && bluetoe::details::call_handle_l2cap_stream( static_cast< l2cap_t& >( *this ), input, in_size, last, connection_data_, 0 );
+    }
+
     template < class Server, template < std::size_t, std::size_t, class > class ScheduledRadio, typename ... Options >
     typename link_layer< Server, ScheduledRadio, Options... >::ll_result link_layer< Server, ScheduledRadio, Options... >::send_control_pdus()
     {
@@ -1826,6 +1930,7 @@ namespace link_layer {
             static_cast< std::uint8_t >( buffer.first & 0xff ) } );
 
         this->commit_l2cap_transmit_buffer( out_buffer );
+        this->transmit_complete_sdu_committed( buffer.second );
     }
     /** @endcond */
 
@@ -6,6 +6,7 @@
 #include <cassert>
 #include <initializer_list>
 #include <algorithm>
+#include <cstring>
 
 #include <bluetoe/default_pdu_layout.hpp>
 #include "ring_buffer.hpp"
@@ -32,6 +33,13 @@ namespace link_layer {
      * TransmitSize and ReceiveSize are the total size of memory for the receiving and
      * transmitting buffer. Depending on the layout of the used Radio, there might be
      * an overhead per PDU.
+     *
+     * After a call to share_pdu_buffer(), both directions borrow memory from each other
+     * on demand: If the transmit buffer runs full, while the receive buffer is empty, the
+     * transmit buffer takes all memory, except for the reservation of the receive buffer.
+     * If no receive buffer can be allocated, the transmit buffer gives back all memory, that
+     * is not used by it. The memory is moved from within allocate_receive_buffer(), because
+     * this is the only point in time, where the radio does not own a receive buffer.
      */
     template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
     class ll_data_pdu_buffer
@@ -145,6 +153,35 @@ namespace link_layer {
          */
         void max_tx_size( std::size_t max_size );
 
+        /**
+         * @brief lets the transmit and receive buffer share the memory of both buffers
+         *
+         * min_transmit_size and min_receive_size are the minimum number of bytes, that are reserved
+         * for the transmit and receive buffer. The memory above the reservations is given to the
+         * direction that needs it. Passing TransmitSize and ReceiveSize disables the sharing, which
+         * is the default.
+         *
+         * @pre min_transmit_size <= TransmitSize
+         * @pre min_receive_size <= ReceiveSize
+         * @pre min_transmit_size >= layout_overhead + min_buffer_size
+         * @pre min_receive_size >= layout_overhead + min_buffer_size
+         */
+        void share_pdu_buffer( std::size_t min_transmit_size, std::size_t min_receive_size );
+
+        /**
+         * @brief the number of bytes currently used for the transmit buffer
+         *
+         * Without sharing, this is TransmitSize.
+         */
+        std::size_t transmit_buffer_size() const;
+
+        /**
+         * @brief the number of bytes currently used for the receive buffer
+         *
+         * Without sharing, this is ReceiveSize.
+         */
+        std::size_t receive_buffer_size() const;
+
         /**@}*/
 
         /**@{*/
@@ -194,6 +231,9 @@ namespace link_layer {
          * To indicate that the allocated memory is filled with data to be send, commit_transmit_buffer() must be called.
          * The size parameter is the sum of the payload + header.
          *
+         * Until the next call to commit_transmit_buffer() or allocate_transmit_buffer(), no memory is moved between the
+         * transmit and the receive buffer of a shared buffer.
+         *
          * @post r = allocate_transmit_buffer( n ); r.size == 0 || r.size == n
          * @pre  buffer is in running mode
          * @pre size <= max_tx_size()
@@ -218,11 +258,60 @@ namespace link_layer {
          */
         void commit_transmit_buffer( read_buffer );
 
+        /**
+         * @brief queues a PDU for transmission, that is located outside of the transmit buffer
+         *
+         * Instead of copying the PDU into the transmit buffer, only a small reference to the PDU is stored
+         * in the transmit buffer. pdu has the same layout as a buffer obtained by allocate_transmit_buffer(),
+         * the payload size is pdu.size minus header and layout overhead. The LL header is not written
+         * by the caller, but when the PDU becomes the next PDU to be transmitted. At that time, all PDUs
+         * that where queued before are acknowledged by the peer. This allows to transmit the fragments
+         * of a larger SDU directly out of the SDU, by placing the header of a fragment over the end of
+         * the already acknowledged, previous fragment.
+         *
+         * The memory referenced by pdu must not be changed until pending_transmit_references() drops
+         * to the number of references queued before this PDU.
+         *
+         * Returns false, if there is no room in the transmit buffer for the reference.
+         *
+         * @pre llid is the LLID of a LL Data PDU (1, 2 or 3)
+         * @pre pdu.size - layout_overhead <= max_tx_size()
+         * @pre buffer is in running mode
+         */
+        bool commit_transmit_reference( read_buffer pdu, std::uint8_t llid );
+
+        /**
+         * @brief number of PDUs, committed by commit_transmit_reference(), that are not acknowledged yet
+         */
+        std::size_t pending_transmit_references() const;
+
         /**
          * @brief returns true, if there is pending, outgoing data
          */
         bool pending_outgoing_data_available() const;
 
+        /**
+         * @brief number of PDUs of max_tx_size(), that can be allocated and committed right now
+         *
+         * This allows producers of data to fill the transmit buffer exactly to its capacity.
+         */
+        std::size_t transmit_credits() const;
+
+        /**
+         * @brief number of PDUs, committed by commit_transmit_buffer() or commit_transmit_reference()
+         *        since the last call to reset_pdu_buffer()
+         *
+         * The counter wraps around and is meant to be compared with acknowledged_transmit_pdus():
+         * A PDU is acknowledged by the peer, once acknowledged_transmit_pdus() reached the value
+         * of committed_transmit_pdus() right after the PDU was committed.
+         */
+        std::size_t committed_transmit_pdus() const;
+
+        /**
+         * @brief number of committed PDUs, that were acknowledged by the peer since the last call to reset_pdu_buffer()
+         */
+        std::size_t acknowledged_transmit_pdus() const;
+
         /**@}*/
 
         /**@{*/
@@ -262,12 +351,15 @@ namespace link_layer {
          * Once a buffer was allocated to the radio hardware is will be released by the hardware by calling
          * received().
          *
+         * If the buffer is shared between both directions, memory is moved between the transmit and the
+         * receive buffer here.
+         *
          * This function can return an empty buffer if the receive buffers are all still allocated. The radio is
          * than required to ignore all incoming trafic.
          *
          * @attention there should be a maximum of one allocated but jet not released buffer.
          */
-        read_buffer allocate_receive_buffer() const;
+        read_buffer allocate_receive_buffer();
 
         /**
          * @brief This function will be called by the scheduled radio when a PDU was received without error.
@@ -299,8 +391,14 @@ namespace link_layer {
         /**@}*/
 
     private:
-        // transmit buffer followed by receive buffer at buffer_[ TransmitSize ]
+        // transmit buffer followed by receive buffer at buffer_[ transmit_size_ ]
         std::uint8_t    buffer_[ size ];
+        volatile std::size_t            transmit_size_;
+        std::size_t                     min_transmit_size_;
+        std::size_t                     min_receive_size_;
+        volatile bool                   transmit_starving_;
+        // a transmit buffer was allocated, but not committed yet; the memory must not be moved
+        volatile bool                   transmit_allocated_;
 
         pdu_ring_buffer< ReceiveSize, read_buffer, layout >  receive_buffer_;
         volatile std::size_t            max_rx_size_;
@@ -314,13 +412,21 @@ namespace link_layer {
         bool                    next_empty_;
         bool                    empty_sequence_number_;
         bool                    stopped_;
+        volatile std::size_t    pending_references_;
+        std::size_t             committed_pdus_;
+        volatile std::size_t    acknowledged_pdus_;
 
         static constexpr std::size_t  ll_header_size = 2;
         static constexpr std::uint8_t more_data_flag = 0x10;
         static constexpr std::uint8_t sn_flag        = 0x8;
         static constexpr std::uint8_t nesn_flag      = 0x4;
         static constexpr std::uint8_t ll_empty_id    = 0x01;
+        static constexpr std::uint8_t llid_mask      = 0x03;
 
+        // A reference is stored with the reserved LLID 0 and contains a pointer to the referenced PDU,
+        // followed by the LL header of the referenced PDU, without SN, NESN and MD.
+        static constexpr std::uint8_t reference_id   = 0x00;
+        static constexpr std::size_t  reference_size = sizeof( std::uint8_t* ) + sizeof( std::uint16_t );
 
         const std::uint8_t* transmit_buffer() const
         {
@@ -334,25 +440,39 @@ namespace link_layer {
 
         const std::uint8_t* receive_buffer() const
         {
-            return &buffer_[ TransmitSize ];
+            return &buffer_[ transmit_size_ ];
         }
 
         std::uint8_t* receive_buffer()
         {
-            return &buffer_[ TransmitSize ];
+            return &buffer_[ transmit_size_ ];
         }
 
+        void lend_to_transmit_buffer( std::size_t receive_size );
+
+        bool return_from_transmit_buffer();
+
         write_buffer set_next_expected_sequence_number( read_buffer ) const;
 
+        read_buffer resolve_reference( read_buffer ) const;
+
         void acknowledge( bool sequence_number );
     };
 
     // implementation
     template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
     ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::ll_data_pdu_buffer()
-        : receive_buffer_( receive_buffer() )
+        : transmit_size_( TransmitSize )
+        , min_transmit_size_( TransmitSize )
+        , min_receive_size_( ReceiveSize )
+        , transmit_starving_( false )
+        , transmit_allocated_( false )
+        , receive_buffer_( receive_buffer() )
         , transmit_buffer_( transmit_buffer() )
         , stopped_( false )
+        , pending_references_( 0 )
+        , committed_pdus_( 0 )
+        , acknowledged_pdus_( 0 )
     {
         layout::header( empty_, 0 );
         reset_pdu_buffer();
@@ -390,9 +510,37 @@ namespace link_layer {
         max_tx_size_ = max_size;
     }
 
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
+    void ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::share_pdu_buffer( std::size_t min_transmit_size, std::size_t min_receive_size )
+    {
+        assert( min_transmit_size <= TransmitSize );
+        assert( min_receive_size <= ReceiveSize );
+        assert( min_transmit_size >= layout_overhead + min_buffer_size );
+        assert( min_receive_size >= layout_overhead + min_buffer_size );
+
+        min_transmit_size_ = min_transmit_size;
+        min_receive_size_  = min_receive_size;
+    }
+
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
+    std::size_t ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::transmit_buffer_size() const
+    {
+        return transmit_size_;
+    }
+
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
+    std::size_t ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::receive_buffer_size() const
+    {
+        return size - transmit_size_;
+    }
+
     template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
     void ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::reset_pdu_buffer()
     {
+        transmit_size_      = TransmitSize;
+        transmit_starving_  = false;
+        transmit_allocated_ = false;
+
         max_rx_size_    = min_buffer_size;
         receive_buffer_.reset( receive_buffer() );
 
@@ -403,6 +551,9 @@ namespace link_layer {
         next_expected_sequence_number_ = false;
         next_empty_      = false;
         stopped_         = false;
+        pending_references_ = 0;
+        committed_pdus_     = 0;
+        acknowledged_pdus_  = 0;
     }
 
     template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
@@ -422,7 +573,20 @@ namespace link_layer {
     {
         typename Radio::lock_guard lock;
 
-        return transmit_buffer_.alloc_front( transmit_buffer(), size );
+        read_buffer result = transmit_buffer_.alloc_front( transmit_buffer(), size );
+
+        // an empty ring, that was shrunk, might not have enough room left behind the last position
+        if ( result.empty() && transmit_buffer_.next_end().empty() )
+        {
+            transmit_buffer_.reset( transmit_buffer(), transmit_size_ );
+            result = transmit_buffer_.alloc_front( transmit_buffer(), size );
+        }
+
+        // allocations are idempotent: a failed allocation supersedes an allocation, that was not committed
+        transmit_starving_  = result.empty();
+        transmit_allocated_ = !result.empty();
+
+        return result;
     }
 
     template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
@@ -447,11 +611,104 @@ namespace link_layer {
             layout::header( pdu, header );
         }
 
-        sequence_number_ = !sequence_number_;
+        sequence_number_    = !sequence_number_;
+        transmit_allocated_ = false;
+        ++committed_pdus_;
 
         transmit_buffer_.push_front( transmit_buffer(), pdu );
     }
 
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
+    bool ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::commit_transmit_reference( read_buffer pdu, std::uint8_t llid )
+    {
+        assert( ( llid & llid_mask ) == llid && llid != reference_id );
+        assert( pdu.size >= layout::data_channel_pdu_memory_size( 0 ) );
+
+        if ( stopped_ )
+            return true;
+
+        const std::uint16_t header = llid | ( ( pdu.size - layout::data_channel_pdu_memory_size( 0 ) ) << 8 );
+
+        typename Radio::lock_guard lock;
+
+        const read_buffer reference = transmit_buffer_.alloc_front( transmit_buffer(), layout::data_channel_pdu_memory_size( reference_size ) );
+
+        transmit_starving_ = reference.empty();
+
+        if ( reference.empty() )
+            return false;
+
+        std::uint8_t* const body = layout::body( reference ).first;
+        std::memcpy( body, &pdu.buffer, sizeof( pdu.buffer ) );
+        body[ sizeof( pdu.buffer ) ]     = static_cast< std::uint8_t >( header & 0xff );
+        body[ sizeof( pdu.buffer ) + 1 ] = static_cast< std::uint8_t >( header >> 8 );
+
+        layout::header( reference, reference_id | ( reference_size << 8 ) | ( sequence_number_ ? sn_flag : 0 ) );
+        sequence_number_ = !sequence_number_;
+        ++pending_references_;
+        ++committed_pdus_;
+
+        transmit_buffer_.push_front( transmit_buffer(), reference );
+
+        return true;
+    }
+
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
+    std::size_t ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::pending_transmit_references() const
+    {
+        return pending_references_;
+    }
+
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
+    std::size_t ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::transmit_credits() const
+    {
+        const std::size_t pdu_size = max_tx_size_ + layout_overhead;
+
+        typename Radio::lock_guard lock;
+
+        const std::size_t credits = transmit_buffer_.free_slots( transmit_buffer(), pdu_size );
+
+        // allocate_transmit_buffer() resets an empty ring, if there is no room left otherwise
+        return credits == 0 && transmit_buffer_.next_end().empty()
+            ? transmit_size_ / pdu_size
+            : credits;
+    }
+
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
+    std::size_t ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::committed_transmit_pdus() const
+    {
+        return committed_pdus_;
+    }
+
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
+    std::size_t ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::acknowledged_transmit_pdus() const
+    {
+        return acknowledged_pdus_;
+    }
+
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
+    read_buffer ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::resolve_reference( read_buffer reference ) const
+    {
+        const std::uint16_t reference_header = layout::header( reference );
+
+        if ( ( reference_header & llid_mask ) != reference_id )
+            return reference;
+
+        const std::uint8_t* const body = layout::body( reference ).first;
+
+        std::uint8_t* target;
+        std::memcpy( &target, body, sizeof( target ) );
+
+        const std::uint16_t header = body[ sizeof( target ) ] | ( body[ sizeof( target ) + 1 ] << 8 );
+        const read_buffer   pdu{ target, layout::data_channel_pdu_memory_size( header >> 8 ) };
+
+        // the memory in front of the payload could contain the payload of the previous fragment
+        layout::header( pdu, header | ( reference_header & ( sn_flag | more_data_flag ) ) );
+        std::fill( pdu.buffer + header_size, layout::body( pdu ).first, 0 );
+
+        return pdu;
+    }
+
     template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
     bool ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::pending_outgoing_data_available() const
     {
@@ -510,7 +767,7 @@ namespace link_layer {
         if ( transmit_buffer_.more_than_one() )
             layout::header( next, layout::header( next ) | more_data_flag );
 
-        return set_next_expected_sequence_number( next );
+        return set_next_expected_sequence_number( resolve_reference( next ) );
     }
 
     template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
@@ -532,6 +789,11 @@ namespace link_layer {
             const std::uint16_t header = layout::header( next );
             if ( static_cast< bool >( header & sn_flag ) != nesn )
             {
+                if ( ( header & llid_mask ) == reference_id )
+                    pending_references_ = pending_references_ - 1;
+
+                acknowledged_pdus_ = acknowledged_pdus_ + 1;
+
                 transmit_buffer_.pop_end( transmit_buffer() );
                 static_cast< Radio* >( this )->increment_transmit_packet_counter();
             }
@@ -561,9 +823,65 @@ namespace link_layer {
     }
 
     template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
-    read_buffer ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::allocate_receive_buffer() const
+    read_buffer ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::allocate_receive_buffer()
     {
-        return receive_buffer_.alloc_front( const_cast< std::uint8_t* >( receive_buffer() ), layout::data_channel_pdu_memory_size( max_rx_size_ - ll_header_size ) );
+        const std::size_t receive_size = layout::data_channel_pdu_memory_size( max_rx_size_ - ll_header_size );
+
+        // The link layer might be filling an allocated transmit buffer, while this function is called from the
+        // radio's interrupt handler. Resizing the transmit buffer would move the memory underneath.
+        const bool resizable = !transmit_allocated_;
+
+        if ( resizable && transmit_starving_ && receive_buffer_.next_end().empty() )
+            lend_to_transmit_buffer( receive_size );
+
+        read_buffer result = receive_buffer_.alloc_front( receive_buffer(), receive_size );
+
+        if ( result.empty() && receive_buffer_.next_end().empty() )
+        {
+            receive_buffer_.reset( receive_buffer(), size - transmit_size_ );
+            result = receive_buffer_.alloc_front( receive_buffer(), receive_size );
+        }
+
+        if ( result.empty() && resizable && !receive_buffer_.split() && return_from_transmit_buffer() )
+            result = receive_buffer_.alloc_front( receive_buffer(), receive_size );
+
+        return result;
+    }
+
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
+    void ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::lend_to_transmit_buffer( std::size_t receive_size )
+    {
+        // the receive buffer has to be able to receive a PDU, otherwise the transmit buffer would never be acknowledged
+        const std::size_t new_transmit_size = size - std::max( min_receive_size_, receive_size );
+
+        if ( new_transmit_size <= transmit_size_ )
+            return;
+
+        transmit_buffer_.resize( transmit_buffer(), transmit_buffer(), new_transmit_size );
+        transmit_size_     = new_transmit_size;
+        transmit_starving_ = false;
+
+        receive_buffer_.reset( receive_buffer(), size - transmit_size_ );
+    }
+
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
+    bool ll_data_pdu_buffer< TransmitSize, ReceiveSize, Radio >::return_from_transmit_buffer()
+    {
+        // keep room for a transmit buffer, that might be allocated, but not committed jet
+        const std::size_t new_transmit_size = std::max( min_transmit_size_,
+            transmit_buffer_.min_capacity( transmit_buffer(), max_tx_size_ + layout_overhead ) );
+
+        if ( new_transmit_size >= transmit_size_ )
+            return false;
+
+        std::uint8_t* const old_receive_buffer = receive_buffer();
+
+        transmit_buffer_.resize( transmit_buffer(), transmit_buffer(), new_transmit_size );
+        transmit_size_ = new_transmit_size;
+
+        receive_buffer_.resize( old_receive_buffer, receive_buffer(), size - transmit_size_ );
+
+        return true;
     }
 
     template < std::size_t TransmitSize, std::size_t ReceiveSize, typename Radio >
@@ -5,15 +5,47 @@
 #include <bluetoe/codes.hpp>
 #include <bluetoe/bits.hpp>
 
+#include <utility>
+#include <type_traits>
+
 namespace bluetoe {
 namespace link_layer {
 
+    namespace details {
+        template < class Radio >
+        struct transmit_references_supported
+        {
+            template < class R >
+            static auto check( int )
+                -> decltype( std::declval< R& >().commit_transmit_reference( read_buffer(), std::uint8_t() ), std::true_type() );
+
+            template < class R >
+            static std::false_type check( long );
+
+            static constexpr bool value = decltype( check< Radio >( 0 ) )::value;
+        };
+    }
+
     /**
      * @brief buffer responsible for fragment or defragment L2CAP SDUs
      *
      * If the L2CAP MTU size is 23, this class shall no generate any overhead as SDUs are directly
      * mapped to LL PDUs.
      *
+     * If ReceiveCallbacks provides the optional functions `bool l2cap_sdu_stream_start( const std::uint8_t*, std::size_t )`
+     * and `bool l2cap_sdu_stream( const std::uint8_t*, std::size_t, bool last )`, the first fragment of a fragmented
+     * SDU (including the L2CAP header) is offered to l2cap_sdu_stream_start(). If that function returns true, the SDU
+     * is not copied into the receive buffer, but all following fragments are passed to l2cap_sdu_stream() directly
+     * out of the LL receive buffer. If l2cap_sdu_stream() returns false, the fragment is passed again with the next call
+     * to next_ll_l2cap_received().
+     *
+     * If BufferedRadio provides `bool commit_transmit_reference( read_buffer, std::uint8_t llid )` and
+     * `std::size_t pending_transmit_references() const` (like ll_data_pdu_buffer), the fragments of an outgoing SDU,
+     * that does not fit into a single LL PDU, are not copied into the LL transmit buffer, but are transmitted directly
+     * out of the L2CAP transmit buffer. SDUs that fit into a single LL PDU are still copied. In this case, there are two
+     * L2CAP transmit buffers: while the fragments of one SDU wait for their acknowledgment, the next SDU can be
+     * allocated and committed. A buffer is released, once the last fragment of its SDU was acknowledged.
+     *
      * @tparam ReceiveCallbacks type that has to provide a callback for raw received PDUs
      */
     template < class BufferedRadio, class ReceiveCallbacks, std::size_t MTUSize >
@@ -79,6 +111,22 @@ namespace link_layer {
          */
         void free_ll_l2cap_received();
 
+        /**
+         * @brief returns true, if not all fragments of the last committed L2CAP SDU are committed to the BufferedRadio jet
+         */
+        bool l2cap_transmit_pending() const;
+
+        /**
+         * @brief value of BufferedRadio::committed_transmit_pdus(), right after the last fragment of the last
+         *        L2CAP SDU was committed to the BufferedRadio.
+         *
+         * Together with BufferedRadio::acknowledged_transmit_pdus(), this can be used to find out, whether
+         * an SDU was completely acknowledged by the peer.
+         *
+         * @pre !l2cap_transmit_pending()
+         */
+        std::size_t l2cap_sdu_committed_pdus() const;
+
         /**
          * @brief radio layout assumed by the buffer
          */
@@ -96,20 +144,95 @@ namespace link_layer {
         static constexpr std::size_t    overall_overhead        = header_size + layout_overhead + l2cap_header_size;
         static constexpr std::size_t    ll_overhead             = header_size + layout_overhead;
 
+        static constexpr std::size_t    transmit_buffers        = details::transmit_references_supported< BufferedRadio >::value ? 2 : 1;
+
         void add_to_receive_buffer( const std::uint8_t*, const std::uint8_t* );
         void try_send_pdus();
+        bool copy_fragment();
+        std::uint8_t* sdu_transmit_buffer();
+
+        // If the BufferedRadio is able to transmit PDUs out of memory, that is not part of its transmit buffer,
+        // the fragments are transmitted directly out of transmit_buffer_.
+        template < class Radio = BufferedRadio >
+        auto send_pdus( int )
+            -> decltype( std::declval< Radio& >().commit_transmit_reference( read_buffer(), std::uint8_t() ), void() );
+
+        template < class Radio = BufferedRadio >
+        void send_pdus( long );
+
+        template < class Radio = BufferedRadio >
+        auto pending_references( int ) const
+            -> decltype( std::declval< const Radio& >().pending_transmit_references() )
+        {
+            return this->pending_transmit_references();
+        }
+
+        template < class Radio = BufferedRadio >
+        std::size_t pending_references( long ) const
+        {
+            return 0;
+        }
+
+        template < class Radio = BufferedRadio >
+        auto committed_pdus( int ) const
+            -> decltype( std::declval< const Radio& >().committed_transmit_pdus() )
+        {
+            return this->committed_transmit_pdus();
+        }
+
+        template < class Radio = BufferedRadio >
+        std::size_t committed_pdus( long ) const
+        {
+            return 0;
+        }
+
+        template < class Callbacks >
+        static auto stream_start( Callbacks& cb, const std::uint8_t* input, std::size_t size, int )
+            -> decltype( cb.l2cap_sdu_stream_start( input, size ) )
+        {
+            return cb.l2cap_sdu_stream_start( input, size );
+        }
+
+        template < class Callbacks >
+        static bool stream_start( Callbacks&, const std::uint8_t*, std::size_t, long )
+        {
+            return false;
+        }
+
+        template < class Callbacks >
+        static auto stream( Callbacks& cb, const std::uint8_t* input, std::size_t size, bool last, int )
+            -> decltype( cb.l2cap_sdu_stream( input, size, last ) )
+        {
+            return cb.l2cap_sdu_stream( input, size, last );
+        }
+
+        template < class Callbacks >
+        static bool stream( Callbacks&, const std::uint8_t*, std::size_t, bool, long )
+        {
+            return true;
+        }
 
         std::uint8_t    receive_buffer_[ MTUSize + overall_overhead ];
         std::uint16_t   receive_size_;
         std::size_t     receive_buffer_used_;
+        // the current SDU is streamed to the ReceiveCallbacks, receive_size_ contains the remaining payload
+        bool            streaming_;
+        // the oldest PDU in the receive buffer is a last fragment, that was refused by the ReceiveCallbacks
+        bool            fragment_kept_;
 
         // when transmitting L2CAP PDUs, we need room for at least the first LL header. Otherwise,
         // it would not be possible to transparently replace commit_l2cap_transmit_buffer()
         // transparently with commit_transmit_buffer() for the case that fragmentation is not
         // used.
-        std::uint8_t    transmit_buffer_[ MTUSize + overall_overhead ];
+        std::uint8_t    transmit_buffer_[ transmit_buffers ][ MTUSize + overall_overhead ];
         std::uint16_t   transmit_size_;
         std::size_t     transmit_buffer_used_;
+        std::size_t     sdu_committed_pdus_;
+        // index of the buffer of the current SDU
+        std::size_t     transmit_index_;
+        // index of the buffer of the last SDU, that was transmitted by reference and the number of its fragments
+        std::size_t     referenced_index_;
+        std::size_t     referenced_pdus_;
     };
 
     /**
@@ -126,6 +249,8 @@ namespace link_layer {
         void commit_ll_transmit_buffer( read_buffer buffer );
         write_buffer next_ll_l2cap_received() const;
         void free_ll_l2cap_received();
+        bool l2cap_transmit_pending() const;
+        std::size_t l2cap_sdu_committed_pdus() const;
     private:
         static constexpr std::size_t    header_size             = BufferedRadio::header_size;
         static constexpr std::size_t    layout_overhead         = BufferedRadio::layout_overhead;
@@ -139,8 +264,14 @@ namespace link_layer {
     ll_l2cap_sdu_buffer< BufferedRadio, ReceiveCallbacks, MTUSize >::ll_l2cap_sdu_buffer()
         : receive_size_( 0 )
         , receive_buffer_used_( 0 )
+        , streaming_( false )
+        , fragment_kept_( false )
         , transmit_size_( 0 )
         , transmit_buffer_used_( 0 )
+        , sdu_committed_pdus_( 0 )
+        , transmit_index_( 0 )
+        , referenced_index_( 0 )
+        , referenced_pdus_( 0 )
     {
     }
 
@@ -152,7 +283,16 @@ namespace link_layer {
         if ( transmit_buffer_used_ != 0 ||  transmit_size_ != 0 )
             return { nullptr, 0 };
 
-        return { transmit_buffer_, payload_size + overall_overhead };
+        // References are acknowledged in the order, they were committed. So, if there are more pending references,
+        // than fragments of the last SDU transmitted by reference, the other buffer is still referenced too.
+        const std::size_t pending = pending_references( 0 );
+
+        if ( pending != 0 && ( transmit_buffers == 1 || pending > referenced_pdus_ ) )
+            return { nullptr, 0 };
+
+        transmit_index_ = ( referenced_index_ + 1 ) % transmit_buffers;
+
+        return { sdu_transmit_buffer(), payload_size + overall_overhead };
     }
 
     template < class BufferedRadio, class ReceiveCallbacks, std::size_t MTUSize >
@@ -199,7 +339,13 @@ namespace link_layer {
             if ( type == pdu_type_link_layer )
                 return pdu;
 
-            static_cast< ReceiveCallbacks* >( this )->pdu_receive_data_callback( pdu );
+            ReceiveCallbacks& callbacks = *static_cast< ReceiveCallbacks* >( this );
+
+            // a kept last fragment of a stream was already reported
+            if ( !fragment_kept_ )
+                callbacks.pdu_receive_data_callback( pdu );
+
+            fragment_kept_ = false;
 
             // l2cap message
             const auto          body        = layout::body( pdu );
@@ -207,6 +353,9 @@ namespace link_layer {
 
             if ( type == pdu_type_start )
             {
+                // a new SDU ends a stream, that was not completed
+                streaming_ = false;
+
                 if ( body_size >= l2cap_header_size )
                 {
                     const std::uint16_t l2cap_size  = bluetoe::details::read_16bit( body.first );
@@ -217,11 +366,34 @@ namespace link_layer {
 
                     if ( l2cap_size <= MTUSize )
                     {
-                        receive_size_ = l2cap_size + overall_overhead;
-                        add_to_receive_buffer( pdu.buffer, pdu.buffer + pdu.size );
+                        if ( l2cap_size + l2cap_header_size > body_size && stream_start( callbacks, body.first, body_size, 0 ) )
+                        {
+                            streaming_    = true;
+                            receive_size_ = l2cap_size + l2cap_header_size - body_size;
+                        }
+                        else
+                        {
+                            receive_size_ = l2cap_size + overall_overhead;
+                            add_to_receive_buffer( pdu.buffer, pdu.buffer + pdu.size );
+                        }
                     }
                 }
             }
+            else if ( streaming_ )
+            {
+                const std::size_t   size = std::min< std::size_t >( receive_size_, body_size );
+                const bool          last = size == receive_size_;
+
+                // keep the last fragment, until it can be handled
+                if ( !stream( callbacks, body.first, size, last, 0 ) )
+                {
+                    fragment_kept_ = true;
+                    return { nullptr, 0 };
+                }
+
+                receive_size_ -= size;
+                streaming_     = !last;
+            }
             else
             {
                 add_to_receive_buffer( body.first, body.second );
@@ -250,47 +422,124 @@ namespace link_layer {
 
     template < class BufferedRadio, class ReceiveCallbacks, std::size_t MTUSize >
     void ll_l2cap_sdu_buffer< BufferedRadio, ReceiveCallbacks, MTUSize >::try_send_pdus()
+    {
+        send_pdus( 0 );
+    }
+
+    template < class BufferedRadio, class ReceiveCallbacks, std::size_t MTUSize >
+    template < class Radio >
+    auto ll_l2cap_sdu_buffer< BufferedRadio, ReceiveCallbacks, MTUSize >::send_pdus( int )
+        -> decltype( std::declval< Radio& >().commit_transmit_reference( read_buffer(), std::uint8_t() ), void() )
     {
         while ( transmit_size_ )
         {
             const bool first_fragment   = transmit_buffer_used_ == 0;
 
-            // for the first PDU, the header overhead is already taken into account. For all additonal fragments,
-            // an additional header has to be allocated.
+            // an SDU that fits into a single PDU is copied, so that the SDU buffer is released right away
+            if ( first_fragment && transmit_size_ <= this->max_tx_size() )
+            {
+                if ( !copy_fragment() )
+                    return;
+
+                continue;
+            }
+
+            // The first fragment starts with the original LL header. The LL header of every additional fragment
+            // is written by the radio over the end of the previous fragment, once the previous fragment was acknowledged.
             const std::size_t overhead  = first_fragment ? 0 : ll_overhead;
-            const auto buffer           = this->allocate_transmit_buffer( std::min( transmit_size_ + overhead, this->max_tx_size() ) );
+            const std::size_t size      = std::min< std::size_t >( transmit_size_ + overhead, this->max_tx_size() );
+            const read_buffer fragment  = { sdu_transmit_buffer() + transmit_buffer_used_ - overhead, size };
 
-            if ( buffer.size == 0 )
+            if ( !this->commit_transmit_reference( fragment, first_fragment ? pdu_type_start : pdu_type_continuation ) )
                 return;
 
-            if ( first_fragment )
-            {
-                // The first fragment contains the original LL header
-                const auto copy_size = std::min< std::size_t >( buffer.size, transmit_size_ );
+            referenced_index_      = transmit_index_;
+            referenced_pdus_       = first_fragment ? 1 : referenced_pdus_ + 1;
+            transmit_size_        -= size - overhead;
+            transmit_buffer_used_ += size - overhead;
 
-                std::copy( &transmit_buffer_[ 0 ], &transmit_buffer_[ copy_size ], buffer.buffer );
-                layout::header( buffer, pdu_type_start | ( ( copy_size - ll_overhead ) << 8 ) );
+            if ( transmit_size_ == 0 )
+                sdu_committed_pdus_ = committed_pdus( 0 );
+        }
 
-                transmit_size_        -= copy_size;
-                transmit_buffer_used_ += copy_size;
-            }
-            else
-            {
-                // for every additional fragment, an additional header has to be generated
-                const auto body        = layout::body( buffer );
-                const auto copy_size   = std::min< std::size_t >( std::distance( body.first, body.second ), transmit_size_ );
+        transmit_buffer_used_ = 0;
+    }
 
-                std::copy( &transmit_buffer_[ transmit_buffer_used_ ], &transmit_buffer_[ transmit_buffer_used_+ copy_size ], body.first );
-                layout::header( buffer, pdu_type_continuation | ( copy_size << 8 ) );
+    template < class BufferedRadio, class ReceiveCallbacks, std::size_t MTUSize >
+    template < class Radio >
+    void ll_l2cap_sdu_buffer< BufferedRadio, ReceiveCallbacks, MTUSize >::send_pdus( long )
+    {
+        while ( transmit_size_ )
+        {
+            if ( !copy_fragment() )
+                return;
+        }
 
-                transmit_size_        -= copy_size;
-                transmit_buffer_used_ += copy_size;
-            }
+        transmit_buffer_used_ = 0;
+    }
+
+    template < class BufferedRadio, class ReceiveCallbacks, std::size_t MTUSize >
+    bool ll_l2cap_sdu_buffer< BufferedRadio, ReceiveCallbacks, MTUSize >::copy_fragment()
+    {
+        const std::uint8_t* const sdu = sdu_transmit_buffer();
+        const bool first_fragment     = transmit_buffer_used_ == 0;
+
+        // for the first PDU, the header overhead is already taken into account. For all additonal fragments,
+        // an additional header has to be allocated.
+        const std::size_t overhead  = first_fragment ? 0 : ll_overhead;
+        const auto buffer           = this->allocate_transmit_buffer( std::min( transmit_size_ + overhead, this->max_tx_size() ) );
+
+        if ( buffer.size == 0 )
+            return false;
+
+        if ( first_fragment )
+        {
+            // The first fragment contains the original LL header
+            const auto copy_size = std::min< std::size_t >( buffer.size, transmit_size_ );
+
+            std::copy( &sdu[ 0 ], &sdu[ copy_size ], buffer.buffer );
+            layout::header( buffer, pdu_type_start | ( ( copy_size - ll_overhead ) << 8 ) );
 
-            this->commit_transmit_buffer( buffer );
+            transmit_size_        -= copy_size;
+            transmit_buffer_used_ += copy_size;
         }
+        else
+        {
+            // for every additional fragment, an additional header has to be generated
+            const auto body        = layout::body( buffer );
+            const auto copy_size   = std::min< std::size_t >( std::distance( body.first, body.second ), transmit_size_ );
 
-        transmit_buffer_used_ = 0;
+            std::copy( &sdu[ transmit_buffer_used_ ], &sdu[ transmit_buffer_used_+ copy_size ], body.first );
+            layout::header( buffer, pdu_type_continuation | ( copy_size << 8 ) );
+
+            transmit_size_        -= copy_size;
+            transmit_buffer_used_ += copy_size;
+        }
+
+        this->commit_transmit_buffer( buffer );
+
+        if ( transmit_size_ == 0 )
+            sdu_committed_pdus_ = committed_pdus( 0 );
+
+        return true;
+    }
+
+    template < class BufferedRadio, class ReceiveCallbacks, std::size_t MTUSize >
+    std::uint8_t* ll_l2cap_sdu_buffer< BufferedRadio, ReceiveCallbacks, MTUSize >::sdu_transmit_buffer()
+    {
+        return &transmit_buffer_[ transmit_index_ ][ 0 ];
+    }
+
+    template < class BufferedRadio, class ReceiveCallbacks, std::size_t MTUSize >
+    bool ll_l2cap_sdu_buffer< BufferedRadio, ReceiveCallbacks, MTUSize >::l2cap_transmit_pending() const
+    {
+        return transmit_size_ != 0;
+    }
+
+    template < class BufferedRadio, class ReceiveCallbacks, std::size_t MTUSize >
+    std::size_t ll_l2cap_sdu_buffer< BufferedRadio, ReceiveCallbacks, MTUSize >::l2cap_sdu_committed_pdus() const
+    {
+        return sdu_committed_pdus_;
     }
 
     template < class BufferedRadio, class ReceiveCallbacks, std::size_t MTUSize >
@@ -344,6 +593,19 @@ namespace link_layer {
     {
         return this->free_received();
     }
+
+    template < class BufferedRadio, class ReceiveCallbacks >
+    bool ll_l2cap_sdu_buffer< BufferedRadio, ReceiveCallbacks, bluetoe::details::default_att_mtu_size >::l2cap_transmit_pending() const
+    {
+        return false;
+    }
+
+    template < class BufferedRadio, class ReceiveCallbacks >
+    std::size_t ll_l2cap_sdu_buffer< BufferedRadio, ReceiveCallbacks, bluetoe::details::default_att_mtu_size >::l2cap_sdu_committed_pdus() const
+    {
+        // SDUs are committed directly
+        return this->committed_transmit_pdus();
+    }
 }
 }
 
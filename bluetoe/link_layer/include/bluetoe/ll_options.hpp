@@ -139,6 +139,47 @@ namespace link_layer
          * configured link layer receive buffer size in bytes.
          */
         static constexpr std::size_t receive_buffer_size  = ReceiveSize;
+
+        /** @cond HIDDEN_SYMBOLS */
+        static constexpr bool        shared                       = false;
+        static constexpr std::size_t min_transmit_buffer_size     = TransmitSize;
+        static constexpr std::size_t min_receive_buffer_size      = ReceiveSize;
+        /** @endcond */
+    };
+
+    /**
+     * @brief defines a single link layer buffer, that is shared by transmitting and receiving PDUs
+     *
+     * Instead of splitting the memory statically into a transmit and a receive buffer (see buffer_sizes),
+     * both directions borrow memory from each other on demand. For example, a device that sends a lot of
+     * notifications can use most of the memory to queue outgoing PDUs, while a device that receives large
+     * writes uses most of the memory to buffer incoming PDUs.
+     *
+     * MinTransmitSize and MinReceiveSize are the number of bytes that are always reserved for the
+     * corresponding direction. Both have to be large enough to store at least one PDU of the maximum
+     * transmit / receive size plus the PDU overhead required by the radio hardware. Initially, both
+     * directions get half of the memory. The maximum size of a single PDU is limited by the initial
+     * buffer size of the direction.
+     *
+     * @sa buffer_sizes
+     */
+    template < std::size_t Size, std::size_t MinTransmitSize, std::size_t MinReceiveSize >
+    struct shared_buffer_sizes
+    {
+        static_assert( MinTransmitSize <= Size / 2, "the transmit reservation has to fit into the initial transmit buffer" );
+        static_assert( MinReceiveSize <= Size - Size / 2, "the receive reservation has to fit into the initial receive buffer" );
+
+        /** @cond HIDDEN_SYMBOLS */
+        struct meta_type :
+            details::buffer_sizes_meta_type,
+            details::valid_link_layer_option_meta_type {};
+
+        static constexpr std::size_t transmit_buffer_size         = Size / 2;
+        static constexpr std::size_t receive_buffer_size          = Size - Size / 2;
+        static constexpr bool        shared                       = true;
+        static constexpr std::size_t min_transmit_buffer_size     = MinTransmitSize;
+        static constexpr std::size_t min_receive_buffer_size      = MinReceiveSize;
+        /** @endcond */
     };
 
     namespace details
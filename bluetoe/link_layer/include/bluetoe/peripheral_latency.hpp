@@ -3,6 +3,10 @@
 
 #include <bluetoe/ll_meta_types.hpp>
 #include <bluetoe/connection_events.hpp>
+#include <bluetoe/atomic_rmw.hpp>
+
+#include <atomic>
+#include <cstdint>
 
 /**
  * @file bluetoe/peripheral_latency.hpp
@@ -52,6 +56,10 @@ namespace link_layer {
          * payload becomes available while the next connection event was
          * planned to utilize peripheral latency, the library tries to
          * reschedule the next connection event to happen earlier.
+         *
+         * Notifications and indications of characteristics with a bluetoe::maximum_delivery_latency
+         * do not cause a rescheduling, as long as the planned connection events allow to meet
+         * the deadline.
          */
         listen_if_pending_transmit_data,
 
@@ -315,6 +323,8 @@ namespace link_layer {
                 channel_index_ = ( channel_index_ + 1 ) % channel_map::max_number_of_data_channels;
                 ++event_counter_;
                 time_since_last_event_ += connection_interval;
+
+                publish_planned_event( connection_interval );
             }
 
             /**
@@ -350,10 +360,26 @@ namespace link_layer {
                         connection_peripheral_latency = std::min( connection_peripheral_latency, instance_distance );
                 }
 
+                // once the L2CAP output was moved into the link layer and sent, the deadline was met
+                if ( deadline_pending_ && deadline_flushed_ && !last_event_events.pending_outgoing_data )
+                    deadline_pending_ = false;
+
+                collect_delivery_deadline( connection_interval );
+
+                if ( deadline_pending_ )
+                {
+                    const std::int16_t deadline_distance = static_cast< std::int16_t >( deadline_ - event_counter_ );
+
+                    if ( deadline_distance < connection_peripheral_latency )
+                        connection_peripheral_latency = std::max< std::int16_t >( deadline_distance, 1 );
+                }
+
                 channel_index_  = ( channel_index_ + connection_peripheral_latency ) % channel_map::max_number_of_data_channels;
                 event_counter_ += connection_peripheral_latency;
                 time_since_last_event_ = connection_peripheral_latency * connection_interval;
 
+                publish_planned_event( connection_interval );
+
                 base().disarmable_connection_state_last_latency( connection_peripheral_latency );
             }
 
@@ -374,6 +400,39 @@ namespace link_layer {
                 return false;
             }
 
+            /**
+             * @brief to be called, when outgoing data with a maximum delivery latency was queued
+             *
+             * The latency is counted from the last connection event that took place. Until the data
+             * was moved into the link layer by the next call to delivery_deadlines_flushed(), connection
+             * events will only be skipped, as long as the earliest pending deadline allows it.
+             *
+             * This function is called in the context of server::notify() and server::indicate(), which
+             * can be an interrupt handler. So it only records the shortest requested latency atomically.
+             * The deadline is calculated, when the next connection event is planned.
+             *
+             * @ret true: the next, planned connection event is too late to meet the deadline and
+             *      should be rescheduled.
+             */
+            bool queue_delivery_deadline( std::uint32_t latency_ms )
+            {
+                const std::uint32_t latency = std::min( latency_ms, maximum_latency_ms );
+                std::uint32_t       requested = requested_latency_ms_.load( std::memory_order_relaxed );
+
+                while ( latency < requested && !::bluetoe::details::atomic_compare_exchange( requested_latency_ms_, requested, latency ) )
+                    ;
+
+                return delta_time::msec( latency ) < delta_time( planned_event_latency_.load( std::memory_order_relaxed ) );
+            }
+
+            /**
+             * @brief to be called, after pending L2CAP output was moved into the link layer
+             */
+            void delivery_deadlines_flushed()
+            {
+                deadline_flushed_ = true;
+            }
+
             /**
              * @brief connection is just established
              */
@@ -382,6 +441,10 @@ namespace link_layer {
                 channel_index_         = 0;
                 event_counter_         = 0;
                 time_since_last_event_ = delta_time();
+                deadline_pending_      = false;
+                deadline_flushed_      = true;
+                requested_latency_ms_.store( no_requested_latency, std::memory_order_relaxed );
+                planned_event_latency_.store( 0, std::memory_order_relaxed );
                 base().disarmable_connection_state_last_latency( 1 );
             }
 
@@ -399,12 +462,54 @@ namespace link_layer {
                 event_counter_ += count;
 
                 time_since_last_event_ -= -count * connection_iterval;
+
+                publish_planned_event( connection_iterval );
             }
 
         private:
+            // there is no point in deadlines beyond the maximum supervision timeout of 32s
+            static constexpr std::uint32_t maximum_latency_ms   = 32000;
+            static constexpr std::uint32_t no_requested_latency = ~std::uint32_t( 0 );
+
+            // moves the latency requested by queue_delivery_deadline() into the deadline, counted from the last
+            // connection event, before the one that just happend, as the request could have been queued before
+            // that event.
+            void collect_delivery_deadline( delta_time connection_interval )
+            {
+                const std::uint32_t latency = ::bluetoe::details::atomic_exchange( requested_latency_ms_, no_requested_latency );
+
+                if ( latency == no_requested_latency )
+                    return;
+
+                assert( !connection_interval.zero() );
+
+                const std::uint16_t last_event = event_counter_ - time_since_last_event_ / connection_interval;
+                const std::uint16_t deadline   = last_event + delta_time::msec( latency ) / connection_interval;
+
+                if ( !deadline_pending_ || static_cast< std::int16_t >( deadline - deadline_ ) < 0 )
+                    deadline_ = deadline;
+
+                deadline_pending_ = true;
+                deadline_flushed_ = false;
+            }
+
+            // latencies shorter than the time from the last connection event till the end of the interval of the
+            // next, planned connection event, can not be met without rescheduling the planned event.
+            void publish_planned_event( delta_time connection_interval )
+            {
+                planned_event_latency_.store( ( time_since_last_event_ + connection_interval ).usec(), std::memory_order_relaxed );
+            }
+
             unsigned        channel_index_;
             std::uint16_t   event_counter_;
             delta_time      time_since_last_event_;
+            std::uint16_t   deadline_;
+            bool            deadline_pending_;
+            bool            deadline_flushed_;
+
+            // shared with the context of queue_delivery_deadline()
+            std::atomic< std::uint32_t >    requested_latency_ms_;
+            std::atomic< std::uint32_t >    planned_event_latency_;
 
             Base& base()
             {
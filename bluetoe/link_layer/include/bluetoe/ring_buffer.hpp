@@ -4,6 +4,8 @@
 #include <cstdint>
 #include <cassert>
 #include <cstdlib>
+#include <atomic>
+#include <algorithm>
 
 #include <bluetoe/buffer.hpp>
 #include <bluetoe/default_pdu_layout.hpp>
@@ -22,6 +24,9 @@ namespace link_layer {
      *
      * The Layout is used to access the header field of the PDU and to determin the in memory
      * length of stored PDUs.
+     *
+     * Size is the initial capacity of the ring. The capacity can be changed at runtime by resize(),
+     * which allows two rings to share a common piece of memory.
      */
     template < std::size_t Size, typename Buffer = read_buffer, typename Layout = default_pdu_layout >
     class pdu_ring_buffer
@@ -43,9 +48,49 @@ namespace link_layer {
          * @brief resets the ring to be empty
          * @pre next_end().size == 0
          * @pre buffer must point to an array of at least Size bytes
+         * @post capacity() == Size
          */
         void reset( std::uint8_t* buffer );
 
+        /**
+         * @brief resets the ring to be empty, with the given capacity
+         * @pre buffer must point to an array of at least capacity bytes
+         * @post capacity() == capacity
+         */
+        void reset( std::uint8_t* buffer, std::size_t capacity );
+
+        /**
+         * @brief current capacity of the ring in bytes
+         */
+        std::size_t capacity() const;
+
+        /**
+         * @brief returns true, if the stored PDUs wrap around the end of the ring
+         */
+        bool split() const;
+
+        /**
+         * @brief the smallest capacity, the ring can be resized to, without moving stored PDUs
+         *
+         * If the ring is not split, this is the size of the memory in front of the next allocation plus
+         * allocation bytes, so that an allocation of up to allocation bytes, that was obtained by alloc_front()
+         * but not pushed jet, stays valid. If the ring is split, the capacity can not be reduced.
+         */
+        std::size_t min_capacity( const std::uint8_t* buffer, std::size_t allocation ) const;
+
+        /**
+         * @brief changes the memory of the ring without moving the stored PDUs
+         *
+         * The ring can be grown and shrunk at the end. If the ring is not split, the start of the ring can also
+         * be moved towards lower addresses. From now on, new_buffer has to be passed to the functions of the ring.
+         *
+         * @pre new_buffer <= old_buffer
+         * @pre new_buffer + new_capacity >= old_buffer + min_capacity( old_buffer, x )
+         * @pre !split() || new_buffer == old_buffer
+         * @post capacity() == new_capacity
+         */
+        void resize( std::uint8_t* old_buffer, std::uint8_t* new_buffer, std::size_t new_capacity );
+
         /**
          * @brief return a writeable PDU buffer of at least size bytes at the front of the ring
          *
@@ -91,6 +136,14 @@ namespace link_layer {
          */
         bool more_than_one() const;
 
+        /**
+         * @brief number of PDUs of size bytes, that can be allocated and pushed to the ring, one after an other
+         *
+         * @pre size >= Layout::data_channel_pdu_memory_size( 0 )
+         * @pre buffer must point to an array of at least capacity() bytes
+         */
+        std::size_t free_slots( const std::uint8_t* buffer, std::size_t size ) const;
+
     private:
         static constexpr std::size_t    ll_header_size = 2;
         static constexpr std::uint16_t  wrap_mark = 0;
@@ -109,6 +162,81 @@ namespace link_layer {
         //        and there are elements from the beginning of the buffer till end_
         std::uint8_t* end_;
         std::uint8_t* front_;
+        std::size_t   capacity_;
+    };
+
+    /**
+     * @brief lock-free variant of the pdu_ring_buffer for a single producer and a single consumer
+     *
+     * The interface and the memory layout are the same as with pdu_ring_buffer. alloc_front() and push_front()
+     * must only be called by the producer, next_end(), pop_end() and more_than_one() must only be called by the
+     * consumer. Producer and consumer can run in different contexts (for example, a radio ISR and the application),
+     * without disabling interrupts. reset() must not be called concurrently to any other function.
+     *
+     * Both sides only write their own position and publish it with release semantic: once the consumer
+     * sees a new front position, it sees the content of the pushed PDU and once the producer sees a new
+     * end position, the consumer is done with the freed PDU. Different to pdu_ring_buffer, the producer
+     * never moves the end position, when wrapping from an empty ring. Instead, the consumer follows
+     * the wrap mark. This requires to keep the buffer pointer passed to reset().
+     */
+    template < std::size_t Size, typename Buffer = read_buffer, typename Layout = default_pdu_layout >
+    class spsc_pdu_ring_buffer
+    {
+    public:
+        /**
+         * @brief the size of the buffer in bytes
+         */
+        static constexpr std::size_t size = Size;
+
+        /**
+         * @copydoc pdu_ring_buffer::pdu_ring_buffer
+         */
+        explicit spsc_pdu_ring_buffer( std::uint8_t* buffer );
+
+        /**
+         * @copydoc pdu_ring_buffer::reset
+         */
+        void reset( std::uint8_t* buffer );
+
+        /**
+         * @copydoc pdu_ring_buffer::alloc_front
+         */
+        Buffer alloc_front( std::uint8_t* buffer, std::size_t size ) const;
+
+        /**
+         * @copydoc pdu_ring_buffer::push_front
+         */
+        void push_front( std::uint8_t* buffer, const Buffer& pdu );
+
+        /**
+         * @copydoc pdu_ring_buffer::next_end
+         */
+        Buffer next_end() const;
+
+        /**
+         * @copydoc pdu_ring_buffer::pop_end
+         */
+        void pop_end( std::uint8_t* buffer );
+
+        /**
+         * @copydoc pdu_ring_buffer::more_than_one
+         */
+        bool more_than_one() const;
+
+    private:
+        static constexpr std::uint16_t  wrap_mark = 0;
+
+        static std::size_t pdu_length( const std::uint8_t* );
+
+        // position of the next PDU, if the ring is not empty
+        const std::uint8_t* wrapped_end( const std::uint8_t* end ) const;
+
+        std::uint8_t*                   buffer_;
+
+        // end_ is written by the consumer, front_ by the producer. The same invariants as with pdu_ring_buffer apply,
+        // except that end_ can point to a wrap mark.
+        std::atomic< std::uint8_t* >    end_;
+        std::atomic< std::uint8_t* >    front_;
     };
 
     template < std::size_t Size, typename Buffer, typename Layout >
@@ -119,14 +247,72 @@ namespace link_layer {
 
     template < std::size_t Size, typename Buffer, typename Layout >
     void pdu_ring_buffer< Size, Buffer, Layout >::reset( std::uint8_t* buffer )
+    {
+        reset( buffer, Size );
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    void pdu_ring_buffer< Size, Buffer, Layout >::reset( std::uint8_t* buffer, std::size_t capacity )
     {
         assert( buffer );
-        front_ = buffer;
-        end_   = buffer;
+        front_    = buffer;
+        end_      = buffer;
+        capacity_ = capacity;
 
         Layout::header( buffer, wrap_mark );
     }
 
+    template < std::size_t Size, typename Buffer, typename Layout >
+    std::size_t pdu_ring_buffer< Size, Buffer, Layout >::capacity() const
+    {
+        return capacity_;
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    bool pdu_ring_buffer< Size, Buffer, Layout >::split() const
+    {
+        return end_ > front_;
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    std::size_t pdu_ring_buffer< Size, Buffer, Layout >::min_capacity( const std::uint8_t* buffer, std::size_t allocation ) const
+    {
+        if ( split() )
+            return capacity_;
+
+        return std::min( capacity_, static_cast< std::size_t >( front_ - buffer ) + allocation );
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    void pdu_ring_buffer< Size, Buffer, Layout >::resize( std::uint8_t* old_buffer, std::uint8_t* new_buffer, std::size_t new_capacity )
+    {
+        assert( new_buffer <= old_buffer );
+        assert( new_buffer + new_capacity >= front_ );
+        assert( !split() || new_buffer == old_buffer );
+
+        if ( front_ == end_ )
+            return reset( new_buffer, new_capacity );
+
+        const std::uint8_t* old_end_of_buffer = old_buffer + capacity_;
+        const std::uint8_t* new_end_of_buffer = new_buffer + new_capacity;
+
+        // if the ring is split, the PDUs at the end of the ring are terminated by a wrap mark, or by the end of the
+        // ring. In the later case, the wrap mark has to be added, if the enlarged ring does not end there too.
+        if ( split() )
+        {
+            assert( new_end_of_buffer >= old_end_of_buffer );
+
+            std::uint8_t* pdu = end_;
+            while ( pdu + 1 < old_end_of_buffer && ( Layout::header( pdu ) >> 8 ) != wrap_mark )
+                pdu += pdu_length( pdu );
+
+            if ( pdu + 1 < new_end_of_buffer && pdu + 1 >= old_end_of_buffer )
+                Layout::header( pdu, wrap_mark );
+        }
+
+        capacity_ = new_capacity;
+    }
+
     template < std::size_t Size, typename Buffer, typename Layout >
     Buffer pdu_ring_buffer< Size, Buffer, Layout >::alloc_front( std::uint8_t* buffer, std::size_t size ) const
     {
@@ -141,7 +327,7 @@ namespace link_layer {
 
         if ( front_ >= end_ )
         {
-            const std::uint8_t* end_of_buffer = buffer + Size;
+            const std::uint8_t* end_of_buffer = buffer + capacity_;
 
             // allocate at the end?
             if ( static_cast< std::ptrdiff_t >( size ) <= end_of_buffer - front_ )
@@ -164,7 +350,7 @@ namespace link_layer {
     {
         assert( pdu.size >= pdu_length( pdu ) );
 
-        const std::uint8_t* end_of_buffer = buffer + Size;
+        const std::uint8_t* end_of_buffer = buffer + capacity_;
 
         // set size to 0 to mark force the end_ pointer to wrap here
         if ( front_ != pdu.buffer && front_ + 1 < end_of_buffer )
@@ -194,10 +380,10 @@ namespace link_layer {
     {
         end_ += pdu_length( end_ );
 
-        const std::uint8_t* end_of_buffer = buffer + Size;
+        const std::uint8_t* end_of_buffer = buffer + capacity_;
 
         // wrap the end_ pointer to the beginning, if the buffer is not empty
-        if ( end_ != front_ && ( end_ + 1 >= end_of_buffer || end_[ 1 ] == wrap_mark ) )
+        if ( end_ != front_ && ( end_ + 1 >= end_of_buffer || ( Layout::header( end_ ) >> 8 ) == wrap_mark ) )
             end_ = buffer;
     }
 
@@ -221,6 +407,156 @@ namespace link_layer {
         return end_ != front_ && ( end_ + pdu_length( end_) ) != front_;
     }
 
+    template < std::size_t Size, typename Buffer, typename Layout >
+    std::size_t pdu_ring_buffer< Size, Buffer, Layout >::free_slots( const std::uint8_t* buffer, std::size_t size ) const
+    {
+        assert( size >= Layout::data_channel_pdu_memory_size( 0 ) );
+
+        // again, there must be one byte left between front_ and end_
+        if ( split() )
+            return ( end_ - front_ - 1 ) / size;
+
+        const std::size_t at_the_end       = buffer + capacity_ - front_;
+        const std::size_t at_the_beginning = end_ - buffer;
+
+        // an empty ring wraps completely, if the first PDU does not fit at the end
+        if ( front_ == end_ && at_the_end < size )
+            return size < at_the_beginning ? capacity_ / size : 0;
+
+        return at_the_end / size + ( at_the_beginning == 0 ? 0 : ( at_the_beginning - 1 ) / size );
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    spsc_pdu_ring_buffer< Size, Buffer, Layout >::spsc_pdu_ring_buffer( std::uint8_t* buffer )
+    {
+        reset( buffer );
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    void spsc_pdu_ring_buffer< Size, Buffer, Layout >::reset( std::uint8_t* buffer )
+    {
+        assert( buffer );
+        buffer_ = buffer;
+        Layout::header( buffer, wrap_mark );
+
+        front_.store( buffer, std::memory_order_relaxed );
+        end_.store( buffer, std::memory_order_release );
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    Buffer spsc_pdu_ring_buffer< Size, Buffer, Layout >::alloc_front( std::uint8_t* buffer, std::size_t size ) const
+    {
+        assert( buffer == buffer_ );
+        assert( size >= Layout::data_channel_pdu_memory_size( 0 ) );
+
+        std::uint8_t* const front = front_.load( std::memory_order_relaxed );
+        std::uint8_t* const end   = end_.load( std::memory_order_acquire );
+
+        // the same as pdu_ring_buffer::alloc_front(). If end points to a wrap mark, the result is just more conservative
+        if ( end > front && static_cast< std::ptrdiff_t >( size ) < end - front )
+        {
+            return Buffer{ front, size };
+        }
+
+        if ( front >= end )
+        {
+            const std::uint8_t* end_of_buffer = buffer + Size;
+
+            if ( static_cast< std::ptrdiff_t >( size ) <= end_of_buffer - front )
+            {
+                return Buffer{ front, size };
+            }
+
+            if ( static_cast< std::ptrdiff_t >( size ) < end - buffer )
+            {
+                return Buffer{ buffer, size };
+            }
+        }
+
+        return Buffer{ 0, 0 };
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    void spsc_pdu_ring_buffer< Size, Buffer, Layout >::push_front( std::uint8_t* buffer, const Buffer& pdu )
+    {
+        assert( buffer == buffer_ );
+        assert( pdu.size >= pdu_length( pdu.buffer ) );
+
+        std::uint8_t* const front         = front_.load( std::memory_order_relaxed );
+        const std::uint8_t* end_of_buffer = buffer + Size;
+
+        // the wrap mark is published together with the PDU
+        if ( front != pdu.buffer && front + 1 < end_of_buffer )
+        {
+            Layout::header( front, wrap_mark );
+        }
+
+        front_.store( pdu.buffer + pdu_length( pdu.buffer ), std::memory_order_release );
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    Buffer spsc_pdu_ring_buffer< Size, Buffer, Layout >::next_end() const
+    {
+        const std::uint8_t* const front = front_.load( std::memory_order_acquire );
+        const std::uint8_t* const end   = end_.load( std::memory_order_relaxed );
+
+        if ( front == end )
+            return Buffer{ 0, 0 };
+
+        std::uint8_t* const next = const_cast< std::uint8_t* >( wrapped_end( end ) );
+
+        return Buffer{ next, pdu_length( next ) };
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    void spsc_pdu_ring_buffer< Size, Buffer, Layout >::pop_end( std::uint8_t* buffer )
+    {
+        assert( buffer == buffer_ );
+        static_cast< void >( buffer );
+
+        const std::uint8_t* const front = front_.load( std::memory_order_acquire );
+        const std::uint8_t*       end   = end_.load( std::memory_order_relaxed );
+        assert( front != end );
+
+        end = wrapped_end( end );
+        end += pdu_length( end );
+
+        if ( end != front )
+            end = wrapped_end( end );
+
+        end_.store( const_cast< std::uint8_t* >( end ), std::memory_order_release );
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    bool spsc_pdu_ring_buffer< Size, Buffer, Layout >::more_than_one() const
+    {
+        const std::uint8_t* const front = front_.load( std::memory_order_acquire );
+        const std::uint8_t* const end   = end_.load( std::memory_order_relaxed );
+
+        if ( front == end )
+            return false;
+
+        const std::uint8_t* const next = wrapped_end( end );
+
+        return next + pdu_length( next ) != front;
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    std::size_t spsc_pdu_ring_buffer< Size, Buffer, Layout >::pdu_length( const std::uint8_t* p )
+    {
+        return Layout::data_channel_pdu_memory_size( Layout::header( p ) >> 8 );
+    }
+
+    template < std::size_t Size, typename Buffer, typename Layout >
+    const std::uint8_t* spsc_pdu_ring_buffer< Size, Buffer, Layout >::wrapped_end( const std::uint8_t* end ) const
+    {
+        const std::uint8_t* end_of_buffer = buffer_ + Size;
+
+        return end + 1 >= end_of_buffer || ( Layout::header( end ) >> 8 ) == 0
+            ? buffer_
+            : end;
+    }
+
 }
 }
 
@@ -0,0 +1,338 @@
+#ifndef BLUETOE_LINK_LAYER_TIMER_WHEEL_HPP
+#define BLUETOE_LINK_LAYER_TIMER_WHEEL_HPP
+
+#include <bluetoe/ll_meta_types.hpp>
+#include <bluetoe/atomic_rmw.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+
+namespace bluetoe {
+namespace link_layer {
+
+    namespace details {
+        struct timer_wheel_meta_type : details::valid_link_layer_option_meta_type {};
+    }
+
+    /**
+     * @brief application timers, that expire at the end of connection events
+     *
+     * An application, that has to perform multiple periodic tasks, usually needs a hardware timer per
+     * task or a timer service, that wakes up the CPU independently of the radio activity. With this option,
+     * the link layer provides Timers application timers, that are driven by the connection events: At the end
+     * of every connection event, the link layer advances the timers by the time elapsed since the last
+     * connection event and calls Obj.ll_timer_expired() for every timer, that expired in the meantime. So
+     * timer expirations do not cause additional CPU wake ups and the time between an expiration and the
+     * connection anchor is deterministic.
+     *
+     * The timers are kept in a hierarchical timer wheel with a resolution of TickMS milliseconds. Starting a timer
+     * takes constant time. Stopping or restarting a running timer walks the list of timers in its slot. While at least
+     * one timer is running, advancing the wheel takes one step per elapsed tick; so a long connection interval with a
+     * small TickMS results in many steps per connection event.
+     *
+     * The parameter T has to be a class type with following none static member function:
+     *
+     * void ll_timer_expired( std::size_t timer );
+     *
+     * The callback is called from the context of the link layers connection event handling. Timers
+     * are started and stopped with start_timer() and stop_timer(). Both functions can be called from any
+     * context, including the callback. They take effect at the end of the next connection event. As the
+     * timers are driven by connection events, a timer expires at the end of the first connection event after
+     * its delay elapsed. Timers do not advance, while there is no connection.
+     *
+     * Example
+     * @code
+    struct tasks_t {
+        void ll_timer_expired( std::size_t timer );
+    } tasks;
+
+    using link_layer = bluetoe::nrf52<
+        gatt,
+        bluetoe::link_layer::timer_wheel< tasks_t, tasks, 4 >
+    >;
+
+    link_layer gatt_server;
+
+    int main()
+    {
+        // sample every 100ms, report every 1s
+        gatt_server.start_timer( 0, 100, 100 );
+        gatt_server.start_timer( 1, 1000, 1000 );
+        ...
+    }
+     * @endcode
+     *
+     * @sa synchronized_connection_event_callback
+     * @sa connection_event_callback
+     */
+    template < typename T, T& Obj, std::size_t Timers, unsigned TickMS = 10 >
+    struct timer_wheel
+    {
+        static_assert( Timers > 0 && Timers <= 32, "up to 32 timers are supported" );
+        static_assert( TickMS > 0, "the resolution of the timers has to be at least 1ms" );
+
+        /**
+         * @brief starts or restarts the given timer
+         *
+         * The timer expires after delay_ms milliseconds. If period_ms is not 0, the timer restarts
+         * with period_ms milliseconds after it expired, until it is stopped.
+         *
+         * @pre timer < Timers
+         */
+        void start_timer( std::size_t timer, std::uint32_t delay_ms, std::uint32_t period_ms = 0 );
+
+        /**
+         * @brief stops the given timer
+         *
+         * @pre timer < Timers
+         */
+        void stop_timer( std::size_t timer );
+
+        /** @cond HIDDEN_SYMBOLS */
+        template < typename LinkLayer >
+        class impl
+        {
+        public:
+            impl()
+                : pending_( 0 )
+                , now_( 0 )
+                , remainder_us_( 0 )
+                , active_( 0 )
+                , connection_event_counter_( 0 )
+                , synchronized_( false )
+            {
+                for ( auto& head : heads_ )
+                    head = none;
+
+                for ( std::size_t timer = 0; timer != Timers; ++timer )
+                {
+                    requested_delay_[ timer ].store( 0, std::memory_order_relaxed );
+                    requested_period_[ timer ].store( 0, std::memory_order_relaxed );
+                    location_[ timer ] = none;
+                }
+            }
+
+            void start_timer( std::size_t timer, std::uint32_t delay_ms, std::uint32_t period_ms = 0 )
+            {
+                assert( timer < Timers );
+
+                requested_delay_[ timer ].store( std::max< std::uint32_t >( to_ticks( delay_ms ), 1 ), std::memory_order_relaxed );
+                requested_period_[ timer ].store( to_ticks( period_ms ), std::memory_order_relaxed );
+                bluetoe::details::atomic_fetch_or( pending_, std::uint32_t( 1 ) << timer, std::memory_order_release );
+            }
+
+            void stop_timer( std::size_t timer )
+            {
+                assert( timer < Timers );
+
+                requested_delay_[ timer ].store( 0, std::memory_order_relaxed );
+                bluetoe::details::atomic_fetch_or( pending_, std::uint32_t( 1 ) << timer, std::memory_order_release );
+            }
+
+            void timer_wheel_new_connection()
+            {
+                synchronized_ = false;
+            }
+
+            /*
+             * to be called at the end of every connection event
+             */
+            void timer_wheel_connection_event( std::uint16_t connection_event_counter, std::uint32_t connection_interval_us )
+            {
+                if ( synchronized_ )
+                {
+                    const std::uint64_t elapsed_us = remainder_us_
+                        + std::uint64_t( static_cast< std::uint16_t >( connection_event_counter - connection_event_counter_ ) ) * connection_interval_us;
+
+                    remainder_us_ = static_cast< std::uint32_t >( elapsed_us % tick_us );
+                    advance( elapsed_us / tick_us );
+                }
+
+                synchronized_             = true;
+                connection_event_counter_ = connection_event_counter;
+
+                apply_requests();
+            }
+
+        private:
+            static constexpr std::uint32_t tick_us = TickMS * 1000;
+
+            // number of slots per level of the wheel; a timer is cascaded at most twice
+            static constexpr std::uint32_t slots   = 16;
+            static constexpr std::uint8_t  none    = 0xff;
+
+            static std::uint32_t to_ticks( std::uint32_t ms )
+            {
+                return ms / TickMS + ( ms % TickMS == 0 ? 0 : 1 );
+            }
+
+            void advance( std::uint64_t ticks )
+            {
+                // nothing to do, but keeping the time
+                if ( active_ == 0 )
+                {
+                    now_ += static_cast< std::uint32_t >( ticks );
+                    return;
+                }
+
+                for ( ; ticks != 0; --ticks )
+                    tick();
+            }
+
+            void tick()
+            {
+                ++now_;
+
+                const std::uint32_t slot = now_ % slots;
+
+                // move the timers of the next 16 ticks from the second level into the first level
+                if ( slot == 0 )
+                {
+                    for ( std::uint8_t timer = detach( slots + ( now_ / slots ) % slots ); timer != none; )
+                    {
+                        const std::uint8_t next = next_[ timer ];
+                        insert( timer );
+                        timer = next;
+                    }
+                }
+
+                for ( std::uint8_t timer = detach( slot ); timer != none; )
+                {
+                    const std::uint8_t next = next_[ timer ];
+
+                    if ( period_[ timer ] != 0 )
+                    {
+                        expires_[ timer ] = now_ + period_[ timer ];
+                        insert( timer );
+                    }
+                    else
+                    {
+                        --active_;
+                    }
+
+                    Obj.ll_timer_expired( timer );
+                    timer = next;
+                }
+            }
+
+            void apply_requests()
+            {
+                const std::uint32_t pending = bluetoe::details::atomic_exchange( pending_, 0, std::memory_order_acquire );
+
+                for ( std::uint8_t timer = 0; timer != Timers; ++timer )
+                {
+                    if ( ( pending & ( std::uint32_t( 1 ) << timer ) ) == 0 )
+                        continue;
+
+                    if ( location_[ timer ] != none )
+                    {
+                        remove( timer );
+                        --active_;
+                    }
+
+                    const std::uint32_t delay = requested_delay_[ timer ].load( std::memory_order_relaxed );
+
+                    if ( delay != 0 )
+                    {
+                        expires_[ timer ] = now_ + delay;
+                        period_[ timer ]  = requested_period_[ timer ].load( std::memory_order_relaxed );
+                        insert( timer );
+                        ++active_;
+                    }
+                }
+            }
+
+            void insert( std::uint8_t timer )
+            {
+                const std::uint32_t expires = expires_[ timer ];
+                const std::uint32_t delta   = expires - now_;
+
+                // timers, that expire beyond the range of the wheel, are placed into the farthest slot and are
+                // cascaded until they are in range
+                const std::uint8_t location = static_cast< std::uint8_t >(
+                      delta < slots         ? expires % slots
+                    : delta < slots * slots ? slots + ( expires / slots ) % slots
+                    :                         slots + ( now_ / slots + slots - 1 ) % slots );
+
+                next_[ timer ]     = heads_[ location ];
+                heads_[ location ] = timer;
+                location_[ timer ] = location;
+            }
+
+            void remove( std::uint8_t timer )
+            {
+                std::uint8_t* link = &heads_[ location_[ timer ] ];
+
+                while ( *link != timer )
+                    link = &next_[ *link ];
+
+                *link = next_[ timer ];
+                location_[ timer ] = none;
+            }
+
+            std::uint8_t detach( std::uint32_t location )
+            {
+                const std::uint8_t first = heads_[ location ];
+                heads_[ location ] = none;
+
+                for ( std::uint8_t timer = first; timer != none; timer = next_[ timer ] )
+                    location_[ timer ] = none;
+
+                return first;
+            }
+
+            // requests from start_timer() and stop_timer(); a delay of 0 denotes a stop request
+            std::atomic< std::uint32_t >    pending_;
+            std::atomic< std::uint32_t >    requested_delay_[ Timers ];
+            std::atomic< std::uint32_t >    requested_period_[ Timers ];
+
+            // two levels of slots with lists of timers
+            std::uint8_t                    heads_[ 2 * slots ];
+            std::uint8_t                    next_[ Timers ];
+            std::uint8_t                    location_[ Timers ];
+            std::uint32_t                   expires_[ Timers ];
+            std::uint32_t                   period_[ Timers ];
+
+            std::uint32_t                   now_;
+            std::uint32_t                   remainder_us_;
+            std::size_t                     active_;
+            std::uint16_t                   connection_event_counter_;
+            bool                            synchronized_;
+        };
+
+        typedef details::timer_wheel_meta_type meta_type;
+        /** @endcond */
+    };
+
+    /**
+     * @brief no application timers
+     *
+     * This is the default.
+     *
+     * @sa timer_wheel
+     */
+    struct no_timer_wheel
+    {
+        /** @cond HIDDEN_SYMBOLS */
+        template < typename LinkLayer >
+        struct impl {
+            void timer_wheel_new_connection()
+            {
+            }
+
+            void timer_wheel_connection_event( std::uint16_t, std::uint32_t )
+            {
+            }
+        };
+
+        typedef details::timer_wheel_meta_type meta_type;
+        /** @endcond */
+    };
+
+}
+}
+
+#endif
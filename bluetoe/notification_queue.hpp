@@ -7,6 +7,9 @@
 #include <cassert>
 #include <algorithm>
 #include <iterator>
+#include <atomic>
+
+#include <bluetoe/atomic_rmw.hpp>
 
 namespace bluetoe {
 
@@ -33,7 +36,11 @@ namespace bluetoe {
      * @brief class responsible to keep track of those characteristics that have outstanding
      *        notifications or indications.
      *
-     * All operations on the queue must be reentrent / atomic!
+     * queue_notification() and queue_indication() are lock-free and can be called concurrently from
+     * any number of contexts (threads or interrupt handlers of different priorities). The queued entries
+     * are kept in bitmaps of std::atomic words, that are only modified by atomic fetch_or / fetch_and
+     * operations (on ARMv6-M, where these are not lock-free, with interrupts disabled for the duration of the
+     * operation). All other functions have to be called from a single context (usually the link layer).
      *
      * @param Sizes List of number of characteristics that have notifications and / or indications enabled by priorities.
      * @param Mixin a class to be mixed in, to allow empty base class optimizations
@@ -58,6 +65,12 @@ namespace bluetoe {
         template < class ... Args >
         notification_queue( Args... mixin_arguments );
 
+        /** @cond HIDDEN_SYMBOLS */
+        // connection data is reset by assignment; copying must not be concurrent to queueing
+        notification_queue( const notification_queue& other );
+        notification_queue& operator=( const notification_queue& other );
+        /** @endcond */
+
         /**
          * @brief queue the indexed characteristic for notification
          *
@@ -116,7 +129,7 @@ namespace bluetoe {
 
     private:
         using impl = details::notification_queue_impl_base< Sizes, 0 >;
-        std::size_t outstanding_confirmation_index_;
+        std::atomic< std::size_t > outstanding_confirmation_index_;
     };
 
     // impl
@@ -128,6 +141,24 @@ namespace bluetoe {
     {
     }
 
+    template < typename Sizes, class Mixin >
+    notification_queue< Sizes, Mixin >::notification_queue( const notification_queue& other )
+        : Mixin( other )
+        , impl( other )
+        , outstanding_confirmation_index_( other.outstanding_confirmation_index_.load() )
+    {
+    }
+
+    template < typename Sizes, class Mixin >
+    notification_queue< Sizes, Mixin >& notification_queue< Sizes, Mixin >::operator=( const notification_queue& other )
+    {
+        Mixin::operator=( other );
+        impl::operator=( other );
+        outstanding_confirmation_index_ = other.outstanding_confirmation_index_.load();
+
+        return *this;
+    }
+
     template < typename Sizes, class Mixin >
     bool notification_queue< Sizes, Mixin >::queue_notification( std::size_t index )
     {
@@ -149,7 +180,11 @@ namespace bluetoe {
     template < typename Sizes, class Mixin >
     std::pair< details::notification_queue_entry_type, std::size_t > notification_queue< Sizes, Mixin >::dequeue_indication_or_confirmation()
     {
-        const auto result = impl::dequeue_indication_or_confirmation( 0, outstanding_confirmation_index_ );
+        std::size_t outstanding_confirmation = outstanding_confirmation_index_.load();
+        const auto result = impl::dequeue_indication_or_confirmation( 0, outstanding_confirmation );
+
+        if ( result.first == details::notification_queue_entry_type::indication )
+            outstanding_confirmation_index_ = outstanding_confirmation;
 
         return result;
     }
@@ -173,6 +208,21 @@ namespace bluetoe {
                 clear_indications_and_confirmations();
             }
 
+            notification_queue_impl( const notification_queue_impl& other )
+            {
+                *this = other;
+            }
+
+            notification_queue_impl& operator=( const notification_queue_impl& other )
+            {
+                next_ = other.next_;
+
+                for ( std::size_t word = 0; word != sizeof( queue_ ) / sizeof( queue_[ 0 ] ); ++word )
+                    queue_[ word ].store( other.queue_[ word ].load() );
+
+                return *this;
+            }
+
             bool queue_notification( std::size_t index )
             {
                 assert( index < Size );
@@ -196,6 +246,7 @@ namespace bluetoe {
                     ignore_first = false;
                     auto entry = at( i );
 
+                    // only the consumer removes entries, so an entry found, can not vanish before it is removed
                     if ( entry & indication_bit && outstanding_confirmation == no_outstanding_indicaton )
                     {
                         outstanding_confirmation = i + offset;
@@ -218,51 +269,55 @@ namespace bluetoe {
             void clear_indications_and_confirmations()
             {
                 next_ = 0;
-                std::fill( std::begin( queue_ ), std::end( queue_ ), 0 );
+
+                for ( auto& word : queue_ )
+                    word.store( 0 );
             }
 
         private:
-            int at( std::size_t index )
+            using word_t = std::uint32_t;
+
+            static constexpr std::size_t bits_per_characteristc = 2;
+            static constexpr std::size_t bits_per_word          = sizeof( word_t ) * 8;
+
+            int at( std::size_t index ) const
             {
-                const auto bit_offset  = ( index * bits_per_characteristc ) % 8;
-                const auto byte_offset = index * bits_per_characteristc / 8;
-                assert( byte_offset < sizeof( queue_ ) / sizeof( queue_[ 0 ] ) );
+                const auto bit_offset  = ( index * bits_per_characteristc ) % bits_per_word;
+                const auto word_offset = index * bits_per_characteristc / bits_per_word;
+                assert( word_offset < sizeof( queue_ ) / sizeof( queue_[ 0 ] ) );
 
-                return ( queue_[ byte_offset ] >> bit_offset ) & 0x03;
+                return ( queue_[ word_offset ].load( std::memory_order_acquire ) >> bit_offset ) & 0x03;
             }
 
             bool add( std::size_t index, int bits )
             {
                 assert( bits & ( ( 1 << bits_per_characteristc ) -1 ) );
-                const auto bit_offset  = ( index * bits_per_characteristc ) % 8;
-                const auto byte_offset = index * bits_per_characteristc / 8;
-                assert( byte_offset < sizeof( queue_ ) / sizeof( queue_[ 0 ] ) );
+                const auto bit_offset  = ( index * bits_per_characteristc ) % bits_per_word;
+                const auto word_offset = index * bits_per_characteristc / bits_per_word;
+                assert( word_offset < sizeof( queue_ ) / sizeof( queue_[ 0 ] ) );
 
-                const bool result = ( queue_[ byte_offset ] & ( bits << bit_offset ) ) == 0;
-                queue_[ byte_offset ] |= bits << bit_offset;
+                const word_t mask = static_cast< word_t >( bits ) << bit_offset;
 
-                return result;
+                return ( atomic_fetch_or( queue_[ word_offset ], mask, std::memory_order_acq_rel ) & mask ) == 0;
             }
 
             void remove( std::size_t index, int bits )
             {
                 assert( bits & ( ( 1 << bits_per_characteristc ) -1 ) );
-                const auto bit_offset  = ( index * bits_per_characteristc ) % 8;
-                const auto byte_offset = index * bits_per_characteristc / 8;
-                assert( byte_offset < sizeof( queue_ ) / sizeof( queue_[ 0 ] ) );
+                const auto bit_offset  = ( index * bits_per_characteristc ) % bits_per_word;
+                const auto word_offset = index * bits_per_characteristc / bits_per_word;
+                assert( word_offset < sizeof( queue_ ) / sizeof( queue_[ 0 ] ) );
 
-                queue_[ byte_offset ] &= ~( bits << bit_offset );
+                atomic_fetch_and( queue_[ word_offset ], ~( static_cast< word_t >( bits ) << bit_offset ), std::memory_order_acq_rel );
             }
 
-            static constexpr std::size_t bits_per_characteristc = 2;
-
             enum char_bits {
                 notification_bit = 0x01,
                 indication_bit   = 0x02
             };
 
-            std::size_t     next_;
-            std::uint8_t    queue_[ ( Size * bits_per_characteristc + 7 ) / 8 ];
+            std::size_t             next_;
+            std::atomic< word_t >   queue_[ ( Size * bits_per_characteristc + bits_per_word - 1 ) / bits_per_word ];
         };
 
         /**
@@ -277,42 +332,48 @@ namespace bluetoe {
             {
             }
 
+            notification_queue_impl( const notification_queue_impl& other )
+                : state_( other.state_.load() )
+            {
+            }
+
+            notification_queue_impl& operator=( const notification_queue_impl& other )
+            {
+                state_ = other.state_.load();
+
+                return *this;
+            }
+
             bool queue_notification( std::size_t idx )
             {
                 static_cast< void >( idx );
                 assert( idx == 0 );
 
-                const bool result = state_ == notification_queue_entry_type::empty;
-
-                if ( result )
-                    state_ = notification_queue_entry_type::notification;
-
-                return result;
+                return add( notification_queue_entry_type::notification );
             }
 
             bool queue_indication( std::size_t idx )
             {
                 static_cast< void >( idx );
                 assert( idx == 0 );
-                const bool result = state_ == notification_queue_entry_type::empty;
-
-                if ( result )
-                    state_ = notification_queue_entry_type::indication;
 
-                return result;
+                return add( notification_queue_entry_type::indication );
             }
 
             std::pair< notification_queue_entry_type, std::size_t > dequeue_indication_or_confirmation( std::size_t offset, std::size_t& outstanding_confirmation )
             {
-                const auto result = state_ == notification_queue_entry_type::notification || ( state_ == notification_queue_entry_type::indication && outstanding_confirmation == details::no_outstanding_indicaton )
-                    ? std::pair< notification_queue_entry_type, std::size_t >{ static_cast< notification_queue_entry_type >( state_ ), offset }
+                // only the consumer changes a non-empty state
+                const notification_queue_entry_type state = state_.load( std::memory_order_acquire );
+
+                const auto result = state == notification_queue_entry_type::notification || ( state == notification_queue_entry_type::indication && outstanding_confirmation == details::no_outstanding_indicaton )
+                    ? std::pair< notification_queue_entry_type, std::size_t >{ state, offset }
                     : std::pair< notification_queue_entry_type, std::size_t >{ notification_queue_entry_type::empty, 0 };
 
                 if ( result.first == notification_queue_entry_type::indication )
                     outstanding_confirmation = offset;
 
                 if ( result.first != notification_queue_entry_type::empty )
-                    state_ = notification_queue_entry_type::empty;
+                    state_.store( notification_queue_entry_type::empty, std::memory_order_release );
 
                 return result;
             }
@@ -322,7 +383,14 @@ namespace bluetoe {
                 state_ = notification_queue_entry_type::empty;
             }
         private:
-            notification_queue_entry_type state_;
+            bool add( notification_queue_entry_type type )
+            {
+                notification_queue_entry_type expected = notification_queue_entry_type::empty;
+
+                return atomic_compare_exchange( state_, expected, type, std::memory_order_acq_rel );
+            }
+
+            std::atomic< notification_queue_entry_type > state_;
         };
 
         template < int C >
@@ -0,0 +1,285 @@
+#ifndef BLUETOE_NOTIFICATION_RATE_LIMIT_HPP
+#define BLUETOE_NOTIFICATION_RATE_LIMIT_HPP
+
+#include <bluetoe/meta_tools.hpp>
+#include <bluetoe/meta_types.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+namespace bluetoe {
+
+    namespace details {
+        struct notification_rate_limit_meta_type {};
+
+        // upper limit for intervals and windows; the time base is kept in µs and wraps after about 71 minutes
+        static constexpr std::uint32_t maximum_notification_rate_limit_ms = 1800000;
+    }
+
+    /**
+     * @brief limits the rate at which notifications of a characteristic are sent
+     *
+     * By default, a notification is sent at the next connection event after server::notify() was called.
+     * Multiple calls to notify() before the notification was sent, result in a single notification, but
+     * there is no pacing: a producer that calls notify() at a high rate, gets a notification sent
+     * at every connection event and shares the available bandwidth with all other characteristics.
+     *
+     * With this option, a notification of the characteristic is held back:
+     * - until MinimumInterval milliseconds passed since the last notification of the characteristic
+     *   was sent, and
+     * - until CoalescingWindow milliseconds passed since the notification was first found pending.
+     *
+     * All calls to notify() while the notification is held back, result in a single notification that
+     * carries the value of the characteristic at the time the notification is sent. While held back,
+     * a notification does not occupy any link layer buffer, so notifications of other characteristics
+     * are sent in the meantime.
+     *
+     * The time base is the connection event counter of the link layer and the current connection interval.
+     * Held notifications are released at the first connection event after their time came. Indications
+     * are not affected.
+     *
+     * A released notification does not cancel peripheral latency: if the link layer skips connection events,
+     * the notification is sent at the next connection event, the link layer takes part in. So with a peripheral
+     * latency of N, a held notification can be sent up to N connection intervals after its time came.
+     *
+     * Example
+     * @code
+    std::int16_t acceleration[ 3 ] = { 0 };
+
+    using server = bluetoe::server<
+        bluetoe::service<
+            service_uuid,
+            // the sensor updates at 1kHz; notify at most every 100ms and collect updates for 20ms
+            bluetoe::characteristic<
+                acceleration_uuid,
+                bluetoe::bind_characteristic_value< decltype( acceleration ), &acceleration >,
+                bluetoe::notify,
+                bluetoe::notification_rate_limit< 100, 20 >
+            >
+        >
+    >;
+     * @endcode
+     *
+     * @sa notify
+     * @sa characteristic
+     * @sa server::connection_data::notification_time_base
+     */
+    template < std::uint32_t MinimumInterval, std::uint32_t CoalescingWindow = 0 >
+    struct notification_rate_limit
+    {
+        static_assert( MinimumInterval > 0 || CoalescingWindow > 0, "a notification rate limit without interval and window has no effect" );
+        static_assert( MinimumInterval < details::maximum_notification_rate_limit_ms && CoalescingWindow < details::maximum_notification_rate_limit_ms,
+            "notification rate limits have to be shorter than 30 minutes" );
+
+        /** @cond HIDDEN_SYMBOLS */
+        static constexpr std::uint32_t minimum_interval_ms  = MinimumInterval;
+        static constexpr std::uint32_t coalescing_window_ms = CoalescingWindow;
+
+        struct meta_type :
+            details::notification_rate_limit_meta_type,
+            details::valid_characteristic_option_meta_type {};
+        /** @endcond */
+    };
+
+    namespace details {
+        /*
+         * default for characteristics without notification_rate_limit<>
+         */
+        struct no_notification_rate_limit
+        {
+            static constexpr std::uint32_t minimum_interval_ms  = 0;
+            static constexpr std::uint32_t coalescing_window_ms = 0;
+
+            struct meta_type :
+                details::notification_rate_limit_meta_type,
+                details::valid_characteristic_option_meta_type {};
+        };
+
+        template < typename ... Options >
+        struct notification_rate
+        {
+            static_assert( std::tuple_size< typename find_all_by_meta_type< notification_rate_limit_meta_type, Options... >::type >::value <= 1,
+                "Only one notification_rate_limit<> per characteristic allowed!" );
+
+            using limit = typename find_by_meta_type< notification_rate_limit_meta_type, Options..., no_notification_rate_limit >::type;
+
+            static constexpr std::uint32_t minimum_interval_ms  = limit::minimum_interval_ms;
+            static constexpr std::uint32_t coalescing_window_ms = limit::coalescing_window_ms;
+        };
+
+        /*
+         * rate limit of a single characteristic, as found by the index of its value attribute
+         */
+        struct notification_rate_limit_data
+        {
+            std::size_t     slot;
+            std::uint32_t   minimum_interval_ms;
+            std::uint32_t   coalescing_window_ms;
+        };
+
+        /*
+         * per connection state of all characteristics with notification_rate_limit<>
+         */
+        template < std::size_t Size >
+        class notification_rate_limits
+        {
+        public:
+            notification_rate_limits()
+                : now_( 0 )
+                , connection_event_counter_( 0 )
+            {
+            }
+
+            /**
+             * @brief advances the time base of notification rate limits to the given connection event
+             *
+             * To be called by the link layer, before outgoing data is collected at the end of a connection
+             * event. Time elapses with the number of connection events since the last call, multiplied
+             * by the given connection interval.
+             *
+             * @sa notification_rate_limit
+             */
+            void notification_time_base( std::uint16_t connection_event_counter, std::uint32_t connection_interval_us )
+            {
+                now_ += static_cast< std::uint16_t >( connection_event_counter - connection_event_counter_ ) * connection_interval_us;
+                connection_event_counter_ = connection_event_counter;
+
+                // Once a notification was sent longer ago than any interval, the point in time is not relevant anymore.
+                // Forget it, before the distance to now_ wraps and the notification would look like recently sent.
+                for ( slot& s : slots_ )
+                {
+                    if ( s.sent && now_ - s.last_sent >= maximum_notification_rate_limit_ms * 1000 )
+                        s.sent = false;
+                }
+            }
+
+            /*
+             * queues all held notifications, that are due by now
+             */
+            template < class Queue >
+            void release_due_notifications( Queue& queue )
+            {
+                for ( slot& s : slots_ )
+                {
+                    if ( s.state == held && due( s.due ) )
+                    {
+                        s.state = released;
+                        queue.queue_notification( s.cccd_index );
+                    }
+                }
+            }
+
+            /*
+             * returns true, if a notification for the given characteristic can be sent now. Otherwise, the
+             * notification is held back until it is released by release_due_notifications().
+             */
+            bool notification_due( const notification_rate_limit_data& limit, std::size_t cccd_index )
+            {
+                if ( limit.slot >= Size )
+                    return true;
+
+                slot& s = slots_[ limit.slot ];
+
+                if ( s.state == released )
+                    return true;
+
+                if ( s.state == idle )
+                {
+                    const std::uint32_t elapsed  = now_ - s.last_sent;
+                    const std::uint32_t interval = limit.minimum_interval_ms * 1000;
+                    const std::uint32_t wait     = s.sent && elapsed < interval
+                        ? std::max( interval - elapsed, limit.coalescing_window_ms * 1000 )
+                        : limit.coalescing_window_ms * 1000;
+
+                    if ( wait == 0 )
+                        return true;
+
+                    s.due        = now_ + wait;
+                    s.cccd_index = cccd_index;
+                    s.state      = held;
+                }
+
+                return false;
+            }
+
+            /*
+             * to be called, when a notification for the given characteristic was sent, or dropped
+             */
+            void notification_done( const notification_rate_limit_data& limit, bool sent )
+            {
+                if ( limit.slot >= Size )
+                    return;
+
+                slot& s = slots_[ limit.slot ];
+                s.state = idle;
+
+                if ( sent )
+                {
+                    s.sent      = true;
+                    s.last_sent = now_;
+                }
+            }
+
+        private:
+            enum slot_state : std::uint8_t {
+                idle,
+                held,
+                released
+            };
+
+            struct slot
+            {
+                slot()
+                    : due( 0 )
+                    , last_sent( 0 )
+                    , cccd_index( 0 )
+                    , state( idle )
+                    , sent( false )
+                {
+                }
+
+                std::uint32_t   due;
+                std::uint32_t   last_sent;
+                std::size_t     cccd_index;
+                slot_state      state;
+                bool            sent;
+            };
+
+            // true, if the given point in time is not in the future; the time base wraps
+            bool due( std::uint32_t time ) const
+            {
+                return static_cast< std::int32_t >( time - now_ ) <= 0;
+            }
+
+            slot            slots_[ Size ];
+            std::uint32_t   now_;
+            std::uint16_t   connection_event_counter_;
+        };
+
+        template <>
+        class notification_rate_limits< 0 >
+        {
+        public:
+            void notification_time_base( std::uint16_t, std::uint32_t )
+            {
+            }
+
+            template < class Queue >
+            void release_due_notifications( Queue& )
+            {
+            }
+
+            bool notification_due( const notification_rate_limit_data&, std::size_t )
+            {
+                return true;
+            }
+
+            void notification_done( const notification_rate_limit_data&, bool )
+            {
+            }
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,226 @@
+#ifndef BLUETOE_READ_BLOB_SNAPSHOT_HPP
+#define BLUETOE_READ_BLOB_SNAPSHOT_HPP
+
+#include <bluetoe/meta_types.hpp>
+#include <bluetoe/attribute.hpp>
+#include <bluetoe/atomic_rmw.hpp>
+#include <bluetoe/pairing_status.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+namespace bluetoe {
+
+    namespace details {
+        struct read_blob_snapshot_meta_type {};
+    }
+
+    /**
+     * @brief keeps a per connection snapshot of the last read characteristic value, to serve Read Blob Requests
+     *
+     * A client reads a value that does not fit into a single ATT PDU, with a Read Request (or a Read Blob Request with
+     * offset 0), followed by Read Blob Requests with increasing offsets. Without a snapshot, every request results
+     * in a call to the read handler of the characteristic. If the value is computed by the handler (for example a
+     * serialized report), it is computed once per PDU, and the parts sent to the client can stem from different
+     * versions of the value.
+     *
+     * With this option, the value read at offset 0 is copied into a per connection buffer of S octets. Subsequent
+     * Read Blob Requests to the same handle are served from that buffer, until:
+     * - an other handle is read,
+     * - an attribute is written by a client,
+     * - server::notify() or server::indicate() is called,
+     * - server::invalidate_read_blob_snapshots() is called, or
+     * - the security of the connection changed (encryption or pairing status).
+     *
+     * If an application changes a value without notifying it, it has to call server::invalidate_read_blob_snapshots()
+     * to make sure, that clients do not read an outdated value. Values larger than S octets are not buffered and
+     * are read, as if this option was not given.
+     *
+     * @sa server
+     * @sa free_read_blob_handler
+     *
+     * example:
+     * @code
+    typedef bluetoe::server<
+        bluetoe::read_blob_snapshot< 200 >,
+    ...
+    > report_server;
+     * @endcode
+     */
+    template < std::uint16_t S >
+    struct read_blob_snapshot {
+        static_assert( S > 0, "a read blob snapshot needs a buffer" );
+
+        /** @cond HIDDEN_SYMBOLS */
+        struct meta_type :
+            details::read_blob_snapshot_meta_type,
+            details::valid_server_option_meta_type {};
+
+        static constexpr std::uint16_t snapshot_size = S;
+        /** @endcond */
+    };
+
+namespace details {
+
+    /*
+     * default, if no read_blob_snapshot<> is given
+     */
+    struct no_read_blob_snapshot {
+        struct meta_type :
+            details::read_blob_snapshot_meta_type,
+            details::valid_server_option_meta_type {};
+
+        static constexpr std::uint16_t snapshot_size = 0;
+    };
+
+    /*
+     * Server part of the snapshot: a generation counter, that is incremented, when ever a value might have changed.
+     * All snapshots taken before are outdated then. Can be changed from an interrupt handler.
+     */
+    template < std::size_t Size >
+    class read_blob_snapshot_generation
+    {
+    public:
+        read_blob_snapshot_generation()
+            : generation_( 0 )
+        {
+        }
+
+        void read_blob_snapshot_value_changed()
+        {
+            details::atomic_fetch_add( generation_, 1, std::memory_order_relaxed );
+        }
+
+        std::uint32_t read_blob_snapshot_current_generation() const
+        {
+            return generation_.load( std::memory_order_relaxed );
+        }
+
+    private:
+        std::atomic< std::uint32_t > generation_;
+    };
+
+    template <>
+    class read_blob_snapshot_generation< 0 >
+    {
+    public:
+        void read_blob_snapshot_value_changed()
+        {
+        }
+
+        std::uint32_t read_blob_snapshot_current_generation() const
+        {
+            return 0;
+        }
+    };
+
+    /*
+     * Per connection part of the snapshot; the server's connection data derives from this type.
+     *
+     * Access is a function object with the signature:
+     *   attribute_access_result( std::uint8_t* buffer, std::size_t buffer_size, std::size_t offset, std::size_t& read_size )
+     * that performs the actual read of the attribute, including all access and security checks. As the snapshot
+     * is only used with the security attributes of the connection, that were in effect, when the snapshot was taken,
+     * the checks do not have to be repeated, when serving from the snapshot.
+     */
+    template < std::size_t Size >
+    class read_blob_snapshot_client
+    {
+    public:
+        read_blob_snapshot_client()
+            : handle_( 0 )
+            , size_( 0 )
+            , generation_( 0 )
+        {
+        }
+
+        template < class Access >
+        attribute_access_result read_blob_snapshot_read( std::uint16_t handle, std::uint32_t generation, std::size_t offset,
+            const connection_security_attributes& security, std::uint8_t* buffer, std::size_t& buffer_size, Access access )
+        {
+            if ( offset != 0 && handle == handle_ && generation == generation_
+              && security.is_encrypted == security_.is_encrypted && security.pairing_status == security_.pairing_status )
+                return copy_snapshot( offset, buffer, buffer_size );
+
+            handle_ = 0;
+
+            if ( offset != 0 )
+                return access( buffer, buffer_size, offset, buffer_size );
+
+            // the handler is called only once: if the output is larger than the snapshot, the value is read directly
+            // into the output and copied into the snapshot, if it is complete and fits.
+            if ( buffer_size > Size )
+            {
+                const attribute_access_result rc = access( buffer, buffer_size, 0, buffer_size );
+
+                if ( rc == attribute_access_result::success && buffer_size <= Size )
+                {
+                    std::copy( buffer, buffer + buffer_size, &snapshot_[ 0 ] );
+                    take_snapshot( handle, generation, security, buffer_size );
+                }
+
+                return rc;
+            }
+
+            // one octet more than the snapshot size, to detect values that do not fit
+            std::size_t size = 0;
+            const attribute_access_result rc = access( snapshot_, Size + 1, 0, size );
+
+            if ( rc != attribute_access_result::success )
+                return rc;
+
+            // if the value does not fit, it is larger than the output, so the output is served from the octets read
+            if ( size <= Size )
+                take_snapshot( handle, generation, security, size );
+
+            buffer_size = std::min( buffer_size, size );
+            std::copy( &snapshot_[ 0 ], &snapshot_[ buffer_size ], buffer );
+
+            return attribute_access_result::success;
+        }
+
+    private:
+        void take_snapshot( std::uint16_t handle, std::uint32_t generation, const connection_security_attributes& security, std::size_t size )
+        {
+            handle_     = handle;
+            size_       = static_cast< std::uint16_t >( size );
+            generation_ = generation;
+            security_   = security;
+        }
+
+        attribute_access_result copy_snapshot( std::size_t offset, std::uint8_t* buffer, std::size_t& buffer_size ) const
+        {
+            if ( offset > size_ )
+                return attribute_access_result::invalid_offset;
+
+            buffer_size = std::min< std::size_t >( buffer_size, size_ - offset );
+            std::copy( &snapshot_[ offset ], &snapshot_[ offset + buffer_size ], buffer );
+
+            return attribute_access_result::success;
+        }
+
+        // a handle of 0 denotes an empty snapshot
+        std::uint16_t                   handle_;
+        std::uint16_t                   size_;
+        std::uint32_t                   generation_;
+        connection_security_attributes  security_;
+        std::uint8_t                    snapshot_[ Size + 1 ];
+    };
+
+    template <>
+    class read_blob_snapshot_client< 0 >
+    {
+    public:
+        template < class Access >
+        attribute_access_result read_blob_snapshot_read( std::uint16_t, std::uint32_t, std::size_t offset,
+            const connection_security_attributes&, std::uint8_t* buffer, std::size_t& buffer_size, Access access )
+        {
+            return access( buffer, buffer_size, offset, buffer_size );
+        }
+    };
+}
+}
+
+#endif
@@ -0,0 +1,212 @@
+#ifndef BLUETOE_SEQLOCK_VALUE_HPP
+#define BLUETOE_SEQLOCK_VALUE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+namespace bluetoe {
+
+    /**
+     * @brief a characteristic value, that can be updated by the application, while the server reads it from a
+     *        different context, without the server ever observing a torn value.
+     *
+     * If bind_characteristic_value<> binds a multi-byte value, that is updated from an interrupt handler or an other
+     * thread, an ATT read or a notification could observe a value, that is partly old and partly new. A seqlock_value
+     * guards the value by a sequence counter. The value is kept in two copies: While the writer updates one copy, readers
+     * use the other one. A reader retries, only if a writer completed an update, while the reader was copying the value.
+     * So neither the writer, nor a reader that interrupts the writer, is ever blocked.
+     *
+     * A seqlock_value is bound to a characteristic by bind_characteristic_value<>, like any other variable. To update the
+     * value and to queue a notification or indication in one call, use server::update_and_notify() or
+     * server::update_and_indicate().
+     *
+     * There must be only one writer at a time. If a client can write the characteristic, the application must not
+     * update the value concurrently.
+     *
+     * Example
+     * @code
+    struct acceleration_t {
+        std::int16_t x, y, z;
+    };
+
+    bluetoe::seqlock_value< acceleration_t > acceleration;
+
+    using gatt = bluetoe::server<
+        bluetoe::service<
+            service_uuid,
+            bluetoe::characteristic<
+                acceleration_uuid,
+                bluetoe::bind_characteristic_value< decltype( acceleration ), &acceleration >,
+                bluetoe::no_write_access,
+                bluetoe::notify
+            >
+        >
+    >;
+
+    gatt server;
+
+    // called from the sensor interrupt handler
+    void sensor_isr( const acceleration_t& value )
+    {
+        server.update_and_notify( acceleration, value );
+    }
+     * @endcode
+     *
+     * @sa bind_characteristic_value
+     * @sa server::update_and_notify
+     * @sa server::update_and_indicate
+     */
+    template < typename T >
+    class seqlock_value
+    {
+    public:
+        static_assert( std::is_trivially_copyable< T >::value, "seqlock_value<> requires a trivially copyable type" );
+
+        /**
+         * @brief the value type
+         */
+        using value_type = T;
+
+        /**
+         * @brief the size of the value in octets
+         */
+        static constexpr std::size_t size = sizeof( T );
+
+        /**
+         * @brief a value initialized with all bytes being zero
+         */
+        seqlock_value();
+
+        /**
+         * @brief a value initialized with the given value
+         */
+        explicit seqlock_value( const T& initial );
+
+        /**
+         * @brief updates the value
+         *
+         * @pre there is no concurrent call to store() or write()
+         */
+        void store( const T& value );
+
+        /**
+         * @brief returns a consistent copy of the value
+         */
+        T load() const;
+
+        /**
+         * @brief copies a consistent snapshot of the in memory representation of the value (in the byte order of
+         *        the target) to the given buffer
+         *
+         * The buffer has to be at least size octets large.
+         */
+        void snapshot( std::uint8_t* buffer ) const;
+
+        /**
+         * @brief replaces the octets starting at offset with the given octets
+         *
+         * Used by the server to apply writes from a client.
+         *
+         * @pre offset + length <= size
+         * @pre there is no concurrent call to store() or write()
+         */
+        void write( std::size_t offset, const std::uint8_t* octets, std::size_t length );
+
+    private:
+        void store_octets( const std::uint8_t* octets );
+        void copy_to( std::uint8_t* buffer, std::size_t copy ) const;
+
+        // odd sequence: copy 0 is being written, readers use copy 1
+        std::atomic< std::uint32_t >    sequence_;
+        std::atomic< std::uint8_t >     copies_[ 2 ][ size ];
+    };
+
+    // implementation
+    /** @cond HIDDEN_SYMBOLS */
+    template < typename T >
+    seqlock_value< T >::seqlock_value()
+        : sequence_( 0 )
+    {
+        for ( auto& copy : copies_ )
+            for ( auto& octet : copy )
+                octet.store( 0, std::memory_order_relaxed );
+    }
+
+    template < typename T >
+    seqlock_value< T >::seqlock_value( const T& initial )
+        : seqlock_value()
+    {
+        store( initial );
+    }
+
+    template < typename T >
+    void seqlock_value< T >::store( const T& value )
+    {
+        store_octets( static_cast< const std::uint8_t* >( static_cast< const void* >( &value ) ) );
+    }
+
+    template < typename T >
+    T seqlock_value< T >::load() const
+    {
+        T result;
+        snapshot( static_cast< std::uint8_t* >( static_cast< void* >( &result ) ) );
+
+        return result;
+    }
+
+    template < typename T >
+    void seqlock_value< T >::snapshot( std::uint8_t* buffer ) const
+    {
+        for ( ;; )
+        {
+            const std::uint32_t sequence = sequence_.load( std::memory_order_acquire );
+
+            copy_to( buffer, sequence & 1 );
+
+            // retry, if the copy was changed, while being copied
+            if ( sequence_.load( std::memory_order_relaxed ) == sequence )
+                return;
+        }
+    }
+
+    template < typename T >
+    void seqlock_value< T >::write( std::size_t offset, const std::uint8_t* octets, std::size_t length )
+    {
+        // as the only writer, copy 0 is always consistent, when there is no write in progress
+        std::uint8_t value[ size ];
+        copy_to( value, 0 );
+
+        for ( std::size_t i = 0; i != length; ++i )
+            value[ offset + i ] = octets[ i ];
+
+        store_octets( value );
+    }
+
+    template < typename T >
+    void seqlock_value< T >::store_octets( const std::uint8_t* octets )
+    {
+        const std::uint32_t sequence = sequence_.load( std::memory_order_relaxed );
+
+        for ( std::size_t copy = 0; copy != 2; ++copy )
+        {
+            // redirect readers to the other copy, that was completely written, before this copy is changed
+            sequence_.store( sequence + copy + 1, std::memory_order_release );
+
+            // a reader, that observes a changed octet, is guaranteed to observe the changed sequence, too
+            for ( std::size_t i = 0; i != size; ++i )
+                copies_[ copy ][ i ].store( octets[ i ], std::memory_order_release );
+        }
+    }
+
+    template < typename T >
+    void seqlock_value< T >::copy_to( std::uint8_t* buffer, std::size_t copy ) const
+    {
+        for ( std::size_t i = 0; i != size; ++i )
+            buffer[ i ] = copies_[ copy ][ i ].load( std::memory_order_acquire );
+    }
+    /** @endcond */
+}
+
+#endif
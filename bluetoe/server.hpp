@@ -21,6 +21,11 @@
 #include <bluetoe/attribute_handle.hpp>
 #include <bluetoe/l2cap_channels.hpp>
 #include <bluetoe/notification_queue.hpp>
+#include <bluetoe/unchanged_notifications.hpp>
+#include <bluetoe/notification_rate_limit.hpp>
+#include <bluetoe/seqlock_value.hpp>
+#include <bluetoe/read_blob_snapshot.hpp>
+#include <bluetoe/write_command_burst.hpp>
 #include <bluetoe/custom_advertising.hpp>
 
 #include <cstdint>
@@ -47,6 +52,22 @@ namespace bluetoe {
                         Options...,
                         auto_scan_response_data
                     >::type;
+
+        template < typename ... Options >
+        using selected_read_blob_snapshot =
+            typename details::find_by_meta_type<
+                        details::read_blob_snapshot_meta_type,
+                        Options...,
+                        no_read_blob_snapshot
+                    >::type;
+
+        template < typename ... Options >
+        using selected_write_command_burst_buffer =
+            typename details::find_by_meta_type<
+                        details::write_command_burst_buffer_meta_type,
+                        Options...,
+                        no_write_command_burst_buffer
+                    >::type;
     }
 
     /**
@@ -70,15 +91,19 @@ namespace bluetoe {
      * @endcode
      * @sa service
      * @sa shared_write_queue
+     * @sa pooled_write_queue
      * @sa extend_server
      * @sa server_name
      * @sa appearance
      * @sa requires_encryption
      * @sa max_mtu_size
+     * @sa read_blob_snapshot
+     * @sa write_command_burst_buffer
      */
     template < typename ... Options >
     class server
         : private details::write_queue< typename details::find_by_meta_type< details::write_queue_meta_type, Options... >::type >
+        , private details::read_blob_snapshot_generation< details::selected_read_blob_snapshot< Options... >::snapshot_size >
         , public details::derive_from< typename details::collect_mixins< Options... >::type >
         , public details::selected_advertising_data_source< Options ... >
         , public details::selected_scan_response_data_source< Options ... >
@@ -105,6 +130,19 @@ namespace bluetoe {
 
         using cccd_indices = typename details::find_notification_data_in_list< notification_priority, services >::cccd_indices;
 
+        using notification_digests = details::notification_digests<
+            details::find_notification_data_in_list< notification_priority, services >::number_of_notification_digests >;
+
+        using notification_rate_limits = details::notification_rate_limits<
+            details::find_notification_data_in_list< notification_priority, services >::number_of_notification_rate_limits >;
+
+        using read_blob_snapshot_client = details::read_blob_snapshot_client<
+            details::selected_read_blob_snapshot< Options... >::snapshot_size >;
+
+        using write_command_burst_client = details::write_command_burst_client<
+            details::selected_write_command_burst_buffer< Options... >::buffer_size,
+            details::selected_write_command_burst_buffer< Options... >::number_of_writes >;
+
         using server_t       = server< Options... >;
         using handle_mapping = details::handle_index_mapping< server_t >;
 
@@ -119,10 +157,19 @@ namespace bluetoe {
          */
         class connection_data
             : public details::client_characteristic_configurations< number_of_client_configs >
+            , public details::write_queue_client< write_queue_type >
+            , public notification_digests
+            , public notification_rate_limits
+            , public read_blob_snapshot_client
+            , public write_command_burst_client
         {
         public:
             connection_data()
                 : client_mtu_( details::default_att_mtu_size )
+                , stream_handle_( 0 )
+                , stream_opcode_( 0 )
+                , stream_offset_( 0 )
+                , stream_error_( 0 )
             {
             }
 
@@ -168,7 +215,15 @@ namespace bluetoe {
 
 
         private:
+            friend class server;
+
             std::uint16_t               client_mtu_;
+
+            // state of a write, that is received as stream of L2CAP fragments; a handle of 0 denotes no stream
+            std::uint16_t               stream_handle_;
+            std::uint8_t                stream_opcode_;
+            std::uint16_t               stream_offset_;
+            std::uint8_t                stream_error_;
         };
 
         /**
@@ -179,13 +234,15 @@ namespace bluetoe {
         /**
          * @brief notifies all connected clients about this value
          *
-         * There is no check whether there was actual a change to the value or not. It's safe to call this function from a different
+         * There is no check whether there was actual a change to the value or not, unless the characteristic<> was given
+         * the suppress_unchanged_notifications parameter. It's safe to call this function from a different
          * thread or from an interrupt service routine. But there is a check whether or not clients enabled notifications.
          *
          * The characteristic<> must have been given the notify parameter.
          *
          * @sa notify
          * @sa characteristic
+         * @sa suppress_unchanged_notifications
          *
          * Example:
          @code
@@ -273,6 +330,59 @@ namespace bluetoe {
         template < class CharacteristicUUID >
         bool indicate();
 
+        /**
+         * @brief updates a bound seqlock_value<> and queues a notification of the characteristic in one call
+         *
+         * Example:
+         @code
+        bluetoe::seqlock_value< std::int32_t > temperature;
+
+        typedef bluetoe::server<
+            bluetoe::service_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CA9 >,
+            bluetoe::characteristic<
+                bluetoe::bind_characteristic_value< decltype( temperature ), &temperature >,
+                bluetoe::notify
+            >
+        > temperature_service;
+
+        temperature_service server;
+
+        void temperature_isr( std::int32_t value )
+        {
+            server.update_and_notify( temperature, value );
+        }
+        @endcode
+
+         * @return the result of notify()
+         *
+         * @sa seqlock_value
+         * @sa notify
+         */
+        template < class T >
+        bool update_and_notify( seqlock_value< T >& value, const T& new_value );
+
+        /**
+         * @brief updates a bound seqlock_value<> and queues an indication of the characteristic in one call
+         *
+         * @return the result of indicate()
+         *
+         * @sa seqlock_value
+         * @sa indicate
+         */
+        template < class T >
+        bool update_and_indicate( seqlock_value< T >& value, const T& new_value );
+
+        /**
+         * @brief discards the read blob snapshots of all connections
+         *
+         * To be called, if the application changed a characteristic value without calling notify() or indicate().
+         * Without a read_blob_snapshot<> option, the function does nothing. It's safe to call this function from a
+         * different thread or from an interrupt service routine.
+         *
+         * @sa read_blob_snapshot
+         */
+        void invalidate_read_blob_snapshots();
+
         /**
          * @brief returns true, if the given connection is configured to send indications for the given characteristic
          */
@@ -302,6 +412,26 @@ namespace bluetoe {
         template < typename ConnectionData >
         void l2cap_output( std::uint8_t*, std::size_t& out_size, ConnectionData& );
 
+        /**
+         * @brief optional streaming interface of a l2cap channel
+         *
+         * Write Requests and Write Commands to characteristics with prepared_write_through<> are streamed
+         * to the characteristic, without being defragmented first.
+         */
+        template < typename ConnectionData >
+        bool l2cap_input_stream_start( const std::uint8_t* input, std::size_t in_size, std::size_t sdu_size, ConnectionData& );
+
+        template < typename ConnectionData >
+        void l2cap_input_stream( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& );
+
+        /**
+         * @brief passes all collected write commands to their free_write_command_burst_handler
+         *
+         * Called by the L2CAP layer at the end of every connection event.
+         */
+        template < typename ConnectionData >
+        void l2cap_input_flush( ConnectionData& );
+
         /**
          * @brief returns the advertising data to the L2CAP implementation
          */
@@ -329,6 +459,19 @@ namespace bluetoe {
          */
         void notification_callback( lcap_notification_callback_t, void* usr_arg );
 
+        /** @cond HIDDEN_SYMBOLS */
+        /*
+         * true, if at least one characteristic defines a maximum_delivery_latency<>
+         */
+        static constexpr bool has_delivery_latencies =
+            details::find_notification_data_in_list< notification_priority, services >::has_delivery_latencies;
+
+        /*
+         * maximum delivery latency in ms of the notified or indicated characteristic; 0 for unbounded
+         */
+        static std::uint32_t delivery_latency( const details::notification_data& item );
+        /** @endcond */
+
         /**
          * @attention this function must be called with every client that got disconnected.
          */
@@ -391,6 +534,8 @@ namespace bluetoe {
         void handle_read_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& );
         template < typename ConnectionData >
         void handle_read_blob_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& );
+        template < typename ConnectionData >
+        details::attribute_access_result read_through_snapshot( std::uint16_t handle, std::size_t index, std::size_t offset, std::uint8_t* output, std::size_t& out_size, ConnectionData& );
         void handle_read_by_group_type_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size );
         template < typename ConnectionData >
         void handle_read_multiple_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& );
@@ -399,6 +544,15 @@ namespace bluetoe {
         template < typename ConnectionData >
         void handle_write_command( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& );
 
+        template < typename ConnectionData >
+        details::attribute_access_result end_write_through( bool commit, std::size_t index, ConnectionData& );
+        template < typename ConnectionData >
+        void write_stream_fragment( const std::uint8_t* input, std::size_t in_size, ConnectionData& );
+        template < typename ConnectionData >
+        void abort_write_stream( ConnectionData& );
+        template < typename ConnectionData >
+        bool collect_write_command( std::size_t index, const std::uint8_t* input, std::size_t in_size, ConnectionData& );
+
         template < typename Connection >
         void handle_prepair_write_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, Connection&, const details::no_such_type& );
         template < typename Connection, typename WriteQueue >
@@ -407,6 +561,29 @@ namespace bluetoe {
         void handle_execute_write_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, Connection&, const details::no_such_type& );
         template < typename Connection, typename WriteQueue >
         void handle_execute_write_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, Connection&, const WriteQueue& );
+
+        // a queue element, that contains only a handle, denotes fragments that where written through
+        static constexpr std::size_t write_through_element_size = 2;
+
+        template < typename Connection >
+        bool write_through_queued( std::uint16_t handle, Connection& );
+        template < typename Connection >
+        void rollback_write_through_from( std::pair< std::uint8_t*, std::size_t > queue, Connection& );
+        template < typename Connection >
+        void rollback_write_through( Connection&, const details::no_such_type& );
+        template < typename Connection, typename WriteQueue >
+        void rollback_write_through( Connection&, const WriteQueue& );
+
+        // the write handlers of characteristics with prepared_write_through<> have a single staging area, so only
+        // one client at a time is allowed to have written through fragments, that are not committed or rolled back.
+        template < typename Connection >
+        bool acquire_write_through( Connection& );
+        template < typename Connection >
+        void release_write_through( Connection& );
+        template < typename Connection >
+        bool write_through_prepared( Connection&, const details::no_such_type& );
+        template < typename Connection, typename WriteQueue >
+        bool write_through_prepared( Connection&, const WriteQueue& );
         void handle_value_confirmation( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, connection_data& );
 
         template < class Iterator, class Filter = details::all_uuid_filter >
@@ -435,6 +612,7 @@ namespace bluetoe {
         // data
         lcap_notification_callback_t l2cap_cb_;
         void*                        l2cap_arg_;
+        const void*                  write_through_client_;
 
         static_assert(
             std::is_same<
@@ -491,6 +669,7 @@ namespace bluetoe {
     template < typename ... Options >
     server< Options... >::server()
         : l2cap_cb_( nullptr )
+        , write_through_client_( nullptr )
     {
 
     }
@@ -505,8 +684,15 @@ namespace bluetoe {
         assert( in_size != 0 );
         assert( out_size >= details::default_att_mtu_size );
 
+        // a stream, that was not completed, is ended by the next PDU
+        abort_write_stream( connection );
+
         const details::att_opcodes opcode = static_cast< details::att_opcodes >( input[ 0 ] );
 
+        // collected write commands become effective, before any other request is handled
+        if ( opcode != details::att_opcodes::write_command )
+            l2cap_input_flush( connection );
+
         switch ( opcode )
         {
         // do not respond to an error response:
@@ -539,15 +725,18 @@ namespace bluetoe {
             handle_read_multiple_request( input, in_size, output, out_size, connection );
             break;
         case details::att_opcodes::write_request:
+            this->read_blob_snapshot_value_changed();
             handle_write_request( input, in_size, output, out_size, connection );
             break;
         case details::att_opcodes::write_command:
+            this->read_blob_snapshot_value_changed();
             handle_write_command( input, in_size, output, out_size, connection );
             break;
         case details::att_opcodes::prepare_write_request:
             handle_prepair_write_request( input, in_size, output, out_size, connection, write_queue_type() );
             break;
         case details::att_opcodes::execute_write_request:
+            this->read_blob_snapshot_value_changed();
             handle_execute_write_request( input, in_size, output, out_size, connection, write_queue_type() );
             break;
         case details::att_opcodes::confirmation:
@@ -559,19 +748,123 @@ namespace bluetoe {
         }
     }
 
+    template < typename ... Options >
+    template < typename ConnectionData >
+    bool server< Options... >::l2cap_input_stream_start( const std::uint8_t* input, std::size_t in_size, std::size_t, ConnectionData& connection )
+    {
+        abort_write_stream( connection );
+        l2cap_input_flush( connection );
+
+        const std::uint8_t opcode = input[ 0 ];
+
+        if ( in_size < 3 || ( opcode != bits( details::att_opcodes::write_request ) && opcode != bits( details::att_opcodes::write_command ) ) )
+            return false;
+
+        // all error handling is left to the defragmented request
+        const std::uint16_t handle = details::read_handle( &input[ 1 ] );
+        const std::size_t   index  = handle == 0
+            ? details::invalid_attribute_index
+            : handle_mapping::index_by_handle( handle );
+
+        if ( index == details::invalid_attribute_index )
+            return false;
+
+        auto query = details::attribute_access_arguments::query_write_through( connection.security_attributes(), this );
+
+        if ( attribute_at( index ).access( query, index ) != details::attribute_access_result::write_through )
+            return false;
+
+        // the defragmented request will be rejected
+        if ( !acquire_write_through( connection ) )
+            return false;
+
+        this->read_blob_snapshot_value_changed();
+
+        connection.stream_handle_ = handle;
+        connection.stream_opcode_ = opcode;
+        connection.stream_offset_ = 0;
+        connection.stream_error_  = 0;
+
+        write_stream_fragment( input + 3, in_size - 3, connection );
+
+        return true;
+    }
+
+    template < typename ... Options >
+    template < typename ConnectionData >
+    void server< Options... >::l2cap_input_stream( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& connection )
+    {
+        const std::uint16_t handle = connection.stream_handle_;
+
+        if ( handle == 0 )
+        {
+            out_size = 0;
+            return;
+        }
+
+        write_stream_fragment( input, in_size, connection );
+
+        // not the last fragment
+        if ( output == nullptr )
+            return;
+
+        out_size = std::min< std::size_t >( out_size, connection.negotiated_mtu() );
+
+        const std::size_t index = handle_mapping::index_by_handle( handle );
+        std::uint8_t      error = connection.stream_error_;
+
+        if ( error == 0 )
+        {
+            const auto rc = end_write_through( true, index, connection );
+
+            if ( rc != details::attribute_access_result::success )
+                error = static_cast< std::uint8_t >( access_result_to_att_code( rc, details::att_error_codes::write_not_permitted ) );
+        }
+
+        if ( error != 0 )
+            end_write_through( false, index, connection );
+
+        connection.stream_handle_ = 0;
+        release_write_through( connection );
+
+        if ( connection.stream_opcode_ == bits( details::att_opcodes::write_command ) )
+        {
+            out_size = 0;
+        }
+        else if ( error != 0 )
+        {
+            error_response( connection.stream_opcode_, static_cast< details::att_error_codes >( error ), handle, output, out_size );
+        }
+        else
+        {
+            *output  = bits( details::att_opcodes::write_response );
+            out_size = 1;
+        }
+    }
+
     template < typename ... Options >
     template < typename ConnectionData >
     void server< Options... >::l2cap_output( std::uint8_t* output, std::size_t& out_size, ConnectionData& connection )
     {
-        const auto pending = connection.dequeue_indication_or_confirmation();
+        using notification_data_list = details::find_notification_data_in_list< notification_priority, services >;
+
+        connection.release_due_notifications( connection );
+
+        auto pending = connection.dequeue_indication_or_confirmation();
 
-        if ( pending.first != details::notification_queue_entry_type::empty )
+        // skip notifications of characteristics, that are held back by a rate limit or that did not change since the last notification
+        for ( ; pending.first != details::notification_queue_entry_type::empty; pending = connection.dequeue_indication_or_confirmation() )
         {
-            const std::uint16_t required_flag = pending.first == details::notification_queue_entry_type::notification
+            const bool notification = pending.first == details::notification_queue_entry_type::notification;
+            const std::uint16_t required_flag = notification
                 ? details::client_characteristic_configuration_notification_enabled
                 : details::client_characteristic_configuration_indication_enabled;
 
-            const auto data = find_notification_data_by_index( pending.second );
+            const auto data       = find_notification_data_by_index( pending.second );
+            const auto rate_limit = notification_data_list::notification_rate_limit_by_attribute_index( data.attribute_table_index() );
+
+            if ( notification && !connection.notification_due( rate_limit, pending.second ) )
+                continue;
 
             if ( connection.client_configurations().flags( data.client_characteristic_configuration_index() ) & required_flag &&
                  out_size >= 3 )
@@ -582,7 +875,19 @@ namespace bluetoe {
 
                 if ( rc == details::attribute_access_result::success )
                 {
-                    *output = pending.first == details::notification_queue_entry_type::notification
+                    if ( notification )
+                    {
+                        const bool changed = connection.notification_value_changed(
+                            notification_data_list::notification_digest_by_attribute_index( data.attribute_table_index() ),
+                            output + 3, read.buffer_size );
+
+                        connection.notification_done( rate_limit, changed );
+
+                        if ( !changed )
+                            continue;
+                    }
+
+                    *output = notification
                         ? bits( details::att_opcodes::notification )
                         : bits( details::att_opcodes::indication );
                     details::write_handle( output +1, handle_mapping::handle_by_index( data.attribute_table_index() ) );
@@ -591,6 +896,11 @@ namespace bluetoe {
                     return;
                 }
             }
+
+            if ( notification )
+                connection.notification_done( rate_limit, false );
+
+            break;
         }
 
         out_size = 0;
@@ -758,12 +1068,32 @@ namespace bluetoe {
         const details::notification_data data = find_notification_data( &value );
         assert( data.valid() );
 
+        this->read_blob_snapshot_value_changed();
+
         if ( l2cap_cb_ )
             return l2cap_cb_( data, l2cap_arg_, details::notification_type::notification );
 
         return false;
     }
 
+    template < typename ... Options >
+    template < class T >
+    bool server< Options... >::update_and_notify( seqlock_value< T >& value, const T& new_value )
+    {
+        value.store( new_value );
+
+        return notify( value );
+    }
+
+    template < typename ... Options >
+    template < class T >
+    bool server< Options... >::update_and_indicate( seqlock_value< T >& value, const T& new_value )
+    {
+        value.store( new_value );
+
+        return indicate( value );
+    }
+
     template < typename ... Options >
     template < class CharacteristicUUID >
     bool server< Options... >::notify()
@@ -777,6 +1107,8 @@ namespace bluetoe {
 
         const auto data = details::find_notification_by_uuid< notification_priority, services, typename characteristic::characteristic_t >::data();
 
+        this->read_blob_snapshot_value_changed();
+
         if ( l2cap_cb_ )
             return l2cap_cb_( data, l2cap_arg_, details::notification_type::notification );
 
@@ -792,6 +1124,8 @@ namespace bluetoe {
         const details::notification_data data = find_notification_data( &value );
         assert( data.valid() );
 
+        this->read_blob_snapshot_value_changed();
+
         if ( l2cap_cb_ )
             return l2cap_cb_( data, l2cap_arg_, details::notification_type::indication );
 
@@ -811,12 +1145,20 @@ namespace bluetoe {
 
         const auto data = details::find_notification_by_uuid< notification_priority, services, typename characteristic::characteristic_t >::data();
 
+        this->read_blob_snapshot_value_changed();
+
         if ( l2cap_cb_ )
             return l2cap_cb_( data, l2cap_arg_, details::notification_type::indication );
 
         return false;
     }
 
+    template < typename ... Options >
+    void server< Options... >::invalidate_read_blob_snapshots()
+    {
+        this->read_blob_snapshot_value_changed();
+    }
+
     template < typename ... Options >
     template < class CharacteristicUUID >
     bool server< Options... >::configured_for_indications( const details::client_characteristic_configuration& connection ) const
@@ -860,7 +1202,11 @@ namespace bluetoe {
     template < typename Connection >
     void server< Options... >::client_disconnected( Connection& client )
     {
+        l2cap_input_flush( client );
+        abort_write_stream( client );
+        rollback_write_through( client, write_queue_type() );
         this->free_write_queue( client );
+        release_write_through( client );
     }
 
     template < typename ... Options >
@@ -1120,13 +1466,13 @@ namespace bluetoe {
         if ( !check_size_and_handle< 3 >( input, in_size, output, out_size, handle, index ) )
             return;
 
-        auto read = details::attribute_access_arguments::read( output + 1, output + out_size, 0, connection.client_configurations(), connection.security_attributes(), this );
-        auto rc   = attribute_at( index ).access( read, index );
+        std::size_t read_size = out_size - 1;
+        const auto  rc        = read_through_snapshot( handle, index, 0, output + 1, read_size, connection );
 
         if ( rc == details::attribute_access_result::success )
         {
             *output  = bits( details::att_opcodes::read_response );
-            out_size = 1 + read.buffer_size;
+            out_size = 1 + read_size;
         }
         else
         {
@@ -1146,13 +1492,13 @@ namespace bluetoe {
 
         const std::uint16_t offset = details::read_16bit( input + 3 );
 
-        auto read = details::attribute_access_arguments::read( output + 1, output + out_size, offset, connection.client_configurations(), connection.security_attributes(), this );
-        auto rc   = attribute_at( index ).access( read, index );
+        std::size_t read_size = out_size - 1;
+        const auto  rc        = read_through_snapshot( handle, index, offset, output + 1, read_size, connection );
 
         if ( rc == details::attribute_access_result::success )
         {
             *output  = bits( details::att_opcodes::read_blob_response );
-            out_size = 1 + read.buffer_size;
+            out_size = 1 + read_size;
         }
         else
         {
@@ -1160,6 +1506,22 @@ namespace bluetoe {
         }
      }
 
+    template < typename ... Options >
+    template < typename ConnectionData >
+    details::attribute_access_result server< Options... >::read_through_snapshot( std::uint16_t handle, std::size_t index, std::size_t offset, std::uint8_t* output, std::size_t& out_size, ConnectionData& connection )
+    {
+        return connection.read_blob_snapshot_read( handle, this->read_blob_snapshot_current_generation(), offset, connection.security_attributes(), output, out_size,
+            [ this, index, &connection ]( std::uint8_t* buffer, std::size_t buffer_size, std::size_t buffer_offset, std::size_t& read_size )
+            {
+                auto read = details::attribute_access_arguments::read( buffer, buffer + buffer_size, buffer_offset, connection.client_configurations(), connection.security_attributes(), this );
+                auto rc   = attribute_at( index ).access( read, index );
+
+                read_size = read.buffer_size;
+
+                return rc;
+            } );
+    }
+
     namespace details {
         template < typename Server >
         struct collect_attributes
@@ -1408,9 +1770,27 @@ namespace bluetoe {
         if ( !check_handle( input, in_size, output, out_size, handle, index ) )
             return;
 
+        // a write, that is written through, becomes effective, when it is committed
+        auto query = details::attribute_access_arguments::query_write_through( connection.security_attributes(), this );
+        const bool write_through = attribute_at( index ).access( query, index ) == details::attribute_access_result::write_through;
+
+        if ( write_through && !acquire_write_through( connection ) )
+            return error_response( *input, details::att_error_codes::insufficient_resources, handle, output, out_size );
+
         auto write = details::attribute_access_arguments::write( input + 3, input + in_size, 0, connection.client_configurations(), connection.security_attributes(), this );
         auto rc    = attribute_at( index ).access( write, index );
 
+        if ( rc == details::attribute_access_result::success && write_through )
+        {
+            rc = end_write_through( true, index, connection );
+
+            if ( rc != details::attribute_access_result::success )
+                end_write_through( false, index, connection );
+        }
+
+        if ( write_through )
+            release_write_through( connection );
+
         if ( rc == details::attribute_access_result::success )
         {
             *output  = bits( details::att_opcodes::write_response );
@@ -1422,17 +1802,120 @@ namespace bluetoe {
         }
     }
 
+    template < typename ... Options >
+    template < typename ConnectionData >
+    details::attribute_access_result server< Options... >::end_write_through( bool commit, std::size_t index, ConnectionData& connection )
+    {
+        auto end = details::attribute_access_arguments::end_write_through( commit, connection.client_configurations(), connection.security_attributes(), this );
+
+        return attribute_at( index ).access( end, index );
+    }
+
+    template < typename ... Options >
+    template < typename ConnectionData >
+    void server< Options... >::write_stream_fragment( const std::uint8_t* input, std::size_t in_size, ConnectionData& connection )
+    {
+        // after the first error, the remaining fragments are ignored
+        if ( connection.stream_error_ == 0 )
+        {
+            const std::size_t index = handle_mapping::index_by_handle( connection.stream_handle_ );
+
+            auto write = details::attribute_access_arguments::write( input, input + in_size, connection.stream_offset_,
+                            connection.client_configurations(), connection.security_attributes(), this );
+            auto rc    = attribute_at( index ).access( write, index );
+
+            if ( rc != details::attribute_access_result::success )
+                connection.stream_error_ = static_cast< std::uint8_t >( access_result_to_att_code( rc, details::att_error_codes::write_not_permitted ) );
+        }
+
+        connection.stream_offset_ += in_size;
+    }
+
+    template < typename ... Options >
+    template < typename ConnectionData >
+    void server< Options... >::abort_write_stream( ConnectionData& connection )
+    {
+        if ( connection.stream_handle_ == 0 )
+            return;
+
+        end_write_through( false, handle_mapping::index_by_handle( connection.stream_handle_ ), connection );
+        connection.stream_handle_ = 0;
+        release_write_through( connection );
+    }
+
     template < typename ... Options >
     template < typename ConnectionData >
     void server< Options... >::handle_write_command( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& cc )
     {
-        // just like a write request
-        handle_write_request( input, in_size, output, out_size, cc );
+        const std::uint16_t handle = in_size < 3 ? 0 : details::read_handle( &input[ 1 ] );
+        const std::size_t   index  = handle == 0
+            ? details::invalid_attribute_index
+            : handle_mapping::index_by_handle( handle );
+
+        if ( !collect_write_command( index, input, in_size, cc ) )
+        {
+            l2cap_input_flush( cc );
+
+            // just like a write request
+            handle_write_request( input, in_size, output, out_size, cc );
+        }
 
         // but ignore all output
         out_size = 0;
     }
 
+    template < typename ... Options >
+    template < typename ConnectionData >
+    bool server< Options... >::collect_write_command( std::size_t index, const std::uint8_t* input, std::size_t in_size, ConnectionData& connection )
+    {
+        if ( index == details::invalid_attribute_index )
+            return false;
+
+        // the permissions are checked with the first write command of a burst only
+        if ( index != connection.write_command_burst_index() )
+        {
+            auto query = details::attribute_access_arguments::query_write_command_burst( connection.security_attributes(), this );
+
+            if ( attribute_at( index ).access( query, index ) != details::attribute_access_result::write_command_burst )
+                return false;
+
+            l2cap_input_flush( connection );
+        }
+
+        if ( connection.write_command_burst_append( index, input + 3, in_size - 3 ) )
+            return true;
+
+        l2cap_input_flush( connection );
+
+        if ( connection.write_command_burst_append( index, input + 3, in_size - 3 ) )
+            return true;
+
+        // larger than the whole buffer, or no buffer at all
+        const write_command_view write = { input + 3, in_size - 3 };
+        auto burst = details::attribute_access_arguments::write_command_burst( &write, 1, connection.client_configurations(), connection.security_attributes(), this );
+        attribute_at( index ).access( burst, index );
+
+        return true;
+    }
+
+    template < typename ... Options >
+    template < typename ConnectionData >
+    void server< Options... >::l2cap_input_flush( ConnectionData& connection )
+    {
+        const std::size_t index = connection.write_command_burst_index();
+
+        if ( index == details::invalid_attribute_index )
+            return;
+
+        auto burst = details::attribute_access_arguments::write_command_burst(
+            connection.write_command_burst_writes(), connection.write_command_burst_count(),
+            connection.client_configurations(), connection.security_attributes(), this );
+
+        // the views of the burst point into the buffer, so the buffer is cleared after the handler returned
+        attribute_at( index ).access( burst, index );
+        connection.write_command_burst_clear();
+    }
+
     template < typename ... Options >
     template < typename Connection >
     void server< Options... >::handle_prepair_write_request( const std::uint8_t* input, std::size_t, std::uint8_t* output, std::size_t& out_size, Connection&, const details::no_such_type& )
@@ -1459,13 +1942,44 @@ namespace bluetoe {
         if ( rc != details::attribute_access_result::success )
             return error_response( *input, access_result_to_att_code( rc, details::att_error_codes::write_not_permitted ), handle, output, out_size );
 
-        // find size in the queue to write all but the opcode
-        std::uint8_t* const queue_element = this->allocate_from_write_queue( in_size - 1, client );
+        auto query = details::attribute_access_arguments::query_write_through( client.security_attributes(), this );
+
+        if ( attribute_at( index ).access( query, index ) == details::attribute_access_result::write_through )
+        {
+            if ( !acquire_write_through( client ) )
+                return error_response( *input, details::att_error_codes::prepare_queue_full, handle, output, out_size );
+
+            // only the handle is queued, to be able to commit or rollback the fragments later
+            if ( !write_through_queued( handle, client ) )
+            {
+                std::uint8_t* const queue_element = this->allocate_from_write_queue( write_through_element_size, client );
 
-        if ( queue_element == nullptr )
-            return error_response( *input, details::att_error_codes::prepare_queue_full, handle, output, out_size );
+                if ( queue_element == nullptr )
+                {
+                    release_write_through( client );
+                    return error_response( *input, details::att_error_codes::prepare_queue_full, handle, output, out_size );
+                }
 
-        std::copy( input + 1, input + in_size, queue_element );
+                details::write_handle( queue_element, handle );
+            }
+
+            auto fragment = details::attribute_access_arguments::write( input + 5, input + in_size, details::read_16bit( input + 3 ),
+                                client.client_configurations(), client.security_attributes(), this );
+            auto fragment_rc = attribute_at( index ).access( fragment, index );
+
+            if ( fragment_rc != details::attribute_access_result::success )
+                return error_response( *input, access_result_to_att_code( fragment_rc, details::att_error_codes::write_not_permitted ), handle, output, out_size );
+        }
+        else
+        {
+            // find size in the queue to write all but the opcode
+            std::uint8_t* const queue_element = this->allocate_from_write_queue( in_size - 1, client );
+
+            if ( queue_element == nullptr )
+                return error_response( *input, details::att_error_codes::prepare_queue_full, handle, output, out_size );
+
+            std::copy( input + 1, input + in_size, queue_element );
+        }
 
         *output = bits( details::att_opcodes::prepare_write_response );
 
@@ -1497,17 +2011,35 @@ namespace bluetoe {
             for ( std::pair< std::uint8_t*, std::size_t > queue = this->first_write_queue_element( client ); queue.first; queue = this->next_write_queue_element( queue.first, client ) )
             {
                 const std::uint16_t handle = details::read_handle( queue.first );
-                const std::uint16_t offset = details::read_16bit( queue.first + 2 );
-
                 const std::size_t attribute_index = handle_mapping::index_by_handle( handle );
 
+                if ( queue.second == write_through_element_size )
+                {
+                    auto rc = end_write_through( true, attribute_index, client );
+
+                    if ( rc != details::attribute_access_result::success )
+                    {
+                        rollback_write_through_from( queue, client );
+                        this->free_write_queue( client );
+                        release_write_through( client );
+
+                        return error_response( *input, access_result_to_att_code( rc, details::att_error_codes::write_not_permitted ), handle, output, out_size );
+                    }
+
+                    continue;
+                }
+
+                const std::uint16_t offset = details::read_16bit( queue.first + 2 );
+
                 auto write = details::attribute_access_arguments::write( queue.first + 4 , queue.first + queue.second,
                                 offset, client.client_configurations(), client.security_attributes(), this );
                 auto rc    = attribute_at( attribute_index ).access( write, attribute_index );
 
                 if ( rc != details::attribute_access_result::success )
                 {
+                    rollback_write_through_from( queue, client );
                     this->free_write_queue( client );
+                    release_write_through( client );
 
                     if ( rc == details::attribute_access_result::invalid_attribute_value_length )
                         return error_response( *input, details::att_error_codes::invalid_attribute_value_length, handle, output, out_size );
@@ -1516,13 +2048,97 @@ namespace bluetoe {
                 }
             }
         }
+        else
+        {
+            rollback_write_through_from( this->first_write_queue_element( client ), client );
+        }
 
         this->free_write_queue( client );
+        release_write_through( client );
 
         *output  = bits( details::att_opcodes::execute_write_response );
         out_size = 1;
     }
 
+    template < typename ... Options >
+    template < typename Connection >
+    bool server< Options... >::write_through_queued( std::uint16_t handle, Connection& client )
+    {
+        for ( std::pair< std::uint8_t*, std::size_t > queue = this->first_write_queue_element( client ); queue.first; queue = this->next_write_queue_element( queue.first, client ) )
+        {
+            if ( queue.second == write_through_element_size && details::read_handle( queue.first ) == handle )
+                return true;
+        }
+
+        return false;
+    }
+
+    template < typename ... Options >
+    template < typename Connection >
+    void server< Options... >::rollback_write_through_from( std::pair< std::uint8_t*, std::size_t > queue, Connection& client )
+    {
+        for ( ; queue.first; queue = this->next_write_queue_element( queue.first, client ) )
+        {
+            if ( queue.second != write_through_element_size )
+                continue;
+
+            end_write_through( false, handle_mapping::index_by_handle( details::read_handle( queue.first ) ), client );
+        }
+    }
+
+    template < typename ... Options >
+    template < typename Connection >
+    void server< Options... >::rollback_write_through( Connection&, const details::no_such_type& )
+    {
+    }
+
+    template < typename ... Options >
+    template < typename Connection, typename WriteQueue >
+    void server< Options... >::rollback_write_through( Connection& client, const WriteQueue& )
+    {
+        rollback_write_through_from( this->first_write_queue_element( client ), client );
+    }
+
+    template < typename ... Options >
+    template < typename Connection >
+    bool server< Options... >::acquire_write_through( Connection& client )
+    {
+        if ( write_through_client_ != nullptr && write_through_client_ != &client )
+            return false;
+
+        write_through_client_ = &client;
+
+        return true;
+    }
+
+    template < typename ... Options >
+    template < typename Connection >
+    void server< Options... >::release_write_through( Connection& client )
+    {
+        if ( write_through_client_ == &client && client.stream_handle_ == 0 && !write_through_prepared( client, write_queue_type() ) )
+            write_through_client_ = nullptr;
+    }
+
+    template < typename ... Options >
+    template < typename Connection >
+    bool server< Options... >::write_through_prepared( Connection&, const details::no_such_type& )
+    {
+        return false;
+    }
+
+    template < typename ... Options >
+    template < typename Connection, typename WriteQueue >
+    bool server< Options... >::write_through_prepared( Connection& client, const WriteQueue& )
+    {
+        for ( std::pair< std::uint8_t*, std::size_t > queue = this->first_write_queue_element( client ); queue.first; queue = this->next_write_queue_element( queue.first, client ) )
+        {
+            if ( queue.second == write_through_element_size )
+                return true;
+        }
+
+        return false;
+    }
+
     template < typename ... Options >
     void server< Options... >::handle_value_confirmation( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, connection_data& )
     {
@@ -1673,6 +2289,12 @@ namespace bluetoe {
             : mapped;
     }
 
+    template < typename ... Options >
+    std::uint32_t server< Options... >::delivery_latency( const details::notification_data& item )
+    {
+        return details::find_notification_data_in_list< notification_priority, services >::delivery_latency_by_attribute_index( item.attribute_table_index() );
+    }
+
     template < typename ... Options >
     details::notification_data server< Options... >::find_notification_data( const void* value ) const
     {
@@ -14,6 +14,7 @@
 #include <cstddef>
 #include <cassert>
 #include <algorithm>
+#include <iterator>
 #include <type_traits>
 
 namespace bluetoe {
@@ -3,6 +3,8 @@
 
 #include <bluetoe/service.hpp>
 #include <bluetoe/mixin.hpp>
+#include "bootloader_compression.hpp"
+#include "bootloader_delta.hpp"
 #include <algorithm>
 
 /**
@@ -128,7 +130,15 @@ namespace bluetoe
             no_operation_in_progress = bluetoe::error_codes::application_error_start,
             invalid_opcode,
             invalid_state,
-            buffer_overrun_attempt
+            buffer_overrun_attempt,
+            /*
+             * the compressed stream, received by the data characteristic is malformed
+             */
+            invalid_compressed_data,
+            /*
+             * the patch, received by the data characteristic is malformed or refers to already overwritten data
+             */
+            invalid_patch_data
         };
 
         /**
@@ -265,6 +275,9 @@ namespace bluetoe
                 opc_start,
                 opc_reset,
                 opc_read,
+                opc_start_compressed_flash,
+                opc_start_patch,
+                opc_get_page_checksums,
                 undefined_opcode = 0xff
             };
 
@@ -273,7 +286,8 @@ namespace bluetoe
                 success         = 1,
             };
 
-            template < typename UserHandler, typename MemRegions, std::size_t PageSize >
+            template < typename UserHandler, typename MemRegions, std::size_t PageSize,
+                typename Compression = no_compressed_transfer, typename Delta = no_delta_update >
             class controller : public UserHandler
             {
             public:
@@ -282,7 +296,9 @@ namespace bluetoe
                     , start_address( 0 )
                     , end_address( 0 )
                     , check_sum( 0 )
+                    , page_count_( 0 )
                     , in_flash_mode( false )
+                    , format_( plain_data )
                     , next_buffer_( 0 )
                     , used_buffer_( 0 )
                     , consecutive_( 0 )
@@ -333,31 +349,50 @@ namespace bluetoe
                                                  start_address = read_address( value +1 );
                             const std::uintptr_t end_address   = read_address( value +1 + sizeof( std::uint8_t* ) );
 
-                            if ( start_address > end_address || !MemRegions::acceptable( start_address,end_address ) )
+                            if ( start_address > end_address || !patchable( start_address,end_address ) )
                                 return request_error( bluetoe::error_codes::invalid_offset );
 
                             check_sum = this->public_checksum32( start_address, end_address - start_address );
                         }
                         break;
+                    case opc_start_compressed_flash:
+                        if ( !Compression::supported )
+                            return std::pair< std::uint8_t, bool >{ att_error_codes::invalid_opcode, false };
+
+                        // fall through
                     case opc_start_flash:
                         {
                             if ( write_size != 1 + sizeof( std::uint8_t* ) )
                                 return request_error( bluetoe::error_codes::invalid_attribute_value_length );
 
-                            start_address = read_address( value +1 );
-                            check_sum     = this->checksum32( start_address );
-                            consecutive_  = 0;
-                            next_buffer_  = 0;
-                            used_buffer_  = 0;
-                            in_flash_mode = true;
+                            const std::uintptr_t address = read_address( value +1 );
 
-                            if ( !MemRegions::acceptable( start_address, start_address ) )
+                            if ( !MemRegions::acceptable( address, address ) )
                                 return request_error( bluetoe::error_codes::invalid_offset );
 
-                            for ( auto& buffer : buffers_ )
-                                buffer.free();
+                            start_flash_mode( address, opcode == opc_start_compressed_flash ? compressed_data : plain_data );
+                        }
+                        break;
+                    case opc_start_patch:
+                        {
+                            if ( !Delta::supported )
+                                return std::pair< std::uint8_t, bool >{ att_error_codes::invalid_opcode, false };
+
+                            if ( write_size != 1 + 3 * sizeof( std::uint8_t* ) )
+                                return request_error( bluetoe::error_codes::invalid_attribute_value_length );
+
+                            const std::uintptr_t address      = read_address( value +1 );
+                            const std::uintptr_t source_start = read_address( value +1 + sizeof( std::uint8_t* ) );
+                            const std::uintptr_t source_end   = read_address( value +1 + 2 * sizeof( std::uint8_t* ) );
+
+                            if ( source_start > source_end || !patchable( source_start, source_end ) || !patchable( address, address ) )
+                                return request_error( bluetoe::error_codes::invalid_offset );
+
+                            patch_source_ = source_start;
+                            patch_start_  = address;
+                            patch_decoder_.reset( source_end - source_start );
 
-                            buffers_[next_buffer_].set_start_address( start_address, *this, check_sum, consecutive_ );
+                            start_flash_mode( address, patch_data );
                         }
                         break;
                     case opc_flush:
@@ -365,6 +400,11 @@ namespace bluetoe
                             if ( !in_flash_mode )
                                 return request_error( invalid_state );
 
+                            // the compressed stream or the patch must not end in the middle of a sequence
+                            if ( ( format_ == compressed_data && !decompressor_.at_sequence_boundary() )
+                              || ( format_ == patch_data && !patch_decoder_.at_sequence_boundary() ) )
+                                return request_error( invalid_state );
+
                             if ( !buffers_[next_buffer_].flush( *this ) )
                                 return request_error( invalid_state );
 
@@ -407,6 +447,30 @@ namespace bluetoe
                             }
                         }
                         break;
+                    case opc_get_page_checksums:
+                        {
+                            if ( write_size != 1 + 2 * sizeof( std::uint8_t* ) )
+                                return request_error( bluetoe::error_codes::invalid_attribute_value_length );
+
+                            start_address = read_address( value +1 );
+                            end_address   = read_address( value +1 + sizeof( std::uint8_t* ) );
+
+                            if ( start_address > end_address || !patchable( start_address,end_address ) )
+                                return request_error( bluetoe::error_codes::invalid_offset );
+
+                            page_count_ = 0;
+
+                            if ( start_address != end_address )
+                            {
+                                const std::uintptr_t first_page = start_address - start_address % PageSize;
+                                page_count_ = static_cast< std::uint32_t >( ( end_address - first_page + PageSize - 1 ) / PageSize );
+
+                                this->data_indication_call_back();
+
+                                return std::pair< std::uint8_t, bool >{ bluetoe::error_codes::success, false };
+                            }
+                        }
+                        break;
                     default:
                         return std::pair< std::uint8_t, bool >{ att_error_codes::invalid_opcode, false };
                     }
@@ -445,10 +509,15 @@ namespace bluetoe
                             out = bluetoe::details::write_32bit( out, PageSize );
                             out = bluetoe::details::write_32bit( out, number_of_concurrent_flashs );
 
+                            if ( Compression::supported )
+                                out = bluetoe::details::write_32bit( out, Compression::window_size );
+
                             out_size = out - out_buffer;
                         }
                         break;
                     case opc_start_flash:
+                    case opc_start_compressed_flash:
+                    case opc_start_patch:
                         {
                             std::uint8_t* out = out_buffer;
                             ++out;
@@ -483,6 +552,12 @@ namespace bluetoe
                             out_size = out - out_buffer;
                         }
                         break;
+                    case opc_get_page_checksums:
+                        {
+                            bluetoe::details::write_32bit( out_buffer + 1, page_count_ );
+                            out_size = sizeof( std::uint8_t ) + sizeof( std::uint32_t );
+                        }
+                        break;
                     }
 
                     return bluetoe::error_codes::success;
@@ -496,22 +571,13 @@ namespace bluetoe
                     if ( write_size == 0 )
                         return bluetoe::error_codes::success;
 
-                    if ( buffers_[ next_buffer_ ].free_size() == 0 && !find_next_buffer( start_address ) )
-                        return buffer_overrun_attempt;
+                    if ( format_ == compressed_data )
+                        return write_compressed_data( write_size, value );
 
-                    while ( write_size )
-                    {
-                        const std::size_t moved = buffers_[ next_buffer_ ].write_data( write_size, value, *this );
+                    if ( format_ == patch_data )
+                        return write_patch_data( write_size, value );
 
-                        value           += moved;
-                        write_size      -= moved;
-                        start_address   += moved;
-
-                        if ( write_size && !find_next_buffer( start_address ) )
-                            return buffer_overrun_attempt;
-                    }
-
-                    return bluetoe::error_codes::success;
+                    return write_image_data( write_size, value );
                 }
 
                 std::uint8_t bootloader_read_data( std::size_t read_size, std::uint8_t* out_buffer, std::size_t& out_size )
@@ -541,6 +607,31 @@ namespace bluetoe
                             this->data_indication_call_back();
                         }
                     }
+                    else if ( opcode == opc_get_page_checksums )
+                    {
+                        // one checksum for every page, covering only the part of the page within the requested range
+                        std::uint8_t* out = out_buffer;
+
+                        while ( start_address != end_address && static_cast< std::size_t >( out - out_buffer ) + sizeof( std::uint32_t ) <= read_size )
+                        {
+                            const std::uintptr_t page_end  = start_address - start_address % PageSize + PageSize;
+                            const std::uintptr_t range_end = page_end < end_address ? page_end : end_address;
+
+                            out = bluetoe::details::write_32bit( out, this->public_checksum32( start_address, range_end - start_address ) );
+                            start_address = range_end;
+                        }
+
+                        out_size = out - out_buffer;
+
+                        if ( start_address == end_address )
+                        {
+                            this->control_point_notification_call_back();
+                        }
+                        else
+                        {
+                            this->data_indication_call_back();
+                        }
+                    }
 
                     return bluetoe::error_codes::success;
                 }
@@ -582,6 +673,133 @@ namespace bluetoe
                 }
 
             private:
+                std::uint8_t write_compressed_data( std::size_t write_size, const std::uint8_t* value )
+                {
+                    std::uint8_t result = bluetoe::error_codes::success;
+
+                    auto sink = [this, &result]( const std::uint8_t* data, std::size_t size ) -> bool
+                    {
+                        result = write_image_data( size, data );
+
+                        return result == bluetoe::error_codes::success;
+                    };
+
+                    if ( decompressor_.decompress( value, write_size, sink ) )
+                        return bluetoe::error_codes::success;
+
+                    // the decoder consumed a part of the input, so the data can not be written again
+                    in_flash_mode = false;
+
+                    if ( result != bluetoe::error_codes::success )
+                        return result;
+
+                    return invalid_compressed_data;
+                }
+
+                std::uint8_t write_patch_data( std::size_t write_size, const std::uint8_t* value )
+                {
+                    std::uint8_t result = bluetoe::error_codes::success;
+
+                    auto source = [this]( std::size_t offset, std::size_t size, std::uint8_t* output ) -> bool
+                    {
+                        const std::uintptr_t address = patch_source_ + offset;
+
+                        // pages, that are already handed over to be flashed, do not contain the old image anymore
+                        const std::uintptr_t overwritten_start = patch_start_ - patch_start_ % PageSize;
+                        const std::uintptr_t overwritten_end   = start_address - start_address % PageSize;
+
+                        if ( address < overwritten_end && address + size > overwritten_start )
+                            return false;
+
+                        this->read_mem( address, size, output );
+
+                        return true;
+                    };
+
+                    auto sink = [this, &result]( const std::uint8_t* data, std::size_t size ) -> bool
+                    {
+                        result = write_image_data( size, data );
+
+                        return result == bluetoe::error_codes::success;
+                    };
+
+                    if ( patch_decoder_.apply( value, write_size, source, sink ) )
+                        return bluetoe::error_codes::success;
+
+                    // the decoder consumed a part of the input, so the data can not be written again
+                    in_flash_mode = false;
+
+                    if ( result != bluetoe::error_codes::success )
+                        return result;
+
+                    return invalid_patch_data;
+                }
+
+                std::uint8_t write_image_data( std::size_t write_size, const std::uint8_t* value )
+                {
+                    if ( buffers_[ next_buffer_ ].free_size() == 0 && !find_next_buffer( start_address ) )
+                        return buffer_overrun_attempt;
+
+                    while ( write_size )
+                    {
+                        const std::size_t moved = buffers_[ next_buffer_ ].write_data( write_size, value, *this );
+
+                        value           += moved;
+                        write_size      -= moved;
+                        start_address   += moved;
+
+                        if ( write_size && !find_next_buffer( start_address ) )
+                            return buffer_overrun_attempt;
+                    }
+
+                    return bluetoe::error_codes::success;
+                }
+
+                enum data_format {
+                    plain_data,
+                    compressed_data,
+                    patch_data
+                };
+
+                void start_flash_mode( std::uintptr_t address, data_format format )
+                {
+                    start_address = address;
+                    check_sum     = this->checksum32( start_address );
+                    consecutive_  = 0;
+                    next_buffer_  = 0;
+                    used_buffer_  = 0;
+                    in_flash_mode = true;
+                    format_       = format;
+
+                    decompressor_.reset();
+
+                    for ( auto& buffer : buffers_ )
+                        buffer.free();
+
+                    buffers_[next_buffer_].set_start_address( start_address, *this, check_sum, consecutive_ );
+                }
+
+                // white listed or part of the optional scratch region
+                bool patchable( std::uintptr_t start, std::uintptr_t end )
+                {
+                    return MemRegions::acceptable( start, end ) || in_scratch_region( static_cast< UserHandler& >( *this ), start, end, 0 );
+                }
+
+                template < class Handler >
+                static auto in_scratch_region( Handler& handler, std::uintptr_t start, std::uintptr_t end, int )
+                    -> decltype( handler.scratch_region(), bool() )
+                {
+                    const std::pair< std::uintptr_t, std::uintptr_t > region = handler.scratch_region();
+
+                    return start >= region.first && end <= region.second;
+                }
+
+                template < class Handler >
+                static bool in_scratch_region( Handler&, std::uintptr_t, std::uintptr_t, long )
+                {
+                    return false;
+                }
+
                 std::uint32_t free_size() const
                 {
                     std::uint32_t result = 0;
@@ -621,7 +839,13 @@ namespace bluetoe
                 std::uintptr_t                  end_address;
                 error_codes                     error;
                 std::uint32_t                   check_sum;
+                std::uint32_t                   page_count_;
                 bool                            in_flash_mode;
+                data_format                     format_;
+                typename Compression::decompressor decompressor_;
+                typename Delta::decoder         patch_decoder_;
+                std::uintptr_t                  patch_source_;
+                std::uintptr_t                  patch_start_;
 
                 static constexpr std::size_t    number_of_concurrent_flashs = 2;
                 unsigned                        next_buffer_;
@@ -647,7 +871,11 @@ namespace bluetoe
                 static_assert( !std::is_same< bluetoe::details::no_such_type, user_handler >::value,
                     "To use the bootloader, please provide a handler<> that fullfiles the requirements documented with bootloader_handler_prototype." );
 
-                using implementation = controller< typename user_handler::user_handler, mem_regions, page_size::value >;
+                using compression  = typename bluetoe::details::find_by_meta_type< compressed_transfer_meta_type, Options..., no_compressed_transfer >::type;
+
+                using delta        = typename bluetoe::details::find_by_meta_type< delta_update_meta_type, Options..., no_delta_update >::type;
+
+                using implementation = controller< typename user_handler::user_handler, mem_regions, page_size::value, compression, delta >;
 
                 using type = bluetoe::service<
                     bluetoe::bootloader::service_uuid,
@@ -688,8 +916,9 @@ namespace bluetoe
             };
         }
 
-        template < typename UserHandler, typename MemRegions, std::size_t PageSize >
-        using controller = details::controller< UserHandler, MemRegions, PageSize >;
+        template < typename UserHandler, typename MemRegions, std::size_t PageSize,
+            typename Compression = details::no_compressed_transfer, typename Delta = details::no_delta_update >
+        using controller = details::controller< UserHandler, MemRegions, PageSize, Compression, Delta >;
         /** @endcond */
 
 
@@ -754,7 +983,7 @@ namespace bluetoe
 
             /**
              * @brief version of checksum function, that will be directly called by the execution of the
-             *        Get CRC procedure.
+             *        Get CRC and the Get Page Checksums procedure.
              *
              * @attention If there are ranges that contain sensitiv information, make sure, that size is large enough,
              *            so that one can not get the content of the memory from the resulting CRC.
@@ -762,6 +991,17 @@ namespace bluetoe
              */
             std::uint32_t public_checksum32( std::uintptr_t start_addr, std::size_t size );
 
+            /**
+             * @brief optional memory region, that can be used by the Start Patch procedure
+             *
+             * The region from first to second (exclusive) can be used as destination and as source of
+             * the Start Patch procedure and can be checked with the Get CRC procedure, even when it is not part
+             * of the white list. A client can reconstruct a new image in the scratch region, verify it and
+             * then copy it to its final location with a second patch. The function is only required, if
+             * bootloader::delta_update is used and a scratch region is desired.
+             */
+            std::pair< std::uintptr_t, std::uintptr_t > scratch_region();
+
             /**
              * @brief technical required function, that have to call bootloader_control_point_notification(), with the instance of the server
              */
@@ -0,0 +1,263 @@
+#ifndef BLUETOE_SERVICES_BOOTLOADER_COMPRESSION_HPP
+#define BLUETOE_SERVICES_BOOTLOADER_COMPRESSION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+/**
+ * @file services/bootloader_compression.hpp
+ *
+ * Streaming decompression of firmware images, that are transfered with the Start Compressed Flash procedure
+ * of the bootloader.
+ *
+ * \ref Bootloader-Protocol
+ */
+namespace bluetoe
+{
+    namespace bootloader {
+
+        /** @cond HIDDEN_SYMBOLS */
+        namespace details {
+            struct compressed_transfer_meta_type {};
+
+            /*
+             * Decompresses a stream of LZ4 like sequences. The stream can be split at any byte, the state of
+             * a partially received sequence is kept between calls to decompress(). Back references can reach
+             * at max WindowSize bytes back, the last WindowSize decompressed bytes are kept in a ring buffer.
+             */
+            template < std::size_t WindowSize >
+            class stream_decompressor
+            {
+            public:
+                static_assert( WindowSize >= 16 && ( WindowSize & ( WindowSize - 1 ) ) == 0, "WindowSize has to be a power of 2 and at least 16" );
+                static_assert( WindowSize < 0x10000, "offsets are limited to 16 bit" );
+
+                static constexpr std::size_t window_size = WindowSize;
+                static constexpr std::size_t min_match   = 4;
+
+                stream_decompressor()
+                {
+                    reset();
+                }
+
+                void reset()
+                {
+                    state_      = token;
+                    literals_   = 0;
+                    match_      = 0;
+                    offset_     = 0;
+                    written_    = 0;
+                }
+
+                /*
+                 * returns true, if the stream was not split in the middle of a sequence
+                 */
+                bool at_sequence_boundary() const
+                {
+                    return state_ == token;
+                }
+
+                /*
+                 * Sink is called with the decompressed data as bool( const std::uint8_t*, std::size_t ) and
+                 * returns false, if the data can not be stored.
+                 *
+                 * Returns false, if the sink returned false, or if the stream is malformed.
+                 */
+                template < class Sink >
+                bool decompress( const std::uint8_t* input, std::size_t size, Sink& sink )
+                {
+                    const std::uint8_t* const end = input + size;
+
+                    while ( input != end )
+                    {
+                        switch ( state_ )
+                        {
+                        case token:
+                            {
+                                const std::uint8_t value = *input++;
+                                literals_ = value >> 4;
+                                match_    = value & 0x0f;
+
+                                state_ = literals_ == 0x0f
+                                    ? literal_length
+                                    : literals_ != 0 ? literals : offset_low;
+                            }
+                            break;
+                        case literal_length:
+                            {
+                                const std::uint8_t value = *input++;
+                                literals_ += value;
+
+                                if ( value != 0xff )
+                                    state_ = literals;
+                            }
+                            break;
+                        case literals:
+                            {
+                                const std::size_t chunk = std::min< std::size_t >( literals_, end - input );
+
+                                if ( !sink( input, chunk ) )
+                                    return false;
+
+                                for ( std::size_t i = 0; i != chunk; ++i )
+                                    window_[ ( written_ + i ) & window_mask ] = input[ i ];
+
+                                written_  += chunk;
+                                input     += chunk;
+                                literals_ -= chunk;
+
+                                if ( literals_ == 0 )
+                                    state_ = offset_low;
+                            }
+                            break;
+                        case offset_low:
+                            offset_ = *input++;
+                            state_  = offset_high;
+                            break;
+                        case offset_high:
+                            {
+                                offset_ |= static_cast< std::size_t >( *input++ ) << 8;
+
+                                // an offset of 0 ends a sequence without match
+                                if ( offset_ == 0 )
+                                {
+                                    if ( match_ != 0 )
+                                        return false;
+
+                                    state_ = token;
+                                }
+                                else
+                                {
+                                    if ( offset_ > WindowSize || offset_ > written_ )
+                                        return false;
+
+                                    state_  = match_ == 0x0f ? match_length : token;
+                                    match_ += min_match;
+
+                                    if ( state_ == token && !copy_match( sink ) )
+                                        return false;
+                                }
+                            }
+                            break;
+                        case match_length:
+                            {
+                                const std::uint8_t value = *input++;
+                                match_ += value;
+
+                                if ( value != 0xff )
+                                {
+                                    state_ = token;
+
+                                    if ( !copy_match( sink ) )
+                                        return false;
+                                }
+                            }
+                            break;
+                        }
+                    }
+
+                    return true;
+                }
+
+            private:
+                static constexpr std::size_t window_mask = WindowSize - 1;
+                static constexpr std::size_t copy_chunk  = 32;
+
+                template < class Sink >
+                bool copy_match( Sink& sink )
+                {
+                    std::uint8_t buffer[ copy_chunk ];
+
+                    while ( match_ )
+                    {
+                        const std::size_t chunk = match_ < copy_chunk ? match_ : copy_chunk;
+
+                        // byte by byte, as source and destination can overlap
+                        for ( std::size_t i = 0; i != chunk; ++i, ++written_ )
+                        {
+                            const std::uint8_t value = window_[ ( written_ - offset_ ) & window_mask ];
+                            window_[ written_ & window_mask ] = value;
+                            buffer[ i ] = value;
+                        }
+
+                        if ( !sink( &buffer[ 0 ], chunk ) )
+                            return false;
+
+                        match_ -= chunk;
+                    }
+
+                    return true;
+                }
+
+                enum {
+                    token,
+                    literal_length,
+                    literals,
+                    offset_low,
+                    offset_high,
+                    match_length
+                } state_;
+
+                std::size_t     literals_;
+                std::size_t     match_;
+                std::size_t     offset_;
+                std::size_t     written_;
+                std::uint8_t    window_[ WindowSize ];
+            };
+
+            struct no_compressed_transfer
+            {
+                static constexpr bool        supported   = false;
+                static constexpr std::size_t window_size = 0;
+
+                typedef compressed_transfer_meta_type meta_type;
+
+                struct decompressor
+                {
+                    void reset() {}
+
+                    bool at_sequence_boundary() const
+                    {
+                        return true;
+                    }
+
+                    template < class Sink >
+                    bool decompress( const std::uint8_t*, std::size_t, Sink& )
+                    {
+                        return false;
+                    }
+                };
+            };
+        }
+        /** @endcond */
+
+        /**
+         * @brief optional parameter, that enables the Start Compressed Flash procedure
+         *
+         * With this option, the bootloader accepts a compressed image stream on the Data characteristic, after
+         * the Start Compressed Flash procedure was executed. The stream is decompressed while it is received, so
+         * the amount of bytes that have to be transmitted over the air is reduced by the compression ratio of the
+         * image. Checksums are calculated over the decompressed image.
+         *
+         * WindowSize is the maximum distance of a back reference in the compressed stream and the size of the
+         * history buffer, that the bootloader has to keep in RAM. It has to be a power of 2. Larger windows yield
+         * better compression ratios. The compressor on the client side has to use the same or a smaller window.
+         *
+         * @sa bootloader::compress()
+         */
+        template < std::size_t WindowSize = 256 >
+        struct compressed_transfer
+        {
+            /** @cond HIDDEN_SYMBOLS */
+            static constexpr bool        supported   = true;
+            static constexpr std::size_t window_size = WindowSize;
+
+            typedef details::compressed_transfer_meta_type      meta_type;
+            typedef details::stream_decompressor< WindowSize >  decompressor;
+            /** @endcond */
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,220 @@
+#ifndef BLUETOE_SERVICES_BOOTLOADER_COMPRESSOR_HPP
+#define BLUETOE_SERVICES_BOOTLOADER_COMPRESSOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+/**
+ * @file services/bootloader_compressor.hpp
+ *
+ * Compressor for the Start Compressed Flash procedure of the bootloader. This is ment to be used by bootloader
+ * clients and tests on a host and not by the bootloader itself.
+ *
+ * \ref Bootloader-Protocol
+ */
+namespace bluetoe
+{
+    namespace bootloader {
+
+        /**
+         * @brief a part of a compressed image or patch, that can be written with a single write to the Data characteristic
+         */
+        struct compressed_chunk
+        {
+            /**
+             * @brief compressed data
+             */
+            std::vector< std::uint8_t > data;
+
+            /**
+             * @brief number of image bytes, the bootloader will have received, after data was decompressed
+             */
+            std::size_t decompressed_size;
+        };
+
+        /** @cond HIDDEN_SYMBOLS */
+        namespace details {
+            class chunk_compressor
+            {
+            public:
+                chunk_compressor( const std::uint8_t* image, std::size_t size, std::size_t window_size,
+                    std::size_t max_chunk_size, std::size_t max_decompressed_chunk_size )
+                    : image_( image )
+                    , size_( size )
+                    , window_( window_size )
+                    , max_chunk_( max_chunk_size )
+                    , max_decompressed_( max_decompressed_chunk_size )
+                {
+                    assert( window_size < 0x10000 );
+                    assert( max_chunk_size >= min_sequence_size + 1 );
+                    assert( max_decompressed_chunk_size > 0 );
+                }
+
+                std::vector< compressed_chunk > compress()
+                {
+                    std::vector< compressed_chunk > result;
+
+                    for ( std::size_t pos = 0; pos != size_; )
+                    {
+                        result.push_back( compressed_chunk{ {}, 0 } );
+                        pos = fill_chunk( pos, result.back() );
+                    }
+
+                    return result;
+                }
+
+            private:
+                static constexpr std::size_t min_match         = 4;
+                // token and offset
+                static constexpr std::size_t min_sequence_size = 3;
+
+                static std::size_t length_size( std::size_t length )
+                {
+                    return length < 15 ? 0 : 1 + ( length - 15 ) / 255;
+                }
+
+                std::pair< std::size_t, std::size_t > find_match( std::size_t pos ) const
+                {
+                    std::size_t best_length = 0;
+                    std::size_t best_offset = 0;
+
+                    const std::size_t first = pos > window_ ? pos - window_ : 0;
+
+                    for ( std::size_t candidate = pos; candidate != first; )
+                    {
+                        --candidate;
+
+                        std::size_t length = 0;
+                        while ( pos + length != size_ && image_[ candidate + length ] == image_[ pos + length ] )
+                            ++length;
+
+                        if ( length > best_length )
+                        {
+                            best_length = length;
+                            best_offset = pos - candidate;
+                        }
+                    }
+
+                    return { best_length, best_offset };
+                }
+
+                std::size_t fill_chunk( std::size_t pos, compressed_chunk& chunk )
+                {
+                    for ( ;; )
+                    {
+                        const std::size_t bytes_left  = max_chunk_ - chunk.data.size();
+                        const std::size_t output_left = max_decompressed_ - chunk.decompressed_size;
+
+                        if ( pos == size_ || bytes_left < min_sequence_size + 1 || output_left == 0 )
+                            return pos;
+
+                        // collect literals up to the next match
+                        std::size_t literals = 0;
+                        std::pair< std::size_t, std::size_t > match = { 0, 0 };
+
+                        for ( ; pos + literals != size_; ++literals )
+                        {
+                            match = find_match( pos + literals );
+
+                            if ( match.first >= min_match )
+                                break;
+                        }
+
+                        if ( match.first < min_match )
+                            match = { 0, 0 };
+
+                        // shrink the sequence, until it fits into the chunk
+                        const std::size_t all_literals = literals;
+                        literals = std::min( literals, output_left );
+
+                        while ( literals != 0 && min_sequence_size + length_size( literals ) + literals > bytes_left )
+                            --literals;
+
+                        std::size_t match_length = literals == all_literals ? std::min( match.first, output_left - literals ) : 0;
+
+                        while ( match_length >= min_match && min_sequence_size + length_size( literals ) + literals + length_size( match_length - min_match ) > bytes_left )
+                            --match_length;
+
+                        if ( match_length < min_match )
+                            match_length = 0;
+
+                        // a match that does not fit, is transmitted as literal
+                        if ( literals == 0 && match_length == 0 )
+                            literals = 1;
+
+                        write_sequence( chunk, pos, literals, match_length, match.second );
+                        pos += literals + match_length;
+                    }
+                }
+
+                static void write_length( std::vector< std::uint8_t >& out, std::size_t length )
+                {
+                    if ( length < 15 )
+                        return;
+
+                    for ( length -= 15; length >= 255; length -= 255 )
+                        out.push_back( 0xff );
+
+                    out.push_back( static_cast< std::uint8_t >( length ) );
+                }
+
+                void write_sequence( compressed_chunk& chunk, std::size_t pos, std::size_t literals, std::size_t match_length, std::size_t offset ) const
+                {
+                    std::vector< std::uint8_t >& out = chunk.data;
+                    const std::size_t match_code = match_length ? match_length - min_match : 0;
+
+                    out.push_back( static_cast< std::uint8_t >(
+                        ( std::min< std::size_t >( literals, 15 ) << 4 ) | std::min< std::size_t >( match_code, 15 ) ) );
+
+                    write_length( out, literals );
+                    out.insert( out.end(), image_ + pos, image_ + pos + literals );
+
+                    // an offset of 0 denotes a sequence without match
+                    if ( match_length == 0 )
+                        offset = 0;
+
+                    out.push_back( static_cast< std::uint8_t >( offset & 0xff ) );
+                    out.push_back( static_cast< std::uint8_t >( offset >> 8 ) );
+
+                    if ( match_length )
+                        write_length( out, match_code );
+
+                    chunk.decompressed_size += literals + match_length;
+                }
+
+                const std::uint8_t* const   image_;
+                const std::size_t           size_;
+                const std::size_t           window_;
+                const std::size_t           max_chunk_;
+                const std::size_t           max_decompressed_;
+            };
+        }
+        /** @endcond */
+
+        /**
+         * @brief compresses an image for the Start Compressed Flash procedure
+         *
+         * The result is split into chunks, that are at max max_chunk_size bytes large (usually MTU - 3) and
+         * that decompress to at max max_decompressed_chunk_size bytes. Every chunk contains only complete
+         * sequences, so a client can use the decompressed_size of the chunks for the buffer management, exactly
+         * like with the uncompressed Start Flash procedure. Choosing the page size as max_decompressed_chunk_size
+         * makes sure, that a chunk can always be written, once a page buffer became free.
+         *
+         * window_size has to be equal or smaller than the window size of the bootloader
+         * (bootloader::compressed_transfer<>).
+         *
+         * The compressor is simple and greedy and searches the whole window for matches.
+         */
+        inline std::vector< compressed_chunk > compress( const std::uint8_t* image, std::size_t size, std::size_t window_size,
+            std::size_t max_chunk_size, std::size_t max_decompressed_chunk_size )
+        {
+            return details::chunk_compressor( image, size, window_size, max_chunk_size, max_decompressed_chunk_size ).compress();
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,230 @@
+#ifndef BLUETOE_SERVICES_BOOTLOADER_DELTA_HPP
+#define BLUETOE_SERVICES_BOOTLOADER_DELTA_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file services/bootloader_delta.hpp
+ *
+ * Application of binary patches, that are transfered with the Start Patch procedure of the bootloader.
+ *
+ * \ref Bootloader-Protocol
+ */
+namespace bluetoe
+{
+    namespace bootloader {
+
+        /** @cond HIDDEN_SYMBOLS */
+        namespace details {
+            struct delta_update_meta_type {};
+
+            /*
+             * Applies a stream of copy and insert operations. The stream can be split at any byte, the state
+             * of a partially received operation is kept between calls to apply(). Copied data is read in small
+             * chunks from the old image, so the RAM usage does not depend on the size of the operations.
+             */
+            class patch_decoder
+            {
+            public:
+                patch_decoder()
+                {
+                    reset( 0 );
+                }
+
+                void reset( std::size_t source_size )
+                {
+                    state_       = header;
+                    value_       = 0;
+                    shift_       = 0;
+                    length_      = 0;
+                    source_pos_  = 0;
+                    source_size_ = source_size;
+                }
+
+                /*
+                 * returns true, if the stream was not split in the middle of an operation
+                 */
+                bool at_sequence_boundary() const
+                {
+                    return state_ == header && shift_ == 0;
+                }
+
+                /*
+                 * Source is called as bool( std::size_t offset, std::size_t size, std::uint8_t* output ) to read
+                 * size bytes from the old image at offset and returns false, if the data can not be read.
+                 *
+                 * Sink is called with the new image data as bool( const std::uint8_t*, std::size_t ) and
+                 * returns false, if the data can not be stored.
+                 *
+                 * Returns false, if source or sink returned false, or if the stream is malformed.
+                 */
+                template < class Source, class Sink >
+                bool apply( const std::uint8_t* input, std::size_t size, Source& source, Sink& sink )
+                {
+                    const std::uint8_t* const end = input + size;
+
+                    while ( input != end )
+                    {
+                        if ( state_ == insert_data )
+                        {
+                            const std::size_t chunk = length_ < static_cast< std::size_t >( end - input )
+                                ? length_
+                                : end - input;
+
+                            if ( !sink( input, chunk ) )
+                                return false;
+
+                            input   += chunk;
+                            length_ -= chunk;
+
+                            if ( length_ == 0 )
+                                state_ = header;
+
+                            continue;
+                        }
+
+                        // header and copy offset are LEB128 encoded; the 5th byte carries the upper 4 bits of a 32 bit value
+                        // and ends the number
+                        const std::uint8_t byte = *input++;
+
+                        if ( shift_ == 28 && ( byte & 0xf0 ) != 0 )
+                            return false;
+                        value_ |= static_cast< std::uint32_t >( byte & 0x7f ) << shift_;
+                        shift_ += 7;
+
+                        if ( byte & 0x80 )
+                            continue;
+
+                        const std::uint32_t value = value_;
+                        value_ = 0;
+                        shift_ = 0;
+
+                        if ( state_ == header )
+                        {
+                            length_ = value >> 1;
+
+                            if ( length_ == 0 )
+                                return false;
+
+                            state_ = ( value & 1 ) ? copy_offset : insert_data;
+                        }
+                        else
+                        {
+                            // zig zag encoded distance to the end of the last copy operation
+                            const std::size_t distance = value >> 1;
+
+                            if ( value & 1 )
+                            {
+                                if ( distance + 1 > source_pos_ )
+                                    return false;
+
+                                source_pos_ -= distance + 1;
+                            }
+                            else
+                            {
+                                source_pos_ += distance;
+                            }
+
+                            if ( source_pos_ > source_size_ || length_ > source_size_ - source_pos_ )
+                                return false;
+
+                            state_ = header;
+
+                            if ( !copy( source, sink ) )
+                                return false;
+                        }
+                    }
+
+                    return true;
+                }
+
+            private:
+                static constexpr std::size_t copy_chunk = 32;
+
+                template < class Source, class Sink >
+                bool copy( Source& source, Sink& sink )
+                {
+                    std::uint8_t buffer[ copy_chunk ];
+
+                    while ( length_ )
+                    {
+                        const std::size_t chunk = length_ < copy_chunk ? length_ : copy_chunk;
+
+                        if ( !source( source_pos_, chunk, &buffer[ 0 ] ) || !sink( &buffer[ 0 ], chunk ) )
+                            return false;
+
+                        source_pos_ += chunk;
+                        length_     -= chunk;
+                    }
+
+                    return true;
+                }
+
+                enum {
+                    header,
+                    insert_data,
+                    copy_offset
+                } state_;
+
+                std::uint32_t   value_;
+                unsigned        shift_;
+                std::size_t     length_;
+                std::size_t     source_pos_;
+                std::size_t     source_size_;
+            };
+
+            struct no_delta_update
+            {
+                static constexpr bool supported = false;
+
+                typedef delta_update_meta_type meta_type;
+
+                struct decoder
+                {
+                    void reset( std::size_t ) {}
+
+                    bool at_sequence_boundary() const
+                    {
+                        return true;
+                    }
+
+                    template < class Source, class Sink >
+                    bool apply( const std::uint8_t*, std::size_t, Source&, Sink& )
+                    {
+                        return false;
+                    }
+                };
+            };
+        }
+        /** @endcond */
+
+        /**
+         * @brief optional parameter, that enables the Start Patch procedure
+         *
+         * With this option, the bootloader can reconstruct a new image from an image, that is already
+         * in the flash and a binary patch, that contains only the differences between both images. For
+         * updates, that change only a small part of the image, this reduces the amount of bytes to be
+         * transmitted dramatically.
+         *
+         * The patch can be applied in place (the new image replaces the old image) or into a different
+         * memory region. If the handler implements the optional scratch_region() function, the scratch
+         * region can be used as destination and as source of a patch, even if it is not part of the
+         * white list.
+         *
+         * @sa bootloader::delta_encode()
+         * @sa bootloader_handler_prototype::scratch_region()
+         */
+        struct delta_update
+        {
+            /** @cond HIDDEN_SYMBOLS */
+            static constexpr bool supported = true;
+
+            typedef details::delta_update_meta_type meta_type;
+            typedef details::patch_decoder          decoder;
+            /** @endcond */
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,302 @@
+#ifndef BLUETOE_SERVICES_BOOTLOADER_DELTA_ENCODER_HPP
+#define BLUETOE_SERVICES_BOOTLOADER_DELTA_ENCODER_HPP
+
+#include "bootloader_compressor.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+/**
+ * @file services/bootloader_delta_encoder.hpp
+ *
+ * Patch generator for the Start Patch procedure of the bootloader. This is ment to be used by bootloader
+ * clients and tests on a host and not by the bootloader itself.
+ *
+ * \ref Bootloader-Protocol
+ */
+namespace bluetoe
+{
+    namespace bootloader {
+
+        /** @cond HIDDEN_SYMBOLS */
+        namespace details {
+            class delta_encoder
+            {
+            public:
+                delta_encoder( const std::uint8_t* old_image, std::size_t old_size, const std::uint8_t* new_image, std::size_t new_size,
+                    std::size_t in_place_page_size )
+                    : old_( old_image )
+                    , old_size_( old_size )
+                    , new_( new_image )
+                    , new_size_( new_size )
+                    , page_size_( in_place_page_size )
+                {
+                    for ( std::size_t pos = 0; pos + key_size <= old_size_; ++pos )
+                    {
+                        auto& candidates = index_[ key( old_, pos ) ];
+
+                        if ( candidates.size() < max_candidates )
+                            candidates.push_back( pos );
+                    }
+                }
+
+                struct operation
+                {
+                    bool        copy;
+                    std::size_t position;
+                    std::size_t length;
+                };
+
+                std::vector< operation > operations() const
+                {
+                    std::vector< operation > result;
+                    std::size_t expected = 0;
+
+                    for ( std::size_t pos = 0; pos != new_size_; )
+                    {
+                        const operation match = find_match( pos, expected );
+
+                        if ( match.length >= min_copy )
+                        {
+                            result.push_back( match );
+                            pos      += match.length;
+                            expected  = match.position + match.length;
+                        }
+                        else
+                        {
+                            if ( result.empty() || result.back().copy )
+                                result.push_back( operation{ false, pos, 0 } );
+
+                            ++result.back().length;
+                            ++pos;
+                            ++expected;
+                        }
+                    }
+
+                    return result;
+                }
+
+            private:
+                static constexpr std::size_t key_size       = 4;
+                static constexpr std::size_t max_candidates = 64;
+                static constexpr std::size_t min_copy       = 6;
+
+                static std::uint32_t key( const std::uint8_t* data, std::size_t pos )
+                {
+                    return data[ pos ] | ( data[ pos + 1 ] << 8 ) | ( data[ pos + 2 ] << 16 ) | ( static_cast< std::uint32_t >( data[ pos + 3 ] ) << 24 );
+                }
+
+                // when patched in place, the source must not be in a page that is already overwritten
+                std::size_t max_length( std::size_t pos, std::size_t source ) const
+                {
+                    std::size_t result = std::min( new_size_ - pos, old_size_ - source );
+
+                    if ( page_size_ )
+                    {
+                        const std::size_t limit = ( source / page_size_ + 1 ) * page_size_;
+
+                        if ( limit <= pos )
+                            return 0;
+
+                        result = std::min( result, limit - pos );
+                    }
+
+                    return result;
+                }
+
+                std::size_t match_length( std::size_t pos, std::size_t source ) const
+                {
+                    const std::size_t limit = max_length( pos, source );
+                    std::size_t length = 0;
+
+                    while ( length != limit && old_[ source + length ] == new_[ pos + length ] )
+                        ++length;
+
+                    return length;
+                }
+
+                operation find_match( std::size_t pos, std::size_t expected ) const
+                {
+                    // prefer to continue at the expected position in the old image
+                    operation best{ true, expected, expected < old_size_ ? match_length( pos, expected ) : 0 };
+
+                    if ( pos + key_size > new_size_ )
+                        return best;
+
+                    const auto candidates = index_.find( key( new_, pos ) );
+
+                    if ( candidates == index_.end() )
+                        return best;
+
+                    for ( const std::size_t source : candidates->second )
+                    {
+                        const std::size_t length = match_length( pos, source );
+
+                        if ( length > best.length )
+                            best = operation{ true, source, length };
+                    }
+
+                    return best;
+                }
+
+                const std::uint8_t* const   old_;
+                const std::size_t           old_size_;
+                const std::uint8_t* const   new_;
+                const std::size_t           new_size_;
+                const std::size_t           page_size_;
+
+                std::unordered_map< std::uint32_t, std::vector< std::size_t > > index_;
+            };
+
+            class patch_writer
+            {
+            public:
+                patch_writer( const std::uint8_t* new_image, std::size_t max_chunk_size, std::size_t max_decompressed_chunk_size )
+                    : new_( new_image )
+                    , max_chunk_( max_chunk_size )
+                    , max_decompressed_( max_decompressed_chunk_size )
+                    , source_pos_( 0 )
+                {
+                    assert( max_chunk_size >= 2 * max_varint_size );
+                    assert( max_decompressed_chunk_size > 0 );
+                }
+
+                std::vector< compressed_chunk > write( const std::vector< delta_encoder::operation >& operations )
+                {
+                    result_.push_back( compressed_chunk{ {}, 0 } );
+
+                    for ( auto op : operations )
+                    {
+                        while ( op.length )
+                        {
+                            const std::size_t length = op.copy
+                                ? write_copy( op.position, op.length )
+                                : write_insert( op.position, op.length );
+
+                            if ( length == 0 )
+                            {
+                                result_.push_back( compressed_chunk{ {}, 0 } );
+                                continue;
+                            }
+
+                            op.position += length;
+                            op.length   -= length;
+                        }
+                    }
+
+                    if ( result_.back().data.empty() )
+                        result_.pop_back();
+
+                    return std::move( result_ );
+                }
+
+            private:
+                static constexpr std::size_t max_varint_size = 5;
+
+                static std::size_t varint_size( std::uint32_t value )
+                {
+                    std::size_t size = 1;
+
+                    for ( ; value >= 0x80; value >>= 7 )
+                        ++size;
+
+                    return size;
+                }
+
+                static void write_varint( std::vector< std::uint8_t >& out, std::uint32_t value )
+                {
+                    for ( ; value >= 0x80; value >>= 7 )
+                        out.push_back( static_cast< std::uint8_t >( value | 0x80 ) );
+
+                    out.push_back( static_cast< std::uint8_t >( value ) );
+                }
+
+                std::size_t output_left() const
+                {
+                    return max_decompressed_ - result_.back().decompressed_size;
+                }
+
+                std::size_t bytes_left() const
+                {
+                    return max_chunk_ - result_.back().data.size();
+                }
+
+                // returns the number of bytes written or 0, if the chunk is full
+                std::size_t write_insert( std::size_t position, std::size_t length )
+                {
+                    length = std::min( length, output_left() );
+
+                    while ( length && varint_size( static_cast< std::uint32_t >( length << 1 ) ) + length > bytes_left() )
+                        --length;
+
+                    if ( length == 0 )
+                        return 0;
+
+                    compressed_chunk& chunk = result_.back();
+                    write_varint( chunk.data, static_cast< std::uint32_t >( length << 1 ) );
+                    chunk.data.insert( chunk.data.end(), new_ + position, new_ + position + length );
+                    chunk.decompressed_size += length;
+
+                    return length;
+                }
+
+                std::size_t write_copy( std::size_t position, std::size_t length )
+                {
+                    length = std::min( length, output_left() );
+
+                    const std::uint32_t distance = position >= source_pos_
+                        ? static_cast< std::uint32_t >( ( position - source_pos_ ) << 1 )
+                        : static_cast< std::uint32_t >( ( ( source_pos_ - position - 1 ) << 1 ) | 1 );
+
+                    if ( length == 0 || varint_size( static_cast< std::uint32_t >( ( length << 1 ) | 1 ) ) + varint_size( distance ) > bytes_left() )
+                        return 0;
+
+                    compressed_chunk& chunk = result_.back();
+                    write_varint( chunk.data, static_cast< std::uint32_t >( ( length << 1 ) | 1 ) );
+                    write_varint( chunk.data, distance );
+                    chunk.decompressed_size += length;
+
+                    source_pos_ = position + length;
+
+                    return length;
+                }
+
+                const std::uint8_t* const       new_;
+                const std::size_t               max_chunk_;
+                const std::size_t               max_decompressed_;
+                std::size_t                     source_pos_;
+                std::vector< compressed_chunk > result_;
+            };
+        }
+        /** @endcond */
+
+        /**
+         * @brief creates a patch for the Start Patch procedure, that transforms old_image into new_image
+         *
+         * The patch consists of copy operations, that copy data from the old image and insert operations for
+         * data, that is not found in the old image. Like with compress(), the result is split into chunks, that
+         * are at max max_chunk_size bytes large and that result in at max max_decompressed_chunk_size bytes of
+         * the new image.
+         *
+         * If the patch is going to be applied in place (the new image will be written to the start address of
+         * the old image), in_place_page_size has to be the page size of the bootloader and the image has to
+         * start at a page boundary. The patch then does not refer to data in pages, that are already overwritten.
+         * If the new image is written to a different memory region (the scratch region for example),
+         * in_place_page_size has to be 0.
+         */
+        inline std::vector< compressed_chunk > delta_encode( const std::uint8_t* old_image, std::size_t old_size,
+            const std::uint8_t* new_image, std::size_t new_size,
+            std::size_t max_chunk_size, std::size_t max_decompressed_chunk_size, std::size_t in_place_page_size )
+        {
+            const details::delta_encoder encoder( old_image, old_size, new_image, new_size, in_place_page_size );
+
+            return details::patch_writer( new_image, max_chunk_size, max_decompressed_chunk_size ).write( encoder.operations() );
+        }
+    }
+}
+
+#endif
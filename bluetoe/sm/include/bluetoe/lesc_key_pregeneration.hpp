@@ -0,0 +1,133 @@
+#ifndef BLUETOE_SM_INCLUDE_LESC_KEY_PREGENERATION_HPP
+#define BLUETOE_SM_INCLUDE_LESC_KEY_PREGENERATION_HPP
+
+#include <bluetoe/ll_meta_types.hpp>
+#include <bluetoe/security_connection_data.hpp>
+
+#include <cstddef>
+#include <array>
+#include <utility>
+#include <algorithm>
+
+namespace bluetoe {
+
+    namespace details {
+        struct lesc_key_pregeneration_meta_type {};
+
+        using lesc_key_pair_t = std::pair< ecdh_public_key_t, ecdh_private_key_t >;
+    }
+
+    /**
+     * @brief generate LESC key pairs ahead of time
+     *
+     * By default, the security manager generates a new P-256 key pair, when the remote device sends
+     * its public key. Depending on the hardware, this can take tens of milliseconds, while the
+     * central is waiting for the response.
+     *
+     * With this option, the link layer generates key pairs between advertising events and stores up
+     * to two of them. A pairing then consumes a ready key pair and the consumed slot is filled again,
+     * when the link layer advertises again. Every key pair is used for a single pairing only. If no
+     * key pair is ready, the key pair is generated on the fly, as without this option.
+     *
+     * No key pairs are generated while connected, as generating a key pair usually takes longer than
+     * the time between two connection events. So a connection can consume at most two pregenerated
+     * key pairs; all further pairings within the same connection generate their key pair on the fly.
+     *
+     * Only one key pair is generated per call to the link layers run() function, so the delay
+     * added to the processing of a radio event is at most the time required to generate a single
+     * key pair.
+     *
+     * This option is meant to be passed as a link layer option to the selected device binding and is only
+     * used by the security managers that support LE Secure Connections.
+     *
+     * @sa lesc_security_manager
+     * @sa security_manager
+     */
+    class lesc_key_pregeneration
+    {
+    public:
+        /** @cond HIDDEN_SYMBOLS */
+        lesc_key_pregeneration()
+            : ready_{ { false, false } }
+        {
+        }
+
+        template < class SecurityFunctions >
+        details::lesc_key_pair_t lesc_key_pair( SecurityFunctions& functions )
+        {
+            for ( std::size_t slot = 0; slot != slots; ++slot )
+            {
+                if ( ready_[ slot ] )
+                {
+                    const details::lesc_key_pair_t result = keys_[ slot ];
+
+                    ready_[ slot ] = false;
+                    std::fill( keys_[ slot ].second.begin(), keys_[ slot ].second.end(), 0 );
+
+                    return result;
+                }
+            }
+
+            return functions.generate_keys();
+        }
+
+        template < class SecurityFunctions >
+        void pregenerate_lesc_key_pair( SecurityFunctions& functions )
+        {
+            for ( std::size_t slot = 0; slot != slots; ++slot )
+            {
+                if ( !ready_[ slot ] )
+                {
+                    keys_[ slot ]  = functions.generate_keys();
+                    ready_[ slot ] = true;
+
+                    return;
+                }
+            }
+        }
+
+        std::size_t pregenerated_lesc_key_pairs() const
+        {
+            return std::count( ready_.begin(), ready_.end(), true );
+        }
+
+        struct meta_type :
+            details::lesc_key_pregeneration_meta_type,
+            link_layer::details::valid_link_layer_option_meta_type {};
+
+    private:
+        static constexpr std::size_t slots = 2;
+
+        std::array< details::lesc_key_pair_t, slots >   keys_;
+        std::array< bool, slots >                       ready_;
+        /** @endcond */
+    };
+
+    namespace details {
+        class no_lesc_key_pregeneration
+        {
+        public:
+            template < class SecurityFunctions >
+            lesc_key_pair_t lesc_key_pair( SecurityFunctions& functions )
+            {
+                return functions.generate_keys();
+            }
+
+            template < class SecurityFunctions >
+            void pregenerate_lesc_key_pair( SecurityFunctions& )
+            {
+            }
+
+            std::size_t pregenerated_lesc_key_pairs() const
+            {
+                return 0;
+            }
+
+            struct meta_type :
+                details::lesc_key_pregeneration_meta_type,
+                link_layer::details::valid_link_layer_option_meta_type {};
+        };
+    }
+}
+
+#endif // include guard
@@ -6,6 +6,7 @@
 #include <cassert>
 #include <array>
 #include <algorithm>
+#include <iterator>
 
 #include <bluetoe/codes.hpp>
 #include <bluetoe/address.hpp>
@@ -17,6 +18,7 @@
 #include <bluetoe/io_capabilities.hpp>
 #include <bluetoe/l2cap_channels.hpp>
 #include <bluetoe/security_connection_data.hpp>
+#include <bluetoe/lesc_key_pregeneration.hpp>
 
 namespace bluetoe {
 
@@ -253,7 +255,11 @@ namespace bluetoe {
             protected details::find_by_meta_type<
                 details::oob_authentication_callback_meta_type,
                 Options...,
-                details::no_oob_authentication >::type
+                details::no_oob_authentication >::type,
+            protected details::find_by_meta_type<
+                details::lesc_key_pregeneration_meta_type,
+                Options...,
+                details::no_lesc_key_pregeneration >::type
         {
         protected:
             static constexpr std::uint8_t authentication_requirements_flags =
@@ -366,6 +372,7 @@ namespace bluetoe {
             static constexpr std::uint16_t channel_id               = l2cap_channel_ids::sm;
             static constexpr std::size_t   minimum_channel_mtu_size = default_att_mtu_size;
             static constexpr std::size_t   maximum_channel_mtu_size = default_att_mtu_size;
+            static constexpr std::uint16_t output_deadline          = 1;
 
             using base_t = security_manager_base< SecurityFunctions, ConnectionData, Options... >;
 
@@ -385,9 +392,15 @@ namespace bluetoe {
             template < class Connection >
             void l2cap_output( std::uint8_t* output, std::size_t& out_size, Connection& );
 
+            /*
+             * called by the link layer, when there is time to do some work in the background
+             */
+            void l2cap_idle();
+
             static constexpr std::uint16_t channel_id               = l2cap_channel_ids::sm;
             static constexpr std::size_t   minimum_channel_mtu_size = default_lesc_mtu_size;
             static constexpr std::size_t   maximum_channel_mtu_size = default_lesc_mtu_size;
+            static constexpr std::uint16_t output_deadline          = 1;
 
             using base_t = security_manager_base< SecurityFunctions, ConnectionData, Options... >;
 
@@ -407,9 +420,15 @@ namespace bluetoe {
             template < class Connection >
             void l2cap_output( std::uint8_t* output, std::size_t& out_size, Connection& );
 
+            /*
+             * called by the link layer, when there is time to do some work in the background
+             */
+            void l2cap_idle();
+
             static constexpr std::uint16_t channel_id               = l2cap_channel_ids::sm;
             static constexpr std::size_t   minimum_channel_mtu_size = default_lesc_mtu_size;
             static constexpr std::size_t   maximum_channel_mtu_size = default_lesc_mtu_size;
+            static constexpr std::uint16_t output_deadline          = 1;
 
             using base_t = security_manager_base< SecurityFunctions, ConnectionData, Options... >;
 
@@ -920,7 +939,7 @@ namespace bluetoe {
         output[ 0 ] = static_cast< std::uint8_t >( details::sm_opcodes::pairing_public_key );
 
         out_size = public_key_exchange_size;
-        const auto& keys  = security_functions().generate_keys();
+        const auto  keys  = this->lesc_key_pair( security_functions() );
         const auto& nonce = security_functions().select_random_nonce();
 
         state.public_key_exchanged( keys.second, keys.first, &input[ 1 ], nonce );
@@ -1158,6 +1177,12 @@ namespace bluetoe {
         }
     }
 
+    template < typename SecurityFunctions, template < class OtherConnectionData > class ConnectionData, typename ... Options >
+    void details::lesc_security_manager_impl< SecurityFunctions, ConnectionData, Options... >::l2cap_idle()
+    {
+        this->pregenerate_lesc_key_pair( this->security_functions() );
+    }
+
     // security_manager_impl
     template < typename SecurityFunctions, template < class OtherConnectionData > class ConnectionData, typename ... Options >
     template < class Connection >
@@ -1217,6 +1242,12 @@ namespace bluetoe {
         }
     }
 
+    template < typename SecurityFunctions, template < class OtherConnectionData > class ConnectionData, typename ... Options >
+    void details::security_manager_impl< SecurityFunctions, ConnectionData, Options... >::l2cap_idle()
+    {
+        this->pregenerate_lesc_key_pair( this->security_functions() );
+    }
+
     template < typename SecurityFunctions, template < class OtherConnectionData > class ConnectionData, typename ... Options >
     template < class Connection >
     void details::security_manager_impl< SecurityFunctions, ConnectionData, Options... >::handle_pairing_request( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, Connection& state )
@@ -0,0 +1,173 @@
+#ifndef BLUETOE_UNCHANGED_NOTIFICATIONS_HPP
+#define BLUETOE_UNCHANGED_NOTIFICATIONS_HPP
+
+#include <bluetoe/meta_types.hpp>
+
+#include <cstdint>
+#include <cstddef>
+
+namespace bluetoe {
+
+    namespace details {
+        struct suppress_unchanged_notifications_meta_type {};
+    }
+
+    /**
+     * @brief notifications of the characteristic are only sent, if the value changed since the last notification
+     *
+     * By default, every call to server::notify() results in a notification being sent to the client, even when
+     * the value of the characteristic did not change. With this option, the server keeps a digest of the last
+     * notified value per connection and drops a notification, when the current value has the same digest,
+     * before the notification consumes any link layer buffer.
+     *
+     * Values of up to 4 octets are compared exactly. For longer values, a 32 bit FNV-1a hash of the value is
+     * compared, so in very rare cases, a changed value could be taken for an unchanged one.
+     *
+     * The first notification after a connection was established is always sent. Indications are not affected.
+     * The number of dropped notifications is counted per connection and is available by
+     * server::connection_data::suppressed_notifications().
+     *
+     * Example
+     * @code
+    std::int16_t temperature = 0;
+
+    using server = bluetoe::server<
+        bluetoe::service<
+            service_uuid,
+            bluetoe::characteristic<
+                temperature_uuid,
+                bluetoe::bind_characteristic_value< decltype( temperature ), &temperature >,
+                bluetoe::notify,
+                bluetoe::suppress_unchanged_notifications
+            >
+        >
+    >;
+     * @endcode
+     *
+     * @sa notify
+     * @sa characteristic
+     */
+    struct suppress_unchanged_notifications
+    {
+        /** @cond HIDDEN_SYMBOLS */
+        struct meta_type :
+            details::suppress_unchanged_notifications_meta_type,
+            details::valid_characteristic_option_meta_type {};
+        /** @endcond */
+    };
+
+    namespace details {
+
+        /*
+         * digest of the last notified value of a characteristic
+         */
+        class notification_digest
+        {
+        public:
+            notification_digest()
+                : digest_( 0 )
+                , size_( invalid_size )
+            {
+            }
+
+            /*
+             * returns true, if the value differs from the last value passed to changed() and stores the digest of the value
+             */
+            bool changed( const std::uint8_t* value, std::size_t size )
+            {
+                const std::uint32_t digest = calculate_digest( value, size );
+
+                if ( size == size_ && digest == digest_ )
+                    return false;
+
+                digest_ = digest;
+                size_   = static_cast< std::uint16_t >( size );
+
+                return true;
+            }
+
+        private:
+            static constexpr std::uint16_t  invalid_size            = 0xffff;
+            static constexpr std::size_t    shadow_copy_size        = sizeof( std::uint32_t );
+            static constexpr std::uint32_t  fnv_offset_basis        = 2166136261u;
+            static constexpr std::uint32_t  fnv_prime               = 16777619u;
+
+            static std::uint32_t calculate_digest( const std::uint8_t* value, std::size_t size )
+            {
+                std::uint32_t result = 0;
+
+                if ( size <= shadow_copy_size )
+                {
+                    for ( std::size_t i = 0; i != size; ++i )
+                        result |= static_cast< std::uint32_t >( value[ i ] ) << ( 8 * i );
+                }
+                else
+                {
+                    result = fnv_offset_basis;
+
+                    for ( std::size_t i = 0; i != size; ++i )
+                        result = ( result ^ value[ i ] ) * fnv_prime;
+                }
+
+                return result;
+            }
+
+            std::uint32_t   digest_;
+            std::uint16_t   size_;
+        };
+
+        /*
+         * per connection digests of all characteristics with suppress_unchanged_notifications
+         */
+        template < std::size_t Size >
+        class notification_digests
+        {
+        public:
+            notification_digests()
+                : suppressed_( 0 )
+            {
+            }
+
+            /**
+             * @brief number of notifications, that where not sent, because the value of the characteristic did not change
+             *
+             * @sa suppress_unchanged_notifications
+             */
+            std::uint32_t suppressed_notifications() const
+            {
+                return suppressed_;
+            }
+
+            bool notification_value_changed( std::size_t digest_index, const std::uint8_t* value, std::size_t size )
+            {
+                if ( digest_index >= Size || digests_[ digest_index ].changed( value, size ) )
+                    return true;
+
+                ++suppressed_;
+
+                return false;
+            }
+
+        private:
+            notification_digest digests_[ Size ];
+            std::uint32_t       suppressed_;
+        };
+
+        template <>
+        class notification_digests< 0 >
+        {
+        public:
+            std::uint32_t suppressed_notifications() const
+            {
+                return 0;
+            }
+
+            bool notification_value_changed( std::size_t, const std::uint8_t*, std::size_t )
+            {
+                return true;
+            }
+        };
+    }
+}
+
+#endif
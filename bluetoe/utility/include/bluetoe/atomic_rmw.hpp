@@ -0,0 +1,140 @@
+#ifndef BLUETOE_UTILITY_ATOMIC_RMW_HPP
+#define BLUETOE_UTILITY_ATOMIC_RMW_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+namespace bluetoe {
+namespace details {
+
+    /** @cond HIDDEN_SYMBOLS */
+
+    /*
+     * Read-modify-write operations on std::atomic objects, that are shared between interrupt priorities.
+     *
+     * ARMv6-M (Cortex-M0 / M0+, for example the nRF51) lacks the exclusive load / store instructions. There,
+     * the read-modify-write member functions of std::atomic are not lock-free and are compiled to calls into
+     * a library, that is usually not available. As all these targets are single core, the operations are
+     * performed with a load and a store, while interrupts are disabled. All other targets use std::atomic.
+     */
+#if defined( __ARM_ARCH_6M__ )
+
+    class atomic_rmw_lock
+    {
+    public:
+        atomic_rmw_lock()
+        {
+            __asm volatile (
+                "mrs %0, primask\n"
+                "cpsid i\n" : "=r" ( primask_ ) : : "memory" );
+        }
+
+        ~atomic_rmw_lock()
+        {
+            __asm volatile ( "msr primask, %0\n" : : "r" ( primask_ ) : "memory" );
+        }
+
+        atomic_rmw_lock( const atomic_rmw_lock& ) = delete;
+        atomic_rmw_lock& operator=( const atomic_rmw_lock& ) = delete;
+
+    private:
+        std::uint32_t primask_;
+    };
+
+    template < typename T >
+    T atomic_fetch_or( std::atomic< T >& object, typename std::common_type< T >::type value, std::memory_order = std::memory_order_seq_cst )
+    {
+        const atomic_rmw_lock lock;
+        const T result = object.load( std::memory_order_relaxed );
+        object.store( static_cast< T >( result | value ), std::memory_order_relaxed );
+
+        return result;
+    }
+
+    template < typename T >
+    T atomic_fetch_and( std::atomic< T >& object, typename std::common_type< T >::type value, std::memory_order = std::memory_order_seq_cst )
+    {
+        const atomic_rmw_lock lock;
+        const T result = object.load( std::memory_order_relaxed );
+        object.store( static_cast< T >( result & value ), std::memory_order_relaxed );
+
+        return result;
+    }
+
+    template < typename T >
+    T atomic_fetch_add( std::atomic< T >& object, typename std::common_type< T >::type value, std::memory_order = std::memory_order_seq_cst )
+    {
+        const atomic_rmw_lock lock;
+        const T result = object.load( std::memory_order_relaxed );
+        object.store( static_cast< T >( result + value ), std::memory_order_relaxed );
+
+        return result;
+    }
+
+    template < typename T >
+    T atomic_exchange( std::atomic< T >& object, typename std::common_type< T >::type value, std::memory_order = std::memory_order_seq_cst )
+    {
+        const atomic_rmw_lock lock;
+        const T result = object.load( std::memory_order_relaxed );
+        object.store( value, std::memory_order_relaxed );
+
+        return result;
+    }
+
+    template < typename T >
+    bool atomic_compare_exchange( std::atomic< T >& object, T& expected, T desired, std::memory_order = std::memory_order_seq_cst )
+    {
+        const atomic_rmw_lock lock;
+        const T current = object.load( std::memory_order_relaxed );
+
+        if ( current != expected )
+        {
+            expected = current;
+            return false;
+        }
+
+        object.store( desired, std::memory_order_relaxed );
+
+        return true;
+    }
+
+#else
+
+    template < typename T >
+    T atomic_fetch_or( std::atomic< T >& object, typename std::common_type< T >::type value, std::memory_order order = std::memory_order_seq_cst )
+    {
+        return object.fetch_or( value, order );
+    }
+
+    template < typename T >
+    T atomic_fetch_and( std::atomic< T >& object, typename std::common_type< T >::type value, std::memory_order order = std::memory_order_seq_cst )
+    {
+        return object.fetch_and( value, order );
+    }
+
+    template < typename T >
+    T atomic_fetch_add( std::atomic< T >& object, typename std::common_type< T >::type value, std::memory_order order = std::memory_order_seq_cst )
+    {
+        return object.fetch_add( value, order );
+    }
+
+    template < typename T >
+    T atomic_exchange( std::atomic< T >& object, typename std::common_type< T >::type value, std::memory_order order = std::memory_order_seq_cst )
+    {
+        return object.exchange( value, order );
+    }
+
+    template < typename T >
+    bool atomic_compare_exchange( std::atomic< T >& object, T& expected, T desired, std::memory_order order = std::memory_order_seq_cst )
+    {
+        return object.compare_exchange_strong( expected, desired, order );
+    }
+
+#endif
+
+    /** @endcond */
+}
+}
+
+#endif
@@ -34,14 +34,27 @@ namespace details {
         // returned when access type is compare_128bit_uuid and the attribute contains a 128bit uuid and
         // the buffer in attribute_access_arguments is equal to the contained uuid.
         uuid_equal                      = 0x100,
-        value_equal
+        value_equal,
+
+        // returned when access type is query_write_through and the attribute wants prepared writes
+        // to be written directly, instead of being queued until they are executed.
+        write_through,
+
+        // returned when access type is query_write_command_burst and the attribute wants write commands
+        // to be collected and to be passed as a burst.
+        write_command_burst
     };
 
     enum class attribute_access_type {
         read,
         write,
         compare_128bit_uuid,
-        compare_value
+        compare_value,
+        query_write_through,
+        commit_write,
+        rollback_write,
+        query_write_command_burst,
+        write_command_burst
     };
 
     struct attribute_access_arguments
@@ -138,6 +151,70 @@ namespace details {
             };
         }
 
+        static constexpr attribute_access_arguments query_write_through( const connection_security_attributes& cs, void* server )
+        {
+            return attribute_access_arguments{
+                attribute_access_type::query_write_through,
+                0,
+                0,
+                0,
+                client_characteristic_configuration(),
+                cs,
+                server
+            };
+        }
+
+        static constexpr attribute_access_arguments query_write_command_burst( const connection_security_attributes& cs, void* server )
+        {
+            return attribute_access_arguments{
+                attribute_access_type::query_write_command_burst,
+                0,
+                0,
+                0,
+                client_characteristic_configuration(),
+                cs,
+                server
+            };
+        }
+
+        /*
+         * passes count collected write commands to the attribute; writes points to an array of bluetoe::write_command_view
+         */
+        static attribute_access_arguments write_command_burst( const void* writes, std::size_t count,
+            const client_characteristic_configuration& cc,
+            const connection_security_attributes& cs,
+            void* server )
+        {
+            return attribute_access_arguments{
+                attribute_access_type::write_command_burst,
+                static_cast< std::uint8_t* >( const_cast< void* >( writes ) ),
+                count,
+                0,
+                cc,
+                cs,
+                server
+            };
+        }
+
+        /*
+         * commit or rollback all prepared writes, that were written through to the attribute
+         */
+        static constexpr attribute_access_arguments end_write_through( bool commit,
+            const client_characteristic_configuration& cc,
+            const connection_security_attributes& cs,
+            void* server )
+        {
+            return attribute_access_arguments{
+                commit ? attribute_access_type::commit_write : attribute_access_type::rollback_write,
+                0,
+                0,
+                0,
+                cc,
+                cs,
+                server
+            };
+        }
+
         static constexpr attribute_access_arguments compare_128bit_uuid( const std::uint8_t* uuid )
         {
             return attribute_access_arguments{
@@ -0,0 +1,213 @@
+#ifndef BLUETOE_UTILITY_CTR_DRBG_HPP
+#define BLUETOE_UTILITY_CTR_DRBG_HPP
+
+#include <array>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace bluetoe {
+namespace details {
+
+    /**
+     * @brief deterministic random bit generator, based on AES-128 in counter mode
+     *
+     * CTR_DRBG of NIST SP 800-90A (AES-128, no derivation function, no prediction resistance).
+     * The generator is seeded once from an entropy source and serves random bytes out of a buffer
+     * of BufferBlocks blocks of keystream. Every refill of the buffer is a single Generate() call
+     * of SP 800-90A, so the internal state is updated after BufferBlocks blocks. Served bytes are
+     * erased from the buffer.
+     *
+     * Traits has to provide two static functions:
+     *
+     * - std::array< std::uint8_t, 16 > aes( const std::array< std::uint8_t, 16 >& key, const std::array< std::uint8_t, 16 >& data )
+     *
+     *   AES-128 with key, data and result in the usual bluetoe byte order (low to high)
+     *
+     * - void entropy( std::uint8_t* buffer, std::size_t size )
+     *
+     *   fills the buffer with size bytes of full entropy. Called at most once, on the first request
+     *   for random bytes, if the generator was not explicitly seeded before.
+     *
+     * The generator is not thread safe.
+     */
+    template < class Traits, std::size_t BufferBlocks = 4 >
+    class ctr_drbg
+    {
+    public:
+        using block_t = std::array< std::uint8_t, 16 >;
+
+        /**
+         * @brief size of the seed material (entropy input) in bytes
+         */
+        static constexpr std::size_t seed_size = 32;
+
+        /**
+         * @brief constructs an unseeded generator
+         */
+        ctr_drbg();
+
+        /**
+         * @brief (re)seeds the generator with seed_size bytes of seed material
+         *
+         * All buffered random bytes are discarded.
+         */
+        void seed( const std::uint8_t* seed_material );
+
+        /**
+         * @brief returns true, if the generator is seeded
+         */
+        bool seeded() const;
+
+        /**
+         * @brief fills output with size random bytes
+         */
+        void generate( std::uint8_t* output, std::size_t size );
+
+        /**
+         * @brief returns a random unsigned integer of type T
+         */
+        template < typename T >
+        T random_number();
+
+    private:
+        static_assert( BufferBlocks > 0, "at least one block of buffer required" );
+
+        static constexpr std::size_t block_size  = 16;
+        static constexpr std::size_t buffer_size = BufferBlocks * block_size;
+
+        // Key and V are stored in bluetoe byte order (reversed compared to SP 800-90A)
+        void increment_counter();
+        block_t next_block();
+        void update( const std::uint8_t* provided_data );
+        void refill();
+
+        block_t         key_;
+        block_t         counter_;
+        std::uint8_t    buffer_[ buffer_size ];
+        std::size_t     used_;
+        bool            seeded_;
+    };
+
+    // implementation
+    template < class Traits, std::size_t BufferBlocks >
+    ctr_drbg< Traits, BufferBlocks >::ctr_drbg()
+        : key_{{ 0 }}
+        , counter_{{ 0 }}
+        , buffer_{ 0 }
+        , used_( buffer_size )
+        , seeded_( false )
+    {
+    }
+
+    template < class Traits, std::size_t BufferBlocks >
+    void ctr_drbg< Traits, BufferBlocks >::seed( const std::uint8_t* seed_material )
+    {
+        key_.fill( 0 );
+        counter_.fill( 0 );
+        update( seed_material );
+
+        std::fill( std::begin( buffer_ ), std::end( buffer_ ), 0 );
+        used_   = buffer_size;
+        seeded_ = true;
+    }
+
+    template < class Traits, std::size_t BufferBlocks >
+    bool ctr_drbg< Traits, BufferBlocks >::seeded() const
+    {
+        return seeded_;
+    }
+
+    template < class Traits, std::size_t BufferBlocks >
+    void ctr_drbg< Traits, BufferBlocks >::generate( std::uint8_t* output, std::size_t size )
+    {
+        if ( !seeded_ )
+        {
+            std::uint8_t entropy[ seed_size ];
+            Traits::entropy( entropy, seed_size );
+            seed( entropy );
+            std::fill( std::begin( entropy ), std::end( entropy ), 0 );
+        }
+
+        while ( size )
+        {
+            if ( used_ == buffer_size )
+                refill();
+
+            const std::size_t chunk = std::min( size, buffer_size - used_ );
+            std::uint8_t* const begin = &buffer_[ used_ ];
+
+            output = std::copy( begin, begin + chunk, output );
+            std::fill( begin, begin + chunk, 0 );
+
+            used_ += chunk;
+            size  -= chunk;
+        }
+    }
+
+    template < class Traits, std::size_t BufferBlocks >
+    template < typename T >
+    T ctr_drbg< Traits, BufferBlocks >::random_number()
+    {
+        std::uint8_t bytes[ sizeof( T ) ];
+        generate( bytes, sizeof( T ) );
+
+        T result = 0;
+
+        for ( std::size_t i = sizeof( T ); i != 0; --i )
+            result = static_cast< T >( ( result << 8 ) | bytes[ i - 1 ] );
+
+        return result;
+    }
+
+    template < class Traits, std::size_t BufferBlocks >
+    void ctr_drbg< Traits, BufferBlocks >::increment_counter()
+    {
+        for ( auto& byte : counter_ )
+        {
+            if ( ++byte != 0 )
+                return;
+        }
+    }
+
+    template < class Traits, std::size_t BufferBlocks >
+    typename ctr_drbg< Traits, BufferBlocks >::block_t ctr_drbg< Traits, BufferBlocks >::next_block()
+    {
+        increment_counter();
+
+        return Traits::aes( key_, counter_ );
+    }
+
+    template < class Traits, std::size_t BufferBlocks >
+    void ctr_drbg< Traits, BufferBlocks >::update( const std::uint8_t* provided_data )
+    {
+        // provided_data is in the byte order of SP 800-90A; new Key = first, new V = second block
+        const block_t first  = next_block();
+        const block_t second = next_block();
+
+        for ( std::size_t i = 0; i != block_size; ++i )
+        {
+            key_[ block_size - 1 - i ]     = first[ block_size - 1 - i ] ^ provided_data[ i ];
+            counter_[ block_size - 1 - i ] = second[ block_size - 1 - i ] ^ provided_data[ block_size + i ];
+        }
+    }
+
+    template < class Traits, std::size_t BufferBlocks >
+    void ctr_drbg< Traits, BufferBlocks >::refill()
+    {
+        for ( std::size_t block = 0; block != BufferBlocks; ++block )
+        {
+            const block_t keystream = next_block();
+            std::reverse_copy( keystream.begin(), keystream.end(), &buffer_[ block * block_size ] );
+        }
+
+        // backtracking resistance
+        static const std::uint8_t no_additional_input[ seed_size ] = { 0 };
+        update( no_additional_input );
+
+        used_ = 0;
+    }
+}
+}
+
+#endif
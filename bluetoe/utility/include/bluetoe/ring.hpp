@@ -3,15 +3,28 @@
 
 #include <atomic>
 #include <cstdint>
+#include <cstddef>
 
 namespace bluetoe {
 namespace details {
 
+    /** @cond HIDDEN_SYMBOLS */
+    constexpr std::size_t round_up_to_power_of_two( std::size_t value, std::size_t result = 1 )
+    {
+        return result >= value ? result : round_up_to_power_of_two( value, result * 2 );
+    }
+    /** @endcond */
+
     /**
      * @brief an atomic ring buffer
      *
      * Ring buffer that supports a single consumer, single producer which
      * do not have to run in the same CPU context.
+     *
+     * try_push() must only be called by the producer and try_pop() must only be called by the consumer.
+     * Both indices are free running counters, that are written only by one side and published with release
+     * semantic. The underlying array is rounded up to a power of two, so that the counters are mapped to
+     * array indices by masking.
      */
     template < std::size_t S, typename T >
     class ring
@@ -22,18 +35,27 @@ namespace details {
          */
         ring();
 
+        /**
+         * @brief appends a copy of the given element, if the ring contains less than S elements
+         */
         bool try_push( const T& );
 
+        /**
+         * @brief removes the oldest element from the ring, if the ring is not empty
+         */
         bool try_pop( T& );
 
     private:
-        // queue is empty, if both point to the very same element
-        // if read_ptr_ != write_ptr_, the ring is not empty and data_[ read_ptr_ ]
-        // contains the next element to read from.
-        std::atomic_int read_ptr_;
-        std::atomic_int write_ptr_;
+        static constexpr std::size_t length = round_up_to_power_of_two( S );
+        static constexpr unsigned    mask   = length - 1;
 
-        static constexpr std::size_t length = S + 1;
+        static_assert( S > 0, "a ring has to have room for at least one element" );
+        static_assert( length <= ( 1u << ( sizeof( unsigned ) * 8 - 1 ) ), "S is too large" );
+
+        // queue is empty, if both counters are equal. Otherwise, data_[ read_ptr_ & mask ]
+        // contains the next element to read from.
+        std::atomic< unsigned > read_ptr_;
+        std::atomic< unsigned > write_ptr_;
 
         T data_[ length ];
     };
@@ -50,15 +72,14 @@ namespace details {
     template < std::size_t S, typename T >
     bool ring< S, T >::try_push( const T& in )
     {
-        const int read  = read_ptr_.load();
-        const int write = write_ptr_.load();
-        const int next  = ( write + 1 ) % length;
+        const unsigned write = write_ptr_.load( std::memory_order_relaxed );
+        const unsigned read  = read_ptr_.load( std::memory_order_acquire );
 
-        if ( next == read )
+        if ( write - read == S )
             return false;
 
-        data_[ write ] = in;
-        write_ptr_.store( next );
+        data_[ write & mask ] = in;
+        write_ptr_.store( write + 1, std::memory_order_release );
 
         return true;
     }
@@ -66,16 +87,14 @@ namespace details {
     template < std::size_t S, typename T >
     bool ring< S, T >::try_pop( T& out )
     {
-        const int read  = read_ptr_.load();
-        const int write = write_ptr_.load();
+        const unsigned read  = read_ptr_.load( std::memory_order_relaxed );
+        const unsigned write = write_ptr_.load( std::memory_order_acquire );
 
         if ( read == write )
             return false;
 
-        const int next  = ( read + 1 ) % length;
-
-        out = data_[ read ];
-        read_ptr_.store( next );
+        out = data_[ read & mask ];
+        read_ptr_.store( read + 1, std::memory_order_release );
 
         return true;
     }
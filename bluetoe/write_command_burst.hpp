@@ -0,0 +1,206 @@
+#ifndef BLUETOE_WRITE_COMMAND_BURST_HPP
+#define BLUETOE_WRITE_COMMAND_BURST_HPP
+
+#include <bluetoe/meta_types.hpp>
+#include <bluetoe/attribute_handle.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+namespace bluetoe {
+
+    namespace details {
+        struct write_command_burst_buffer_meta_type {};
+    }
+
+    /**
+     * @brief a single write command, that is part of a burst of write commands
+     *
+     * value points to the written octets and is only valid during the call to the burst handler.
+     *
+     * @sa free_write_command_burst_handler
+     */
+    struct write_command_view {
+        /**
+         * @brief the written value
+         */
+        const std::uint8_t* value;
+
+        /**
+         * @brief the size of the written value in octets
+         */
+        std::size_t         size;
+    };
+
+    /**
+     * @brief defines a per connection buffer, to collect write commands to a characteristic with a
+     *        free_write_command_burst_handler
+     *
+     * All "Write Command"s to the same characteristic with a free_write_command_burst_handler, that arrive during
+     * one connection event, are copied into this buffer and are passed to the handler in a single call at the end
+     * of the connection event. Up to N write commands with a total size of S octets are collected. If the buffer
+     * overflows, the collected write commands are passed to the handler and collecting starts again.
+     *
+     * Without this option, every write command is passed to the burst handler on its own.
+     *
+     * @sa free_write_command_burst_handler
+     * @sa server
+     *
+     * example:
+     * @code
+    typedef bluetoe::server<
+        bluetoe::write_command_burst_buffer< 512, 32 >,
+    ...
+    > logging_server;
+     * @endcode
+     */
+    template < std::uint16_t S, std::size_t N = 16 >
+    struct write_command_burst_buffer {
+        /** @cond HIDDEN_SYMBOLS */
+        static_assert( S > 0 && N > 0, "a write command burst buffer needs room for at least one write command" );
+
+        struct meta_type :
+            details::write_command_burst_buffer_meta_type,
+            details::valid_server_option_meta_type {};
+
+        static constexpr std::uint16_t buffer_size       = S;
+        static constexpr std::size_t   number_of_writes  = N;
+        /** @endcond */
+    };
+
+namespace details {
+
+    /*
+     * default, if no write_command_burst_buffer<> is given
+     */
+    struct no_write_command_burst_buffer {
+        struct meta_type :
+            details::write_command_burst_buffer_meta_type,
+            details::valid_server_option_meta_type {};
+
+        static constexpr std::uint16_t buffer_size       = 0;
+        static constexpr std::size_t   number_of_writes  = 0;
+    };
+
+    /*
+     * Per connection part of the write command burst buffer; the server's connection data derives from this type.
+     * All member names are prefixed with 'write_command_burst', because this type will be mixed into the
+     * connection data.
+     */
+    template < std::size_t Size, std::size_t Writes >
+    class write_command_burst_client
+    {
+    public:
+        write_command_burst_client()
+            : index_( invalid_attribute_index )
+            , used_( 0 )
+            , count_( 0 )
+        {
+        }
+
+        /*
+         * the copy has to point into its own buffer
+         */
+        write_command_burst_client( const write_command_burst_client& other )
+        {
+            *this = other;
+        }
+
+        write_command_burst_client& operator=( const write_command_burst_client& other )
+        {
+            index_ = other.index_;
+            used_  = other.used_;
+            count_ = other.count_;
+
+            std::copy( &other.buffer_[ 0 ], &other.buffer_[ used_ ], &buffer_[ 0 ] );
+
+            for ( std::size_t write = 0; write != count_; ++write )
+                writes_[ write ] = write_command_view{ &buffer_[ other.writes_[ write ].value - &other.buffer_[ 0 ] ], other.writes_[ write ].size };
+
+            return *this;
+        }
+
+        /*
+         * attribute index of the characteristic, the collected writes belong to or invalid_attribute_index
+         */
+        std::size_t write_command_burst_index() const
+        {
+            return index_;
+        }
+
+        /*
+         * copies the given write command into the buffer; returns false, if there is no room left
+         */
+        bool write_command_burst_append( std::size_t index, const std::uint8_t* value, std::size_t size )
+        {
+            if ( count_ == Writes || Size - used_ < size )
+                return false;
+
+            std::copy( value, value + size, &buffer_[ used_ ] );
+            writes_[ count_ ] = write_command_view{ &buffer_[ used_ ], size };
+
+            index_  = index;
+            used_  += size;
+            ++count_;
+
+            return true;
+        }
+
+        const write_command_view* write_command_burst_writes() const
+        {
+            return &writes_[ 0 ];
+        }
+
+        std::size_t write_command_burst_count() const
+        {
+            return count_;
+        }
+
+        void write_command_burst_clear()
+        {
+            index_ = invalid_attribute_index;
+            used_  = 0;
+            count_ = 0;
+        }
+
+    private:
+        std::size_t         index_;
+        std::size_t         used_;
+        std::size_t         count_;
+        write_command_view  writes_[ Writes ];
+        std::uint8_t        buffer_[ Size ];
+    };
+
+    template <>
+    class write_command_burst_client< 0, 0 >
+    {
+    public:
+        std::size_t write_command_burst_index() const
+        {
+            return invalid_attribute_index;
+        }
+
+        bool write_command_burst_append( std::size_t, const std::uint8_t*, std::size_t )
+        {
+            return false;
+        }
+
+        const write_command_view* write_command_burst_writes() const
+        {
+            return nullptr;
+        }
+
+        std::size_t write_command_burst_count() const
+        {
+            return 0;
+        }
+
+        void write_command_burst_clear()
+        {
+        }
+    };
+}
+}
+
+#endif
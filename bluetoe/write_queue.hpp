@@ -55,6 +55,43 @@ namespace bluetoe {
         /** @endcond */
     };
 
+    /**
+     * @brief defines a write queue, that is partitioned into chunks, that are allocated per connection
+     *
+     * The write queue consists of N chunks of S bytes each. A connection that starts writing a long characteristic
+     * value gets a chunk assigned, until it is done with writing or gets disconnected. So up to N clients can execute
+     * the "Write Long Characteristic" procedure concurrently, while the memory used by the write queue stays bounded
+     * by N * S bytes. Only if all chunks are in use, a further connection will get an "Prepare Queue Full" error.
+     * Assigning a chunk to a connection and releasing it are constant time operations.
+     *
+     * The size S of a chunk has to be calculated like the size of a shared_write_queue. N is usually the maximum number
+     * of simultaneous connections.
+     *
+     * @sa shared_write_queue
+     * @sa server
+     *
+     * example:
+     * @code
+    typedef bluetoe::server<
+        bluetoe::pooled_write_queue< 142, 2 >,
+    ...
+    > large_object_server;
+     * @endcode
+     */
+    template < std::uint16_t S, std::size_t N >
+    struct pooled_write_queue {
+        /** @cond HIDDEN_SYMBOLS */
+        static_assert( N > 0 && N < 0xff, "number of chunks has to be in the range 1 - 254" );
+
+        struct meta_type :
+            details::write_queue_meta_type,
+            details::valid_server_option_meta_type {};
+
+        static constexpr std::uint16_t queue_size       = S;
+        static constexpr std::size_t   number_of_chunks = N;
+        /** @endcond */
+    };
+
 namespace details {
 
     /*
@@ -63,6 +100,32 @@ namespace details {
     template < typename QueueParameter >
     class write_queue;
 
+    /*
+     * Per connection part of a write queue; the server's connection data derives from this type.
+     */
+    template < typename QueueParameter >
+    class write_queue_client
+    {
+    };
+
+    template < std::uint16_t S, std::size_t N >
+    class write_queue_client< pooled_write_queue< S, N > >
+    {
+    public:
+        write_queue_client()
+            : write_queue_chunk_( no_chunk )
+        {
+        }
+
+    private:
+        template < typename QueueParameter >
+        friend class write_queue;
+
+        static constexpr std::uint8_t no_chunk = 0xff;
+
+        std::uint8_t write_queue_chunk_;
+    };
+
     template < std::uint16_t S >
     class write_queue< shared_write_queue< S > >
     {
@@ -103,6 +166,45 @@ namespace details {
         std::uint16_t   buffer_end_;
     };
 
+    template < std::uint16_t S, std::size_t N >
+    class write_queue< pooled_write_queue< S, N > >
+    {
+    public:
+        write_queue();
+
+        /*
+         * Same interface as write_queue< shared_write_queue< S > >, but ConData has to be derived from
+         * write_queue_client< pooled_write_queue< S, N > >
+         */
+        template < typename ConData >
+        std::uint8_t* allocate_from_write_queue( std::size_t n, ConData& client );
+
+        template < typename ConData >
+        void free_write_queue( ConData& client );
+
+        template < typename ConData >
+        std::pair< std::uint8_t*, std::size_t > first_write_queue_element( ConData& client );
+
+        template < typename ConData >
+        std::pair< std::uint8_t*, std::size_t > next_write_queue_element( std::uint8_t* current, ConData& client );
+
+    private:
+        using client_t = write_queue_client< pooled_write_queue< S, N > >;
+
+        struct chunk {
+            std::uint8_t    buffer_[ S ];
+            std::uint16_t   buffer_end_;
+        };
+
+        static std::size_t read_size( std::uint8_t* );
+
+        chunk           chunks_[ N ];
+
+        // stack of unused chunks
+        std::uint8_t    free_chunks_[ N ];
+        std::size_t     free_count_;
+    };
+
     struct no_such_type;
 
     template <>
@@ -206,6 +308,102 @@ namespace details {
         return *( last - 2 ) + *( last - 1 ) * 256;
     }
 
+    template < std::uint16_t S, std::size_t N >
+    write_queue< pooled_write_queue< S, N > >::write_queue()
+        : free_count_( N )
+    {
+        for ( std::size_t i = 0; i != N; ++i )
+            free_chunks_[ i ] = static_cast< std::uint8_t >( N - 1 - i );
+    }
+
+    template < std::uint16_t S, std::size_t N >
+    template < typename ConData >
+    std::uint8_t* write_queue< pooled_write_queue< S, N > >::allocate_from_write_queue( std::size_t size, ConData& con )
+    {
+        assert( size );
+
+        client_t& client = con;
+
+        if ( size + 2 > S )
+            return nullptr;
+
+        if ( client.write_queue_chunk_ == client_t::no_chunk )
+        {
+            if ( free_count_ == 0 )
+                return nullptr;
+
+            client.write_queue_chunk_ = free_chunks_[ --free_count_ ];
+            chunks_[ client.write_queue_chunk_ ].buffer_end_ = 0;
+        }
+
+        chunk& queue = chunks_[ client.write_queue_chunk_ ];
+
+        if ( size + 2 > static_cast< std::size_t >( S - queue.buffer_end_ ) )
+            return nullptr;
+
+        queue.buffer_[ queue.buffer_end_ ]     = size & 0xff;
+        queue.buffer_[ queue.buffer_end_ + 1 ] = size >> 8;
+
+        queue.buffer_end_ += size + 2;
+
+        return &queue.buffer_[ queue.buffer_end_ - size ];
+    }
+
+    template < std::uint16_t S, std::size_t N >
+    template < typename ConData >
+    void write_queue< pooled_write_queue< S, N > >::free_write_queue( ConData& con )
+    {
+        client_t& client = con;
+
+        if ( client.write_queue_chunk_ != client_t::no_chunk )
+        {
+            free_chunks_[ free_count_++ ] = client.write_queue_chunk_;
+            client.write_queue_chunk_     = client_t::no_chunk;
+        }
+    }
+
+    template < std::uint16_t S, std::size_t N >
+    template < typename ConData >
+    std::pair< std::uint8_t*, std::size_t > write_queue< pooled_write_queue< S, N > >::first_write_queue_element( ConData& con )
+    {
+        const client_t& client = con;
+
+        if ( client.write_queue_chunk_ == client_t::no_chunk || chunks_[ client.write_queue_chunk_ ].buffer_end_ == 0 )
+            return std::make_pair( nullptr, 0 );
+
+        std::uint8_t* const first = &chunks_[ client.write_queue_chunk_ ].buffer_[ 2 ];
+
+        return std::make_pair( first, read_size( first ) );
+    }
+
+    template < std::uint16_t S, std::size_t N >
+    template < typename ConData >
+    std::pair< std::uint8_t*, std::size_t > write_queue< pooled_write_queue< S, N > >::next_write_queue_element( std::uint8_t* last, ConData& con )
+    {
+        const client_t& client = con;
+
+        assert( last );
+        assert( client.write_queue_chunk_ != client_t::no_chunk );
+
+        chunk& queue = chunks_[ client.write_queue_chunk_ ];
+
+        assert( last >= &queue.buffer_[ 2 ] );
+        assert( last <= &queue.buffer_[ S ] );
+
+        // lets point last to the next size value
+        last += read_size( last );
+
+        return last == &queue.buffer_[ queue.buffer_end_ ]
+            ? std::make_pair( nullptr, 0 )
+            : std::make_pair( last + 2, read_size( last + 2 ) );
+    }
+
+    template < std::uint16_t S, std::size_t N >
+    std::size_t write_queue< pooled_write_queue< S, N > >::read_size( std::uint8_t* last )
+    {
+        return *( last - 2 ) + *( last - 1 ) * 256;
+    }
+
     template < typename ConData, typename WriteQueue >
     write_queue_guard< ConData, WriteQueue >::write_queue_guard( ConData& client, WriteQueue& queue )
         : client_( client )
@@ -219,3 +219,241 @@ BOOST_AUTO_TEST_SUITE( execute_write_with_fixed_attribute_handles )
     }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( execute_write_through )
+
+    std::array< std::uint8_t, 64 > staged;
+    std::array< std::uint8_t, 64 > committed;
+    int          commit_calls   = 0;
+    int          rollback_calls = 0;
+    std::uint8_t commit_result  = bluetoe::error_codes::success;
+
+    std::uint8_t write_staged( std::size_t offset, std::size_t write_size, const std::uint8_t* value )
+    {
+        if ( offset + write_size > staged.size() )
+            return bluetoe::error_codes::invalid_offset;
+
+        std::copy( value, value + write_size, staged.begin() + offset );
+
+        return bluetoe::error_codes::success;
+    }
+
+    std::uint8_t commit_staged()
+    {
+        ++commit_calls;
+
+        if ( commit_result == bluetoe::error_codes::success )
+            committed = staged;
+
+        return commit_result;
+    }
+
+    void discard_staged()
+    {
+        ++rollback_calls;
+    }
+
+    std::array< std::uint8_t, 4 > small_value = { { 0x01, 0x02, 0x03, 0x04 } };
+
+    // the queue is too small for a single fragment
+    using write_through_server = bluetoe::server<
+        bluetoe::shared_write_queue< 20 >,
+        bluetoe::service<
+            bluetoe::service_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CA9 >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CAA >,
+                bluetoe::free_write_blob_handler< &write_staged >,
+                bluetoe::prepared_write_through< &commit_staged, &discard_staged >
+            >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CAB >,
+                bluetoe::bind_characteristic_value< decltype( small_value ), &small_value >
+            >
+        >
+    >;
+
+    struct write_through_fixture : test::request_with_reponse< write_through_server >
+    {
+        write_through_fixture()
+        {
+            staged.fill( 0 );
+            committed.fill( 0 );
+            commit_calls   = 0;
+            rollback_calls = 0;
+            commit_result  = bluetoe::error_codes::success;
+            small_value    = { { 0x01, 0x02, 0x03, 0x04 } };
+        }
+
+        void prepare_fragment( std::uint16_t offset, std::uint8_t first_value, std::size_t size )
+        {
+            std::vector< std::uint8_t > request = { 0x16, 0x03, 0x00,
+                static_cast< std::uint8_t >( offset & 0xff ), static_cast< std::uint8_t >( offset >> 8 ) };
+
+            for ( std::size_t i = 0; i != size; ++i )
+                request.push_back( static_cast< std::uint8_t >( first_value + i ) );
+
+            l2cap_input( request, connection );
+
+            request[ 0 ] = 0x17;
+            BOOST_CHECK_EQUAL_COLLECTIONS( request.begin(), request.end(), &response[ 0 ], &response[ response_size ] );
+        }
+    };
+
+    struct three_fragments_written : write_through_fixture
+    {
+        three_fragments_written()
+        {
+            prepare_fragment( 0, 0x00, 18 );
+            prepare_fragment( 18, 0x12, 18 );
+            prepare_fragment( 36, 0x24, 18 );
+        }
+    };
+
+    BOOST_FIXTURE_TEST_CASE( fragments_are_passed_to_the_handler_directly, three_fragments_written )
+    {
+        for ( std::size_t i = 0; i != 54; ++i )
+            BOOST_CHECK_EQUAL( staged[ i ], i );
+
+        BOOST_CHECK_EQUAL( commit_calls, 0 );
+        BOOST_CHECK_EQUAL( rollback_calls, 0 );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( execute_commits, three_fragments_written )
+    {
+        l2cap_input( { 0x18, 0x01 } );
+        expected_result( { 0x19 } );
+
+        BOOST_CHECK_EQUAL( commit_calls, 1 );
+        BOOST_CHECK_EQUAL( rollback_calls, 0 );
+        BOOST_CHECK_EQUAL_COLLECTIONS( staged.begin(), staged.end(), committed.begin(), committed.end() );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( cancel_rolls_back, three_fragments_written )
+    {
+        l2cap_input( { 0x18, 0x00 } );
+        expected_result( { 0x19 } );
+
+        BOOST_CHECK_EQUAL( commit_calls, 0 );
+        BOOST_CHECK_EQUAL( rollback_calls, 1 );
+
+        // queue is empty now
+        l2cap_input( { 0x18, 0x01 } );
+        expected_result( { 0x19 } );
+
+        BOOST_CHECK_EQUAL( commit_calls, 0 );
+        BOOST_CHECK_EQUAL( rollback_calls, 1 );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( disconnect_rolls_back, three_fragments_written )
+    {
+        client_disconnected( connection );
+
+        BOOST_CHECK_EQUAL( commit_calls, 0 );
+        BOOST_CHECK_EQUAL( rollback_calls, 1 );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( failed_commit_is_reported_and_rolled_back, three_fragments_written )
+    {
+        commit_result = 0x80;
+
+        BOOST_CHECK( check_error_response( { 0x18, 0x01 }, 0x18, 0x0003, 0x80 ) );
+        BOOST_CHECK_EQUAL( commit_calls, 1 );
+        BOOST_CHECK_EQUAL( rollback_calls, 1 );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( handler_error_is_reported_on_prepare, write_through_fixture )
+    {
+        BOOST_CHECK( check_error_response( { 0x16, 0x03, 0x00, 0x40, 0x00, 0x01 }, 0x16, 0x0003, 0x07 ) );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( mixed_with_queued_writes, three_fragments_written )
+    {
+        l2cap_input( { 0x16, 0x05, 0x00, 0x01, 0x00, 0xaa, 0xbb } );
+        expected_result( { 0x17, 0x05, 0x00, 0x01, 0x00, 0xaa, 0xbb } );
+
+        // queued write is not applied yet
+        BOOST_CHECK_EQUAL( small_value[ 1 ], 0x02 );
+
+        l2cap_input( { 0x18, 0x01 } );
+        expected_result( { 0x19 } );
+
+        static const std::array< std::uint8_t, 4 > expected_small_value = { { 0x01, 0xaa, 0xbb, 0x04 } };
+        BOOST_CHECK_EQUAL_COLLECTIONS( small_value.begin(), small_value.end(), expected_small_value.begin(), expected_small_value.end() );
+        BOOST_CHECK_EQUAL( commit_calls, 1 );
+        BOOST_CHECK_EQUAL( rollback_calls, 0 );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( failed_queued_write_rolls_back_write_through, write_through_fixture )
+    {
+        l2cap_input( { 0x16, 0x05, 0x00, 0x03, 0x00, 0xaa, 0xbb } );
+        expected_result( { 0x17, 0x05, 0x00, 0x03, 0x00, 0xaa, 0xbb } );
+
+        prepare_fragment( 0, 0x00, 18 );
+
+        BOOST_CHECK( check_error_response( { 0x18, 0x01 }, 0x18, 0x0005, 0x0d ) );
+        BOOST_CHECK_EQUAL( commit_calls, 0 );
+        BOOST_CHECK_EQUAL( rollback_calls, 1 );
+    }
+
+    using pooled_write_through_server = bluetoe::server<
+        bluetoe::pooled_write_queue< 20, 2 >,
+        bluetoe::service<
+            bluetoe::service_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CA9 >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CAA >,
+                bluetoe::free_write_blob_handler< &write_staged >,
+                bluetoe::prepared_write_through< &commit_staged, &discard_staged >
+            >
+        >
+    >;
+
+    struct two_clients : test::request_with_reponse< pooled_write_through_server >
+    {
+        two_clients()
+        {
+            commit_calls   = 0;
+            rollback_calls = 0;
+            commit_result  = bluetoe::error_codes::success;
+
+            l2cap_input( { 0x16, 0x03, 0x00, 0x00, 0x00, 0x01, 0x02 }, con1 );
+            expected_result( { 0x17, 0x03, 0x00, 0x00, 0x00, 0x01, 0x02 } );
+        }
+
+        channel_data_t< bluetoe::details::link_state_no_security > con1;
+        channel_data_t< bluetoe::details::link_state_no_security > con2;
+    };
+
+    BOOST_FIXTURE_TEST_CASE( other_client_can_not_prepare_while_fragments_are_outstanding, two_clients )
+    {
+        l2cap_input( { 0x16, 0x03, 0x00, 0x00, 0x00, 0xaa, 0xbb }, con2 );
+        expected_result( { 0x01, 0x16, 0x03, 0x00, 0x09 } );
+
+        l2cap_input( { 0x12, 0x03, 0x00, 0xaa, 0xbb }, con2 );
+        expected_result( { 0x01, 0x12, 0x03, 0x00, 0x11 } );
+
+        BOOST_CHECK_EQUAL( staged[ 0 ], 0x01 );
+        BOOST_CHECK_EQUAL( commit_calls, 0 );
+        BOOST_CHECK_EQUAL( rollback_calls, 0 );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( other_client_can_prepare_after_execute, two_clients )
+    {
+        l2cap_input( { 0x18, 0x01 }, con1 );
+        expected_result( { 0x19 } );
+
+        l2cap_input( { 0x16, 0x03, 0x00, 0x00, 0x00, 0xaa, 0xbb }, con2 );
+        expected_result( { 0x17, 0x03, 0x00, 0x00, 0x00, 0xaa, 0xbb } );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( other_client_can_write_after_disconnect, two_clients )
+    {
+        client_disconnected( con1 );
+
+        l2cap_input( { 0x12, 0x03, 0x00, 0xaa, 0xbb }, con2 );
+        expected_result( { 0x13 } );
+
+        BOOST_CHECK_EQUAL( commit_calls, 1 );
+        BOOST_CHECK_EQUAL( rollback_calls, 1 );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
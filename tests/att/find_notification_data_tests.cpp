@@ -276,3 +276,106 @@ BOOST_AUTO_TEST_CASE( multiple_characteristics_with_same_uuid )
             std::tuple< int_c< 0 > > >::value
     ) );
 }
+
+template < class Server >
+std::uint32_t delivery_latency( const std::uint8_t& value )
+{
+    using find = bluetoe::details::find_notification_data_in_list< typename Server::notification_priority, typename Server::services >;
+
+    return Server::delivery_latency( find::find_notification_data( &value ) );
+}
+
+BOOST_AUTO_TEST_CASE( no_delivery_latencies )
+{
+    using server = bluetoe::server<
+        bluetoe::service<
+            A,
+            characteristic< A_a, &value_Aa >,
+            characteristic< A_b, &value_Ab >
+        >
+    >;
+
+    BOOST_CHECK( !server::has_delivery_latencies );
+    BOOST_CHECK_EQUAL( delivery_latency< server >( value_Aa ), 0u );
+    BOOST_CHECK_EQUAL( delivery_latency< server >( value_Ab ), 0u );
+}
+
+BOOST_AUTO_TEST_CASE( delivery_latencies_with_priorities )
+{
+    using server = bluetoe::server<
+        bluetoe::service<
+            A,
+            bluetoe::characteristic<
+                A_a,
+                bluetoe::bind_characteristic_value< const std::uint8_t, &value_Aa >,
+                bluetoe::notify,
+                bluetoe::maximum_delivery_latency< 50 >
+            >,
+            characteristic< A_b, &value_Ab >,
+            bluetoe::higher_outgoing_priority< A_b >
+        >,
+        bluetoe::service<
+            B,
+            characteristic_without_cccd< B_a, &value_Ba >,
+            bluetoe::characteristic<
+                B_b,
+                bluetoe::bind_characteristic_value< const std::uint8_t, &value_Bb >,
+                bluetoe::indicate,
+                bluetoe::maximum_delivery_latency< 2000 >
+            >
+        >
+    >;
+
+    BOOST_CHECK( server::has_delivery_latencies );
+    BOOST_CHECK_EQUAL( delivery_latency< server >( value_Aa ), 50u );
+    BOOST_CHECK_EQUAL( delivery_latency< server >( value_Ab ), 0u );
+    BOOST_CHECK_EQUAL( delivery_latency< server >( value_Bb ), 2000u );
+}
+
+template < class Server >
+bluetoe::details::notification_rate_limit_data notification_rate_limit( const std::uint8_t& value )
+{
+    using find = bluetoe::details::find_notification_data_in_list< typename Server::notification_priority, typename Server::services >;
+
+    return find::notification_rate_limit_by_attribute_index( find::find_notification_data( &value ).attribute_table_index() );
+}
+
+BOOST_AUTO_TEST_CASE( notification_rate_limits_are_numbered )
+{
+    using server = bluetoe::server<
+        bluetoe::service<
+            A,
+            characteristic< A_a, &value_Aa >,
+            bluetoe::characteristic<
+                A_b,
+                bluetoe::bind_characteristic_value< const std::uint8_t, &value_Ab >,
+                bluetoe::notify,
+                bluetoe::notification_rate_limit< 100, 20 >
+            >
+        >,
+        bluetoe::service<
+            B,
+            characteristic_without_cccd< B_a, &value_Ba >,
+            bluetoe::characteristic<
+                B_b,
+                bluetoe::bind_characteristic_value< const std::uint8_t, &value_Bb >,
+                bluetoe::notify,
+                bluetoe::notification_rate_limit< 0, 50 >
+            >
+        >
+    >;
+
+    using find = bluetoe::details::find_notification_data_in_list< server::notification_priority, server::services >;
+
+    BOOST_CHECK_EQUAL( find::number_of_notification_rate_limits, 2u );
+
+    BOOST_CHECK_EQUAL( notification_rate_limit< server >( value_Aa ).slot, 2u );
+
+    BOOST_CHECK_EQUAL( notification_rate_limit< server >( value_Ab ).slot, 0u );
+    BOOST_CHECK_EQUAL( notification_rate_limit< server >( value_Ab ).minimum_interval_ms, 100u );
+    BOOST_CHECK_EQUAL( notification_rate_limit< server >( value_Ab ).coalescing_window_ms, 20u );
+
+    BOOST_CHECK_EQUAL( notification_rate_limit< server >( value_Bb ).slot, 1u );
+    BOOST_CHECK_EQUAL( notification_rate_limit< server >( value_Bb ).minimum_interval_ms, 0u );
+    BOOST_CHECK_EQUAL( notification_rate_limit< server >( value_Bb ).coalescing_window_ms, 50u );
+}
@@ -3,6 +3,8 @@
 
 #include <bluetoe/notification_queue.hpp>
 
+#include <vector>
+
 #include "test_servers.hpp"
 #include "attribute_io.hpp"
 
@@ -848,3 +850,392 @@ BOOST_AUTO_TEST_SUITE( access_error )
     }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( unchanged_notifications )
+
+    std::uint8_t sensor = 0;
+    std::uint8_t counter = 0;
+    std::uint8_t long_value[ 8 ] = { 0 };
+
+    using server = bluetoe::server<
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x8C8B >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x8C8B >,
+                bluetoe::bind_characteristic_value< decltype( sensor ), &sensor >,
+                bluetoe::notify,
+                bluetoe::suppress_unchanged_notifications
+            >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x8C8C >,
+                bluetoe::bind_characteristic_value< decltype( counter ), &counter >,
+                bluetoe::notify
+            >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x8C8D >,
+                bluetoe::bind_characteristic_value< decltype( long_value ), &long_value >,
+                bluetoe::notify,
+                bluetoe::suppress_unchanged_notifications
+            >
+        >
+    >;
+
+    struct subscribed : test::request_with_reponse< server >
+    {
+        subscribed()
+        {
+            sensor  = 0x42;
+            counter = 0x17;
+            std::fill( std::begin( long_value ), std::end( long_value ), 0 );
+
+            subscribe( connection );
+        }
+
+        template < class Connection >
+        void subscribe( Connection& con )
+        {
+            for ( const std::uint8_t cccd_handle : { 0x04, 0x07, 0x0A } )
+            {
+                l2cap_input( { 0x12, cccd_handle, 0x00, 0x01, 0x00 }, con );
+                expected_result( { 0x13 } );
+            }
+        }
+    };
+
+    BOOST_FIXTURE_TEST_CASE( first_notification_is_sent, subscribed )
+    {
+        connection.queue_notification( 0 );
+        expected_output( sensor, { 0x1B, 0x03, 0x00, 0x42 } );
+
+        BOOST_TEST( connection.suppressed_notifications() == 0u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( unchanged_value_is_not_notified, subscribed )
+    {
+        connection.queue_notification( 0 );
+        expected_output( sensor, { 0x1B, 0x03, 0x00, 0x42 } );
+
+        connection.queue_notification( 0 );
+        expected_output( sensor, {} );
+
+        BOOST_TEST( connection.suppressed_notifications() == 1u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( changed_value_is_notified, subscribed )
+    {
+        connection.queue_notification( 0 );
+        expected_output( sensor, { 0x1B, 0x03, 0x00, 0x42 } );
+
+        sensor = 0x43;
+        connection.queue_notification( 0 );
+        expected_output( sensor, { 0x1B, 0x03, 0x00, 0x43 } );
+
+        sensor = 0x42;
+        connection.queue_notification( 0 );
+        expected_output( sensor, { 0x1B, 0x03, 0x00, 0x42 } );
+
+        BOOST_TEST( connection.suppressed_notifications() == 0u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( characteristic_without_option_is_always_notified, subscribed )
+    {
+        connection.queue_notification( 1 );
+        expected_output( counter, { 0x1B, 0x06, 0x00, 0x17 } );
+
+        connection.queue_notification( 1 );
+        expected_output( counter, { 0x1B, 0x06, 0x00, 0x17 } );
+
+        BOOST_TEST( connection.suppressed_notifications() == 0u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( suppressed_notification_does_not_hide_other_notifications, subscribed )
+    {
+        connection.queue_notification( 0 );
+        expected_output( sensor, { 0x1B, 0x03, 0x00, 0x42 } );
+
+        // the queue serves its entries round robin; make sure, index 0 is served before index 1
+        connection.queue_notification( 1 );
+        expected_output( counter, { 0x1B, 0x06, 0x00, 0x17 } );
+
+        connection.queue_notification( 0 );
+        connection.queue_notification( 1 );
+        expected_output( counter, { 0x1B, 0x06, 0x00, 0x17 } );
+        expected_output( sensor, {} );
+
+        BOOST_TEST( connection.suppressed_notifications() == 1u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( long_values_are_compared_by_digest, subscribed )
+    {
+        connection.queue_notification( 2 );
+        expected_output( long_value, { 0x1B, 0x09, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } );
+
+        connection.queue_notification( 2 );
+        expected_output( long_value, {} );
+
+        long_value[ 7 ] = 0x01;
+        connection.queue_notification( 2 );
+        expected_output( long_value, { 0x1B, 0x09, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 } );
+
+        BOOST_TEST( connection.suppressed_notifications() == 1u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( digests_are_kept_per_connection, subscribed )
+    {
+        channel_data_t< bluetoe::details::link_state_no_security > second;
+        subscribe( second );
+
+        connection.queue_notification( 0 );
+        expected_output( sensor, { 0x1B, 0x03, 0x00, 0x42 } );
+
+        second.queue_notification( 0 );
+        expected_output( sensor, { 0x1B, 0x03, 0x00, 0x42 }, second );
+    }
+
+    BOOST_AUTO_TEST_CASE( digest_of_short_values_is_exact )
+    {
+        bluetoe::details::notification_digest digest;
+        const std::uint8_t zero[]  = { 0x00 };
+        const std::uint8_t zeros[] = { 0x00, 0x00 };
+
+        BOOST_TEST( digest.changed( zero, 1 ) );
+        BOOST_TEST( !digest.changed( zero, 1 ) );
+        BOOST_TEST( digest.changed( zeros, 2 ) );
+        BOOST_TEST( digest.changed( zeros, 0 ) );
+        BOOST_TEST( !digest.changed( zeros, 0 ) );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( notification_rate_limits )
+
+    std::uint8_t sensor  = 0;
+    std::uint8_t burst   = 0;
+    std::uint8_t counter = 0;
+
+    using server = bluetoe::server<
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x8C8B >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x8C8B >,
+                bluetoe::bind_characteristic_value< decltype( sensor ), &sensor >,
+                bluetoe::notify,
+                bluetoe::notification_rate_limit< 100 >
+            >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x8C8C >,
+                bluetoe::bind_characteristic_value< decltype( burst ), &burst >,
+                bluetoe::notify,
+                bluetoe::notification_rate_limit< 0, 20 >
+            >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x8C8D >,
+                bluetoe::bind_characteristic_value< decltype( counter ), &counter >,
+                bluetoe::notify
+            >
+        >
+    >;
+
+    struct subscribed : test::request_with_reponse< server >
+    {
+        subscribed()
+            : connection_event_counter( 0 )
+        {
+            sensor  = 0x42;
+            burst   = 0x10;
+            counter = 0x17;
+
+            for ( const std::uint8_t cccd_handle : { 0x04, 0x07, 0x0A } )
+            {
+                l2cap_input( { 0x12, cccd_handle, 0x00, 0x01, 0x00 } );
+                expected_result( { 0x13 } );
+            }
+        }
+
+        // advance the time base by connection events with an interval of 10ms
+        void advance( unsigned ms )
+        {
+            connection_event_counter += ms / 10;
+            connection.notification_time_base( connection_event_counter, 10000 );
+        }
+
+        std::uint16_t connection_event_counter;
+    };
+
+    BOOST_FIXTURE_TEST_CASE( first_notification_is_not_delayed_by_minimum_interval, subscribed )
+    {
+        connection.queue_notification( 0 );
+        expected_output( sensor, { 0x1B, 0x03, 0x00, 0x42 } );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( notification_is_held_back_for_the_minimum_interval, subscribed )
+    {
+        connection.queue_notification( 0 );
+        expected_output( sensor, { 0x1B, 0x03, 0x00, 0x42 } );
+
+        advance( 40 );
+        connection.queue_notification( 0 );
+        expected_output( sensor, {} );
+
+        advance( 50 );
+        expected_output( sensor, {} );
+
+        advance( 10 );
+        expected_output( sensor, { 0x1B, 0x03, 0x00, 0x42 } );
+        expected_output( sensor, {} );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( notifications_are_coalesced_while_held_back, subscribed )
+    {
+        connection.queue_notification( 0 );
+        expected_output( sensor, { 0x1B, 0x03, 0x00, 0x42 } );
+
+        for ( std::uint8_t value = 1; value != 10; ++value )
+        {
+            advance( 10 );
+            sensor = value;
+            connection.queue_notification( 0 );
+            expected_output( sensor, {} );
+        }
+
+        advance( 10 );
+        expected_output( sensor, { 0x1B, 0x03, 0x00, 0x09 } );
+        expected_output( sensor, {} );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( held_back_notification_does_not_block_other_characteristics, subscribed )
+    {
+        connection.queue_notification( 0 );
+        expected_output( sensor, { 0x1B, 0x03, 0x00, 0x42 } );
+
+        connection.queue_notification( 0 );
+        connection.queue_notification( 2 );
+        expected_output( counter, { 0x1B, 0x09, 0x00, 0x17 } );
+
+        connection.queue_notification( 2 );
+        expected_output( counter, { 0x1B, 0x09, 0x00, 0x17 } );
+
+        advance( 100 );
+        expected_output( sensor, { 0x1B, 0x03, 0x00, 0x42 } );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( notification_is_delayed_by_the_coalescing_window, subscribed )
+    {
+        connection.queue_notification( 1 );
+        expected_output( burst, {} );
+
+        advance( 10 );
+        burst = 0x11;
+        connection.queue_notification( 1 );
+        expected_output( burst, {} );
+
+        advance( 10 );
+        expected_output( burst, { 0x1B, 0x06, 0x00, 0x11 } );
+
+        // without minimum interval, the next notification is again just delayed by the window
+        connection.queue_notification( 1 );
+        expected_output( burst, {} );
+
+        advance( 20 );
+        expected_output( burst, { 0x1B, 0x06, 0x00, 0x11 } );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( characteristic_without_rate_limit_is_not_delayed, subscribed )
+    {
+        for ( int i = 0; i != 3; ++i )
+        {
+            connection.queue_notification( 2 );
+            expected_output( counter, { 0x1B, 0x09, 0x00, 0x17 } );
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE( time_base_wraps_with_the_connection_event_counter )
+    {
+        bluetoe::details::notification_rate_limits< 1 > limits;
+        const bluetoe::details::notification_rate_limit_data limit = { 0, 200, 0 };
+
+        limits.notification_time_base( 0xfff0, 10000 );
+        BOOST_CHECK( limits.notification_due( limit, 0 ) );
+        limits.notification_done( limit, true );
+
+        limits.notification_time_base( 0xfff9, 10000 );
+        BOOST_CHECK( !limits.notification_due( limit, 0 ) );
+
+        struct queue_t {
+            void queue_notification( std::size_t index ) { queued.push_back( index ); }
+            std::vector< std::size_t > queued;
+        } queue;
+
+        limits.notification_time_base( 0xfffe, 10000 );
+        limits.release_due_notifications( queue );
+        BOOST_CHECK( queue.queued.empty() );
+
+        limits.notification_time_base( 0x0004, 10000 );
+        limits.release_due_notifications( queue );
+        BOOST_CHECK_EQUAL( queue.queued.size(), 1u );
+        BOOST_CHECK( limits.notification_due( limit, 0 ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( last_notification_is_forgotten_before_the_time_base_wraps )
+    {
+        bluetoe::details::notification_rate_limits< 1 > limits;
+        const bluetoe::details::notification_rate_limit_data limit = { 0, 200, 0 };
+
+        BOOST_CHECK( limits.notification_due( limit, 0 ) );
+        limits.notification_done( limit, true );
+
+        // 1024 connection events with an interval of 2^32µs / 1024, so that the time base wraps exactly once
+        for ( std::uint16_t event = 1; event != 1025; ++event )
+            limits.notification_time_base( event, 4194304 );
+
+        BOOST_CHECK( limits.notification_due( limit, 0 ) );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( seqlock_values )
+
+    bluetoe::seqlock_value< std::uint16_t > guarded;
+
+    using server = bluetoe::server<
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x8C8B >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x8C8B >,
+                bluetoe::bind_characteristic_value< decltype( guarded ), &guarded >,
+                bluetoe::notify,
+                bluetoe::indicate
+            >
+        >
+    >;
+
+    BOOST_FIXTURE_TEST_CASE( update_and_notify_queues_a_notification, test::request_with_reponse< server > )
+    {
+        update_and_notify( guarded, std::uint16_t( 0x1234 ) );
+
+        BOOST_CHECK( notification.valid() );
+        BOOST_CHECK_EQUAL( notification.attribute_table_index(), 2u );
+        BOOST_CHECK_EQUAL( notification_type, bluetoe::details::notification_type::notification );
+        BOOST_CHECK_EQUAL( guarded.load(), 0x1234u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( update_and_indicate_queues_an_indication, test::request_with_reponse< server > )
+    {
+        update_and_indicate( guarded, std::uint16_t( 0x4321 ) );
+
+        BOOST_CHECK( notification.valid() );
+        BOOST_CHECK_EQUAL( notification_type, bluetoe::details::notification_type::indication );
+        BOOST_CHECK_EQUAL( guarded.load(), 0x4321u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( notification_carries_updated_value, test::request_with_reponse< server > )
+    {
+        l2cap_input( { 0x12, 0x04, 0x00, 0x01, 0x00 } );
+        expected_result( { 0x13 } );
+
+        update_and_notify( guarded, std::uint16_t( 0xABCD ) );
+        connection.queue_notification( 0 );
+        expected_output( guarded, { 0x1B, 0x03, 0x00, 0xCD, 0xAB } );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -80,6 +80,38 @@ BOOST_FIXTURE_TEST_CASE( write_queue_used_by_other_client, large_fixture )
     expected_result( { 0x01, 0x16, 0x03, 0x00, 0x09 } );
 }
 
+typedef bluetoe::server<
+    bluetoe::pooled_write_queue< ( ( sizeof( very_large_value ) + 17 ) / 18 * 7 ) + sizeof( very_large_value ), 2 >,
+    bluetoe::service<
+        bluetoe::service_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CA9 >,
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CAA >,
+            bluetoe::bind_characteristic_value< decltype( very_large_value ), &very_large_value >
+        >
+    >
+> pooled_queue_server;
+
+BOOST_FIXTURE_TEST_CASE( pooled_write_queue_used_by_other_clients, test::request_with_reponse< pooled_queue_server > )
+{
+    channel_data_t< bluetoe::details::link_state_no_security > con1;
+    channel_data_t< bluetoe::details::link_state_no_security > con2;
+    channel_data_t< bluetoe::details::link_state_no_security > con3;
+
+    l2cap_input( { 0x16, 0x03, 0x00, 0x00, 0x00, 0x00, 0x01 }, con1 );
+    expected_result( { 0x17, 0x03, 0x00, 0x00, 0x00, 0x00, 0x01 } );
+
+    l2cap_input( { 0x16, 0x03, 0x00, 0x00, 0x00, 0x00, 0x01 }, con2 );
+    expected_result( { 0x17, 0x03, 0x00, 0x00, 0x00, 0x00, 0x01 } );
+
+    l2cap_input( { 0x16, 0x03, 0x00, 0x00, 0x00, 0x00, 0x01 }, con3 );
+    expected_result( { 0x01, 0x16, 0x03, 0x00, 0x09 } );
+
+    this->client_disconnected( con1 );
+
+    l2cap_input( { 0x16, 0x03, 0x00, 0x00, 0x00, 0x00, 0x01 }, con3 );
+    expected_result( { 0x17, 0x03, 0x00, 0x00, 0x00, 0x00, 0x01 } );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE( prepare_writes )
@@ -102,3 +102,205 @@ BOOST_FIXTURE_TEST_CASE( read_starting_at_10, test::request_with_reponse< blob_s
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( read_blob_snapshot )
+
+static std::size_t   report_reads   = 0;
+static std::uint8_t  report_version = 0;
+
+static std::uint8_t read_report( std::size_t offset, std::size_t read_size, std::uint8_t* out_buffer, std::size_t& out_size )
+{
+    static constexpr std::size_t report_size = 50;
+
+    ++report_reads;
+
+    if ( offset > report_size )
+        return bluetoe::error_codes::invalid_offset;
+
+    out_size = std::min( read_size, report_size - offset );
+
+    for ( std::size_t i = 0; i != out_size; ++i )
+        out_buffer[ i ] = static_cast< std::uint8_t >( report_version + offset + i );
+
+    return bluetoe::error_codes::success;
+}
+
+template < std::uint16_t SnapshotSize >
+using report_server = bluetoe::server<
+    bluetoe::read_blob_snapshot< SnapshotSize >,
+    bluetoe::service<
+        bluetoe::service_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CA9 >,
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CAA >,
+            bluetoe::free_read_blob_handler< &read_report >
+        >,
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CAB >,
+            bluetoe::bind_characteristic_value< decltype( read_blob::const_blob ), &read_blob::const_blob >
+        >
+    >
+>;
+
+template < std::uint16_t SnapshotSize >
+struct report_fixture : test::request_with_reponse< report_server< SnapshotSize > >
+{
+    report_fixture()
+    {
+        report_reads   = 0;
+        report_version = 0;
+    }
+
+    // reads the value of the report in chunks and returns the number of calls to the read handler
+    std::size_t read_report_chunks( std::uint8_t first )
+    {
+        report_reads = 0;
+
+        this->l2cap_input( { 0x0A, 0x03, 0x00 } );
+        BOOST_CHECK_EQUAL( this->response_size, 23u );
+        BOOST_CHECK_EQUAL( this->response[ 1 ], first );
+
+        this->l2cap_input( { 0x0C, 0x03, 0x00, 22, 0x00 } );
+        BOOST_CHECK_EQUAL( this->response_size, 23u );
+        BOOST_CHECK_EQUAL( this->response[ 1 ], first + 22 );
+
+        this->l2cap_input( { 0x0C, 0x03, 0x00, 44, 0x00 } );
+        BOOST_CHECK_EQUAL( this->response_size, 7u );
+        BOOST_CHECK_EQUAL( this->response[ 6 ], first + 49 );
+
+        return report_reads;
+    }
+};
+
+BOOST_FIXTURE_TEST_CASE( long_read_calls_handler_once, report_fixture< 64 > )
+{
+    BOOST_CHECK_EQUAL( read_report_chunks( 0 ), 1u );
+}
+
+BOOST_FIXTURE_TEST_CASE( value_larger_than_snapshot_is_read_per_chunk, report_fixture< 49 > )
+{
+    BOOST_CHECK_EQUAL( read_report_chunks( 0 ), 3u );
+}
+
+BOOST_FIXTURE_TEST_CASE( value_larger_than_snapshot_and_pdu_is_read_per_chunk, report_fixture< 16 > )
+{
+    BOOST_CHECK_EQUAL( read_report_chunks( 0 ), 3u );
+}
+
+BOOST_FIXTURE_TEST_CASE( blob_read_with_offset_0_fills_snapshot, report_fixture< 64 > )
+{
+    l2cap_input( { 0x0C, 0x03, 0x00, 0x00, 0x00 } );
+    report_version = 100;
+
+    l2cap_input( { 0x0C, 0x03, 0x00, 22, 0x00 } );
+    BOOST_CHECK_EQUAL( response[ 1 ], 22 );
+    BOOST_CHECK_EQUAL( report_reads, 1u );
+}
+
+BOOST_FIXTURE_TEST_CASE( chunks_stem_from_a_single_version, report_fixture< 64 > )
+{
+    l2cap_input( { 0x0A, 0x03, 0x00 } );
+    report_version = 100;
+
+    l2cap_input( { 0x0C, 0x03, 0x00, 44, 0x00 } );
+    expected_result( { 0x0D, 44, 45, 46, 47, 48, 49 } );
+}
+
+BOOST_FIXTURE_TEST_CASE( invalidated_snapshot_is_not_used, report_fixture< 64 > )
+{
+    l2cap_input( { 0x0A, 0x03, 0x00 } );
+    report_version = 100;
+    invalidate_read_blob_snapshots();
+
+    l2cap_input( { 0x0C, 0x03, 0x00, 44, 0x00 } );
+    expected_result( { 0x0D, 144, 145, 146, 147, 148, 149 } );
+    BOOST_CHECK_EQUAL( report_reads, 2u );
+}
+
+BOOST_FIXTURE_TEST_CASE( reading_an_other_handle_drops_the_snapshot, report_fixture< 64 > )
+{
+    l2cap_input( { 0x0A, 0x03, 0x00 } );
+    l2cap_input( { 0x0C, 0x05, 0x00, 10, 0x00 } );
+    report_version = 100;
+
+    l2cap_input( { 0x0C, 0x03, 0x00, 44, 0x00 } );
+    expected_result( { 0x0D, 144, 145, 146, 147, 148, 149 } );
+}
+
+BOOST_FIXTURE_TEST_CASE( a_write_drops_the_snapshot, report_fixture< 64 > )
+{
+    l2cap_input( { 0x0A, 0x03, 0x00 } );
+    report_version = 100;
+
+    // the write itself fails, as the report is read only
+    l2cap_input( { 0x52, 0x03, 0x00, 0x01 } );
+
+    l2cap_input( { 0x0C, 0x03, 0x00, 44, 0x00 } );
+    expected_result( { 0x0D, 144, 145, 146, 147, 148, 149 } );
+}
+
+BOOST_FIXTURE_TEST_CASE( offsets_are_checked_against_the_snapshot, report_fixture< 64 > )
+{
+    l2cap_input( { 0x0A, 0x03, 0x00 } );
+
+    l2cap_input( { 0x0C, 0x03, 0x00, 50, 0x00 } );
+    expected_result( { 0x0D } );
+
+    BOOST_CHECK( check_error_response( { 0x0C, 0x03, 0x00, 51, 0x00 }, 0x0C, 0x0003, 0x07 ) );
+    BOOST_CHECK_EQUAL( report_reads, 1u );
+}
+
+using encrypted_report_server = bluetoe::server<
+    bluetoe::read_blob_snapshot< 64 >,
+    bluetoe::service<
+        bluetoe::service_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CA9 >,
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CAA >,
+            bluetoe::free_read_blob_handler< &read_report >,
+            bluetoe::requires_encryption
+        >
+    >
+>;
+
+struct encrypted_report_fixture : test::request_with_reponse< encrypted_report_server >
+{
+    encrypted_report_fixture()
+    {
+        report_reads   = 0;
+        report_version = 0;
+
+        connection.is_encrypted( true );
+        connection.pairing_status( bluetoe::device_pairing_status::unauthenticated_key );
+    }
+};
+
+BOOST_FIXTURE_TEST_CASE( snapshot_is_served_on_an_encrypted_link, encrypted_report_fixture )
+{
+    l2cap_input( { 0x0A, 0x03, 0x00 } );
+    report_version = 100;
+
+    l2cap_input( { 0x0C, 0x03, 0x00, 44, 0x00 } );
+    expected_result( { 0x0D, 44, 45, 46, 47, 48, 49 } );
+    BOOST_CHECK_EQUAL( report_reads, 1u );
+}
+
+BOOST_FIXTURE_TEST_CASE( security_is_checked_after_the_encryption_was_dropped, encrypted_report_fixture )
+{
+    l2cap_input( { 0x0A, 0x03, 0x00 } );
+    connection.is_encrypted( false );
+
+    // Insufficient Encryption, as there is a key for the link
+    BOOST_CHECK( check_error_response( { 0x0C, 0x03, 0x00, 22, 0x00 }, 0x0C, 0x0003, 0x0F ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( a_changed_pairing_status_drops_the_snapshot, encrypted_report_fixture )
+{
+    l2cap_input( { 0x0A, 0x03, 0x00 } );
+    report_version = 100;
+    connection.pairing_status( bluetoe::device_pairing_status::authenticated_key );
+
+    l2cap_input( { 0x0C, 0x03, 0x00, 44, 0x00 } );
+    expected_result( { 0x0D, 144, 145, 146, 147, 148, 149 } );
+    BOOST_CHECK_EQUAL( report_reads, 2u );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -56,3 +56,162 @@ BOOST_FIXTURE_TEST_CASE( write_full_data_part, test::request_with_reponse< small
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( write_command_bursts )
+
+static std::vector< std::vector< std::vector< std::uint8_t > > > bursts;
+
+static std::uint8_t log_samples( const bluetoe::write_command_view* writes, std::size_t count )
+{
+    BOOST_REQUIRE( count > 0 );
+
+    bursts.push_back( std::vector< std::vector< std::uint8_t > >() );
+
+    for ( std::size_t write = 0; write != count; ++write )
+        bursts.back().push_back( std::vector< std::uint8_t >( writes[ write ].value, writes[ write ].value + writes[ write ].size ) );
+
+    return bluetoe::error_codes::success;
+}
+
+std::uint32_t other_value = 0;
+
+template < typename ... Options >
+using logging_server = bluetoe::server<
+    Options...,
+    bluetoe::service<
+        bluetoe::service_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CA9 >,
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CAA >,
+            bluetoe::free_write_command_burst_handler< &log_samples >,
+            bluetoe::write_without_response
+        >,
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CAB >,
+            bluetoe::bind_characteristic_value< decltype( other_value ), &other_value >
+        >
+    >
+>;
+
+template < class Server >
+struct burst_fixture : test::request_with_reponse< Server >
+{
+    burst_fixture()
+    {
+        bursts.clear();
+        other_value = 0;
+    }
+
+    void check_bursts( std::initializer_list< std::initializer_list< std::initializer_list< std::uint8_t > > > expected )
+    {
+        BOOST_REQUIRE_EQUAL( bursts.size(), expected.size() );
+
+        auto burst = bursts.begin();
+        for ( const auto& expected_burst : expected )
+        {
+            BOOST_REQUIRE_EQUAL( burst->size(), expected_burst.size() );
+
+            auto write = burst->begin();
+            for ( const auto& expected_write : expected_burst )
+            {
+                BOOST_CHECK_EQUAL_COLLECTIONS( write->begin(), write->end(), expected_write.begin(), expected_write.end() );
+                ++write;
+            }
+
+            ++burst;
+        }
+
+        bursts.clear();
+    }
+};
+
+using buffered_fixture   = burst_fixture< logging_server< bluetoe::write_command_burst_buffer< 16, 4 > > >;
+using unbuffered_fixture = burst_fixture< logging_server<> >;
+
+BOOST_FIXTURE_TEST_CASE( write_commands_are_collected_until_flushed, buffered_fixture )
+{
+    l2cap_input( { 0x52, 0x03, 0x00, 0x01 } );
+    l2cap_input( { 0x52, 0x03, 0x00, 0x02, 0x03 } );
+    l2cap_input( { 0x52, 0x03, 0x00 } );
+    expected_result( {} );
+    BOOST_CHECK( bursts.empty() );
+
+    l2cap_input_flush( connection );
+    check_bursts( { { { 0x01 }, { 0x02, 0x03 }, {} } } );
+
+    l2cap_input_flush( connection );
+    BOOST_CHECK( bursts.empty() );
+}
+
+BOOST_FIXTURE_TEST_CASE( write_request_is_passed_as_single_write, buffered_fixture )
+{
+    l2cap_input( { 0x52, 0x03, 0x00, 0x01 } );
+    l2cap_input( { 0x12, 0x03, 0x00, 0x02 } );
+    expected_result( { 0x13 } );
+
+    check_bursts( { { { 0x01 } }, { { 0x02 } } } );
+}
+
+BOOST_FIXTURE_TEST_CASE( other_requests_flush_the_burst, buffered_fixture )
+{
+    l2cap_input( { 0x52, 0x03, 0x00, 0x01 } );
+    l2cap_input( { 0x0A, 0x05, 0x00 } );
+
+    check_bursts( { { { 0x01 } } } );
+}
+
+BOOST_FIXTURE_TEST_CASE( write_command_to_an_other_characteristic_flushes_the_burst, buffered_fixture )
+{
+    l2cap_input( { 0x52, 0x03, 0x00, 0x01 } );
+    l2cap_input( { 0x52, 0x05, 0x00, 0x01, 0x02, 0x03, 0x04 } );
+
+    check_bursts( { { { 0x01 } } } );
+    BOOST_CHECK_EQUAL( other_value, 0x04030201u );
+}
+
+BOOST_FIXTURE_TEST_CASE( burst_is_limited_by_number_of_writes, buffered_fixture )
+{
+    for ( std::uint8_t write = 0; write != 5; ++write )
+        l2cap_input( { 0x52, 0x03, 0x00, write } );
+
+    check_bursts( { { { 0x00 }, { 0x01 }, { 0x02 }, { 0x03 } } } );
+
+    l2cap_input_flush( connection );
+    check_bursts( { { { 0x04 } } } );
+}
+
+BOOST_FIXTURE_TEST_CASE( burst_is_limited_by_buffer_size, buffered_fixture )
+{
+    l2cap_input( { 0x52, 0x03, 0x00, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 } );
+    l2cap_input( { 0x52, 0x03, 0x00, 11, 12, 13, 14, 15, 16, 17 } );
+
+    check_bursts( { { { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 } } } );
+
+    l2cap_input_flush( connection );
+    check_bursts( { { { 11, 12, 13, 14, 15, 16, 17 } } } );
+}
+
+BOOST_FIXTURE_TEST_CASE( write_larger_than_buffer_is_passed_directly, buffered_fixture )
+{
+    l2cap_input( { 0x52, 0x03, 0x00, 0x01 } );
+    l2cap_input( { 0x52, 0x03, 0x00, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17 } );
+
+    check_bursts( { { { 0x01 } }, { { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17 } } } );
+}
+
+BOOST_FIXTURE_TEST_CASE( disconnect_flushes_the_burst, buffered_fixture )
+{
+    l2cap_input( { 0x52, 0x03, 0x00, 0x01 } );
+    client_disconnected( connection );
+
+    check_bursts( { { { 0x01 } } } );
+}
+
+BOOST_FIXTURE_TEST_CASE( without_buffer_every_write_command_is_passed_on_its_own, unbuffered_fixture )
+{
+    l2cap_input( { 0x52, 0x03, 0x00, 0x01 } );
+    l2cap_input( { 0x52, 0x03, 0x00, 0x02 } );
+
+    check_bursts( { { { 0x01 } }, { { 0x02 } } } );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
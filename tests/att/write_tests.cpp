@@ -3,6 +3,8 @@
 
 #include "test_servers.hpp"
 
+#include <array>
+
 BOOST_AUTO_TEST_SUITE( write_errors )
 
 BOOST_FIXTURE_TEST_CASE( pdu_to_small, test::small_temperature_service_with_response<> )
@@ -111,3 +113,175 @@ BOOST_FIXTURE_TEST_CASE( write_full_data_part, test::request_with_reponse< small
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( streamed_write_requests )
+
+std::array< std::uint8_t, 64 > staged;
+std::array< std::uint8_t, 64 > committed;
+int          commit_calls   = 0;
+int          rollback_calls = 0;
+
+std::uint8_t write_staged( std::size_t offset, std::size_t write_size, const std::uint8_t* value )
+{
+    if ( offset + write_size > staged.size() )
+        return bluetoe::error_codes::invalid_offset;
+
+    std::copy( value, value + write_size, staged.begin() + offset );
+
+    return bluetoe::error_codes::success;
+}
+
+std::uint8_t commit_staged()
+{
+    ++commit_calls;
+    committed = staged;
+
+    return bluetoe::error_codes::success;
+}
+
+void discard_staged()
+{
+    ++rollback_calls;
+}
+
+std::uint32_t value = 0x0000;
+
+typedef bluetoe::server<
+    bluetoe::service<
+        bluetoe::service_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CA9 >,
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CAA >,
+            bluetoe::free_write_blob_handler< &write_staged >,
+            bluetoe::prepared_write_through< &commit_staged, &discard_staged >
+        >,
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CAB >,
+            bluetoe::bind_characteristic_value< decltype( value ), &value >
+        >
+    >
+> write_through_server;
+
+struct streaming_fixture : test::request_with_reponse< write_through_server, 100 >
+{
+    streaming_fixture()
+    {
+        staged.fill( 0 );
+        committed.fill( 0 );
+        commit_calls   = 0;
+        rollback_calls = 0;
+    }
+
+    static std::vector< std::uint8_t > fragment( std::uint8_t first_value, std::size_t size )
+    {
+        std::vector< std::uint8_t > result;
+
+        for ( std::size_t i = 0; i != size; ++i )
+            result.push_back( static_cast< std::uint8_t >( first_value + i ) );
+
+        return result;
+    }
+
+    bool stream_start( std::uint8_t opcode, std::uint16_t handle, std::size_t value_size, const std::vector< std::uint8_t >& first )
+    {
+        std::vector< std::uint8_t > input = { opcode, static_cast< std::uint8_t >( handle & 0xff ), static_cast< std::uint8_t >( handle >> 8 ) };
+        input.insert( input.end(), first.begin(), first.end() );
+
+        return l2cap_input_stream_start( input.data(), input.size(), value_size + 3, connection );
+    }
+
+    void stream( const std::vector< std::uint8_t >& input )
+    {
+        std::size_t out_size = 0;
+        l2cap_input_stream( input.data(), input.size(), nullptr, out_size, connection );
+
+        BOOST_TEST( out_size == 0u );
+    }
+
+    void stream_last( const std::vector< std::uint8_t >& input )
+    {
+        response_size = 100;
+        l2cap_input_stream( input.data(), input.size(), response, response_size, connection );
+    }
+
+    void check_committed( std::size_t size )
+    {
+        for ( std::size_t i = 0; i != size; ++i )
+            BOOST_CHECK_EQUAL( committed[ i ], i );
+    }
+};
+
+BOOST_FIXTURE_TEST_CASE( streamed_write_request_is_committed, streaming_fixture )
+{
+    BOOST_TEST( stream_start( 0x12, 0x0003, 54, fragment( 0, 20 ) ) );
+    stream( fragment( 20, 27 ) );
+    BOOST_CHECK_EQUAL( commit_calls, 0 );
+
+    stream_last( fragment( 47, 7 ) );
+    expected_result( { 0x13 } );
+
+    BOOST_CHECK_EQUAL( commit_calls, 1 );
+    BOOST_CHECK_EQUAL( rollback_calls, 0 );
+    check_committed( 54 );
+}
+
+BOOST_FIXTURE_TEST_CASE( streamed_write_command_is_committed_without_response, streaming_fixture )
+{
+    BOOST_TEST( stream_start( 0x52, 0x0003, 30, fragment( 0, 20 ) ) );
+    stream_last( fragment( 20, 10 ) );
+
+    BOOST_TEST( response_size == 0u );
+    BOOST_CHECK_EQUAL( commit_calls, 1 );
+    check_committed( 30 );
+}
+
+BOOST_FIXTURE_TEST_CASE( only_write_through_characteristics_are_streamed, streaming_fixture )
+{
+    BOOST_TEST( !stream_start( 0x12, 0x0005, 30, fragment( 0, 20 ) ) );
+    BOOST_TEST( !stream_start( 0x12, 0x0000, 30, fragment( 0, 20 ) ) );
+    BOOST_TEST( !stream_start( 0x12, 0x0042, 30, fragment( 0, 20 ) ) );
+    BOOST_TEST( !stream_start( 0x16, 0x0003, 30, fragment( 0, 20 ) ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( handler_error_rolls_back, streaming_fixture )
+{
+    BOOST_TEST( stream_start( 0x12, 0x0003, 70, fragment( 0, 20 ) ) );
+    stream( fragment( 20, 27 ) );
+    stream_last( fragment( 47, 23 ) );
+
+    expected_result( { 0x01, 0x12, 0x03, 0x00, 0x07 } );
+    BOOST_CHECK_EQUAL( commit_calls, 0 );
+    BOOST_CHECK_EQUAL( rollback_calls, 1 );
+}
+
+BOOST_FIXTURE_TEST_CASE( incomplete_stream_is_rolled_back_by_next_request, streaming_fixture )
+{
+    BOOST_TEST( stream_start( 0x12, 0x0003, 54, fragment( 0, 20 ) ) );
+
+    l2cap_input( { 0x0A, 0x05, 0x00 } );
+    BOOST_CHECK_EQUAL( commit_calls, 0 );
+    BOOST_CHECK_EQUAL( rollback_calls, 1 );
+
+    // the rest of the stream is ignored
+    stream_last( fragment( 20, 34 ) );
+    BOOST_TEST( response_size == 0u );
+    BOOST_CHECK_EQUAL( commit_calls, 0 );
+}
+
+BOOST_FIXTURE_TEST_CASE( incomplete_stream_is_rolled_back_on_disconnect, streaming_fixture )
+{
+    BOOST_TEST( stream_start( 0x12, 0x0003, 54, fragment( 0, 20 ) ) );
+
+    client_disconnected( connection );
+    BOOST_CHECK_EQUAL( rollback_calls, 1 );
+}
+
+BOOST_FIXTURE_TEST_CASE( unfragmented_write_request_is_committed, streaming_fixture )
+{
+    l2cap_input( { 0x12, 0x03, 0x00, 0x00, 0x01, 0x02 } );
+    expected_result( { 0x13 } );
+
+    BOOST_CHECK_EQUAL( commit_calls, 1 );
+    check_committed( 3 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
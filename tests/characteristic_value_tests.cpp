@@ -227,6 +227,107 @@ BOOST_AUTO_TEST_SUITE( characteristic_value_access )
 BOOST_AUTO_TEST_SUITE_END()
 
 
+BOOST_AUTO_TEST_SUITE( seqlock_value_tests )
+
+    bluetoe::seqlock_value< std::uint32_t > guarded_value;
+
+    struct guarded_value_char :
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid< 0xD0B10674, 0x6DDD, 0x4B59, 0x89CA, 0xA009B78C956B >,
+            bluetoe::bind_characteristic_value< decltype( guarded_value ), &guarded_value >
+        >
+    {
+        guarded_value_char()
+        {
+            guarded_value.store( 0x04030201 );
+        }
+
+        bluetoe::details::attribute_access_result read( std::size_t offset )
+        {
+            auto read = bluetoe::details::attribute_access_arguments::read( buffer, offset );
+            const auto rc = attribute_at< cccd_indices, 0, bluetoe::service< suuid >, srv >( 1 ).access( read, 1 );
+            read_size = read.buffer_size;
+
+            return rc;
+        }
+
+        std::uint8_t buffer[ 100 ];
+        std::size_t  read_size;
+    };
+
+    BOOST_AUTO_TEST_CASE( value_is_zero_initialized )
+    {
+        const bluetoe::seqlock_value< std::uint64_t > value;
+
+        BOOST_CHECK_EQUAL( value.load(), 0u );
+    }
+
+    BOOST_AUTO_TEST_CASE( stored_value_can_be_loaded )
+    {
+        bluetoe::seqlock_value< std::uint64_t > value( 42 );
+        BOOST_CHECK_EQUAL( value.load(), 42u );
+
+        value.store( 0x1122334455667788 );
+        BOOST_CHECK_EQUAL( value.load(), 0x1122334455667788u );
+
+        value.store( 17 );
+        BOOST_CHECK_EQUAL( value.load(), 17u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( value_can_be_read, guarded_value_char )
+    {
+        BOOST_REQUIRE( read( 0 ) == bluetoe::details::attribute_access_result::success );
+
+        static const std::uint8_t expected_value[] = { 0x01, 0x02, 0x03, 0x04 };
+        BOOST_CHECK_EQUAL_COLLECTIONS( std::begin( expected_value ), std::end( expected_value ), &buffer[ 0 ], &buffer[ read_size ] );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( value_can_be_read_with_offset, guarded_value_char )
+    {
+        BOOST_REQUIRE( read( 3 ) == bluetoe::details::attribute_access_result::success );
+
+        static const std::uint8_t expected_value[] = { 0x04 };
+        BOOST_CHECK_EQUAL_COLLECTIONS( std::begin( expected_value ), std::end( expected_value ), &buffer[ 0 ], &buffer[ read_size ] );
+
+        BOOST_CHECK( read( 5 ) == bluetoe::details::attribute_access_result::invalid_offset );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( value_can_be_written_with_offset, guarded_value_char )
+    {
+        static const std::uint8_t new_value[] = { 0x22, 0x33 };
+        auto write = bluetoe::details::attribute_access_arguments::write( new_value, 1 );
+        auto rc    = attribute_at< cccd_indices, 0, bluetoe::service< suuid >, srv >( 1 ).access( write, 1 );
+
+        BOOST_CHECK( rc == bluetoe::details::attribute_access_result::success );
+        BOOST_CHECK_EQUAL( guarded_value.load(), 0x04332201u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( writing_over_the_end_is_rejected, guarded_value_char )
+    {
+        static const std::uint8_t new_value[] = { 0x22, 0x33 };
+        auto write = bluetoe::details::attribute_access_arguments::write( new_value, 3 );
+        auto rc    = attribute_at< cccd_indices, 0, bluetoe::service< suuid >, srv >( 1 ).access( write, 1 );
+
+        BOOST_CHECK( rc == bluetoe::details::attribute_access_result::invalid_attribute_value_length );
+        BOOST_CHECK_EQUAL( guarded_value.load(), 0x04030201u );
+    }
+
+    BOOST_AUTO_TEST_CASE( write_access_can_be_removed )
+    {
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid< 0xD0B10674, 0x6DDD, 0x4B59, 0x89CA, 0xA009B78C956B >,
+            bluetoe::bind_characteristic_value< decltype( guarded_value ), &guarded_value >,
+            bluetoe::no_write_access
+        > characteristic;
+
+        static const std::uint8_t new_value[] = { 0x22 };
+        auto write = bluetoe::details::attribute_access_arguments::write( new_value );
+
+        BOOST_CHECK( ( bluetoe::details::attribute_access_result::write_not_permitted == characteristic.attribute_at< cccd_indices, 0, bluetoe::service< suuid >, srv >( 1 ).access( write, 1 ) ) );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
 BOOST_AUTO_TEST_SUITE( fixed_value_tests )
 
     typedef bluetoe::characteristic<
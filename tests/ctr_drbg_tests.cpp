@@ -0,0 +1,145 @@
+#include <bluetoe/ctr_drbg.hpp>
+
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include <vector>
+
+#include "aes.h"
+
+namespace {
+
+    using block_t = std::array< std::uint8_t, 16 >;
+
+    unsigned entropy_requests = 0;
+
+    struct test_traits
+    {
+        // tiny-AES expects the byte order of FIPS-197
+        static block_t aes( const block_t& key, const block_t& data )
+        {
+            std::uint8_t k[ 16 ];
+            std::uint8_t d[ 16 ];
+            std::reverse_copy( key.begin(), key.end(), k );
+            std::reverse_copy( data.begin(), data.end(), d );
+
+            AES_ctx context;
+            AES_init_ctx( &context, k );
+            AES_ECB_encrypt( &context, d );
+
+            block_t result;
+            std::reverse_copy( std::begin( d ), std::end( d ), result.begin() );
+
+            return result;
+        }
+
+        static void entropy( std::uint8_t* buffer, std::size_t size )
+        {
+            ++entropy_requests;
+            std::fill( buffer, buffer + size, 0x42 );
+        }
+    };
+
+    using drbg_t = bluetoe::details::ctr_drbg< test_traits >;
+
+    // CAVP CTR_DRBG test vectors, AES-128 use df = false, PredictionResistance = false, COUNT = 0
+    const std::uint8_t entropy_input[ 32 ] = {
+        0xce, 0x50, 0xf3, 0x3d, 0xa5, 0xd4, 0xc1, 0xd3, 0xd4, 0x00, 0x4e, 0xb3, 0x52, 0x44, 0xb7, 0xf2,
+        0xcd, 0x7f, 0x2e, 0x50, 0x76, 0xfb, 0xf6, 0x78, 0x0a, 0x7f, 0xf6, 0x34, 0xb2, 0x49, 0xa5, 0xfc
+    };
+
+    const std::uint8_t returned_bits[ 64 ] = {
+        0x65, 0x45, 0xc0, 0x52, 0x9d, 0x37, 0x24, 0x43, 0xb3, 0x92, 0xce, 0xb3, 0xae, 0x3a, 0x99, 0xa3,
+        0x0f, 0x96, 0x3e, 0xaf, 0x31, 0x32, 0x80, 0xf1, 0xd1, 0xa1, 0xe8, 0x7f, 0x9d, 0xb3, 0x73, 0xd3,
+        0x61, 0xe7, 0x5d, 0x18, 0x01, 0x82, 0x66, 0x49, 0x9c, 0xcc, 0xd6, 0x4d, 0x9b, 0xbb, 0x8d, 0xe0,
+        0x18, 0x5f, 0x21, 0x33, 0x83, 0x08, 0x0f, 0xad, 0xde, 0xc4, 0x6b, 0xae, 0x1f, 0x78, 0x4e, 0x5a
+    };
+
+    struct seeded_drbg : drbg_t
+    {
+        seeded_drbg()
+        {
+            entropy_requests = 0;
+            seed( entropy_input );
+        }
+
+        std::vector< std::uint8_t > bytes( std::size_t size )
+        {
+            std::vector< std::uint8_t > result( size );
+            generate( result.data(), size );
+
+            return result;
+        }
+    };
+}
+
+BOOST_FIXTURE_TEST_CASE( nist_test_vector, seeded_drbg )
+{
+    // with the default of 4 buffered blocks, every refill is a generate call of 512 bits
+    bytes( 64 );
+    const auto output = bytes( 64 );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( output.begin(), output.end(), std::begin( returned_bits ), std::end( returned_bits ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( stream_does_not_depend_on_request_sizes, seeded_drbg )
+{
+    const auto expected = bytes( 200 );
+
+    seed( entropy_input );
+
+    std::vector< std::uint8_t > output;
+    for ( std::size_t size = 1; output.size() < expected.size(); ++size )
+    {
+        const auto chunk = bytes( std::min( size, expected.size() - output.size() ) );
+        output.insert( output.end(), chunk.begin(), chunk.end() );
+    }
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( output.begin(), output.end(), expected.begin(), expected.end() );
+}
+
+BOOST_FIXTURE_TEST_CASE( seeding_discards_buffered_bytes, seeded_drbg )
+{
+    const auto first = bytes( 5 );
+
+    seed( entropy_input );
+    const auto second = bytes( 5 );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( first.begin(), first.end(), second.begin(), second.end() );
+}
+
+BOOST_FIXTURE_TEST_CASE( random_numbers_are_little_endian, seeded_drbg )
+{
+    const std::uint32_t number = random_number< std::uint32_t >();
+
+    seed( entropy_input );
+    const auto raw = bytes( 4 );
+
+    BOOST_CHECK_EQUAL( number,
+        static_cast< std::uint32_t >( raw[ 0 ] )
+      | static_cast< std::uint32_t >( raw[ 1 ] ) << 8
+      | static_cast< std::uint32_t >( raw[ 2 ] ) << 16
+      | static_cast< std::uint32_t >( raw[ 3 ] ) << 24 );
+}
+
+BOOST_AUTO_TEST_CASE( seeds_itself_once_from_entropy_source )
+{
+    entropy_requests = 0;
+
+    drbg_t drbg;
+    BOOST_CHECK( !drbg.seeded() );
+
+    std::uint8_t output[ 100 ];
+    drbg.generate( output, sizeof( output ) );
+    drbg.generate( output, sizeof( output ) );
+
+    BOOST_CHECK( drbg.seeded() );
+    BOOST_CHECK_EQUAL( entropy_requests, 1u );
+}
+
+BOOST_FIXTURE_TEST_CASE( explicitly_seeded_does_not_request_entropy, seeded_drbg )
+{
+    bytes( 100 );
+
+    BOOST_CHECK_EQUAL( entropy_requests, 0u );
+}
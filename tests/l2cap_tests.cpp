@@ -1,4 +1,5 @@
 #include <bluetoe/l2cap.hpp>
+#include <vector>
 
 #define BOOST_TEST_MODULE
 #include <boost/test/included/unit_test.hpp>
@@ -17,6 +18,65 @@ public:
     static constexpr std::size_t   minimum_channel_mtu_size = 19;
     static constexpr std::size_t   maximum_channel_mtu_size = 44;
 
+    channel_a() : idle_calls( 0 ), flush_calls( 0 ), streamed_sdu_size( 0 )
+    {
+    }
+
+    // channel_b does not implement l2cap_idle()
+    void l2cap_idle()
+    {
+        ++idle_calls;
+    }
+
+    int idle_calls;
+
+    // channel_b does not implement l2cap_input_flush()
+    template < typename ConnectionData >
+    void l2cap_input_flush( ConnectionData& connection )
+    {
+        ++flush_calls;
+        connection.a = 'F';
+    }
+
+    int flush_calls;
+
+    // channel_b does not implement streaming; channel_a accepts only SDUs starting with 's'
+    template < typename ConnectionData >
+    bool l2cap_input_stream_start( const std::uint8_t* input, std::size_t in_size, std::size_t sdu_size, ConnectionData& )
+    {
+        BOOST_REQUIRE( in_size >= 1 );
+
+        if ( input[ 0 ] != 's' )
+            return false;
+
+        streamed.assign( input, input + in_size );
+        streamed_sdu_size = sdu_size;
+
+        return true;
+    }
+
+    template < typename ConnectionData >
+    void l2cap_input_stream( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& )
+    {
+        streamed.insert( streamed.end(), input, input + in_size );
+
+        if ( output )
+        {
+            BOOST_REQUIRE( out_size >= minimum_channel_mtu_size );
+
+            output[ 0 ] = 's';
+            output[ 1 ] = static_cast< std::uint8_t >( streamed.size() );
+            out_size = 2;
+        }
+        else
+        {
+            BOOST_TEST( out_size == 0u );
+        }
+    }
+
+    std::vector< std::uint8_t > streamed;
+    std::size_t                 streamed_sdu_size;
+
     template < typename ConnectionData >
     void l2cap_input( const std::uint8_t* input, std::size_t in_size, std::uint8_t* output, std::size_t& out_size, ConnectionData& connection )
     {
@@ -133,6 +193,27 @@ public:
             pdu.data(), pdu.size(), connection_data_ );
     }
 
+    bool handle_l2cap_stream_start( std::uint16_t channel, std::uint16_t sdu_size, std::initializer_list< std::uint8_t > input )
+    {
+        std::vector< std::uint8_t > pdu = {
+            low( sdu_size ), high( sdu_size ),
+            low( channel ), high( channel )
+        };
+
+        pdu.insert( pdu.end(), input.begin(), input.end() );
+
+        return bluetoe::details::l2cap< link_layer, base_data, channel_a, channel_b >::handle_l2cap_stream_start(
+            pdu.data(), pdu.size(), connection_data_ );
+    }
+
+    bool handle_l2cap_stream( std::initializer_list< std::uint8_t > input, bool last )
+    {
+        const std::vector< std::uint8_t > fragment( input );
+
+        return bluetoe::details::l2cap< link_layer, base_data, channel_a, channel_b >::handle_l2cap_stream(
+            fragment.data(), fragment.size(), last, connection_data_ );
+    }
+
     void add_buffer( std::size_t size )
     {
         BOOST_REQUIRE( current_buffer_used_ <= current_buffer_used_ + size );
@@ -337,3 +418,224 @@ BOOST_AUTO_TEST_CASE( read_pending_from_multiple_channels )
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_FIXTURE_TEST_CASE( idle_is_forwarded_to_channels_implementing_l2cap_idle, link_layer )
+{
+    BOOST_TEST( idle_calls == 0 );
+
+    l2cap_idle();
+    l2cap_idle();
+
+    BOOST_TEST( idle_calls == 2 );
+}
+
+BOOST_FIXTURE_TEST_CASE( input_flush_is_forwarded_to_channels_implementing_l2cap_input_flush, link_layer )
+{
+    BOOST_TEST( flush_calls == 0 );
+
+    l2cap_input_flush( connection_data_ );
+    l2cap_input_flush( connection_data_ );
+
+    BOOST_TEST( flush_calls == 2 );
+    BOOST_TEST( connection_data_.a == 'F' );
+}
+
+BOOST_FIXTURE_TEST_SUITE( streamed_input, link_layer )
+
+BOOST_AUTO_TEST_CASE( fragments_are_streamed_to_the_channel )
+{
+    add_buffer( 44u );
+
+    BOOST_TEST( handle_l2cap_stream_start( 42, 5, { 's', 0x01 } ) );
+    BOOST_TEST( handle_l2cap_stream( { 0x02, 0x03 }, false ) );
+    check_next_output( {} );
+
+    BOOST_TEST( handle_l2cap_stream( { 0x04 }, true ) );
+    check_next_output( { 0x02, 0x00, 42, 0x00, 's', 5 } );
+
+    const std::vector< std::uint8_t > expected = { 's', 0x01, 0x02, 0x03, 0x04 };
+    BOOST_CHECK_EQUAL_COLLECTIONS( channel_a::streamed.begin(), channel_a::streamed.end(), expected.begin(), expected.end() );
+    BOOST_TEST( channel_a::streamed_sdu_size == 5u );
+}
+
+BOOST_AUTO_TEST_CASE( channel_refuses_stream )
+{
+    BOOST_TEST( !handle_l2cap_stream_start( 42, 5, { 'x', 0x01 } ) );
+}
+
+BOOST_AUTO_TEST_CASE( channel_without_streaming_support )
+{
+    BOOST_TEST( !handle_l2cap_stream_start( 43, 5, { 's', 0x01 } ) );
+}
+
+BOOST_AUTO_TEST_CASE( complete_sdus_are_not_streamed )
+{
+    BOOST_TEST( !handle_l2cap_stream_start( 42, 2, { 's', 0x01 } ) );
+}
+
+BOOST_AUTO_TEST_CASE( last_fragment_is_not_consumed_without_output_buffer )
+{
+    BOOST_TEST( handle_l2cap_stream_start( 42, 3, { 's', 0x01 } ) );
+    BOOST_TEST( !handle_l2cap_stream( { 0x02 }, true ) );
+    check_next_output( {} );
+
+    add_buffer( 44u );
+    BOOST_TEST( handle_l2cap_stream( { 0x02 }, true ) );
+    check_next_output( { 0x02, 0x00, 42, 0x00, 's', 3 } );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/*
+ * Scheduling of outgoing SDUs: every channel provides pending_sdus SDUs
+ */
+template < std::uint16_t ChannelId >
+class counting_channel
+{
+public:
+    static constexpr std::uint16_t channel_id = ChannelId;
+    static constexpr std::size_t   minimum_channel_mtu_size = 23;
+    static constexpr std::size_t   maximum_channel_mtu_size = 23;
+
+    counting_channel() : pending_sdus( 0 )
+    {
+    }
+
+    template < typename ConnectionData >
+    void l2cap_input( const std::uint8_t*, std::size_t, std::uint8_t*, std::size_t& out_size, ConnectionData& )
+    {
+        out_size = 0;
+    }
+
+    template < typename ConnectionData >
+    void l2cap_output( std::uint8_t* output, std::size_t& out_size, ConnectionData& )
+    {
+        if ( pending_sdus == 0 )
+        {
+            out_size = 0;
+            return;
+        }
+
+        --pending_sdus;
+        output[ 0 ] = static_cast< std::uint8_t >( channel_id );
+        out_size = 1;
+    }
+
+    template < class PreviousData >
+    using channel_data_t = PreviousData;
+
+    unsigned pending_sdus;
+};
+
+class urgent_channel : public counting_channel< 50 >
+{
+public:
+    static constexpr std::uint16_t output_deadline = 0;
+};
+
+class bulk_channel : public counting_channel< 51 >
+{
+};
+
+class scheduling_link_layer : public bluetoe::details::l2cap< scheduling_link_layer, base_data, bulk_channel, urgent_channel >
+{
+public:
+    scheduling_link_layer()
+        : free_buffers( 0 )
+    {
+    }
+
+    std::pair< std::size_t, std::uint8_t* > allocate_l2cap_output_buffer( std::size_t size )
+    {
+        if ( free_buffers == 0 )
+            return { 0, nullptr };
+
+        return { size + bluetoe::details::l2cap_layer_header_size, buffer_ };
+    }
+
+    void commit_l2cap_output_buffer( std::pair< std::size_t, std::uint8_t* > buffer )
+    {
+        --free_buffers;
+        output_channels.push_back( bluetoe::details::read_16bit( buffer.second + 2 ) );
+    }
+
+    void transmit( unsigned buffers )
+    {
+        free_buffers = buffers;
+        transmit_pending_l2cap_output( connection_data_ );
+    }
+
+    bulk_channel& bulk()
+    {
+        return *this;
+    }
+
+    urgent_channel& urgent()
+    {
+        return *this;
+    }
+
+    unsigned                        free_buffers;
+    std::vector< std::uint16_t >    output_channels;
+    connection_data_t               connection_data_;
+
+private:
+    std::uint8_t                    buffer_[ 100 ];
+};
+
+BOOST_FIXTURE_TEST_SUITE( output_scheduling, scheduling_link_layer )
+
+BOOST_AUTO_TEST_CASE( channel_without_deadline_has_default_deadline )
+{
+    BOOST_TEST( bluetoe::details::l2cap_output_deadline< bulk_channel >( 0 ) == bluetoe::details::default_l2cap_output_deadline );
+    BOOST_TEST( bluetoe::details::l2cap_output_deadline< urgent_channel >( 0 ) == 0u );
+}
+
+BOOST_AUTO_TEST_CASE( channel_with_earlier_deadline_is_served_first )
+{
+    bulk().pending_sdus   = 1;
+    urgent().pending_sdus = 1;
+
+    transmit( 2 );
+
+    const std::vector< std::uint16_t > expected = { 50, 51 };
+    BOOST_CHECK_EQUAL_COLLECTIONS( output_channels.begin(), output_channels.end(), expected.begin(), expected.end() );
+}
+
+BOOST_AUTO_TEST_CASE( urgent_output_overtakes_pending_output )
+{
+    bulk().pending_sdus = 10;
+    transmit( 2 );
+
+    urgent().pending_sdus = 1;
+    transmit( 2 );
+
+    const std::vector< std::uint16_t > expected = { 51, 51, 50, 51 };
+    BOOST_CHECK_EQUAL_COLLECTIONS( output_channels.begin(), output_channels.end(), expected.begin(), expected.end() );
+}
+
+BOOST_AUTO_TEST_CASE( channel_with_later_deadline_is_not_starved )
+{
+    bulk().pending_sdus   = 100;
+    urgent().pending_sdus = 100;
+
+    transmit( 16 );
+
+    // the bulk channel is served, after 4 SDUs of the urgent channel were sent
+    const std::vector< std::uint16_t > expected = {
+        50, 50, 50, 50, 50, 51,
+        50, 50, 50, 50, 51,
+        50, 50, 50, 50, 51 };
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( output_channels.begin(), output_channels.end(), expected.begin(), expected.end() );
+}
+
+BOOST_AUTO_TEST_CASE( nothing_to_send )
+{
+    transmit( 2 );
+
+    BOOST_CHECK( output_channels.empty() );
+    BOOST_CHECK_EQUAL( free_buffers, 2u );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
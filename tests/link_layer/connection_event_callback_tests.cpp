@@ -555,3 +555,147 @@ BOOST_FIXTURE_TEST_CASE( update_callback, server_20ms_minus_100us_cbs )
     BOOST_TEST( hist[ 0 ] == "connect: 30ms, 2" );
     BOOST_TEST( hist[ 1 ] == "update: 10ms, 0, 1" );
 }
+
+BOOST_AUTO_TEST_SUITE( transmit_complete )
+
+    std::uint32_t streamed_value = 0;
+
+    using streaming_server = bluetoe::server<
+        bluetoe::service<
+            bluetoe::service_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CA9 >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CAA >,
+                bluetoe::bind_characteristic_value< decltype( streamed_value ), &streamed_value >,
+                bluetoe::no_write_access,
+                bluetoe::notify
+            >
+        >,
+        bluetoe::no_gap_service_for_gatt_servers
+    >;
+
+    using streamed_characteristic = bluetoe::characteristic_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CAA >;
+
+    struct enable_notifications_t {
+        template < typename ConnectionData >
+        void ll_connection_established(
+              const bluetoe::link_layer::connection_details&   ,
+              const bluetoe::link_layer::connection_addresses& ,
+                    ConnectionData&                            connection )
+        {
+            connection.client_configurations().flags( 0u, bluetoe::details::client_characteristic_configuration_notification_enabled );
+        }
+
+    } enable_notifications;
+
+    struct transmit_complete_t {
+        void ll_notification_acknowledged( std::uint16_t value_handle )
+        {
+            acknowledged.push_back( value_handle );
+
+            if ( renotify && server )
+                server->notify< streamed_characteristic >();
+        }
+
+        std::vector< std::uint16_t >    acknowledged;
+        bool                            renotify;
+        streaming_server*               server;
+    } transmit_complete;
+
+    struct streaming : unconnected_base_t<
+        streaming_server,
+        test::radio,
+        bluetoe::link_layer::connection_callbacks< enable_notifications_t, enable_notifications >,
+        bluetoe::link_layer::buffer_sizes< 100, 61 >,
+        bluetoe::link_layer::transmit_complete_callback< transmit_complete_t, transmit_complete >
+    >
+    {
+        streaming()
+        {
+            transmit_complete = transmit_complete_t();
+            transmit_complete.renotify  = false;
+            transmit_complete.server    = this;
+
+            this->respond_to( 37, valid_connection_request_pdu );
+        }
+
+        unsigned transmitted_notifications()
+        {
+            unsigned result = 0;
+
+            check_connection_events( [&]( const test::connection_event& evt ) -> bool {
+                using test::X;
+                using test::and_so_on;
+
+                for ( const auto& pdu: evt.transmitted_data )
+                    result += check_pdu( pdu, { X, X, 0x07, 0x00, 0x04, 0x00, 0x1b, 0x03, 0x00, and_so_on } ) ? 1 : 0;
+
+                return true;
+            }, "" );
+
+            return result;
+        }
+    };
+
+    BOOST_FIXTURE_TEST_CASE( no_callback_without_notification, streaming )
+    {
+        ll_empty_pdus( 5 );
+        run( 10 );
+
+        BOOST_CHECK( transmit_complete.acknowledged.empty() );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( callback_after_acknowledgment, streaming )
+    {
+        ll_empty_pdu();
+        ll_function_call( [this]{
+            BOOST_REQUIRE( notify< streamed_characteristic >() );
+        } );
+        ll_empty_pdus( 5 );
+        run( 10 );
+
+        BOOST_CHECK_EQUAL( transmitted_notifications(), 1u );
+        BOOST_REQUIRE_EQUAL( transmit_complete.acknowledged.size(), 1u );
+        BOOST_CHECK_EQUAL( transmit_complete.acknowledged[ 0 ], 0x0003 );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( notifying_from_callback_streams_data, streaming )
+    {
+        transmit_complete.renotify = true;
+
+        ll_empty_pdu();
+        ll_function_call( [this]{
+            BOOST_REQUIRE( notify< streamed_characteristic >() );
+        } );
+        ll_empty_pdus( 10 );
+        run( 10 );
+
+        BOOST_CHECK_GE( transmit_complete.acknowledged.size(), 5u );
+        BOOST_CHECK_GE( transmitted_notifications(), transmit_complete.acknowledged.size() );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( credits_are_consumed_by_notifications, streaming )
+    {
+        std::size_t credits_before = 0;
+        std::size_t credits_after  = 0;
+
+        ll_empty_pdu();
+        ll_function_call( [&]{
+            credits_before = transmit_credits();
+            BOOST_REQUIRE( notify< streamed_characteristic >() );
+        } );
+        ll_function_call( [&]{
+            credits_after = transmit_credits();
+        } );
+        ll_empty_pdus( 5 );
+        run( 10 );
+
+        // credits are counted in PDUs of maximum size; a notification of a 4 byte value has a 11 byte body
+        const std::size_t pdu_size = layout::data_channel_pdu_memory_size( 27 );
+
+        BOOST_CHECK_EQUAL( credits_before, 100 / pdu_size );
+        BOOST_CHECK_EQUAL( credits_after, ( 100 - layout::data_channel_pdu_memory_size( 11 ) ) / pdu_size );
+        BOOST_CHECK_LT( credits_after, credits_before );
+        BOOST_CHECK_GT( transmit_credits(), 0u );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
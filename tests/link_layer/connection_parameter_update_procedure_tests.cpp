@@ -864,3 +864,134 @@ BOOST_FIXTURE_TEST_CASE( Accepting_Connection_Parameter_Request__Interval_Range_
     // in this case, the upcall to the host is required
     BOOST_REQUIRE( connection_parameter_update_cb.remote_connection_parameter_request_received );
 }
+
+/*
+ * Latency of the L2CAP connection parameter update request under mixed load: all characteristics
+ * of a server are notified in every connection event, which keeps the transmit buffer of the link
+ * layer filled with ATT notifications.
+ */
+BOOST_AUTO_TEST_SUITE( l2cap_request_under_notification_load )
+
+    std::uint8_t load_value[ 20 ] = { 0 };
+
+    template < std::uint32_t Id >
+    using load_characteristic = bluetoe::characteristic<
+        bluetoe::characteristic_uuid16< Id >,
+        bluetoe::bind_characteristic_value< decltype( load_value ), &load_value >,
+        bluetoe::no_write_access,
+        bluetoe::notify
+    >;
+
+    using load_server = bluetoe::server<
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x8C8B >,
+            load_characteristic< 0x8C01 >,
+            load_characteristic< 0x8C02 >,
+            load_characteristic< 0x8C03 >,
+            load_characteristic< 0x8C04 >
+        >,
+        bluetoe::no_gap_service_for_gatt_servers
+    >;
+
+    struct enable_notifications_t {
+        template < typename ConnectionData >
+        void ll_connection_established(
+              const bluetoe::link_layer::connection_details&   ,
+              const bluetoe::link_layer::connection_addresses& ,
+                    ConnectionData&                            connection )
+        {
+            for ( std::size_t cccd = 0; cccd != 4; ++cccd )
+                connection.client_configurations().flags( cccd, bluetoe::details::client_characteristic_configuration_notification_enabled );
+        }
+
+    } enable_notifications;
+
+    struct link_layer_under_load : unconnected_base_t<
+        load_server,
+        test::radio,
+        bluetoe::l2cap::signaling_channel<>,
+        bluetoe::link_layer::connection_callbacks< enable_notifications_t, enable_notifications >,
+        bluetoe::link_layer::buffer_sizes< 100, 61 >
+    >
+    {
+        static constexpr unsigned request_event = 4;
+        static constexpr unsigned events        = 20;
+
+        link_layer_under_load()
+            : request_connection_event( 0 )
+        {
+            respond_to( 37, valid_connection_request_pdu );
+
+            ll_control_pdu(
+                {
+                    0x0C,               // LL_VERSION_IND
+                    0x06,               // VersNr = Core Specification 4.0
+                    0x00, 0x02,         // CompId
+                    0x00, 0x00          // SubVersNr
+                } );
+
+            for ( unsigned event = 1; event != events; ++event )
+            {
+                ll_function_call( [this, event]{
+                    notify< bluetoe::characteristic_uuid16< 0x8C01 > >();
+                    notify< bluetoe::characteristic_uuid16< 0x8C02 > >();
+                    notify< bluetoe::characteristic_uuid16< 0x8C03 > >();
+                    notify< bluetoe::characteristic_uuid16< 0x8C04 > >();
+
+                    if ( event == request_event )
+                    {
+                        BOOST_REQUIRE( connection_parameter_update_request( 10, 20, 3, 2 * 20 * 4 ) );
+                        request_connection_event = connection_events().size() - 1;
+                    }
+                } );
+            }
+
+            run( events + 2 );
+        }
+
+        /*
+         * number of notifications and connection events, that were transmitted after the request was
+         * queued, until the L2CAP connection parameter update request was transmitted.
+         */
+        bool request_latency( unsigned& notifications, unsigned& connection_events_waited )
+        {
+            notifications = 0;
+
+            for ( std::size_t event = request_connection_event + 1; event < connection_events().size(); ++event )
+            {
+                connection_events_waited = event - request_connection_event;
+
+                for ( const auto& pdu: connection_events()[ event ].transmitted_data )
+                {
+                    if ( check_pdu( pdu, { X, X, X, 0x00, 0x05, 0x00, 0x12, and_so_on } ) )
+                        return true;
+
+                    if ( check_pdu( pdu, { X, X, X, 0x00, 0x04, 0x00, 0x1b, and_so_on } ) )
+                        ++notifications;
+                }
+            }
+
+            return false;
+        }
+
+        std::size_t request_connection_event;
+    };
+
+    BOOST_FIXTURE_TEST_CASE( l2cap_request_is_not_delayed_by_notifications, link_layer_under_load )
+    {
+        BOOST_REQUIRE( request_connection_event != 0u );
+
+        unsigned notifications = 0;
+        unsigned connection_events_waited = 0;
+
+        BOOST_REQUIRE( request_latency( notifications, connection_events_waited ) );
+
+        BOOST_TEST_MESSAGE( "L2CAP request transmitted after " << connection_events_waited
+            << " connection event(s) and " << notifications << " notification(s)" );
+
+        // only a notification, that was already handed to the link layer, can be sent in front of the request
+        BOOST_TEST( notifications <= 1u );
+        BOOST_TEST( connection_events_waited == 1u );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
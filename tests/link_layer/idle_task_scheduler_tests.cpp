@@ -0,0 +1,171 @@
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include <bluetoe/idle_task_scheduler.hpp>
+
+#include "connected.hpp"
+
+#include <utility>
+#include <vector>
+
+using bluetoe::link_layer::delta_time;
+
+namespace {
+    using runs_t = std::vector< std::pair< std::size_t, unsigned > >;
+}
+
+BOOST_TEST_DONT_PRINT_LOG_VALUE( runs_t::value_type )
+
+struct tasks_t {
+    void ll_run_task( std::size_t task );
+
+    // load, that a task actually causes, when run
+    delta_time  loads[ 4 ];
+
+    // a task with a reschedule time, schedules itself again
+    delta_time  reschedule[ 4 ];
+
+    // task and connection event
+    runs_t      runs;
+} tasks;
+
+struct link_layer_with_tasks : unconnected_base_t<
+    test::small_temperature_service,
+    test::radio,
+    bluetoe::link_layer::idle_task_scheduler< tasks_t, tasks, 4 >
+ >
+{
+    link_layer_with_tasks()
+    {
+        tasks = tasks_t();
+        instance = this;
+    }
+
+    void schedule( std::size_t task, delta_time wcet )
+    {
+        tasks.loads[ task ] = wcet;
+        schedule_task( task, wcet );
+    }
+
+    void connect()
+    {
+        // 30ms connection interval
+        respond_to( 37, valid_connection_request_pdu );
+        ll_empty_pdus( 5 );
+
+        run();
+    }
+
+    static link_layer_with_tasks* instance;
+};
+
+link_layer_with_tasks* link_layer_with_tasks::instance = nullptr;
+
+void tasks_t::ll_run_task( std::size_t task )
+{
+    // the radio has already recorded the next connection event
+    runs.push_back( std::make_pair( task, link_layer_with_tasks::instance->connection_events().size() - 2 ) );
+    link_layer_with_tasks::instance->cpu_load( loads[ task ] );
+
+    if ( !reschedule[ task ].zero() )
+        link_layer_with_tasks::instance->schedule_task( task, reschedule[ task ] );
+}
+
+BOOST_FIXTURE_TEST_CASE( tasks_are_not_run_without_connection, link_layer_with_tasks )
+{
+    schedule( 0, delta_time::msec( 1 ) );
+    run();
+
+    BOOST_CHECK( tasks.runs.empty() );
+}
+
+BOOST_FIXTURE_TEST_CASE( scheduled_task_is_run_once, link_layer_with_tasks )
+{
+    schedule( 0, delta_time::msec( 1 ) );
+    connect();
+
+    BOOST_CHECK( ( tasks.runs == runs_t{ { 0, 0 } } ) );
+    BOOST_CHECK_EQUAL( missed_connection_events(), 0u );
+}
+
+BOOST_FIXTURE_TEST_CASE( tasks_that_do_not_fit_are_deferred, link_layer_with_tasks )
+{
+    schedule( 0, delta_time::msec( 12 ) );
+    schedule( 1, delta_time::msec( 12 ) );
+    schedule( 2, delta_time::msec( 12 ) );
+    connect();
+
+    BOOST_CHECK( ( tasks.runs == runs_t{ { 0, 0 }, { 1, 0 }, { 2, 1 } } ) );
+    BOOST_CHECK_EQUAL( missed_connection_events(), 0u );
+}
+
+BOOST_FIXTURE_TEST_CASE( smaller_tasks_use_the_remaining_time, link_layer_with_tasks )
+{
+    schedule( 0, delta_time::msec( 20 ) );
+    schedule( 1, delta_time::msec( 15 ) );
+    schedule( 2, delta_time::msec( 5 ) );
+    connect();
+
+    BOOST_CHECK( ( tasks.runs == runs_t{ { 0, 0 }, { 2, 0 }, { 1, 1 } } ) );
+    BOOST_CHECK_EQUAL( missed_connection_events(), 0u );
+}
+
+BOOST_FIXTURE_TEST_CASE( guard_time_is_kept_free, link_layer_with_tasks )
+{
+    // 30ms interval minus window widening and the guard time of 500µs
+    schedule( 0, delta_time::usec( 29600 ) );
+    connect();
+
+    BOOST_CHECK( tasks.runs.empty() );
+}
+
+BOOST_FIXTURE_TEST_CASE( processing_of_the_connection_event_is_not_idle_time, link_layer_with_tasks )
+{
+    connection_event_processing_time( delta_time::msec( 10 ) );
+
+    schedule( 0, delta_time::msec( 12 ) );
+    schedule( 1, delta_time::msec( 12 ) );
+    connect();
+
+    BOOST_CHECK( ( tasks.runs == runs_t{ { 0, 0 }, { 1, 1 } } ) );
+    BOOST_CHECK_EQUAL( missed_connection_events(), 0u );
+}
+
+BOOST_FIXTURE_TEST_CASE( task_larger_than_the_gap_is_never_run, link_layer_with_tasks )
+{
+    schedule( 0, delta_time::msec( 40 ) );
+    schedule( 1, delta_time::msec( 1 ) );
+    connect();
+
+    BOOST_CHECK( ( tasks.runs == runs_t{ { 1, 0 } } ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( task_is_run_once_per_connection_event, link_layer_with_tasks )
+{
+    tasks.reschedule[ 0 ] = delta_time::msec( 1 );
+    schedule( 0, delta_time::msec( 1 ) );
+    connect();
+
+    BOOST_REQUIRE_GE( tasks.runs.size(), 5u );
+
+    for ( std::size_t run = 0; run != tasks.runs.size(); ++run )
+        BOOST_CHECK_EQUAL( tasks.runs[ run ].second, run );
+}
+
+BOOST_FIXTURE_TEST_CASE( rescheduling_updates_the_execution_time, link_layer_with_tasks )
+{
+    schedule( 0, delta_time::msec( 40 ) );
+    schedule( 0, delta_time::msec( 10 ) );
+    connect();
+
+    BOOST_CHECK( ( tasks.runs == runs_t{ { 0, 0 } } ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( task_exceeding_its_execution_time_causes_a_missed_event, link_layer_with_tasks )
+{
+    schedule( 0, delta_time::msec( 1 ) );
+    tasks.loads[ 0 ] = delta_time::msec( 35 );
+    connect();
+
+    BOOST_CHECK_EQUAL( missed_connection_events(), 1u );
+}
@@ -4,10 +4,12 @@
 #define BOOST_TEST_MODULE
 #include <boost/test/included/unit_test.hpp>
 
+#include <deque>
 #include <initializer_list>
 #include <random>
 #include <tuple>
 #include <type_traits>
+#include <vector>
 
 #include "buffer_io.hpp"
 
@@ -1047,6 +1049,127 @@ BOOST_AUTO_TEST_SUITE( packet_counter_tests )
 
 BOOST_AUTO_TEST_SUITE_END()
 
+BOOST_AUTO_TEST_SUITE( transmit_credits_and_acknowledgments )
+
+    struct credits_mode : running_mode
+    {
+        void transmit_max_pdu()
+        {
+            const auto pdu = random_data( 27 );
+            transmit_pdu( pdu.begin(), pdu.end() );
+        }
+    };
+
+    BOOST_FIXTURE_TEST_CASE( empty_buffer_yields_credits_for_max_tx_size_pdus, running_mode )
+    {
+        BOOST_CHECK_EQUAL( transmit_credits(), 100u / 29u );
+
+        max_tx_size( 50 );
+        BOOST_CHECK_EQUAL( transmit_credits(), 100u / 50u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( credits_are_consumed_by_committed_pdus, credits_mode )
+    {
+        transmit_max_pdu();
+        BOOST_CHECK_EQUAL( transmit_credits(), 2u );
+
+        transmit_max_pdu();
+        BOOST_CHECK_EQUAL( transmit_credits(), 1u );
+
+        transmit_max_pdu();
+        BOOST_CHECK_EQUAL( transmit_credits(), 0u );
+        BOOST_CHECK_EQUAL( allocate_transmit_buffer().size, 0u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( credits_match_allocatable_buffers, credits_mode )
+    {
+        bool nesn = false;
+
+        for ( int round = 0; round != 50; ++round )
+        {
+            const std::size_t credits = transmit_credits();
+
+            for ( std::size_t i = 0; i != credits; ++i )
+                transmit_max_pdu();
+
+            BOOST_CHECK_EQUAL( allocate_transmit_buffer().size, 0u );
+
+            // acknowledge a random number of PDUs
+            for ( std::size_t acks = random_value( 1, 3 ); acks && pending_outgoing_data_available(); --acks )
+            {
+                next_transmit();
+                nesn = !nesn;
+
+                auto incomming = allocate_receive_buffer();
+                incomming.buffer[ 0 ] = 1 | ( nesn ? 4 : 0 );
+                incomming.buffer[ 1 ] = 0;
+                received( incomming );
+            }
+        }
+    }
+
+    BOOST_FIXTURE_TEST_CASE( committed_pdus_are_counted, running_mode )
+    {
+        BOOST_CHECK_EQUAL( committed_transmit_pdus(), 0u );
+
+        transmit_pdu( { 1 } );
+        transmit_pdu( { 2 } );
+
+        BOOST_CHECK_EQUAL( committed_transmit_pdus(), 2u );
+        BOOST_CHECK_EQUAL( acknowledged_transmit_pdus(), 0u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( acknowledged_pdus_are_counted, running_mode )
+    {
+        transmit_pdu( { 1 } );
+        transmit_pdu( { 2 } );
+
+        next_transmit();
+
+        // incomming PDU acknowledges
+        auto incomming = allocate_receive_buffer();
+        incomming.buffer[ 0 ] = 1 | 4;
+        incomming.buffer[ 1 ] = 0;
+        received( incomming );
+
+        BOOST_CHECK_EQUAL( acknowledged_transmit_pdus(), 1u );
+
+        next_transmit();
+
+        // not acknowledged, retransmission requested
+        incomming = allocate_receive_buffer();
+        incomming.buffer[ 0 ] = 1 | 4;
+        incomming.buffer[ 1 ] = 0;
+        received( incomming );
+
+        BOOST_CHECK_EQUAL( acknowledged_transmit_pdus(), 1u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( empty_pdus_are_not_counted, running_mode )
+    {
+        next_transmit();
+
+        auto incomming = allocate_receive_buffer();
+        incomming.buffer[ 0 ] = 1 | 4;
+        incomming.buffer[ 1 ] = 0;
+        received( incomming );
+
+        BOOST_CHECK_EQUAL( committed_transmit_pdus(), 0u );
+        BOOST_CHECK_EQUAL( acknowledged_transmit_pdus(), 0u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( counters_are_reset, running_mode )
+    {
+        transmit_pdu( { 1 } );
+        reset_pdu_buffer();
+
+        BOOST_CHECK_EQUAL( committed_transmit_pdus(), 0u );
+        BOOST_CHECK_EQUAL( acknowledged_transmit_pdus(), 0u );
+        BOOST_CHECK_EQUAL( transmit_credits(), 100u / 29u );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
 BOOST_AUTO_TEST_SUITE( stop_mode )
 
     BOOST_FIXTURE_TEST_CASE( ignore_outgoing_pdus, running_mode )
@@ -1089,3 +1212,431 @@ BOOST_AUTO_TEST_SUITE( stop_mode )
     }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( transmit_references )
+
+    BOOST_FIXTURE_TEST_CASE( referenced_pdu_is_transmitted_in_place, running_mode )
+    {
+        std::uint8_t pdu[] = { 0xff, 0xff, 0x01, 0x02, 0x03 };
+
+        BOOST_CHECK( commit_transmit_reference( { pdu, sizeof( pdu ) }, 2 ) );
+        BOOST_CHECK( pending_outgoing_data_available() );
+
+        const auto transmit = next_transmit();
+
+        BOOST_CHECK( transmit.buffer == &pdu[ 0 ] );
+        BOOST_CHECK_EQUAL( transmit.size, sizeof( pdu ) );
+        BOOST_CHECK_EQUAL( pdu[ 0 ], 0x02 );
+        BOOST_CHECK_EQUAL( pdu[ 1 ], 0x03 );
+        BOOST_CHECK_EQUAL( pdu[ 2 ], 0x01 );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( references_are_pending_until_acknowledged, running_mode )
+    {
+        std::uint8_t pdu[] = { 0x00, 0x00, 0x01 };
+
+        commit_transmit_reference( { pdu, sizeof( pdu ) }, 2 );
+        BOOST_CHECK_EQUAL( pending_transmit_references(), 1u );
+
+        // not acknowledged
+        receive_pdu( {}, false, false );
+        BOOST_CHECK_EQUAL( pending_transmit_references(), 1u );
+
+        const auto transmit = receive_pdu( {}, true, true );
+        BOOST_CHECK_EQUAL( pending_transmit_references(), 0u );
+        BOOST_CHECK( transmit.buffer != &pdu[ 0 ] );
+        BOOST_CHECK( !pending_outgoing_data_available() );
+        BOOST_CHECK_EQUAL( transmit_packet_counter(), 1 );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( references_and_copies_share_sequence_numbers, one_element_in_transmit_buffer )
+    {
+        std::uint8_t pdu[] = { 0x00, 0x00, 0x01 };
+
+        commit_transmit_reference( { pdu, sizeof( pdu ) }, 1 );
+
+        const auto first = next_transmit();
+        BOOST_CHECK_EQUAL( first.buffer[ 0 ], 0x01 | 0x10 );
+        BOOST_CHECK_EQUAL( first.buffer[ 2 ], 0x34 );
+
+        const auto second = receive_pdu( {}, false, true );
+        BOOST_CHECK( second.buffer == &pdu[ 0 ] );
+        BOOST_CHECK_EQUAL( pdu[ 0 ], 0x01 | 0x08 | 0x04 );
+        BOOST_CHECK_EQUAL( pdu[ 1 ], 0x01 );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( more_data_is_flagged, running_mode )
+    {
+        std::uint8_t pdu1[] = { 0x00, 0x00, 0x01 };
+        std::uint8_t pdu2[] = { 0x00, 0x00, 0x02 };
+
+        commit_transmit_reference( { pdu1, sizeof( pdu1 ) }, 2 );
+        commit_transmit_reference( { pdu2, sizeof( pdu2 ) }, 1 );
+
+        next_transmit();
+        BOOST_CHECK_EQUAL( pdu1[ 0 ], 0x02 | 0x10 );
+
+        receive_pdu( {}, false, true );
+        BOOST_CHECK_EQUAL( pdu2[ 0 ], 0x01 | 0x08 | 0x04 );
+    }
+
+    /*
+     * The header of the second fragment is placed over the end of the first fragment. It must not be
+     * written, before the first fragment was acknowledged.
+     */
+    BOOST_FIXTURE_TEST_CASE( overlapping_fragments, running_mode )
+    {
+        std::uint8_t sdu[] = { 0x00, 0x00, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15 };
+
+        commit_transmit_reference( { &sdu[ 0 ], 6 }, 2 );
+        commit_transmit_reference( { &sdu[ 4 ], 4 }, 1 );
+
+        const auto first = next_transmit();
+        BOOST_CHECK( first.buffer == &sdu[ 0 ] );
+        BOOST_CHECK_EQUAL( first.size, 6u );
+        BOOST_CHECK_EQUAL( sdu[ 4 ], 0x12 );
+        BOOST_CHECK_EQUAL( sdu[ 5 ], 0x13 );
+
+        // resend
+        receive_pdu( {}, false, false );
+        BOOST_CHECK_EQUAL( sdu[ 4 ], 0x12 );
+
+        const auto second = receive_pdu( {}, true, true );
+        BOOST_CHECK( second.buffer == &sdu[ 4 ] );
+        BOOST_CHECK_EQUAL( second.size, 4u );
+        BOOST_CHECK_EQUAL( sdu[ 4 ], 0x01 | 0x08 );
+        BOOST_CHECK_EQUAL( sdu[ 5 ], 0x02 );
+        BOOST_CHECK_EQUAL( sdu[ 6 ], 0x14 );
+        BOOST_CHECK_EQUAL( pending_transmit_references(), 1u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( references_fail_if_transmit_buffer_is_full, running_mode )
+    {
+        std::uint8_t pdu[] = { 0x00, 0x00, 0x01 };
+
+        std::size_t committed = 0;
+        while ( commit_transmit_reference( { pdu, sizeof( pdu ) }, 2 ) && committed != 100 )
+            ++committed;
+
+        BOOST_CHECK_LT( committed, 100u );
+        BOOST_CHECK_GT( committed, 1u );
+        BOOST_CHECK_EQUAL( pending_transmit_references(), committed );
+        BOOST_CHECK_EQUAL( allocate_transmit_buffer().size, 0u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( reset_drops_references, running_mode )
+    {
+        std::uint8_t pdu[] = { 0x00, 0x00, 0x01 };
+
+        commit_transmit_reference( { pdu, sizeof( pdu ) }, 2 );
+        reset_pdu_buffer();
+
+        BOOST_CHECK_EQUAL( pending_transmit_references(), 0u );
+        BOOST_CHECK( !pending_outgoing_data_available() );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( references_are_ignored_in_stop_mode, running_mode )
+    {
+        std::uint8_t pdu[] = { 0x00, 0x00, 0x01 };
+
+        stop_ll_pdu_buffer();
+
+        BOOST_CHECK( commit_transmit_reference( { pdu, sizeof( pdu ) }, 2 ) );
+        BOOST_CHECK_EQUAL( pending_transmit_references(), 0u );
+        BOOST_CHECK( !pending_outgoing_data_available() );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( layout_overhead_is_cleared, layout_tests::buffer_under_test )
+    {
+        std::uint8_t pdu[] = { 0xaa, 0xaa, 0xaa, 'a', 'b', 0xaa };
+
+        commit_transmit_reference( { pdu, sizeof( pdu ) }, 2 );
+
+        const auto transmit = next_transmit();
+
+        BOOST_CHECK( transmit.buffer == &pdu[ 0 ] );
+        BOOST_CHECK_EQUAL( layout::header( transmit ), 0x0202 );
+        BOOST_CHECK_EQUAL( pdu[ 2 ], 0 );
+        BOOST_CHECK_EQUAL( pdu[ 3 ], 'a' );
+        BOOST_CHECK_EQUAL( pdu[ 4 ], 'b' );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( shared_buffer )
+
+    struct shared_running_mode : running_mode
+    {
+        shared_running_mode()
+        {
+            share_pdu_buffer( 31, 31 );
+        }
+
+        // fills the transmit buffer with PDUs of the maximum size and returns the number of queued PDUs
+        std::size_t fill_transmit_buffer()
+        {
+            std::size_t count = 0;
+
+            for ( auto pdu = allocate_transmit_buffer(); pdu.size; pdu = allocate_transmit_buffer(), ++count )
+            {
+                layout::header( pdu, 2 | ( ( pdu.size - 2 ) << 8 ) );
+                pdu.buffer[ 2 ] = static_cast< std::uint8_t >( count );
+                commit_transmit_buffer( pdu );
+            }
+
+            return count;
+        }
+
+        // receives a PDU of the maximum size, filled with value
+        void receive_full_pdu( std::uint8_t value, bool sn )
+        {
+            const std::vector< std::uint8_t > data( 27, value );
+            receive_pdu( data.begin(), data.end(), sn, false );
+        }
+    };
+
+    BOOST_FIXTURE_TEST_CASE( buffers_are_not_shared_by_default, running_mode )
+    {
+        while ( allocate_transmit_buffer().size )
+            transmit_pdu( { 0x01, 0x02, 0x03 } );
+
+        BOOST_CHECK_EQUAL( allocate_receive_buffer().size, 29u );
+        BOOST_CHECK_EQUAL( transmit_buffer_size(), 100u );
+        BOOST_CHECK_EQUAL( receive_buffer_size(), 100u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( initially_the_buffer_is_split_as_configured, shared_running_mode )
+    {
+        BOOST_CHECK_EQUAL( transmit_buffer_size(), 100u );
+        BOOST_CHECK_EQUAL( receive_buffer_size(), 100u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( transmit_buffer_borrows_from_empty_receive_buffer, shared_running_mode )
+    {
+        const std::size_t first_fill = fill_transmit_buffer();
+        BOOST_CHECK_EQUAL( first_fill, 3u );
+
+        BOOST_CHECK_EQUAL( allocate_receive_buffer().size, 29u );
+        BOOST_CHECK_EQUAL( transmit_buffer_size(), 200u - 31u );
+        BOOST_CHECK_EQUAL( receive_buffer_size(), 31u );
+
+        BOOST_CHECK_EQUAL( fill_transmit_buffer(), 2u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( transmit_buffer_borrows_only_if_required, shared_running_mode )
+    {
+        transmit_pdu( { 0x01, 0x02, 0x03 } );
+        allocate_receive_buffer();
+
+        BOOST_CHECK_EQUAL( transmit_buffer_size(), 100u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( no_borrowing_from_a_receive_buffer_in_use, shared_running_mode )
+    {
+        receive_pdu( { 0x01, 0x02 }, false, false );
+        fill_transmit_buffer();
+
+        allocate_receive_buffer();
+        BOOST_CHECK_EQUAL( transmit_buffer_size(), 100u );
+
+        // as soon as the received PDU is consumed, the memory can be borrowed
+        free_received();
+        allocate_receive_buffer();
+        BOOST_CHECK_EQUAL( transmit_buffer_size(), 169u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( receive_buffer_borrows_from_transmit_buffer, shared_running_mode )
+    {
+        transmit_pdu( { 0x01, 0x02, 0x03 } );
+
+        for ( std::uint8_t i = 0; i != 3; ++i )
+            receive_full_pdu( i, i % 2 == 1 );
+
+        BOOST_CHECK_EQUAL( transmit_buffer_size(), 100u );
+
+        // the fourth PDU does not fit into the receive buffer; the transmit buffer keeps its PDU and room for one more
+        receive_full_pdu( 3, true );
+        BOOST_CHECK_EQUAL( transmit_buffer_size(), 5u + 29u );
+        BOOST_CHECK_EQUAL( receive_buffer_size(), 200u - 34u );
+
+        for ( std::uint8_t i = 0; i != 4; ++i )
+        {
+            const auto pdu = next_received();
+            BOOST_REQUIRE_EQUAL( pdu.size, 29u );
+            BOOST_CHECK_EQUAL( pdu.buffer[ 2 ], i );
+            free_received();
+        }
+
+        BOOST_CHECK_EQUAL( next_received().size, 0u );
+        BOOST_CHECK( next_transmit().buffer != nullptr );
+        BOOST_CHECK_EQUAL( layout::body( next_transmit() ).first[ 0 ], 0x01 );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( transmit_reservation_is_kept, shared_running_mode )
+    {
+        for ( std::uint8_t i = 0; i != 4; ++i )
+            receive_full_pdu( i, i % 2 == 1 );
+
+        BOOST_CHECK_EQUAL( transmit_buffer_size(), 31u );
+        BOOST_CHECK_EQUAL( receive_buffer_size(), 169u );
+        BOOST_CHECK_EQUAL( allocate_transmit_buffer().size, 29u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( no_borrowing_while_a_transmit_buffer_is_allocated, shared_running_mode )
+    {
+        fill_transmit_buffer();
+
+        // fill the transmit buffer, until there is no room for a reference, but for a small PDU
+        while ( allocate_transmit_buffer( 12 ).size )
+            transmit_pdu( { 0x01 } );
+
+        const auto allocated = allocate_transmit_buffer( 5 );
+        BOOST_REQUIRE_EQUAL( allocated.size, 5u );
+
+        // makes the transmit buffer starving, while the allocated buffer is still in use
+        std::uint8_t referenced[ 5 ] = { 0x00, 0x00, 0x00, 0x00, 0x00 };
+        BOOST_REQUIRE( !commit_transmit_reference( { referenced, sizeof( referenced ) }, 2 ) );
+
+        allocate_receive_buffer();
+        BOOST_CHECK_EQUAL( transmit_buffer_size(), 100u );
+
+        layout::header( allocated, 1 | ( 3 << 8 ) );
+        std::fill( layout::body( allocated ).first, layout::body( allocated ).second, 0x42 );
+        commit_transmit_buffer( allocated );
+
+        // the transmit buffer is still starving
+        BOOST_REQUIRE_EQUAL( allocate_transmit_buffer().size, 0u );
+
+        allocate_receive_buffer();
+        BOOST_CHECK_EQUAL( transmit_buffer_size(), 169u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( no_returning_while_a_transmit_buffer_is_allocated, shared_running_mode )
+    {
+        transmit_pdu( { 0x01, 0x02, 0x03 } );
+
+        for ( std::uint8_t i = 0; i != 3; ++i )
+            receive_full_pdu( i, i % 2 == 1 );
+
+        const auto allocated = allocate_transmit_buffer( 5 );
+        BOOST_REQUIRE_EQUAL( allocated.size, 5u );
+
+        BOOST_CHECK_EQUAL( allocate_receive_buffer().size, 0u );
+        BOOST_CHECK_EQUAL( transmit_buffer_size(), 100u );
+
+        layout::header( allocated, 1 | ( 3 << 8 ) );
+        std::fill( layout::body( allocated ).first, layout::body( allocated ).second, 0x42 );
+        commit_transmit_buffer( allocated );
+
+        BOOST_CHECK_EQUAL( allocate_receive_buffer().size, 29u );
+        BOOST_CHECK_LT( transmit_buffer_size(), 100u );
+
+        // the queued PDU was not moved
+        BOOST_CHECK_EQUAL( layout::body( next_transmit() ).first[ 0 ], 0x01 );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( reset_restores_the_configured_split, shared_running_mode )
+    {
+        fill_transmit_buffer();
+        allocate_receive_buffer();
+        BOOST_REQUIRE_EQUAL( transmit_buffer_size(), 169u );
+
+        reset_pdu_buffer();
+
+        BOOST_CHECK_EQUAL( transmit_buffer_size(), 100u );
+        BOOST_CHECK_EQUAL( receive_buffer_size(), 100u );
+    }
+
+    /*
+     * Simulates a peer, that sends and acknowledges PDUs and changes between phases with a lot of outgoing and
+     * a lot of incoming traffic. All PDUs have to be transported in order, while the memory is moved
+     * between the transmit and receive buffer.
+     */
+    BOOST_FIXTURE_TEST_CASE( move_random_data_through_a_shared_buffer, shared_running_mode )
+    {
+        std::deque< std::vector< std::uint8_t > > transmitted;
+        std::deque< std::vector< std::uint8_t > > received_by_peer;
+        bool peer_sn   = false;
+        bool peer_nesn = false;
+
+        std::size_t max_transmit_size = 0;
+        std::size_t min_transmit_size = size;
+        std::size_t transmit_count    = 0;
+        std::size_t receive_count     = 0;
+
+        for ( std::size_t step = 0; step != 4000; ++step )
+        {
+            const bool transmit_phase = ( step / 250 ) % 2 == 0;
+            const std::size_t action  = random_value( 0, 99 );
+
+            if ( action < ( transmit_phase ? 50u : 5u ) )
+            {
+                const std::vector< std::uint8_t > data = random_data( random_value( 1, 27 ) );
+                const auto pdu = allocate_transmit_buffer( data.size() + 2 );
+
+                if ( pdu.size )
+                {
+                    layout::header( pdu, 2 | ( data.size() << 8 ) );
+                    std::copy( data.begin(), data.end(), layout::body( pdu ).first );
+                    commit_transmit_buffer( pdu );
+                    transmitted.push_back( data );
+                }
+            }
+            else if ( action < ( transmit_phase ? 75u : 65u ) )
+            {
+                auto incomming = allocate_receive_buffer();
+
+                if ( incomming.size == 0 )
+                    continue;
+
+                const std::vector< std::uint8_t > data = random_data( transmit_phase ? 0 : random_value( 1, 27 ) );
+                layout::header( incomming, 2 | ( data.size() << 8 ) | ( peer_sn ? 8 : 0 ) | ( peer_nesn ? 4 : 0 ) );
+                std::copy( data.begin(), data.end(), layout::body( incomming ).first );
+                peer_sn = !peer_sn;
+
+                if ( !data.empty() )
+                    received_by_peer.push_back( data );
+
+                const auto response = received( incomming );
+                const std::uint16_t header = layout::header( response );
+
+                if ( static_cast< bool >( header & 8 ) == peer_nesn )
+                {
+                    peer_nesn = !peer_nesn;
+
+                    if ( ( header & 0xff00 ) != 0 )
+                    {
+                        BOOST_REQUIRE( !transmitted.empty() );
+                        const auto body = layout::body( response );
+                        BOOST_REQUIRE_EQUAL_COLLECTIONS( body.first, body.first + ( header >> 8 ), transmitted.front().begin(), transmitted.front().end() );
+                        transmitted.pop_front();
+                        ++transmit_count;
+                    }
+                }
+            }
+            else
+            {
+                const auto pdu = next_received();
+
+                if ( pdu.size )
+                {
+                    BOOST_REQUIRE( !received_by_peer.empty() );
+                    const auto body = layout::body( pdu );
+                    BOOST_REQUIRE_EQUAL_COLLECTIONS( body.first, body.first + ( layout::header( pdu ) >> 8 ), received_by_peer.front().begin(), received_by_peer.front().end() );
+                    received_by_peer.pop_front();
+                    free_received();
+                    ++receive_count;
+                }
+            }
+
+            max_transmit_size = std::max( max_transmit_size, transmit_buffer_size() );
+            min_transmit_size = std::min( min_transmit_size, transmit_buffer_size() );
+        }
+
+        BOOST_CHECK_GT( max_transmit_size, 100u );
+        BOOST_CHECK_LT( min_transmit_size, 100u );
+        BOOST_CHECK_GT( transmit_count, 100u );
+        BOOST_CHECK_GT( receive_count, 100u );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
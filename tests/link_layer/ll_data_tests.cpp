@@ -32,3 +32,94 @@ BOOST_FIXTURE_TEST_CASE( response_to_att_request, unconnected )
 
     BOOST_CHECK_EQUAL_COLLECTIONS( std::begin( response ), std::end( response ), std::begin( expected_response ), std::end( expected_response ) );
 }
+
+struct unconnected_with_shared_buffer : unconnected_base< bluetoe::link_layer::shared_buffer_sizes< 122u, 31u, 31u > > {};
+
+BOOST_FIXTURE_TEST_CASE( shared_buffer_is_split_in_half, unconnected_with_shared_buffer )
+{
+    BOOST_CHECK_EQUAL( transmit_buffer_size(), 61u );
+    BOOST_CHECK_EQUAL( receive_buffer_size(), 61u );
+}
+
+BOOST_FIXTURE_TEST_CASE( response_to_att_request_with_shared_buffer, unconnected_with_shared_buffer )
+{
+    respond_to( 37, valid_connection_request_pdu );
+    ll_data_pdu(
+        {
+            0x03, 0x00,         // length
+            0x04, 0x00,         // Channel
+            0x02, 0x50, 0x00    // Exchange MTU Request
+        } );
+    ll_empty_pdu();
+
+    run();
+
+    auto response = connection_events().at( 1 ).transmitted_data.at( 0 );
+    response[ 0 ] &= 0x03;
+
+    static const std::uint8_t expected_response[] = {
+        0x02, 0x07,             // ll header
+        0x03, 0x00, 0x04, 0x00, // l2cap header
+        0x03, 0x17, 0x00        // Exchange MTU Response
+    };
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( std::begin( response ), std::end( response ), std::begin( expected_response ), std::end( expected_response ) );
+}
+
+BOOST_AUTO_TEST_SUITE( write_command_bursts )
+
+    std::vector< std::size_t > burst_sizes;
+
+    std::uint8_t log_samples( const bluetoe::write_command_view*, std::size_t count )
+    {
+        burst_sizes.push_back( count );
+
+        return bluetoe::error_codes::success;
+    }
+
+    using logging_server = bluetoe::server<
+        bluetoe::write_command_burst_buffer< 64, 8 >,
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x8C8B >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x8C01 >,
+                bluetoe::free_write_command_burst_handler< &log_samples >,
+                bluetoe::only_write_without_response
+            >
+        >,
+        bluetoe::no_gap_service_for_gatt_servers
+    >;
+
+    struct logging_link_layer : unconnected_base_t< logging_server, test::radio >
+    {
+        logging_link_layer()
+        {
+            burst_sizes.clear();
+        }
+
+        static test::pdu_t write_command( std::uint8_t sample )
+        {
+            return test::pdu_t{
+                0x02, 0x08,
+                0x04, 0x00, 0x04, 0x00,     // l2cap header
+                0x52, 0x03, 0x00, sample    // Write Command
+            };
+        }
+    };
+
+    BOOST_FIXTURE_TEST_CASE( write_commands_of_a_connection_event_are_passed_as_one_burst, logging_link_layer )
+    {
+        respond_to( 37, valid_connection_request_pdu );
+        add_connection_event_respond( test::connection_event_response( test::pdu_list_t{
+            write_command( 1 ), write_command( 2 ), write_command( 3 ) } ) );
+        add_connection_event_respond( test::connection_event_response( test::pdu_list_t{
+            write_command( 4 ) } ) );
+
+        run( 4 );
+
+        BOOST_CHECK_EQUAL( burst_sizes.size(), 2u );
+        BOOST_CHECK_EQUAL( burst_sizes.at( 0 ), 3u );
+        BOOST_CHECK_EQUAL( burst_sizes.at( 1 ), 1u );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -2,8 +2,12 @@
 #include <boost/test/included/unit_test.hpp>
 
 #include "connected.hpp"
+#include "test_radio_encryption.hpp"
 #include <bluetoe/pairing_status.hpp>
 
+#include <algorithm>
+#include <memory>
+
 namespace test {
     std::uint16_t secret_value;
 
@@ -30,6 +34,7 @@ namespace test {
 
     std::uint16_t ediv;
     std::uint64_t rand;
+    unsigned      idle_calls;
 
     /**
      * A mocked security manager to be used by the link_layer under test to
@@ -80,8 +85,14 @@ namespace test {
             }
 
             template < class Connection >
-            void l2cap_output( std::uint8_t*, std::size_t&, Connection& )
+            void l2cap_output( std::uint8_t*, std::size_t& out_size, Connection& )
             {
+                out_size = 0;
+            }
+
+            void l2cap_idle()
+            {
+                ++idle_calls;
             }
 
             static constexpr std::uint16_t channel_id               = bluetoe::l2cap_channel_ids::sm;
@@ -104,6 +115,7 @@ struct link_layer_with_security : unconnected_base_t< test::secret_service, test
         test::key_vault = { false, { { 0x00 } } };
         test::ediv      = 0u;
         test::rand      = 0u;
+        test::idle_calls = 0u;
     }
 
     void expected_response( const std::initializer_list< std::uint8_t >& expected_response, std::size_t event = 1, std::size_t pdu = 0 )
@@ -132,6 +144,34 @@ BOOST_FIXTURE_TEST_CASE( response_to_an_feature_request_with_security_enabled, l
     } );
 }
 
+struct advertising_with_security : unconnected_base_t< test::secret_service, test::radio_with_encryption, test::security_manager, test::buffer_sizes >
+{
+    advertising_with_security()
+    {
+        test::idle_calls = 0u;
+    }
+};
+
+BOOST_FIXTURE_TEST_CASE( security_manager_idle_while_advertising, advertising_with_security )
+{
+    run();
+
+    BOOST_CHECK_EQUAL( test::idle_calls, 1u );
+}
+
+BOOST_FIXTURE_TEST_CASE( security_manager_not_idle_while_connected, link_layer_with_security )
+{
+    for ( int event = 0; event != 10; ++event )
+        ll_empty_pdu();
+
+    // the simulation ends, while the link layer is still connected
+    end_of_simulation( bluetoe::link_layer::delta_time::msec( 200 ) );
+    run();
+
+    BOOST_CHECK_GT( connection_events().size(), 2u );
+    BOOST_CHECK_EQUAL( test::idle_calls, 0u );
+}
+
 BOOST_FIXTURE_TEST_CASE( skd_and_iv_stored, link_layer_with_security )
 {
     ll_control_pdu({
@@ -424,3 +464,117 @@ BOOST_FIXTURE_TEST_CASE( pause_encryption, link_layer_with_encryption )
     BOOST_CHECK( !connection_events().at( 7 ).receive_encryption_at_start_of_event );
     BOOST_CHECK( !connection_events().at( 7 ).transmit_encryption_at_start_of_event );
 }
+
+/*
+ * Encrypted throughput: the same sequence of ATT requests is run over a link, that is encrypted
+ * by the software AES-CCM engine, and over a link, where the radio only simulates the encryption.
+ */
+template < template < std::size_t, std::size_t, typename > class Radio >
+struct encrypted_read_requests : unconnected_base_t< test::secret_service, Radio, test::security_manager, bluetoe::link_layer::buffer_sizes< 256u, 256u > >
+{
+    static constexpr std::size_t events             = 20;
+    static constexpr std::size_t requests_per_event = 3;
+
+    encrypted_read_requests()
+    {
+        this->respond_to( 37, valid_connection_request_pdu );
+        test::key_vault = std::make_pair( true, test::example_key );
+        test::secret_value = 0x1234;
+
+        this->ll_control_pdu({
+            0x03,                                   // LL_ENC_REQ
+            0x00, 0x00, 0x00, 0x00,                 // Rand
+            0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00,                             // EDIV
+            0x00, 0x10, 0x20, 0x30,                 // SKDm
+            0x40, 0x50, 0x60, 0x70,
+            0xab, 0xbc, 0x12, 0x34,                 // IVm
+        });
+        this->ll_empty_pdu();
+        this->ll_control_pdu({
+            0x06                                    // LL_START_ENC_RSP
+        });
+        this->ll_empty_pdu();
+
+        const test::pdu_t read_request({
+            0x02, 0x07,
+            0x03, 0x00, 0x04, 0x00,                 // L2CAP
+            0x0A, 0x03, 0x00                        // Read Request, handle 3
+        });
+
+        for ( std::size_t event = 0; event != events; ++event )
+            this->add_connection_event_respond( test::connection_event_response( test::pdu_list_t( requests_per_event, read_request ) ) );
+
+        this->ll_empty_pdus( 2 );
+        this->run();
+    }
+
+    // ATT PDUs sent to the central, starting with the L2CAP header
+    test::pdu_list_t att_responses() const
+    {
+        test::pdu_list_t result;
+
+        for ( const auto& event : this->connection_events() )
+        {
+            for ( const auto& pdu : event.transmitted_data )
+            {
+                if ( ( pdu.data[ 0 ] & 0x03 ) == 0x02 )
+                    result.push_back( test::pdu_t( std::vector< std::uint8_t >( pdu.begin() + 2, pdu.end() ), pdu.encrypted ) );
+            }
+        }
+
+        return result;
+    }
+
+    std::vector< std::size_t > att_responses_per_event() const
+    {
+        std::vector< std::size_t > result;
+
+        for ( const auto& event : this->connection_events() )
+        {
+            result.push_back( static_cast< std::size_t >( std::count_if( event.transmitted_data.begin(), event.transmitted_data.end(),
+                []( const test::pdu_t& pdu ) {
+                    return ( pdu.data[ 0 ] & 0x03 ) == 0x02;
+                } ) ) );
+        }
+
+        return result;
+    }
+};
+
+using software_encrypted_read_requests = encrypted_read_requests< test::radio_with_software_encryption >;
+
+BOOST_FIXTURE_TEST_CASE( software_encryption_passes_mic_checks, software_encrypted_read_requests )
+{
+    BOOST_CHECK( connection_events().at( 3 ).receive_encryption_at_start_of_event );
+    BOOST_CHECK( connection_events().at( 3 ).transmit_encryption_at_start_of_event );
+    BOOST_CHECK_EQUAL( mic_failures(), 0u );
+}
+
+BOOST_FIXTURE_TEST_CASE( all_requests_answered_over_software_encrypted_link, software_encrypted_read_requests )
+{
+    static const std::vector< std::uint8_t > expected_response = {
+        0x03, 0x00, 0x04, 0x00,                     // L2CAP
+        0x0B, 0x34, 0x12                            // Read Response
+    };
+
+    const test::pdu_list_t responses = att_responses();
+    BOOST_CHECK_EQUAL( responses.size(), events * requests_per_event );
+
+    for ( const auto& response : responses )
+    {
+        BOOST_CHECK( response.encrypted );
+        BOOST_CHECK_EQUAL_COLLECTIONS( response.begin(), response.end(), expected_response.begin(), expected_response.end() );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( software_encryption_does_not_reduce_throughput )
+{
+    const std::unique_ptr< software_encrypted_read_requests > software( new software_encrypted_read_requests );
+    const std::unique_ptr< encrypted_read_requests< test::radio_with_encryption > > simulated( new encrypted_read_requests< test::radio_with_encryption > );
+
+    const std::vector< std::size_t > software_throughput  = software->att_responses_per_event();
+    const std::vector< std::size_t > simulated_throughput = simulated->att_responses_per_event();
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( software_throughput.begin(), software_throughput.end(), simulated_throughput.begin(), simulated_throughput.end() );
+}
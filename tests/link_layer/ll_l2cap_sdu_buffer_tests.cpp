@@ -137,6 +137,126 @@ namespace {
             bluetoe::details::write_16bit( layout::body( buffer ).first, size );
         }
     };
+
+    class streaming_buffer_under_test : public bluetoe::link_layer::ll_l2cap_sdu_buffer< radio_mock_t, streaming_buffer_under_test, 100 >
+    {
+    public:
+        streaming_buffer_under_test()
+            : accept_streams( true )
+            , consume_last_fragment( true )
+            , last_fragment_received( false )
+            , reported_pdus( 0 )
+        {
+        }
+
+        void pdu_receive_data_callback( const bluetoe::link_layer::write_buffer )
+        {
+            ++reported_pdus;
+        }
+
+        bool l2cap_sdu_stream_start( const std::uint8_t* input, std::size_t size )
+        {
+            if ( !accept_streams )
+                return false;
+
+            streamed.assign( input, input + size );
+
+            return true;
+        }
+
+        bool l2cap_sdu_stream( const std::uint8_t* input, std::size_t size, bool last )
+        {
+            if ( last && !consume_last_fragment )
+                return false;
+
+            streamed.insert( streamed.end(), input, input + size );
+            last_fragment_received = last;
+
+            return true;
+        }
+
+        bool                        accept_streams;
+        bool                        consume_last_fragment;
+        bool                        last_fragment_received;
+        std::size_t                 reported_pdus;
+        std::vector< std::uint8_t > streamed;
+    };
+
+    /*
+     * radio, that is able to transmit PDUs directly out of the memory of the sdu buffer
+     */
+    class referencing_radio_mock_t : public radio_mock_t
+    {
+    public:
+        referencing_radio_mock_t()
+            : available_references_( 0 )
+        {
+        }
+
+        bool commit_transmit_reference( bluetoe::link_layer::read_buffer pdu, std::uint8_t llid )
+        {
+            if ( available_references_ == 0 )
+                return false;
+
+            --available_references_;
+            references_.push_back( reference_t{ pdu, llid } );
+
+            return true;
+        }
+
+        std::size_t pending_transmit_references() const
+        {
+            return references_.size();
+        }
+
+        /*
+         * Interface for the tests
+         */
+        void add_free_references( std::size_t num_references )
+        {
+            available_references_ += num_references;
+        }
+
+        // writes the header in place, like ll_data_pdu_buffer does, when the reference becomes the next PDU to be send
+        bluetoe::link_layer::read_buffer next_referenced_pdu() const
+        {
+            if ( references_.empty() )
+                return { nullptr, 0 };
+
+            const auto& ref = references_.front();
+            layout::header( ref.pdu, ref.llid | ( ( ref.pdu.size - layout::data_channel_pdu_memory_size( 0 ) ) << 8 ) );
+
+            return ref.pdu;
+        }
+
+        std::vector< std::uint8_t > acknowledge_referenced_pdu()
+        {
+            const auto pdu = next_referenced_pdu();
+            BOOST_REQUIRE( pdu.size );
+
+            references_.erase( references_.begin() );
+
+            return std::vector< std::uint8_t >( pdu.buffer, pdu.buffer + pdu.size );
+        }
+
+    private:
+        struct reference_t {
+            bluetoe::link_layer::read_buffer pdu;
+            std::uint8_t                     llid;
+        };
+
+        std::size_t                 available_references_;
+        std::vector< reference_t >  references_;
+    };
+
+    class referencing_buffer_under_test : public bluetoe::link_layer::ll_l2cap_sdu_buffer< referencing_radio_mock_t, referencing_radio_mock_t, 100 >
+    {
+    public:
+        void write_l2cap_size( bluetoe::link_layer::read_buffer buffer, std::size_t size )
+        {
+            bluetoe::details::write_16bit( layout::body( buffer ).first, size );
+        }
+    };
 }
 
 // All Tests are done with a layout that has an extra byte between header and body
@@ -362,6 +482,107 @@ BOOST_AUTO_TEST_SUITE( receive_buffer_for_mtu_size_larger_than_23_bytes )
     }
 BOOST_AUTO_TEST_SUITE_END()
 
+BOOST_AUTO_TEST_SUITE( stream_received_l2cap_sdus )
+
+    struct streaming_24byte_fragmented_sdu : streaming_buffer_under_test
+    {
+        streaming_24byte_fragmented_sdu()
+        {
+            add_received_pdu(
+                {
+                    0x02, 0x1D, 0xaa, 0x18, 0x00, 0x04, 0x00,       // Header: L2CAP length 24
+                    0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, // 23 bytes of data
+                    0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18,
+                    0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27
+                }
+            );
+
+            add_received_pdu(
+                {
+                    0x01, 0x01, 0xaa, 0x28                          // remaining byte
+                }
+            );
+        }
+
+        void check_streamed_sdu()
+        {
+            static const std::uint8_t expected[] = {
+                0x18, 0x00, 0x04, 0x00,
+                0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+                0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18,
+                0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28
+            };
+
+            BOOST_CHECK_EQUAL_COLLECTIONS( streamed.begin(), streamed.end(), std::begin( expected ), std::end( expected ) );
+            BOOST_TEST( last_fragment_received );
+        }
+    };
+
+    BOOST_FIXTURE_TEST_CASE( fragments_are_streamed_without_defragmentation, streaming_24byte_fragmented_sdu )
+    {
+        const auto received = next_ll_l2cap_received();
+
+        BOOST_TEST( received.size == 0u );
+        BOOST_TEST( receive_buffer_empty() );
+        check_streamed_sdu();
+    }
+
+    BOOST_FIXTURE_TEST_CASE( refused_streams_are_defragmented, streaming_24byte_fragmented_sdu )
+    {
+        accept_streams = false;
+
+        const auto received = next_ll_l2cap_received();
+
+        BOOST_TEST( received.size == 31u );
+        BOOST_TEST( streamed.empty() );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( last_fragment_is_kept_until_consumed, streaming_24byte_fragmented_sdu )
+    {
+        consume_last_fragment = false;
+
+        BOOST_TEST( next_ll_l2cap_received().size == 0u );
+        BOOST_TEST( !receive_buffer_empty() );
+        BOOST_TEST( !last_fragment_received );
+
+        consume_last_fragment = true;
+
+        BOOST_TEST( next_ll_l2cap_received().size == 0u );
+        BOOST_TEST( receive_buffer_empty() );
+        check_streamed_sdu();
+    }
+
+    BOOST_FIXTURE_TEST_CASE( kept_fragment_is_reported_once, streaming_24byte_fragmented_sdu )
+    {
+        consume_last_fragment = false;
+        next_ll_l2cap_received();
+        next_ll_l2cap_received();
+
+        consume_last_fragment = true;
+        next_ll_l2cap_received();
+
+        BOOST_TEST( reported_pdus == 2u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( unfragmented_sdus_are_not_streamed, streaming_buffer_under_test )
+    {
+        add_received_pdu( { 0x02, 0x08, 0xaa, 0x04, 0x00, 0xff, 0xff, 0x03, 0x01, 0x02, 0x03 } );
+
+        BOOST_TEST( next_ll_l2cap_received().size == 11u );
+        BOOST_TEST( streamed.empty() );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( new_sdu_ends_incomplete_stream, streaming_buffer_under_test )
+    {
+        add_received_pdu( { 0x02, 0x06, 0xaa, 0x18, 0x00, 0x04, 0x00, 0x01, 0x02 } );
+        add_received_pdu( { 0x02, 0x08, 0xaa, 0x04, 0x00, 0xff, 0xff, 0x03, 0x01, 0x02, 0x03 } );
+
+        BOOST_TEST( next_ll_l2cap_received().size == 11u );
+        BOOST_TEST( !last_fragment_received );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
 // All Tests are done with a layout that has an extra byte between header and body
 BOOST_AUTO_TEST_SUITE( transmit_l2cap_sdus )
 
@@ -443,6 +664,23 @@ BOOST_AUTO_TEST_SUITE( transmit_l2cap_sdus )
         BOOST_CHECK_EQUAL( allocate_l2cap_transmit_buffer( 23 ).size, 30u );
     }
 
+    BOOST_FIXTURE_TEST_CASE( transmit_is_pending_until_all_fragments_are_committed, buffer_under_test )
+    {
+        BOOST_CHECK( !l2cap_transmit_pending() );
+
+        add_free_ll_pdus(3);
+        const auto buffer = allocate_l2cap_transmit_buffer( 100 );
+        write_l2cap_size( buffer, 100 );
+        commit_l2cap_transmit_buffer( buffer );
+
+        BOOST_CHECK( l2cap_transmit_pending() );
+
+        add_free_ll_pdus(1);
+        allocate_ll_transmit_buffer( 27 );
+
+        BOOST_CHECK( !l2cap_transmit_pending() );
+    }
+
     BOOST_FIXTURE_TEST_CASE( unfragmented_sdu, buffer_under_test )
     {
         add_free_ll_pdus(1);
@@ -567,3 +805,151 @@ BOOST_AUTO_TEST_SUITE( transmit_ll_pdus )
     }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( transmit_l2cap_sdus_by_reference )
+
+    struct fragmented_sdu_by_reference : referencing_buffer_under_test
+    {
+        fragmented_sdu_by_reference()
+        {
+            sdu = allocate_l2cap_transmit_buffer( 100 );
+            BOOST_REQUIRE( sdu.size == 107 );
+
+            fill_buffer( sdu, {
+                0x00, 0x00, 0x00,
+                0x48, 0x00, 0x04, 0x00,
+                0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+                0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27,
+                0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37,
+                0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47,
+                0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57,
+                0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67,
+                0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77,
+                0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87
+            } );
+        }
+
+        bluetoe::link_layer::read_buffer sdu;
+    };
+
+    BOOST_FIXTURE_TEST_CASE( fragments_are_not_copied, fragmented_sdu_by_reference )
+    {
+        add_free_references( 3 );
+        commit_l2cap_transmit_buffer( sdu );
+
+        BOOST_CHECK_EQUAL( pending_transmit_references(), 3u );
+        BOOST_TEST( next_transmitted_pdu() == std::vector< std::uint8_t >() );
+
+        const auto first = next_referenced_pdu();
+        BOOST_CHECK( first.buffer == sdu.buffer );
+        BOOST_CHECK_EQUAL( first.size, 30u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( fragmented_sdu, fragmented_sdu_by_reference )
+    {
+        add_free_references( 2 );
+        commit_l2cap_transmit_buffer( sdu );
+
+        BOOST_TEST( acknowledge_referenced_pdu() == std::vector< std::uint8_t >({
+            0x02, 0x1B, 0x00,
+            0x48, 0x00, 0x04, 0x00,
+            0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+            0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+            0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26
+        }), per_element() );
+
+        BOOST_TEST( acknowledge_referenced_pdu() == std::vector< std::uint8_t >({
+            0x01, 0x1B, 0x26,
+                                                      0x27,
+            0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37,
+            0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47,
+            0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57,
+            0x60, 0x61
+        }), per_element() );
+
+        // no room for a third reference
+        BOOST_CHECK_EQUAL( pending_transmit_references(), 0u );
+
+        add_free_references( 1 );
+        next_ll_l2cap_received();
+
+        BOOST_TEST( acknowledge_referenced_pdu() == std::vector< std::uint8_t >({
+            0x01, 0x16, 0x61,
+                        0x62, 0x63, 0x64, 0x65, 0x66, 0x67,
+            0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77,
+            0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87
+        }), per_element() );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( next_sdu_can_be_allocated_while_the_fragments_are_pending, fragmented_sdu_by_reference )
+    {
+        add_free_references( 3 );
+        commit_l2cap_transmit_buffer( sdu );
+
+        BOOST_CHECK_EQUAL( pending_transmit_references(), 3u );
+
+        const auto next = allocate_l2cap_transmit_buffer( 100 );
+        BOOST_CHECK_EQUAL( next.size, 107u );
+        BOOST_CHECK( next.buffer != sdu.buffer );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( sdu_buffer_is_released_after_the_last_fragment_was_acknowledged, fragmented_sdu_by_reference )
+    {
+        add_free_references( 6 );
+        commit_l2cap_transmit_buffer( sdu );
+
+        const auto second = allocate_l2cap_transmit_buffer( 100 );
+        BOOST_REQUIRE_EQUAL( second.size, 107u );
+        write_l2cap_size( second, 72 );
+        commit_l2cap_transmit_buffer( second );
+
+        BOOST_CHECK_EQUAL( pending_transmit_references(), 6u );
+
+        // both buffers are referenced, until the fragments of the first SDU are acknowledged
+        for ( int fragment = 0; fragment != 3; ++fragment )
+        {
+            BOOST_CHECK_EQUAL( allocate_l2cap_transmit_buffer( 23 ).size, 0u );
+            acknowledge_referenced_pdu();
+        }
+
+        const auto third = allocate_l2cap_transmit_buffer( 23 );
+        BOOST_CHECK_EQUAL( third.size, 30u );
+        BOOST_CHECK( third.buffer == sdu.buffer );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( small_sdus_are_copied, referencing_buffer_under_test )
+    {
+        add_free_ll_pdus( 2 );
+        add_free_references( 2 );
+
+        for ( std::uint8_t value = 0; value != 2; ++value )
+        {
+            // no acknowledgment between the two SDUs
+            const auto buffer = allocate_l2cap_transmit_buffer( 2 );
+            BOOST_REQUIRE_EQUAL( buffer.size, 9u );
+
+            fill_buffer( buffer, { 0x00, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00, 0x0A, value } );
+            commit_l2cap_transmit_buffer( buffer );
+        }
+
+        BOOST_CHECK_EQUAL( pending_transmit_references(), 0u );
+        BOOST_TEST( next_transmitted_pdu() == std::vector< std::uint8_t >({ 0x02, 0x06, 0x00, 0x02, 0x00, 0x04, 0x00, 0x0A, 0x00 }), per_element() );
+        BOOST_TEST( next_transmitted_pdu() == std::vector< std::uint8_t >({ 0x02, 0x06, 0x00, 0x02, 0x00, 0x04, 0x00, 0x0A, 0x01 }), per_element() );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( ll_pdus_are_still_copied, referencing_buffer_under_test )
+    {
+        add_free_ll_pdus( 1 );
+
+        const auto buffer = allocate_ll_transmit_buffer( 1 );
+        BOOST_REQUIRE_EQUAL( buffer.size, 4u );
+
+        fill_buffer( buffer, { 0x03, 0x01, 0x00, 0x02 } );
+        commit_ll_transmit_buffer( buffer );
+
+        BOOST_TEST( next_transmitted_pdu() == std::vector< std::uint8_t >({ 0x03, 0x01, 0x00, 0x02 }), per_element() );
+        BOOST_CHECK_EQUAL( pending_transmit_references(), 0u );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -82,3 +82,91 @@ BOOST_FIXTURE_TEST_CASE( no_request_when_confirmation_received, link_layer )
 
 }
 
+
+BOOST_AUTO_TEST_SUITE( rate_limited_notifications )
+
+    std::uint8_t sensor_value = 0;
+
+    using rate_limited_server = bluetoe::server<
+        bluetoe::service<
+            bluetoe::service_uuid16< 0x8C8B >,
+            bluetoe::characteristic<
+                bluetoe::characteristic_uuid16< 0x8C01 >,
+                bluetoe::bind_characteristic_value< decltype( sensor_value ), &sensor_value >,
+                bluetoe::no_write_access,
+                bluetoe::notify,
+                bluetoe::notification_rate_limit< 100 >
+            >
+        >,
+        bluetoe::no_gap_service_for_gatt_servers
+    >;
+
+    struct enable_notifications_t {
+        template < typename ConnectionData >
+        void ll_connection_established(
+              const bluetoe::link_layer::connection_details&   ,
+              const bluetoe::link_layer::connection_addresses& ,
+                    ConnectionData&                            connection )
+        {
+            connection.client_configurations().flags( 0, bluetoe::details::client_characteristic_configuration_notification_enabled );
+        }
+
+    } enable_notifications;
+
+    // notifies at every connection event with an interval of 30ms
+    struct bursty_producer : unconnected_base_t<
+        rate_limited_server,
+        test::radio,
+        bluetoe::link_layer::connection_callbacks< enable_notifications_t, enable_notifications >
+    >
+    {
+        static constexpr unsigned events = 20;
+
+        bursty_producer()
+        {
+            respond_to( 37, valid_connection_request_pdu );
+
+            for ( unsigned event = 1; event != events; ++event )
+            {
+                ll_function_call( [this]{
+                    ++sensor_value;
+                    notify( sensor_value );
+                } );
+            }
+
+            run( events + 2 );
+        }
+
+        std::vector< std::size_t > events_with_notifications()
+        {
+            using test::X;
+            using test::and_so_on;
+
+            std::vector< std::size_t > result;
+
+            for ( std::size_t event = 0; event != connection_events().size(); ++event )
+            {
+                for ( const auto& pdu: connection_events()[ event ].transmitted_data )
+                {
+                    if ( check_pdu( pdu, { X, X, X, 0x00, 0x04, 0x00, 0x1b, and_so_on } ) )
+                        result.push_back( event );
+                }
+            }
+
+            return result;
+        }
+    };
+
+    BOOST_FIXTURE_TEST_CASE( notifications_keep_minimum_interval, bursty_producer )
+    {
+        const auto notifications = events_with_notifications();
+
+        BOOST_TEST_MESSAGE( notifications.size() << " notification(s) in " << connection_events().size() << " connection events" );
+        BOOST_REQUIRE_GE( notifications.size(), 3u );
+
+        // 100ms at a connection interval of 30ms
+        for ( std::size_t i = 1; i < notifications.size(); ++i )
+            BOOST_TEST( notifications[ i ] - notifications[ i - 1 ] >= 4u );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -196,3 +196,114 @@ BOOST_FIXTURE_TEST_CASE( change_peripheral_configuration_at_runtime, fixture_wit
     BOOST_TEST( connection_events()[ 4 ].channel == 70u % 37u);
     BOOST_TEST( connection_events()[ 5 ].channel == 75u % 37u);
 }
+
+std::uint8_t telemetry_value = 0;
+std::uint8_t alarm_value     = 0;
+
+using server_with_delivery_latency_t = bluetoe::server<
+    bluetoe::service<
+        bluetoe::service_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CA9 >,
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CAA >,
+            bluetoe::bind_characteristic_value< decltype( telemetry_value ), &telemetry_value >,
+            bluetoe::no_write_access,
+            bluetoe::notify,
+            bluetoe::maximum_delivery_latency< 100 >
+        >,
+        bluetoe::characteristic<
+            bluetoe::characteristic_uuid< 0x8C8B4094, 0x0DE2, 0x499F, 0xA28A, 0x4EED5BC73CAB >,
+            bluetoe::bind_characteristic_value< decltype( alarm_value ), &alarm_value >,
+            bluetoe::no_write_access,
+            bluetoe::notify
+        >
+    >,
+    bluetoe::no_gap_service_for_gatt_servers
+>;
+
+struct fixture_with_delivery_latency
+    : unconnected_base_t<
+        server_with_delivery_latency_t,
+        test::radio,
+        bluetoe::link_layer::peripheral_latency_configuration<
+            bluetoe::link_layer::peripheral_latency::listen_if_pending_transmit_data,
+            bluetoe::link_layer::peripheral_latency::listen_if_unacknowledged_data
+        >
+    >
+{
+    fixture_with_delivery_latency()
+    {
+        respond_to( 37, five_hop_connection_request_pdu );
+
+        ll_data_pdu( {
+            0x05, 0x00,         // length
+            0x04, 0x00,         // Channel
+            0x12,               // ATT_WRITE_REQ PDU
+            0x04, 0x00,         // CCCD handle of telemetry
+            0x01, 0x00          // Enable notifications
+        } );
+        ll_data_pdu( {
+            0x05, 0x00,         // length
+            0x04, 0x00,         // Channel
+            0x12,               // ATT_WRITE_REQ PDU
+            0x07, 0x00,         // CCCD handle of alarm
+            0x01, 0x00          // Enable notifications
+        } );
+        ll_empty_pdu();
+    }
+
+    bool notification_send( const test::connection_event& event, std::uint8_t handle )
+    {
+        using test::X;
+        using test::and_so_on;
+
+        for ( const auto& pdu: event.transmitted_data )
+        {
+            if ( check_pdu( pdu, { X, X, X, X, 0x04, 0x00, 0x1b, handle, 0x00, and_so_on } ) )
+                return true;
+        }
+
+        return false;
+    }
+};
+
+BOOST_FIXTURE_TEST_CASE( notification_with_maximum_delivery_latency_does_not_cancel_connection_event, fixture_with_delivery_latency )
+{
+    ll_function_call( [&](){
+        notify( telemetry_value );
+    } );
+
+    run();
+
+    BOOST_TEST( !event_cancelation_requested() );
+}
+
+BOOST_FIXTURE_TEST_CASE( notification_without_maximum_delivery_latency_cancels_connection_event, fixture_with_delivery_latency )
+{
+    ll_function_call( [&](){
+        notify( alarm_value );
+    } );
+
+    run();
+
+    BOOST_TEST( event_cancelation_requested() );
+}
+
+BOOST_FIXTURE_TEST_CASE( notification_send_within_maximum_delivery_latency, fixture_with_delivery_latency )
+{
+    ll_function_call( [&](){
+        notify( telemetry_value );
+    } );
+    ll_empty_pdus( 3 );
+
+    run();
+
+    BOOST_REQUIRE( connection_events().size() >= 5u );
+
+    // the write requests and the responses are handled at event 0, 1, 2 and 3
+    BOOST_TEST( connection_events()[ 3 ].channel == 20u );
+
+    // the notification is queued at event 3; without deadline, the next event would be event 7
+    // due to peripheral latency, but the deadline is at event 2 + 100ms / 30ms == 5
+    BOOST_TEST( connection_events()[ 4 ].channel == 30u );
+    BOOST_TEST( notification_send( connection_events()[ 4 ], 0x03 ) );
+}
@@ -1093,3 +1093,142 @@ BOOST_FIXTURE_TEST_SUITE( switch_behaviour_at_runtime, runtime_configurable )
     }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+struct delivery_deadlines : bluetoe::link_layer::details::peripheral_latency_state<
+    bluetoe::link_layer::peripheral_latency_configuration<>
+>
+{
+    delivery_deadlines()
+    {
+        reset_connection_state();
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE( maximum_delivery_latency, delivery_deadlines )
+
+    static const int latency = 10;
+
+    BOOST_AUTO_TEST_CASE( latency_limited_by_deadline )
+    {
+        // 100ms with 30ms interval: sent not later than the 3rd event
+        BOOST_TEST( queue_delivery_deadline( 100 ) == false );
+
+        plan_next_connection_event(
+            latency, no_events, typical_connection_interval, no_pending_instance );
+
+        BOOST_TEST( current_channel_index() == 3u );
+        BOOST_TEST( connection_event_counter() == 3u );
+        BOOST_TEST( time_since_last_event() == 3 * typical_connection_interval );
+    }
+
+    BOOST_AUTO_TEST_CASE( latency_not_limited_by_far_deadline )
+    {
+        BOOST_TEST( queue_delivery_deadline( 1000 ) == false );
+
+        plan_next_connection_event(
+            latency, no_events, typical_connection_interval, no_pending_instance );
+
+        BOOST_TEST( connection_event_counter() == 11u );
+    }
+
+    BOOST_AUTO_TEST_CASE( earliest_deadline_is_used )
+    {
+        queue_delivery_deadline( 300 );
+        queue_delivery_deadline( 100 );
+        queue_delivery_deadline( 200 );
+
+        plan_next_connection_event(
+            latency, no_events, typical_connection_interval, no_pending_instance );
+
+        BOOST_TEST( connection_event_counter() == 3u );
+    }
+
+    BOOST_AUTO_TEST_CASE( deadline_counts_from_last_event )
+    {
+        plan_next_connection_event(
+            latency, no_events, typical_connection_interval, no_pending_instance );
+
+        BOOST_TEST( connection_event_counter() == 11u );
+
+        // the last event was event 0; data queued now, will be send at the event following the planned event 11
+        BOOST_TEST( queue_delivery_deadline( 330 ) == true );
+        BOOST_TEST( queue_delivery_deadline( 360 ) == false );
+    }
+
+    BOOST_AUTO_TEST_CASE( missed_deadline_limits_latency_to_next_event )
+    {
+        plan_next_connection_event(
+            latency, no_events, typical_connection_interval, no_pending_instance );
+
+        queue_delivery_deadline( 100 );
+
+        plan_next_connection_event(
+            latency, no_events, typical_connection_interval, no_pending_instance );
+
+        BOOST_TEST( connection_event_counter() == 12u );
+        BOOST_TEST( time_since_last_event() == 1 * typical_connection_interval );
+    }
+
+    BOOST_AUTO_TEST_CASE( deadline_removed_after_data_was_sent )
+    {
+        queue_delivery_deadline( 100 );
+
+        plan_next_connection_event(
+            latency, no_events, typical_connection_interval, no_pending_instance );
+        delivery_deadlines_flushed();
+
+        BOOST_TEST( connection_event_counter() == 3u );
+
+        plan_next_connection_event(
+            latency, no_events, typical_connection_interval, no_pending_instance );
+
+        BOOST_TEST( connection_event_counter() == 14u );
+    }
+
+    BOOST_AUTO_TEST_CASE( deadline_kept_while_data_is_pending )
+    {
+        queue_delivery_deadline( 100 );
+
+        plan_next_connection_event(
+            latency, no_events, typical_connection_interval, no_pending_instance );
+        delivery_deadlines_flushed();
+
+        plan_next_connection_event(
+            latency, pending_outgoing_data_events, typical_connection_interval, no_pending_instance );
+
+        BOOST_TEST( connection_event_counter() == 4u );
+
+        plan_next_connection_event(
+            latency, no_events, typical_connection_interval, no_pending_instance );
+
+        BOOST_TEST( connection_event_counter() == 15u );
+    }
+
+    BOOST_AUTO_TEST_CASE( deadline_kept_until_flushed )
+    {
+        queue_delivery_deadline( 100 );
+
+        plan_next_connection_event(
+            latency, no_events, typical_connection_interval, no_pending_instance );
+
+        BOOST_TEST( connection_event_counter() == 3u );
+
+        // not flushed, for example because there was no room in the transmit buffer
+        plan_next_connection_event(
+            latency, no_events, typical_connection_interval, no_pending_instance );
+
+        BOOST_TEST( connection_event_counter() == 4u );
+    }
+
+    BOOST_AUTO_TEST_CASE( deadline_removed_by_new_connection )
+    {
+        queue_delivery_deadline( 100 );
+        reset_connection_state();
+
+        plan_next_connection_event(
+            latency, no_events, typical_connection_interval, no_pending_instance );
+
+        BOOST_TEST( connection_event_counter() == 11u );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
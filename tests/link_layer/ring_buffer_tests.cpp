@@ -3,6 +3,9 @@
 #define BOOST_TEST_MODULE
 #include <boost/test/included/unit_test.hpp>
 
+#include <deque>
+#include <random>
+
 struct small_ring : bluetoe::link_layer::pdu_ring_buffer< 50 >
 {
     small_ring() : bluetoe::link_layer::pdu_ring_buffer< 50 >( &buffer[ 0 ] )
@@ -205,3 +208,423 @@ BOOST_FIXTURE_TEST_CASE( nearly_max_alloc_from_empty_buffer, splitted_at_end )
     BOOST_CHECK_EQUAL( alloc_front( buffer, 50 ).size, 0u );
     BOOST_CHECK_EQUAL( alloc_front( buffer, 49 ).size, 49u );
 }
+
+BOOST_AUTO_TEST_SUITE( resizing )
+
+    /*
+     * ring of initial 50 bytes, 20 bytes above the start of memory
+     */
+    struct resizable_ring : bluetoe::link_layer::pdu_ring_buffer< 50 >
+    {
+        resizable_ring()
+            : bluetoe::link_layer::pdu_ring_buffer< 50 >( &memory[ 20 ] )
+            , buffer( &memory[ 20 ] )
+        {
+        }
+
+        void push( std::size_t size )
+        {
+            auto p = alloc_front( buffer, size );
+            BOOST_REQUIRE_EQUAL( p.size, size );
+
+            p.buffer[ 1 ] = static_cast< std::uint8_t >( size - 2 );
+            push_front( buffer, p );
+        }
+
+        std::uint8_t  memory[ 80 ];
+        std::uint8_t* buffer;
+    };
+
+    BOOST_FIXTURE_TEST_CASE( capacity_defaults_to_size, resizable_ring )
+    {
+        BOOST_CHECK_EQUAL( capacity(), 50u );
+        BOOST_CHECK( !split() );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( grown_ring_allows_larger_allocations, resizable_ring )
+    {
+        resize( buffer, buffer, 60 );
+
+        BOOST_CHECK_EQUAL( capacity(), 60u );
+        BOOST_CHECK_EQUAL( alloc_front( buffer, 60 ).size, 60u );
+        BOOST_CHECK_EQUAL( alloc_front( buffer, 61 ).size, 0u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( shrunk_ring_limits_allocations, resizable_ring )
+    {
+        push( 10 );
+        pop_end( buffer );
+
+        resize( buffer, buffer, 20 );
+
+        BOOST_CHECK_EQUAL( alloc_front( buffer, 20 ).buffer, buffer );
+        BOOST_CHECK_EQUAL( alloc_front( buffer, 21 ).size, 0u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( min_capacity_of_an_unsplit_ring, resizable_ring )
+    {
+        push( 10 );
+        push( 10 );
+
+        BOOST_CHECK( !split() );
+        BOOST_CHECK_EQUAL( min_capacity( buffer, 15 ), 35u );
+        BOOST_CHECK_EQUAL( min_capacity( buffer, 40 ), 50u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( min_capacity_of_a_split_ring, resizable_ring )
+    {
+        push( 30 );
+        push( 15 );
+        pop_end( buffer );
+        push( 10 );
+
+        BOOST_CHECK( split() );
+        BOOST_CHECK_EQUAL( min_capacity( buffer, 15 ), 50u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( growing_split_ring_keeps_the_order, resizable_ring )
+    {
+        // 1 byte left at the end, no room for a wrap mark
+        push( 24 );
+        push( 25 );
+        pop_end( buffer );
+        push( 20 );
+
+        BOOST_REQUIRE( split() );
+        resize( buffer, buffer, 60 );
+
+        BOOST_CHECK_EQUAL( next_end().buffer, &buffer[ 24 ] );
+        pop_end( buffer );
+        BOOST_CHECK_EQUAL( next_end().buffer, &buffer[ 0 ] );
+        BOOST_CHECK_EQUAL( next_end().size, 20u );
+        pop_end( buffer );
+        BOOST_CHECK_EQUAL( next_end().size, 0u );
+
+        // now the grown part of the ring is usable
+        push( 39 );
+        BOOST_CHECK_EQUAL( next_end().buffer, &buffer[ 20 ] );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( growing_split_ring_by_one_byte, resizable_ring )
+    {
+        push( 24 );
+        push( 25 );
+        pop_end( buffer );
+        push( 20 );
+
+        resize( buffer, buffer, 51 );
+
+        pop_end( buffer );
+        BOOST_CHECK_EQUAL( next_end().buffer, &buffer[ 0 ] );
+        BOOST_CHECK_EQUAL( next_end().size, 20u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( moving_the_start_of_an_unsplit_ring, resizable_ring )
+    {
+        push( 10 );
+        push( 10 );
+
+        resize( buffer, &memory[ 0 ], 70 );
+        buffer = &memory[ 0 ];
+
+        // fill up to the end of the ring
+        push( 30 );
+        BOOST_CHECK_EQUAL( alloc_front( buffer, 15 ).buffer, &memory[ 0 ] );
+        push( 15 );
+
+        BOOST_CHECK_EQUAL( next_end().buffer, &memory[ 20 ] );
+        pop_end( buffer );
+        BOOST_CHECK_EQUAL( next_end().buffer, &memory[ 30 ] );
+        pop_end( buffer );
+        BOOST_CHECK_EQUAL( next_end().buffer, &memory[ 40 ] );
+        pop_end( buffer );
+        BOOST_CHECK_EQUAL( next_end().buffer, &memory[ 0 ] );
+        BOOST_CHECK_EQUAL( next_end().size, 15u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( moving_the_start_of_an_empty_ring, resizable_ring )
+    {
+        push( 10 );
+        pop_end( buffer );
+
+        resize( buffer, &memory[ 0 ], 70 );
+        buffer = &memory[ 0 ];
+
+        BOOST_CHECK_EQUAL( alloc_front( buffer, 70 ).buffer, &memory[ 0 ] );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( free_slots )
+
+    struct counting_ring : small_ring
+    {
+        bool push( std::size_t size )
+        {
+            auto p = alloc_front( buffer, size );
+
+            if ( p.size != size )
+                return false;
+
+            p.buffer[ 1 ] = static_cast< std::uint8_t >( size - 2 );
+            push_front( buffer, p );
+
+            return true;
+        }
+    };
+
+    BOOST_FIXTURE_TEST_CASE( empty_ring, counting_ring )
+    {
+        BOOST_CHECK_EQUAL( free_slots( buffer, 10 ), 5u );
+        BOOST_CHECK_EQUAL( free_slots( buffer, 17 ), 2u );
+        BOOST_CHECK_EQUAL( free_slots( buffer, 50 ), 1u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( full_ring, counting_ring )
+    {
+        push( 25 );
+        push( 25 );
+
+        BOOST_CHECK_EQUAL( free_slots( buffer, 2 ), 0u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( split_ring_leaves_one_byte, counting_ring )
+    {
+        push( 20 );
+        push( 20 );
+        pop_end( buffer );
+        push( 15 );
+
+        BOOST_REQUIRE( split() );
+
+        // 5 bytes between front and end; one has to stay free
+        BOOST_CHECK_EQUAL( free_slots( buffer, 2 ), 2u );
+        BOOST_CHECK_EQUAL( free_slots( buffer, 4 ), 1u );
+        BOOST_CHECK_EQUAL( free_slots( buffer, 5 ), 0u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( unsplit_ring_counts_both_ends, counting_ring )
+    {
+        push( 20 );
+        push( 20 );
+        pop_end( buffer );
+
+        // 10 bytes at the end, 20 at the beginning, of which one has to stay free
+        BOOST_CHECK_EQUAL( free_slots( buffer, 5 ), 2u + 3u );
+        BOOST_CHECK_EQUAL( free_slots( buffer, 10 ), 1u + 1u );
+        BOOST_CHECK_EQUAL( free_slots( buffer, 19 ), 1u );
+        BOOST_CHECK_EQUAL( free_slots( buffer, 20 ), 0u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( free_slots_can_be_allocated, counting_ring )
+    {
+        std::mt19937 random( 42 );
+        std::uniform_int_distribution< std::size_t > sizes( 2, 30 );
+        std::uniform_int_distribution< int > pops( 0, 3 );
+
+        for ( int round = 0; round != 2000; ++round )
+        {
+            for ( int p = pops( random ); p && next_end().size; --p )
+                pop_end( buffer );
+
+            const std::size_t size  = sizes( random );
+            const std::size_t slots = free_slots( buffer, size );
+
+            for ( std::size_t slot = 0; slot != slots; ++slot )
+                BOOST_REQUIRE( push( size ) );
+
+            BOOST_REQUIRE( !push( size ) );
+        }
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/*
+ * A layout, where the header is stored inverted, so that the length of a wrap mark is not
+ * stored as a 0 octet
+ */
+struct inverted_header_layout : bluetoe::link_layer::details::layout_base< inverted_header_layout >
+{
+    using bluetoe::link_layer::details::layout_base< inverted_header_layout >::header;
+
+    static std::uint16_t header( const std::uint8_t* pdu )
+    {
+        return static_cast< std::uint16_t >( ( pdu[ 0 ] | ( pdu[ 1 ] << 8 ) ) ^ 0xffff );
+    }
+
+    static void header( std::uint8_t* pdu, std::uint16_t header_value )
+    {
+        pdu[ 0 ] = static_cast< std::uint8_t >( ~header_value & 0xff );
+        pdu[ 1 ] = static_cast< std::uint8_t >( ~header_value >> 8 );
+    }
+
+    static constexpr std::size_t data_channel_pdu_memory_size( std::size_t payload_size )
+    {
+        return 2 + payload_size;
+    }
+};
+
+struct inverted_header_ring : bluetoe::link_layer::pdu_ring_buffer< 50, bluetoe::link_layer::read_buffer, inverted_header_layout >
+{
+    inverted_header_ring()
+        : bluetoe::link_layer::pdu_ring_buffer< 50, bluetoe::link_layer::read_buffer, inverted_header_layout >( &buffer[ 0 ] )
+    {
+    }
+
+    void push( std::size_t size )
+    {
+        auto p = alloc_front( buffer, size );
+        BOOST_REQUIRE_EQUAL( p.size, size );
+
+        inverted_header_layout::header( p.buffer, static_cast< std::uint16_t >( ( size - 2 ) << 8 ) );
+        push_front( buffer, p );
+    }
+
+    std::uint8_t buffer[ size ];
+};
+
+BOOST_FIXTURE_TEST_CASE( wrap_mark_is_found_through_the_layout, inverted_header_ring )
+{
+    push( 15 );
+    push( 25 );
+    pop_end( buffer );
+
+    // does not fit into the 10 bytes at the end of the ring
+    push( 12 );
+    BOOST_CHECK( more_than_one() );
+
+    pop_end( buffer );
+    BOOST_CHECK_EQUAL( next_end().buffer, &buffer[ 0 ] );
+    BOOST_CHECK_EQUAL( next_end().size, 12u );
+    BOOST_CHECK( !more_than_one() );
+}
+
+BOOST_AUTO_TEST_SUITE( single_producer_single_consumer )
+
+    struct small_spsc_ring : bluetoe::link_layer::spsc_pdu_ring_buffer< 50 >
+    {
+        small_spsc_ring() : bluetoe::link_layer::spsc_pdu_ring_buffer< 50 >( &buffer[ 0 ] )
+        {
+        }
+
+        void push( std::size_t size )
+        {
+            auto p = alloc_front( buffer, size );
+            BOOST_REQUIRE_EQUAL( p.size, size );
+
+            p.buffer[ 1 ] = static_cast< std::uint8_t >( size - 2 );
+            push_front( buffer, p );
+        }
+
+        std::uint8_t buffer[ size ];
+    };
+
+    BOOST_FIXTURE_TEST_CASE( newly_constructed_is_empty, small_spsc_ring )
+    {
+        BOOST_CHECK_EQUAL( next_end().size, 0u );
+        BOOST_CHECK( !more_than_one() );
+        BOOST_CHECK_EQUAL( alloc_front( buffer, 50 ).size, 50u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( fifo_order, small_spsc_ring )
+    {
+        push( 20 );
+        push( 10 );
+
+        BOOST_CHECK( more_than_one() );
+        BOOST_CHECK_EQUAL( next_end().size, 20u );
+        pop_end( buffer );
+
+        BOOST_CHECK( !more_than_one() );
+        BOOST_CHECK_EQUAL( next_end().size, 10u );
+        BOOST_CHECK_EQUAL( next_end().buffer, &buffer[ 20 ] );
+        pop_end( buffer );
+
+        BOOST_CHECK_EQUAL( next_end().size, 0u );
+    }
+
+    /*
+     * When the producer wraps, while the ring is empty, the consumer has to follow the wrap mark
+     */
+    BOOST_FIXTURE_TEST_CASE( consumer_follows_wrap_from_empty_ring, small_spsc_ring )
+    {
+        push( 20 );
+        push( 16 );
+        pop_end( buffer );
+        pop_end( buffer );
+
+        push( 35 );
+
+        BOOST_CHECK_EQUAL( next_end().buffer, &buffer[ 0 ] );
+        BOOST_CHECK_EQUAL( next_end().size, 35u );
+        BOOST_CHECK( !more_than_one() );
+
+        pop_end( buffer );
+        BOOST_CHECK_EQUAL( next_end().size, 0u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( consumer_wraps_at_the_end_of_the_buffer, small_spsc_ring )
+    {
+        push( 20 );
+        push( 29 );
+        pop_end( buffer );
+
+        // one byte left at the end, no room for a wrap mark
+        push( 15 );
+        pop_end( buffer );
+
+        BOOST_CHECK_EQUAL( next_end().buffer, &buffer[ 0 ] );
+        BOOST_CHECK_EQUAL( next_end().size, 15u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( random_operations_keep_fifo_order, small_spsc_ring )
+    {
+        std::mt19937 random( 42 );
+        std::uniform_int_distribution< std::size_t > size_dist( 3, 25 );
+        std::deque< std::pair< std::size_t, std::uint8_t > > model;
+
+        std::uint8_t counter = 0;
+
+        for ( int i = 0; i != 10000; ++i )
+        {
+            if ( random() % 2 )
+            {
+                const std::size_t size = size_dist( random );
+                auto p = alloc_front( buffer, size );
+
+                if ( p.size == 0 )
+                    continue;
+
+                BOOST_REQUIRE_EQUAL( p.size, size );
+                BOOST_REQUIRE( p.buffer >= &buffer[ 0 ] && p.buffer + size <= &buffer[ 50 ] );
+
+                p.buffer[ 1 ] = static_cast< std::uint8_t >( size - 2 );
+                std::fill( &p.buffer[ 2 ], &p.buffer[ size ], ++counter );
+                push_front( buffer, p );
+
+                model.push_back( { size, counter } );
+            }
+            else
+            {
+                const auto next = next_end();
+
+                if ( model.empty() )
+                {
+                    BOOST_REQUIRE_EQUAL( next.size, 0u );
+                    continue;
+                }
+
+                BOOST_REQUIRE_EQUAL( next.size, model.front().first );
+
+                for ( std::size_t b = 2; b != next.size; ++b )
+                    BOOST_REQUIRE_EQUAL( next.buffer[ b ], model.front().second );
+
+                BOOST_REQUIRE_EQUAL( more_than_one(), model.size() > 1 );
+
+                pop_end( buffer );
+                model.pop_front();
+            }
+        }
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,265 @@
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include <bluetoe/timer_wheel.hpp>
+
+#include "connected.hpp"
+
+#include <utility>
+#include <vector>
+
+struct timers_t {
+    void ll_timer_expired( std::size_t timer )
+    {
+        expirations.push_back( std::make_pair( timer, now ) );
+    }
+
+    std::vector< std::pair< std::size_t, unsigned > >   expirations;
+    unsigned                                            now;
+} timers;
+
+namespace {
+    using expirations_t = std::vector< std::pair< std::size_t, unsigned > >;
+
+    template < class T >
+    T take( const T& c, std::size_t n )
+    {
+        return T{ c.begin(), std::next(c.begin(), std::min( n, c.size() ) ) };
+    }
+
+    expirations_t only( std::size_t timer, const expirations_t& expirations )
+    {
+        expirations_t result;
+
+        for ( const auto& e : expirations )
+        {
+            if ( e.first == timer )
+                result.push_back( e );
+        }
+
+        return result;
+    }
+}
+
+BOOST_TEST_DONT_PRINT_LOG_VALUE( expirations_t::value_type )
+
+/*
+ * Tests of the wheel alone: every connection event ends at a multiple of the connection interval
+ */
+struct wheel_t : bluetoe::link_layer::timer_wheel< timers_t, timers, 8 >::impl< void >
+{
+    wheel_t()
+    {
+        timers = timers_t();
+        timers.now = 0;
+        timer_wheel_connection_event( 0, 10000 );
+    }
+
+    void events( unsigned count, std::uint32_t interval_us = 10000 )
+    {
+        for ( ; count; --count )
+        {
+            ++timers.now;
+            timer_wheel_connection_event( static_cast< std::uint16_t >( timers.now ), interval_us );
+        }
+    }
+};
+
+BOOST_AUTO_TEST_SUITE( timer_wheel )
+
+BOOST_FIXTURE_TEST_CASE( no_timer_started, wheel_t )
+{
+    events( 1000 );
+    BOOST_CHECK( timers.expirations.empty() );
+}
+
+BOOST_FIXTURE_TEST_CASE( timers_start_at_the_next_connection_event, wheel_t )
+{
+    events( 3 );
+    start_timer( 1, 50 );
+    events( 5 );
+    BOOST_CHECK( timers.expirations.empty() );
+
+    events( 10 );
+    BOOST_CHECK( ( timers.expirations == expirations_t{ { 1, 9 } } ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( one_shot_timer, wheel_t )
+{
+    start_timer( 0, 50 );
+    events( 100 );
+
+    BOOST_CHECK( ( timers.expirations == expirations_t{ { 0, 6 } } ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( delays_are_rounded_up_to_the_resolution, wheel_t )
+{
+    start_timer( 0, 41 );
+    start_timer( 1, 0 );
+    events( 10 );
+
+    BOOST_CHECK( ( timers.expirations == expirations_t{ { 1, 2 }, { 0, 6 } } ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( periodic_timer, wheel_t )
+{
+    start_timer( 3, 20, 30 );
+    events( 12 );
+
+    BOOST_CHECK( ( timers.expirations == expirations_t{ { 3, 3 }, { 3, 6 }, { 3, 9 }, { 3, 12 } } ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( stopping_a_timer, wheel_t )
+{
+    start_timer( 3, 20, 30 );
+    events( 7 );
+    stop_timer( 3 );
+    events( 100 );
+
+    BOOST_CHECK( ( timers.expirations == expirations_t{ { 3, 3 }, { 3, 6 } } ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( restarting_a_timer, wheel_t )
+{
+    start_timer( 2, 50 );
+    events( 4 );
+    start_timer( 2, 50 );
+    events( 100 );
+
+    BOOST_CHECK( ( timers.expirations == expirations_t{ { 2, 10 } } ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( timers_in_the_second_level, wheel_t )
+{
+    start_timer( 0, 170 );
+    start_timer( 1, 2550 );
+    start_timer( 2, 300, 160 );
+    events( 100 );
+
+    BOOST_CHECK( ( timers.expirations == expirations_t{ { 0, 18 }, { 2, 31 }, { 2, 47 }, { 2, 63 }, { 2, 79 }, { 2, 95 } } ) );
+
+    timers.expirations.clear();
+    events( 160 );
+
+    BOOST_CHECK( ( only( 1, timers.expirations ) == expirations_t{ { 1, 256 } } ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( timers_beyond_the_range_of_the_wheel, wheel_t )
+{
+    start_timer( 0, 5000 );
+    start_timer( 1, 60000 );
+    events( 7000 );
+
+    BOOST_CHECK( ( timers.expirations == expirations_t{ { 0, 501 }, { 1, 6001 } } ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( multiple_timers_in_the_same_slot, wheel_t )
+{
+    for ( std::size_t timer = 0; timer != 8; ++timer )
+        start_timer( timer, 40 );
+
+    events( 5 );
+
+    BOOST_REQUIRE_EQUAL( timers.expirations.size(), 8u );
+
+    for ( const auto& e : timers.expirations )
+        BOOST_CHECK_EQUAL( e.second, 5u );
+}
+
+BOOST_FIXTURE_TEST_CASE( time_is_taken_from_the_connection_interval, wheel_t )
+{
+    start_timer( 0, 20, 20 );
+
+    // 7.5ms interval: the timer expires at the first connection event after every second tick
+    events( 16, 7500 );
+
+    BOOST_CHECK( ( timers.expirations == expirations_t{ { 0, 3 }, { 0, 6 }, { 0, 8 }, { 0, 11 }, { 0, 14 }, { 0, 16 } } ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( skipped_connection_events_are_taken_into_account, wheel_t )
+{
+    start_timer( 0, 30, 30 );
+    events( 1 );
+
+    // peripheral latency of 9 events
+    timers.now = 11;
+    timer_wheel_connection_event( 11, 10000 );
+
+    BOOST_CHECK( ( timers.expirations == expirations_t{ { 0, 11 }, { 0, 11 }, { 0, 11 } } ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( no_time_elapses_between_connections, wheel_t )
+{
+    start_timer( 0, 50 );
+    events( 3 );
+
+    timer_wheel_new_connection();
+    timers.now = 1000;
+    timer_wheel_connection_event( 0, 10000 );
+    BOOST_CHECK( timers.expirations.empty() );
+
+    for ( std::uint16_t counter = 1; counter != 10; ++counter )
+    {
+        ++timers.now;
+        timer_wheel_connection_event( counter, 10000 );
+    }
+
+    BOOST_CHECK( ( timers.expirations == expirations_t{ { 0, 1003 } } ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/*
+ * Tests with a link layer: timers expire at the end of connection events
+ */
+struct link_layer_timers_t {
+    void ll_timer_expired( std::size_t timer );
+} link_layer_timers;
+
+struct link_layer_with_timers : unconnected_base_t<
+    test::small_temperature_service,
+    test::radio,
+    bluetoe::link_layer::timer_wheel< link_layer_timers_t, link_layer_timers, 2 >
+ >
+{
+    link_layer_with_timers()
+    {
+        timers = timers_t();
+        instance = this;
+    }
+
+    static link_layer_with_timers* instance;
+};
+
+link_layer_with_timers* link_layer_with_timers::instance = nullptr;
+
+void link_layer_timers_t::ll_timer_expired( std::size_t timer )
+{
+    // the radio has already recorded the next connection event
+    timers.now = link_layer_with_timers::instance->connection_events().size() - 2;
+    timers.ll_timer_expired( timer );
+}
+
+BOOST_FIXTURE_TEST_CASE( timers_do_not_expire_without_connection, link_layer_with_timers )
+{
+    start_timer( 0, 10, 10 );
+    run();
+
+    BOOST_CHECK( timers.expirations.empty() );
+}
+
+BOOST_FIXTURE_TEST_CASE( timers_expire_at_the_end_of_connection_events, link_layer_with_timers )
+{
+    // 30ms connection interval
+    start_timer( 0, 60, 60 );
+    start_timer( 1, 25 );
+
+    respond_to( 37, valid_connection_request_pdu );
+    ll_empty_pdus( 10 );
+
+    run();
+
+    static const expirations_t expected = { { 1, 1 }, { 0, 2 }, { 0, 4 }, { 0, 6 }, { 0, 8 } };
+
+    BOOST_CHECK( ( take( timers.expirations, expected.size() ) == expected ) );
+}
@@ -0,0 +1,126 @@
+#include <bluetoe/notification_queue.hpp>
+
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/*
+ * Multiple producers (modeling interrupt handlers of different priorities) are queueing notifications and
+ * indications, while a single consumer (modeling the link layer) is dequeuing them. To find data races,
+ * these tests are build with the ThreadSanitizer.
+ */
+namespace {
+#   if defined( BLUETOE_EXCLUDE_SLOW_TESTS )
+        constexpr unsigned number_of_iterations = 2000;
+#   else
+        constexpr unsigned number_of_iterations = 50000;
+#   endif
+
+    constexpr unsigned number_of_producers = 3;
+
+    struct empty_fixture {};
+
+    template < int ... Sizes >
+    using queue_t = bluetoe::notification_queue< std::tuple< std::integral_constant< int, Sizes >... >, empty_fixture >;
+
+    /*
+     * Every call to queue_notification() or queue_indication() that returned true, has to result in exactly
+     * one dequeued entry of that type and index. A lost update of the underlying bitmap would result in
+     * a mismatch.
+     */
+    template < class Queue, std::size_t Size >
+    void stress_queue()
+    {
+        using entry_type = bluetoe::details::notification_queue_entry_type;
+
+        Queue queue;
+
+        std::atomic< unsigned > queued_notifications[ Size ];
+        std::atomic< unsigned > queued_indications[ Size ];
+        unsigned dequeued_notifications[ Size ] = { 0 };
+        unsigned dequeued_indications[ Size ]   = { 0 };
+
+        for ( std::size_t i = 0; i != Size; ++i )
+        {
+            queued_notifications[ i ] = 0;
+            queued_indications[ i ]   = 0;
+        }
+
+        std::atomic< unsigned > running_producers( number_of_producers );
+        std::vector< std::thread > producers;
+
+        for ( unsigned producer = 0; producer != number_of_producers; ++producer )
+        {
+            producers.emplace_back( [ &, producer ]{
+                for ( unsigned iteration = 0; iteration != number_of_iterations; ++iteration )
+                {
+                    const std::size_t index = ( iteration * ( producer + 1 ) + producer ) % Size;
+
+                    if ( iteration % 4 == producer )
+                    {
+                        if ( queue.queue_indication( index ) )
+                            ++queued_indications[ index ];
+                    }
+                    else
+                    {
+                        if ( queue.queue_notification( index ) )
+                            ++queued_notifications[ index ];
+                    }
+                }
+
+                --running_producers;
+            } );
+        }
+
+        for ( bool done = false; !done; )
+        {
+            // read before dequeuing, so that a queue found empty after all producers finished is really empty
+            done = running_producers == 0;
+
+            for ( auto entry = queue.dequeue_indication_or_confirmation(); entry.first != entry_type::empty;
+                entry = queue.dequeue_indication_or_confirmation() )
+            {
+                done = false;
+
+                if ( entry.first == entry_type::notification )
+                {
+                    ++dequeued_notifications[ entry.second ];
+                }
+                else
+                {
+                    ++dequeued_indications[ entry.second ];
+                    queue.indication_confirmed();
+                }
+            }
+
+            std::this_thread::yield();
+        }
+
+        for ( auto& producer : producers )
+            producer.join();
+
+        for ( std::size_t i = 0; i != Size; ++i )
+        {
+            BOOST_CHECK_EQUAL( queued_notifications[ i ].load(), dequeued_notifications[ i ] );
+            BOOST_CHECK_EQUAL( queued_indications[ i ].load(), dequeued_indications[ i ] );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( single_characteristic )
+{
+    stress_queue< queue_t< 1 >, 1 >();
+}
+
+BOOST_AUTO_TEST_CASE( characteristics_share_a_word )
+{
+    stress_queue< queue_t< 13 >, 13 >();
+}
+
+BOOST_AUTO_TEST_CASE( characteristics_with_priorities )
+{
+    stress_queue< queue_t< 2, 21, 1 >, 24 >();
+}
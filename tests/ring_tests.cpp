@@ -58,3 +58,30 @@ BOOST_FIXTURE_TEST_CASE( around, ring_t )
     BOOST_CHECK_EQUAL( d3, out3 );
     BOOST_CHECK_EQUAL( d4, out4 );
 }
+
+BOOST_AUTO_TEST_CASE( capacity_is_not_rounded_up )
+{
+    bluetoe::details::ring< 5u, int > ring;
+
+    for ( int i = 0; i != 5; ++i )
+        BOOST_CHECK( ring.try_push( i ) );
+
+    BOOST_CHECK( !ring.try_push( 5 ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( many_times_around, ring_t )
+{
+    for ( int i = 0; i != 100; ++i )
+    {
+        const std::string in = std::to_string( i );
+        std::string out;
+
+        BOOST_CHECK( try_push( in ) );
+        BOOST_CHECK( try_push( in ) );
+        BOOST_CHECK( try_pop( out ) );
+        BOOST_CHECK_EQUAL( in, out );
+        BOOST_CHECK( try_pop( out ) );
+        BOOST_CHECK_EQUAL( in, out );
+        BOOST_CHECK( !try_pop( out ) );
+    }
+}
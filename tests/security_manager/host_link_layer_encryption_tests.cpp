@@ -0,0 +1,292 @@
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include <bluetoe/host_link_layer_encryption.hpp>
+
+#include <random>
+#include <vector>
+
+namespace {
+    using block_t = bluetoe::host_details::aes128::block_t;
+    using pdu_t   = std::vector< std::uint8_t >;
+
+    // Core Vol 6, Part C, 1 Encryption sample data
+    const bluetoe::details::uint128_t long_term_key = {{
+        0xbf, 0x01, 0xfb, 0x9d, 0x4e, 0xf3, 0xbc, 0x36,
+        0xd8, 0x74, 0xf5, 0x39, 0x41, 0x38, 0x68, 0x4c
+    }};
+
+    const bluetoe::details::uint128_t session_key = {{
+        0x66, 0xc6, 0xc2, 0x27, 0x8e, 0x3b, 0x8e, 0x05,
+        0x3e, 0x7e, 0xa3, 0x26, 0x52, 0x1b, 0xad, 0x99
+    }};
+
+    const std::uint64_t skdm = 0xACBDCEDFE0F10213;
+    const std::uint64_t skds = 0x0213243546576879;
+    const std::uint32_t ivm  = 0xBADCAB24;
+    const std::uint32_t ivs  = 0xDEAFBABE;
+    const std::uint64_t iv   = 0xDEAFBABEBADCAB24;
+
+    struct with_and_without_aes_ni
+    {
+        template < class F >
+        void both( F f )
+        {
+            bluetoe::host_details::use_aes_ni( false );
+            f();
+            bluetoe::host_details::use_aes_ni( true );
+            f();
+        }
+    };
+
+    struct sample_session : with_and_without_aes_ni, bluetoe::host_details::software_radio_encryption
+    {
+        sample_session()
+        {
+            setup_encryption( long_term_key, skdm, ivm, skds, ivs );
+            start_receive_encrypted();
+            start_transmit_encrypted();
+        }
+
+        pdu_t transmit( const pdu_t& pdu )
+        {
+            pdu_t result( pdu.size() + bluetoe::host_details::link_layer_ccm::mic_size );
+            result.resize( transmit_pdu( pdu.data(), result.data() ) );
+
+            return result;
+        }
+
+        std::pair< bool, pdu_t > receive( const pdu_t& pdu )
+        {
+            pdu_t result( pdu.size() );
+            const bool valid = receive_pdu( pdu.data(), result.data() );
+            result.resize( result[ 1 ] + 2 );
+
+            return { valid, result };
+        }
+    };
+
+    // straight forward CCM as in Core Vol 6, Part E: CBC-MAC over the plain text first, then CTR
+    pdu_t reference_encrypt( const pdu_t& pdu, std::uint64_t counter, bool sent_by_central )
+    {
+        block_t key;
+        std::reverse_copy( session_key.begin(), session_key.end(), key.begin() );
+        const bluetoe::host_details::aes128 aes( key );
+
+        const std::size_t size = pdu[ 1 ];
+
+        block_t nonce_block = {{ 0 }};
+        for ( int i = 0; i != 5; ++i )
+            nonce_block[ 1 + i ] = static_cast< std::uint8_t >( counter >> ( 8 * i ) );
+
+        nonce_block[ 5 ] = static_cast< std::uint8_t >( ( nonce_block[ 5 ] & 0x7f ) | ( sent_by_central ? 0x80 : 0 ) );
+
+        for ( int i = 0; i != 8; ++i )
+            nonce_block[ 6 + i ] = static_cast< std::uint8_t >( iv >> ( 8 * i ) );
+
+        std::vector< std::uint8_t > message = { 0x00, 0x01, static_cast< std::uint8_t >( pdu[ 0 ] & 0xe3 ) };
+        message.resize( 16, 0 );
+        message.insert( message.end(), pdu.begin() + 2, pdu.end() );
+        message.resize( ( message.size() + 15 ) / 16 * 16, 0 );
+
+        block_t mac = nonce_block;
+        mac[ 0 ]  = 0x49;
+        mac[ 15 ] = static_cast< std::uint8_t >( size );
+        mac = aes.encrypt( mac );
+
+        for ( std::size_t offset = 0; offset != message.size(); offset += 16 )
+        {
+            for ( std::size_t i = 0; i != 16; ++i )
+                mac[ i ] ^= message[ offset + i ];
+
+            mac = aes.encrypt( mac );
+        }
+
+        pdu_t result = pdu;
+        result[ 1 ] = static_cast< std::uint8_t >( size + 4 );
+
+        block_t a = nonce_block;
+        a[ 0 ] = 0x01;
+
+        const block_t s0 = aes.encrypt( a );
+
+        for ( std::size_t i = 0; i != size; ++i )
+        {
+            if ( i % 16 == 0 )
+                ++a[ 15 ];
+
+            result[ 2 + i ] ^= aes.encrypt( a )[ i % 16 ];
+        }
+
+        for ( std::size_t i = 0; i != 4; ++i )
+            result.push_back( mac[ i ] ^ s0[ i ] );
+
+        return result;
+    }
+}
+
+BOOST_AUTO_TEST_CASE( session_key_derivation )
+{
+    block_t expected;
+    std::reverse_copy( session_key.begin(), session_key.end(), expected.begin() );
+
+    bluetoe::details::uint128_t skd;
+    bluetoe::details::write_64bit( &skd[ 0 ], skdm );
+    bluetoe::details::write_64bit( &skd[ 8 ], skds );
+
+    BOOST_CHECK( bluetoe::host_details::aes_le( long_term_key, skd ) == session_key );
+}
+
+BOOST_FIXTURE_TEST_CASE( sample_data_central_to_peripheral, sample_session )
+{
+    both( [this]{
+        setup_encryption( long_term_key, skdm, ivm, skds, ivs );
+
+        const auto received = receive( { 0x0f, 0x05, 0x9f, 0xcd, 0xa7, 0xf4, 0x48 } );
+        const pdu_t expected = { 0x0f, 0x01, 0x06 };
+
+        BOOST_CHECK( received.first );
+        BOOST_CHECK_EQUAL_COLLECTIONS( received.second.begin(), received.second.end(), expected.begin(), expected.end() );
+    } );
+}
+
+BOOST_FIXTURE_TEST_CASE( sample_data_peripheral_to_central, sample_session )
+{
+    both( [this]{
+        setup_encryption( long_term_key, skdm, ivm, skds, ivs );
+
+        const pdu_t transmitted = transmit( { 0x07, 0x01, 0x06 } );
+        const pdu_t expected    = { 0x07, 0x05, 0xa3, 0x4c, 0x13, 0xa4, 0x15 };
+
+        BOOST_CHECK_EQUAL_COLLECTIONS( transmitted.begin(), transmitted.end(), expected.begin(), expected.end() );
+    } );
+}
+
+BOOST_FIXTURE_TEST_CASE( all_payload_sizes_match_reference, with_and_without_aes_ni )
+{
+    both( []{
+        const bluetoe::host_details::link_layer_ccm ccm( session_key, iv );
+        std::mt19937 random( 17 );
+
+        for ( std::size_t size = 1; size <= 251; ++size )
+        {
+            pdu_t pdu = { static_cast< std::uint8_t >( random() ), static_cast< std::uint8_t >( size ) };
+            for ( std::size_t i = 0; i != size; ++i )
+                pdu.push_back( static_cast< std::uint8_t >( random() ) );
+
+            const std::uint64_t counter = random() & 0x7fffffffff;
+            const bool          central = size % 2;
+
+            pdu_t encrypted( size + 6 );
+            BOOST_REQUIRE_EQUAL( ccm.encrypt( pdu.data(), encrypted.data(), counter, central ), size + 6 );
+
+            const pdu_t expected = reference_encrypt( pdu, counter, central );
+            BOOST_CHECK_EQUAL_COLLECTIONS( encrypted.begin(), encrypted.end(), expected.begin(), expected.end() );
+
+            pdu_t decrypted( size + 6 );
+            BOOST_CHECK( ccm.decrypt( encrypted.data(), decrypted.data(), counter, central ) );
+            decrypted.resize( size + 2 );
+            BOOST_CHECK_EQUAL_COLLECTIONS( decrypted.begin(), decrypted.end(), pdu.begin(), pdu.end() );
+        }
+    } );
+}
+
+BOOST_AUTO_TEST_CASE( in_place_operation )
+{
+    const bluetoe::host_details::link_layer_ccm ccm( session_key, iv );
+    const pdu_t plain = { 0x02, 0x05, 'H', 'e', 'l', 'l', 'o' };
+
+    pdu_t pdu = plain;
+    pdu.resize( plain.size() + 4 );
+
+    ccm.encrypt( pdu.data(), pdu.data(), 4, false );
+    BOOST_CHECK( ccm.decrypt( pdu.data(), pdu.data(), 4, false ) );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( pdu.begin(), pdu.begin() + plain.size(), plain.begin(), plain.end() );
+}
+
+BOOST_FIXTURE_TEST_CASE( modified_pdus_are_rejected, sample_session )
+{
+    pdu_t pdu = { 0x0f, 0x05, 0x9f, 0xcd, 0xa7, 0xf4, 0x48 };
+
+    for ( std::size_t byte = 2; byte != pdu.size(); ++byte )
+    {
+        pdu_t modified = pdu;
+        modified[ byte ] ^= 0x01;
+
+        BOOST_CHECK( !receive( modified ).first );
+    }
+
+    // LLID is authenticated
+    pdu[ 0 ] ^= 0x01;
+    BOOST_CHECK( !receive( pdu ).first );
+
+    // the receive counter did not advance
+    pdu[ 0 ] ^= 0x01;
+    BOOST_CHECK( receive( pdu ).first );
+}
+
+BOOST_FIXTURE_TEST_CASE( nesn_sn_and_md_are_not_authenticated, sample_session )
+{
+    BOOST_CHECK( receive( { 0x0f ^ 0x1c, 0x05, 0x9f, 0xcd, 0xa7, 0xf4, 0x48 } ).first );
+}
+
+BOOST_FIXTURE_TEST_CASE( pdus_too_short_for_a_mic_are_rejected, sample_session )
+{
+    BOOST_CHECK( !receive( { 0x0f, 0x04, 0x9f, 0xcd, 0xa7, 0xf4 } ).first );
+}
+
+BOOST_FIXTURE_TEST_CASE( empty_pdus_are_not_encrypted, sample_session )
+{
+    const pdu_t empty = { 0x01, 0x00 };
+
+    const pdu_t transmitted = transmit( empty );
+    BOOST_CHECK_EQUAL_COLLECTIONS( transmitted.begin(), transmitted.end(), empty.begin(), empty.end() );
+
+    const auto received = receive( empty );
+    BOOST_CHECK( received.first );
+
+    // neither counter advanced
+    const pdu_t expected = { 0x07, 0x05, 0xa3, 0x4c, 0x13, 0xa4, 0x15 };
+    const pdu_t next     = transmit( { 0x07, 0x01, 0x06 } );
+    BOOST_CHECK_EQUAL_COLLECTIONS( next.begin(), next.end(), expected.begin(), expected.end() );
+
+    BOOST_CHECK( receive( { 0x0f, 0x05, 0x9f, 0xcd, 0xa7, 0xf4, 0x48 } ).first );
+}
+
+BOOST_FIXTURE_TEST_CASE( packet_counter_advances_with_every_pdu, sample_session )
+{
+    const pdu_t first  = transmit( { 0x07, 0x01, 0x06 } );
+    const pdu_t second = transmit( { 0x07, 0x01, 0x06 } );
+
+    BOOST_CHECK( first != second );
+    BOOST_CHECK( second == reference_encrypt( { 0x07, 0x01, 0x06 }, 1, false ) );
+}
+
+BOOST_FIXTURE_TEST_CASE( unencrypted_until_started, with_and_without_aes_ni )
+{
+    bluetoe::host_details::software_radio_encryption radio;
+    radio.setup_encryption( long_term_key, skdm, ivm, skds, ivs );
+
+    const pdu_t pdu = { 0x07, 0x01, 0x06 };
+    pdu_t output( 7 );
+
+    BOOST_CHECK_EQUAL( radio.transmit_pdu( pdu.data(), output.data() ), 3u );
+    BOOST_CHECK( std::equal( pdu.begin(), pdu.end(), output.begin() ) );
+
+    radio.start_transmit_encrypted();
+    BOOST_CHECK_EQUAL( radio.transmit_pdu( pdu.data(), output.data() ), 7u );
+
+    radio.stop_transmit_encrypted();
+    BOOST_CHECK_EQUAL( radio.transmit_pdu( pdu.data(), output.data() ), 3u );
+}
+
+BOOST_AUTO_TEST_CASE( random_session_parameters )
+{
+    bluetoe::host_details::software_radio_encryption radio;
+
+    const auto first  = radio.setup_encryption( long_term_key, skdm, ivm );
+    const auto second = radio.setup_encryption( long_term_key, skdm, ivm );
+
+    BOOST_CHECK( first != second );
+}
@@ -0,0 +1,400 @@
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include <bluetoe/host_security_tool_box.hpp>
+#include "lesc_test_vectors.hpp"
+
+#include <random>
+
+namespace {
+    using block_t = bluetoe::host_details::aes128::block_t;
+
+    // RFC 4493, 4. Test Vectors
+    static const block_t cmac_key = {{
+        0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+        0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+    }};
+
+    static const std::uint8_t cmac_message[ 64 ] = {
+        0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96,
+        0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+        0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+        0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+        0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11,
+        0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+        0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17,
+        0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10
+    };
+
+    block_t cmac( std::size_t size )
+    {
+        const std::uint8_t* const message = &cmac_message[ 0 ];
+        block_t result;
+
+        bluetoe::host_details::aes_cmac( bluetoe::host_details::aes128( cmac_key ), &message, 1, size, &result );
+
+        return result;
+    }
+
+    // run every test with and without AES-NI
+    struct with_and_without_aes_ni
+    {
+        template < class F >
+        void both( F f )
+        {
+            bluetoe::host_details::use_aes_ni( false );
+            f();
+            bluetoe::host_details::use_aes_ni( true );
+            f();
+        }
+    };
+}
+
+BOOST_FIXTURE_TEST_CASE( aes_fips_197_example, with_and_without_aes_ni )
+{
+    both( []{
+        const block_t key = {{
+            0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+            0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+        }};
+
+        const block_t plain = {{
+            0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+            0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+        }};
+
+        const block_t expected = {{
+            0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+            0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a
+        }};
+
+        const block_t cipher = bluetoe::host_details::aes128( key ).encrypt( plain );
+
+        BOOST_CHECK_EQUAL_COLLECTIONS( cipher.begin(), cipher.end(), expected.begin(), expected.end() );
+    } );
+}
+
+BOOST_FIXTURE_TEST_CASE( aes_little_endian, with_and_without_aes_ni )
+{
+    both( []{
+        const bluetoe::details::uint128_t key{{
+            0x0f, 0x0e, 0x0d, 0x0c, 0x0b, 0x0a, 0x09, 0x08,
+            0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01, 0x00
+        }};
+
+        const bluetoe::details::uint128_t input{{
+            0xff, 0xee, 0xdd, 0xcc, 0xbb, 0xaa, 0x99, 0x88,
+            0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11, 0x00
+        }};
+
+        const bluetoe::details::uint128_t expected{{
+            0x5a, 0xc5, 0xb4, 0x70, 0x80, 0xb7, 0xcd, 0xd8,
+            0x30, 0x04, 0x7b, 0x6a, 0xd8, 0xe0, 0xc4, 0x69
+        }};
+
+        const bluetoe::details::uint128_t output = bluetoe::host_details::aes_le( key, input );
+
+        BOOST_CHECK_EQUAL_COLLECTIONS( output.begin(), output.end(), expected.begin(), expected.end() );
+    } );
+}
+
+BOOST_AUTO_TEST_CASE( aes_ni_and_software_implementation_yield_same_results )
+{
+    if ( !bluetoe::host_details::aes_ni_supported() )
+        return;
+
+    std::mt19937 random( 42 );
+
+    for ( int i = 0; i != 100; ++i )
+    {
+        block_t key;
+        block_t input[ bluetoe::host_details::aes128::max_parallel_blocks ];
+        std::generate( key.begin(), key.end(), random );
+
+        for ( auto& block : input )
+            std::generate( block.begin(), block.end(), random );
+
+        const bluetoe::host_details::aes128 aes( key );
+
+        block_t software[ bluetoe::host_details::aes128::max_parallel_blocks ];
+        bluetoe::host_details::use_aes_ni( false );
+        aes.encrypt( input, software, bluetoe::host_details::aes128::max_parallel_blocks );
+
+        block_t hardware[ bluetoe::host_details::aes128::max_parallel_blocks ];
+        bluetoe::host_details::use_aes_ni( true );
+        aes.encrypt( input, hardware, bluetoe::host_details::aes128::max_parallel_blocks );
+
+        for ( std::size_t block = 0; block != bluetoe::host_details::aes128::max_parallel_blocks; ++block )
+            BOOST_CHECK( software[ block ] == hardware[ block ] );
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE( aes_cmac_rfc_4493, with_and_without_aes_ni )
+{
+    both( []{
+        const block_t empty = {{
+            0xbb, 0x1d, 0x69, 0x29, 0xe9, 0x59, 0x37, 0x28,
+            0x7f, 0xa3, 0x7d, 0x12, 0x9b, 0x75, 0x67, 0x46
+        }};
+
+        const block_t one_block = {{
+            0x07, 0x0a, 0x16, 0xb4, 0x6b, 0x4d, 0x41, 0x44,
+            0xf7, 0x9b, 0xdd, 0x9d, 0xd0, 0x4a, 0x28, 0x7c
+        }};
+
+        const block_t fourty_bytes = {{
+            0xdf, 0xa6, 0x67, 0x47, 0xde, 0x9a, 0xe6, 0x30,
+            0x30, 0xca, 0x32, 0x61, 0x14, 0x97, 0xc8, 0x27
+        }};
+
+        const block_t four_blocks = {{
+            0x51, 0xf0, 0xbe, 0xbf, 0x7e, 0x3b, 0x9d, 0x92,
+            0xfc, 0x49, 0x74, 0x17, 0x79, 0x36, 0x3c, 0xfe
+        }};
+
+        BOOST_CHECK( cmac( 0 ) == empty );
+        BOOST_CHECK( cmac( 16 ) == one_block );
+        BOOST_CHECK( cmac( 40 ) == fourty_bytes );
+        BOOST_CHECK( cmac( 64 ) == four_blocks );
+    } );
+}
+
+BOOST_FIXTURE_TEST_CASE( parallel_aes_cmac, with_and_without_aes_ni )
+{
+    both( []{
+        std::uint8_t second_message[ sizeof( cmac_message ) ];
+        std::copy( std::begin( cmac_message ), std::end( cmac_message ), std::begin( second_message ) );
+        second_message[ 0 ] ^= 0x01;
+
+        const std::uint8_t* const second = &second_message[ 0 ];
+        block_t second_expected;
+        bluetoe::host_details::aes_cmac( bluetoe::host_details::aes128( cmac_key ), &second, 1, 40, &second_expected );
+
+        const std::uint8_t* const messages[] = { &cmac_message[ 0 ], second, &cmac_message[ 0 ] };
+        block_t macs[ 3 ];
+
+        bluetoe::host_details::aes_cmac( bluetoe::host_details::aes128( cmac_key ), messages, 3, 40, macs );
+
+        BOOST_CHECK( macs[ 0 ] == cmac( 40 ) );
+        BOOST_CHECK( macs[ 1 ] == second_expected );
+        BOOST_CHECK( macs[ 2 ] == cmac( 40 ) );
+        BOOST_CHECK( macs[ 0 ] != macs[ 1 ] );
+    } );
+}
+
+/*
+ * Security tool box functions, tested with the sample data from Core (V5), Vol 3, Part H, Appendix D
+ */
+BOOST_FIXTURE_TEST_CASE( c1_test, bluetoe::host_details::security_tool_box )
+{
+    const bluetoe::details::uint128_t p1{{
+        0x01, 0x00, 0x01, 0x01, 0x00, 0x00, 0x10, 0x07,
+        0x07, 0x02, 0x03, 0x00, 0x00, 0x08, 0x00, 0x05
+    }};
+
+    const bluetoe::details::uint128_t p2{{
+        0xB6, 0xB5, 0xB4, 0xB3, 0xB2, 0xB1, 0xA6, 0xA5,
+        0xA4, 0xA3, 0xA2, 0xA1, 0x00, 0x00, 0x00, 0x00
+    }};
+
+    const bluetoe::details::uint128_t k{{ 0x00 }};
+
+    const bluetoe::details::uint128_t r{{
+        0xE0, 0x2E, 0x70, 0xC6, 0x4E, 0x27, 0x88, 0x63,
+        0x0E, 0x6F, 0xAD, 0x56, 0x21, 0xD5, 0x83, 0x57
+    }};
+
+    const bluetoe::details::uint128_t expected{{
+        0x86, 0x3b, 0xf1, 0xbe, 0xc5, 0x4d, 0xa7, 0xd2,
+        0xea, 0x88, 0x89, 0x87, 0xef, 0x3f, 0x1e, 0x1e
+    }};
+
+    const bluetoe::details::uint128_t confirm = c1( k, r, p1, p2 );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( confirm.begin(), confirm.end(), expected.begin(), expected.end() );
+}
+
+BOOST_FIXTURE_TEST_CASE( s1_test, bluetoe::host_details::security_tool_box )
+{
+    static const bluetoe::details::uint128_t k{{ 0x00 }};
+
+    static const bluetoe::details::uint128_t r1 = {{
+        0x88, 0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11,
+        0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x00
+    }};
+
+    static const bluetoe::details::uint128_t r2 = {{
+        0x00, 0xFF, 0xEE, 0xDD, 0xCC, 0xBB, 0xAA, 0x99,
+        0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01
+    }};
+
+    static const bluetoe::details::uint128_t expected = {{
+        0x62, 0xa0, 0x6d, 0x79, 0xae, 0x16, 0x42, 0x5b,
+        0x9b, 0xf4, 0xb0, 0xe8, 0xf0, 0xe1, 0x1f, 0x9a
+    }};
+
+    const bluetoe::details::uint128_t key = s1( k, r1, r2 );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( key.begin(), key.end(), expected.begin(), expected.end() );
+}
+
+namespace {
+    const std::array< std::uint8_t, 32 > u = {{
+        0xe6, 0x9d, 0x35, 0x0e, 0x48, 0x01, 0x03, 0xcc,
+        0xdb, 0xfd, 0xf4, 0xac, 0x11, 0x91, 0xf4, 0xef,
+        0xb9, 0xa5, 0xf9, 0xe9, 0xa7, 0x83, 0x2c, 0x5e,
+        0x2c, 0xbe, 0x97, 0xf2, 0xd2, 0x03, 0xb0, 0x20
+    }};
+
+    const std::array< std::uint8_t, 32 > v = {{
+        0xfd, 0xc5, 0x7f, 0xf4, 0x49, 0xdd, 0x4f, 0x6b,
+        0xfb, 0x7c, 0x9d, 0xf1, 0xc2, 0x9a, 0xcb, 0x59,
+        0x2a, 0xe7, 0xd4, 0xee, 0xfb, 0xfc, 0x0a, 0x90,
+        0x9a, 0xbb, 0xf6, 0x32, 0x3d, 0x8b, 0x18, 0x55
+    }};
+
+    const bluetoe::details::uint128_t nonce_central = {{
+        0xab, 0xae, 0x2b, 0x71, 0xec, 0xb2, 0xff, 0xff,
+        0x3e, 0x73, 0x77, 0xd1, 0x54, 0x84, 0xcb, 0xd5
+    }};
+
+    const bluetoe::details::uint128_t nonce_periperal = {{
+        0xcf, 0xc4, 0x3d, 0xff, 0xf7, 0x83, 0x65, 0x21,
+        0x6e, 0x5f, 0xa7, 0x25, 0xcc, 0xe7, 0xe8, 0xa6
+    }};
+
+    const bluetoe::link_layer::public_device_address addr_controller({
+        0xce, 0xbf, 0x37, 0x37, 0x12, 0x56
+    });
+
+    const bluetoe::link_layer::public_device_address addr_peripheral({
+        0xc1, 0xcf, 0x2d, 0x70, 0x13, 0xa7
+    });
+
+    const bluetoe::details::uint128_t mac_key = {{
+        0x20, 0x6e, 0x63, 0xce, 0x20, 0x6a, 0x3f, 0xfd,
+        0x02, 0x4a, 0x08, 0xa1, 0x76, 0xf1, 0x65, 0x29
+    }};
+}
+
+BOOST_FIXTURE_TEST_CASE( f4_test, bluetoe::host_details::security_tool_box )
+{
+    const bluetoe::details::uint128_t expected{{
+        0x2d, 0x87, 0x74, 0xa9, 0xbe, 0xa1, 0xed, 0xf1,
+        0x1c, 0xbd, 0xa9, 0x07, 0xf1, 0x16, 0xc9, 0xf2
+    }};
+
+    const bluetoe::details::uint128_t output = f4( u.data(), v.data(), nonce_central, 0 );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( output.begin(), output.end(), expected.begin(), expected.end() );
+}
+
+BOOST_FIXTURE_TEST_CASE( f5_test, bluetoe::host_details::security_tool_box )
+{
+    const bluetoe::details::ecdh_shared_secret_t dh_key = {{
+        0x98, 0xa6, 0xbf, 0x73, 0xf3, 0x34, 0x8d, 0x86,
+        0xf1, 0x66, 0xf8, 0xb4, 0x13, 0x6b, 0x79, 0x99,
+        0x9b, 0x7d, 0x39, 0x0a, 0xa6, 0x10, 0x10, 0x34,
+        0x05, 0xad, 0xc8, 0x57, 0xa3, 0x34, 0x02, 0xec
+    }};
+
+    const bluetoe::details::uint128_t expected_ltk = {{
+        0x38, 0x0a, 0x75, 0x94, 0xb5, 0x22, 0x05, 0x98,
+        0x23, 0xcd, 0xd7, 0x69, 0x11, 0x79, 0x86, 0x69
+    }};
+
+    bluetoe::details::uint128_t calculated_mac_key;
+    bluetoe::details::uint128_t ltk;
+
+    std::tie( calculated_mac_key, ltk ) = f5( dh_key, nonce_central, nonce_periperal, addr_controller, addr_peripheral );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( calculated_mac_key.begin(), calculated_mac_key.end(), mac_key.begin(), mac_key.end() );
+    BOOST_CHECK_EQUAL_COLLECTIONS( ltk.begin(), ltk.end(), expected_ltk.begin(), expected_ltk.end() );
+}
+
+BOOST_FIXTURE_TEST_CASE( f6_test, bluetoe::host_details::security_tool_box )
+{
+    static const bluetoe::details::uint128_t R = {{
+        0xc8, 0x0f, 0x2d, 0x0c, 0xd2, 0x42, 0xda, 0x08,
+        0x54, 0xbb, 0x53, 0xb4, 0x3b, 0x34, 0xa3, 0x12
+    }};
+
+    static const bluetoe::details::io_capabilities_t io_caps = {{
+        0x02, 0x01, 0x01
+    }};
+
+    static const bluetoe::details::uint128_t expected_check_value = {{
+        0x61, 0x8f, 0x95, 0xda, 0x09, 0x0b, 0x6c, 0xd2,
+        0xc5, 0xe8, 0xd0, 0x9c, 0x98, 0x73, 0xc4, 0xe3
+    }};
+
+    const bluetoe::details::uint128_t check_value = f6(
+        mac_key, nonce_central, nonce_periperal, R, io_caps, addr_controller, addr_peripheral );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( check_value.begin(), check_value.end(), expected_check_value.begin(), expected_check_value.end() );
+}
+
+BOOST_FIXTURE_TEST_CASE( g2_test, bluetoe::host_details::security_tool_box )
+{
+    BOOST_CHECK_EQUAL( g2( u.data(), v.data(), nonce_central, nonce_periperal ), 0x2f9ed5bau );
+}
+
+BOOST_FIXTURE_TEST_CASE( p256_test, bluetoe::host_details::security_tool_box )
+{
+    using namespace test::lesc_vectors;
+
+    BOOST_CHECK( is_valid_public_key( public_a.data() ) );
+    BOOST_CHECK( is_valid_public_key( public_b.data() ) );
+
+    const auto shared_a = p256( private_a.data(), public_b.data() );
+    const auto shared_b = p256( private_b.data(), public_a.data() );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( dh_key.begin(), dh_key.end(), shared_a.begin(), shared_a.end() );
+    BOOST_CHECK_EQUAL_COLLECTIONS( dh_key.begin(), dh_key.end(), shared_b.begin(), shared_b.end() );
+}
+
+BOOST_FIXTURE_TEST_CASE( generated_keys_yield_the_same_shared_secret, bluetoe::host_details::security_tool_box )
+{
+    const auto keys_a = generate_keys();
+    const auto keys_b = generate_keys();
+
+    BOOST_CHECK( is_valid_public_key( keys_a.first.data() ) );
+    BOOST_CHECK( is_valid_public_key( keys_b.first.data() ) );
+    BOOST_CHECK( keys_a.first != keys_b.first );
+
+    const auto shared_a = p256( keys_a.second.data(), keys_b.first.data() );
+    const auto shared_b = p256( keys_b.second.data(), keys_a.first.data() );
+
+    BOOST_CHECK( shared_a == shared_b );
+}
+
+BOOST_FIXTURE_TEST_CASE( passkey_in_range, bluetoe::host_details::security_tool_box )
+{
+    for ( int i = 0; i != 100; ++i )
+    {
+        const auto passkey = create_passkey();
+
+        BOOST_CHECK_LE( bluetoe::details::read_32bit( passkey.data() ), 999999u );
+        BOOST_CHECK( std::all_of( passkey.begin() + 4, passkey.end(), []( std::uint8_t b ){ return b == 0; } ) );
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE( seeded_random_numbers_are_reproducible, bluetoe::host_details::security_tool_box )
+{
+    const std::uint8_t seed[ 32 ] = { 0x01, 0x02, 0x03, 0x04 };
+
+    bluetoe::host_details::seed_random_number_generator( seed );
+    const auto srand_1 = create_srand();
+    const auto nonce_1 = select_random_nonce();
+    const auto keys_1  = generate_keys();
+
+    bluetoe::host_details::seed_random_number_generator( seed );
+    const auto srand_2 = create_srand();
+    const auto nonce_2 = select_random_nonce();
+    const auto keys_2  = generate_keys();
+
+    BOOST_CHECK( srand_1 == srand_2 );
+    BOOST_CHECK( nonce_1 == nonce_2 );
+    BOOST_CHECK( keys_1 == keys_2 );
+    BOOST_CHECK( srand_1 != nonce_1 );
+}
@@ -0,0 +1,163 @@
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include <bluetoe/security_manager.hpp>
+
+#include "test_sm.hpp"
+
+namespace {
+
+    /*
+     * returns the key pair B of the sample data on odd calls and key pair A on even calls,
+     * so that every key pair can be traced back to the call that generated it.
+     */
+    struct counting_security_functions : test::all_security_functions
+    {
+        counting_security_functions()
+            : generated_keys( 0 )
+        {
+        }
+
+        std::pair< bluetoe::details::ecdh_public_key_t, bluetoe::details::ecdh_private_key_t > generate_keys()
+        {
+            using namespace test::lesc_vectors;
+
+            return ++generated_keys % 2
+                ? std::make_pair( public_b, private_b )
+                : std::make_pair( public_a, private_a );
+        }
+
+        unsigned generated_keys;
+    };
+
+    template < class Manager, typename ... Options >
+    struct pregeneration_fixture : test::security_manager_base< Manager, counting_security_functions, 65, Options... >
+    {
+        void pairing_request()
+        {
+            this->expected(
+                {
+                    0x01,           // Pairing Request
+                    0x01,           // IO Capability NoInputNoOutput
+                    0x00,           // OOB data flag (data not present)
+                    0x08,           // AuthReq, SC = 1
+                    0x10,           // Maximum Encryption Key Size (16)
+                    0x07,           // Initiator Key Distribution
+                    0x07,           // Responder Key Distribution (RFU)
+                },
+                {
+                    0x02,           // response
+                    0x03,           // NoInputNoOutput
+                    0x00,           // OOB Authentication data not present
+                    0x08,           // Bonding, MITM = 0, SC = 1, Keypress = 0
+                    0x10,           // Maximum Encryption Key Size
+                    0x00,           // LinkKey
+                    0x00            // LinkKey
+                }
+            );
+        }
+
+        // the remote device uses the debug key pair A, the expected response contains the given local key
+        void public_key_exchange( const bluetoe::details::ecdh_public_key_t& expected_local_key )
+        {
+            std::vector< std::uint8_t > request( 1, 0x0C );         // Pairing Public Key
+            request.insert( request.end(), test::lesc_vectors::public_a.begin(), test::lesc_vectors::public_a.end() );
+
+            std::vector< std::uint8_t > response( 1, 0x0C );        // Pairing Public Key
+            response.insert( response.end(), expected_local_key.begin(), expected_local_key.end() );
+
+            this->expected( request, response );
+        }
+
+        std::size_t pregenerated_keys() const
+        {
+            return this->pregenerated_lesc_key_pairs();
+        }
+
+        void new_connection()
+        {
+            this->connection_data_ = typename test::security_manager_base< Manager, counting_security_functions, 65, Options... >::connection_data_t();
+            this->connect( bluetoe::link_layer::random_device_address( { 0xa6, 0xa5, 0xa4, 0xa3, 0xa2, 0xa1 } ) );
+        }
+    };
+
+    template < class Manager >
+    using pregenerating = pregeneration_fixture< Manager, bluetoe::lesc_key_pregeneration >;
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( keys_generated_on_demand_by_default, Manager, test::lesc_managers )
+{
+    pregeneration_fixture< Manager > fixture;
+
+    fixture.l2cap_idle();
+    BOOST_CHECK_EQUAL( fixture.generated_keys, 0u );
+
+    fixture.pairing_request();
+    fixture.public_key_exchange( test::lesc_vectors::public_b );
+    BOOST_CHECK_EQUAL( fixture.generated_keys, 1u );
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( one_key_pair_per_idle_call, Manager, test::lesc_managers )
+{
+    pregenerating< Manager > fixture;
+
+    BOOST_CHECK_EQUAL( fixture.pregenerated_keys(), 0u );
+
+    fixture.l2cap_idle();
+    BOOST_CHECK_EQUAL( fixture.generated_keys, 1u );
+    BOOST_CHECK_EQUAL( fixture.pregenerated_keys(), 1u );
+
+    fixture.l2cap_idle();
+    BOOST_CHECK_EQUAL( fixture.generated_keys, 2u );
+    BOOST_CHECK_EQUAL( fixture.pregenerated_keys(), 2u );
+
+    // both slots are filled
+    fixture.l2cap_idle();
+    BOOST_CHECK_EQUAL( fixture.generated_keys, 2u );
+    BOOST_CHECK_EQUAL( fixture.pregenerated_keys(), 2u );
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( pairing_consumes_pregenerated_key, Manager, test::lesc_managers )
+{
+    pregenerating< Manager > fixture;
+    fixture.l2cap_idle();
+
+    fixture.pairing_request();
+    fixture.public_key_exchange( test::lesc_vectors::public_b );
+
+    BOOST_CHECK_EQUAL( fixture.generated_keys, 1u );
+    BOOST_CHECK_EQUAL( fixture.pregenerated_keys(), 0u );
+
+    // the consumed key pair is replaced lazily
+    fixture.l2cap_idle();
+    BOOST_CHECK_EQUAL( fixture.generated_keys, 2u );
+    BOOST_CHECK_EQUAL( fixture.pregenerated_keys(), 1u );
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( pregenerated_keys_are_not_reused, Manager, test::lesc_managers )
+{
+    pregenerating< Manager > fixture;
+    fixture.l2cap_idle();
+    fixture.l2cap_idle();
+
+    fixture.pairing_request();
+    fixture.public_key_exchange( test::lesc_vectors::public_b );
+
+    fixture.new_connection();
+    fixture.pairing_request();
+    fixture.public_key_exchange( test::lesc_vectors::public_a );
+
+    BOOST_CHECK_EQUAL( fixture.generated_keys, 2u );
+    BOOST_CHECK_EQUAL( fixture.pregenerated_keys(), 0u );
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( falls_back_to_on_demand_generation, Manager, test::lesc_managers )
+{
+    pregenerating< Manager > fixture;
+
+    fixture.pairing_request();
+    fixture.public_key_exchange( test::lesc_vectors::public_b );
+
+    BOOST_CHECK_EQUAL( fixture.generated_keys, 1u );
+    BOOST_CHECK_EQUAL( fixture.pregenerated_keys(), 0u );
+}
@@ -0,0 +1,92 @@
+/*
+ * Compares the cycles required by the P-256 implementations for the LESC key generation and DH key calculation.
+ * This is not a unit test and thus not registered with ctest.
+ */
+#include <bluetoe/p256.hpp>
+#include "lesc_test_vectors.hpp"
+#include "uECC.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+
+#if defined __x86_64__ || defined __i386__
+#   include <x86intrin.h>
+#   define BLUETOE_BENCHMARK_UNIT "cycles"
+
+static std::uint64_t now()
+{
+    return __rdtsc();
+}
+#else
+#   define BLUETOE_BENCHMARK_UNIT "ns"
+
+static std::uint64_t now()
+{
+    return std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+#endif
+
+namespace {
+    static constexpr int iterations = 100;
+
+    template < class F >
+    std::uint64_t measure( F f )
+    {
+        std::uint64_t best = ~std::uint64_t();
+
+        for ( int i = 0; i != iterations; ++i )
+        {
+            const std::uint64_t start = now();
+            f();
+            best = std::min( best, now() - start );
+        }
+
+        return best;
+    }
+
+    template < class Array >
+    Array reverse_halfs( Array input )
+    {
+        const auto middle = input.begin() + input.size() / 2;
+
+        std::reverse( input.begin(), middle );
+        std::reverse( middle, input.end() );
+
+        return input;
+    }
+
+    void report( const char* operation, std::uint64_t uecc, std::uint64_t comb )
+    {
+        std::printf( "%-16s uECC: %10llu " BLUETOE_BENCHMARK_UNIT "  p256: %10llu " BLUETOE_BENCHMARK_UNIT "  (%.1fx)\n",
+            operation,
+            static_cast< unsigned long long >( uecc ),
+            static_cast< unsigned long long >( comb ),
+            static_cast< double >( uecc ) / static_cast< double >( comb ) );
+    }
+}
+
+int main()
+{
+    using namespace test::lesc_vectors;
+
+    std::array< std::uint8_t, 32 > private_key;
+    std::reverse_copy( private_a.begin(), private_a.end(), private_key.begin() );
+
+    const auto remote_key = reverse_halfs( public_b );
+
+    std::uint8_t result[ 64 ];
+
+    report( "public key",
+        measure( [&]{ uECC_compute_public_key( private_key.data(), result ); } ),
+        measure( [&]{ bluetoe::p256::public_key( private_a.data(), result ); } ) );
+
+    report( "shared secret",
+        measure( [&]{ uECC_shared_secret( remote_key.data(), private_key.data(), result ); } ),
+        measure( [&]{ bluetoe::p256::shared_secret( private_a.data(), public_b.data(), result ); } ) );
+
+    report( "key validation",
+        measure( [&]{ uECC_valid_public_key( remote_key.data() ); } ),
+        measure( [&]{ bluetoe::p256::valid_public_key( public_b.data() ); } ) );
+}
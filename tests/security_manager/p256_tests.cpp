@@ -0,0 +1,223 @@
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include <bluetoe/p256.hpp>
+#include "lesc_test_vectors.hpp"
+#include "uECC.h"
+
+#include <random>
+
+namespace {
+    using number_t = std::array< std::uint8_t, 32 >;
+    using public_key_t = bluetoe::details::ecdh_public_key_t;
+
+    // n - 1, little endian
+    const number_t largest_private_key = {{
+        0x50, 0x25, 0x63, 0xfc, 0xc2, 0xca, 0xb9, 0xf3,
+        0x84, 0x9e, 0x17, 0xa7, 0xad, 0xfa, 0xe6, 0xbc,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff
+    }};
+
+    const public_key_t base_point = {{
+        0x96, 0xc2, 0x98, 0xd8, 0x45, 0x39, 0xa1, 0xf4,
+        0xa0, 0x33, 0xeb, 0x2d, 0x81, 0x7d, 0x03, 0x77,
+        0xf2, 0x40, 0xa4, 0x63, 0xe5, 0xe6, 0xbc, 0xf8,
+        0x47, 0x42, 0x2c, 0xe1, 0xf2, 0xd1, 0x17, 0x6b,
+
+        0xf5, 0x51, 0xbf, 0x37, 0x68, 0x40, 0xb6, 0xcb,
+        0xce, 0x5e, 0x31, 0x6b, 0x57, 0x33, 0xce, 0x2b,
+        0x16, 0x9e, 0x0f, 0x7c, 0x4a, 0xeb, 0xe7, 0x8e,
+        0x9b, 0x7f, 0x1a, 0xfe, 0xe2, 0x42, 0xe3, 0x4f
+    }};
+
+    public_key_t public_key( const number_t& private_key )
+    {
+        public_key_t result;
+        BOOST_REQUIRE( bluetoe::p256::public_key( private_key.data(), result.data() ) );
+
+        return result;
+    }
+
+    number_t shared_secret( const number_t& private_key, const public_key_t& public_key )
+    {
+        number_t result;
+        BOOST_REQUIRE( bluetoe::p256::shared_secret( private_key.data(), public_key.data(), result.data() ) );
+
+        return result;
+    }
+
+    // uECC uses big endian numbers
+    template < class Array >
+    Array reverse_halfs( Array input )
+    {
+        const auto middle = input.begin() + input.size() / 2;
+
+        if ( input.size() == 64 )
+        {
+            std::reverse( input.begin(), middle );
+            std::reverse( middle, input.end() );
+        }
+        else
+        {
+            std::reverse( input.begin(), input.end() );
+        }
+
+        return input;
+    }
+
+    number_t random_private_key( std::mt19937& random )
+    {
+        number_t result;
+
+        do
+        {
+            std::generate( result.begin(), result.end(), random );
+        }
+        while ( !bluetoe::p256::valid_private_key( result.data() ) );
+
+        return result;
+    }
+}
+
+BOOST_AUTO_TEST_CASE( sample_data_public_keys )
+{
+    using namespace test::lesc_vectors;
+
+    const public_key_t calculated_a = public_key( private_a );
+    const public_key_t calculated_b = public_key( private_b );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( calculated_a.begin(), calculated_a.end(), public_a.begin(), public_a.end() );
+    BOOST_CHECK_EQUAL_COLLECTIONS( calculated_b.begin(), calculated_b.end(), public_b.begin(), public_b.end() );
+}
+
+BOOST_AUTO_TEST_CASE( sample_data_shared_secret )
+{
+    using namespace test::lesc_vectors;
+
+    const number_t shared_a = shared_secret( private_a, public_b );
+    const number_t shared_b = shared_secret( private_b, public_a );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( shared_a.begin(), shared_a.end(), dh_key.begin(), dh_key.end() );
+    BOOST_CHECK_EQUAL_COLLECTIONS( shared_b.begin(), shared_b.end(), dh_key.begin(), dh_key.end() );
+}
+
+BOOST_AUTO_TEST_CASE( sample_data_public_keys_are_valid )
+{
+    using namespace test::lesc_vectors;
+
+    BOOST_CHECK( bluetoe::p256::valid_public_key( public_a.data() ) );
+    BOOST_CHECK( bluetoe::p256::valid_public_key( public_b.data() ) );
+    BOOST_CHECK( bluetoe::p256::valid_public_key( base_point.data() ) );
+}
+
+BOOST_AUTO_TEST_CASE( points_not_on_the_curve_are_invalid )
+{
+    public_key_t key = test::lesc_vectors::public_a;
+    key[ 40 ] ^= 0x01;
+
+    BOOST_CHECK( !bluetoe::p256::valid_public_key( key.data() ) );
+
+    const public_key_t zero = {{ 0 }};
+    BOOST_CHECK( !bluetoe::p256::valid_public_key( zero.data() ) );
+}
+
+BOOST_AUTO_TEST_CASE( coordinates_out_of_range_are_invalid )
+{
+    public_key_t key = base_point;
+
+    // x = p
+    const std::uint8_t p[ 32 ] = {
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x01, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff
+    };
+
+    std::copy( std::begin( p ), std::end( p ), key.begin() );
+
+    BOOST_CHECK( !bluetoe::p256::valid_public_key( key.data() ) );
+}
+
+BOOST_AUTO_TEST_CASE( private_key_range )
+{
+    const number_t zero = {{ 0 }};
+    number_t order = largest_private_key;
+    ++order[ 0 ];
+
+    BOOST_CHECK( !bluetoe::p256::valid_private_key( zero.data() ) );
+    BOOST_CHECK( !bluetoe::p256::valid_private_key( order.data() ) );
+    BOOST_CHECK( bluetoe::p256::valid_private_key( largest_private_key.data() ) );
+
+    public_key_t key;
+    BOOST_CHECK( !bluetoe::p256::public_key( zero.data(), key.data() ) );
+    BOOST_CHECK( !bluetoe::p256::public_key( order.data(), key.data() ) );
+}
+
+BOOST_AUTO_TEST_CASE( smallest_and_largest_private_key )
+{
+    const number_t one = {{ 1 }};
+
+    const public_key_t g = public_key( one );
+    BOOST_CHECK_EQUAL_COLLECTIONS( g.begin(), g.end(), base_point.begin(), base_point.end() );
+
+    // (n - 1) * G = -G
+    const public_key_t minus_g = public_key( largest_private_key );
+    BOOST_CHECK_EQUAL_COLLECTIONS( minus_g.begin(), minus_g.begin() + 32, base_point.begin(), base_point.begin() + 32 );
+    BOOST_CHECK( !std::equal( minus_g.begin() + 32, minus_g.end(), base_point.begin() + 32 ) );
+
+    const number_t x = shared_secret( largest_private_key, base_point );
+    BOOST_CHECK_EQUAL_COLLECTIONS( x.begin(), x.end(), base_point.begin(), base_point.begin() + 32 );
+}
+
+BOOST_AUTO_TEST_CASE( comb_table_is_up_to_date )
+{
+    using namespace bluetoe::p256_details;
+
+    affine_point table[ comb_table_size ];
+    calculate_comb_table( table );
+
+    for ( std::size_t i = 0; i != comb_table_size; ++i )
+    {
+        BOOST_CHECK( table[ i ].x == comb_table[ i ].x );
+        BOOST_CHECK( table[ i ].y == comb_table[ i ].y );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( public_keys_match_uECC )
+{
+    std::mt19937 random( 4711 );
+
+    for ( int i = 0; i != 50; ++i )
+    {
+        const number_t private_key = random_private_key( random );
+
+        public_key_t expected;
+        BOOST_REQUIRE( uECC_compute_public_key( reverse_halfs( private_key ).data(), expected.data() ) );
+        expected = reverse_halfs( expected );
+
+        const public_key_t calculated = public_key( private_key );
+
+        BOOST_CHECK_EQUAL_COLLECTIONS( calculated.begin(), calculated.end(), expected.begin(), expected.end() );
+        BOOST_CHECK( bluetoe::p256::valid_public_key( calculated.data() ) );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( shared_secrets_match_uECC )
+{
+    std::mt19937 random( 42 );
+
+    for ( int i = 0; i != 50; ++i )
+    {
+        const number_t        local_key  = random_private_key( random );
+        const public_key_t remote_key = public_key( random_private_key( random ) );
+
+        number_t expected;
+        BOOST_REQUIRE( uECC_shared_secret( reverse_halfs( remote_key ).data(), reverse_halfs( local_key ).data(), expected.data() ) );
+        expected = reverse_halfs( expected );
+
+        const number_t calculated = shared_secret( local_key, remote_key );
+
+        BOOST_CHECK_EQUAL_COLLECTIONS( calculated.begin(), calculated.end(), expected.begin(), expected.end() );
+    }
+}
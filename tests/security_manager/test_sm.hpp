@@ -1,8 +1,9 @@
 #ifndef BLUETOE_TESTS_SECURITY_MANAGER_TEST_SM_HPP
 #define BLUETOE_TESTS_SECURITY_MANAGER_TEST_SM_HPP
 
-#include "aes.h"
 #include "uECC.h"
+#include "lesc_test_vectors.hpp"
+#include <bluetoe/host_security_tool_box.hpp>
 #include <bluetoe/link_state.hpp>
 #include <bluetoe/security_manager.hpp>
 #include <bluetoe/address.hpp>
@@ -22,15 +23,7 @@ namespace test {
 
         bluetoe::details::uint128_t aes( bluetoe::details::uint128_t key, bluetoe::details::uint128_t data ) const
         {
-            key  = r( key );
-            data = r( data );
-
-            AES_ctx ctx;
-            AES_init_ctx( &ctx, &key[ 0 ] );
-
-            AES_ECB_encrypt( &ctx, &data[ 0 ] );
-
-            return r( data );
+            return bluetoe::host_details::aes_le( key, data );
         }
 
         bluetoe::details::uint128_t aes( bluetoe::details::uint128_t key, const std::uint8_t* data ) const
@@ -182,31 +175,7 @@ namespace test {
 
         std::pair< bluetoe::details::ecdh_public_key_t, bluetoe::details::ecdh_private_key_t > generate_keys()
         {
-            static const bluetoe::details::ecdh_public_key_t public_key = {
-                {
-                    // Public Key X
-                    0x90, 0xa1, 0xaa, 0x2f, 0xb2, 0x77, 0x90, 0x55,
-                    0x9f, 0xa6, 0x15, 0x86, 0xfd, 0x8a, 0xb5, 0x47,
-                    0x00, 0x4c, 0x9e, 0xf1, 0x84, 0x22, 0x59, 0x09,
-                    0x96, 0x1d, 0xaf, 0x1f, 0xf0, 0xf0, 0xa1, 0x1e,
-                    // Public Key Y
-                    0x4a, 0x21, 0xb1, 0x15, 0xf9, 0xaf, 0x89, 0x5f,
-                    0x76, 0x36, 0x8e, 0xe2, 0x30, 0x11, 0x2d, 0x47,
-                    0x60, 0x51, 0xb8, 0x9a, 0x3a, 0x70, 0x56, 0x73,
-                    0x37, 0xad, 0x9d, 0x42, 0x3e, 0xf3, 0x55, 0x4c
-                }
-            };
-
-            static const bluetoe::details::ecdh_private_key_t private_key = {
-                {
-                    0xfd, 0xc5, 0x7f, 0xf4, 0x49, 0xdd, 0x4f, 0x6b,
-                    0xfb, 0x7c, 0x9d, 0xf1, 0xc2, 0x9a, 0xcb, 0x59,
-                    0x2a, 0xe7, 0xd4, 0xee, 0xfb, 0xfc, 0x0a, 0x90,
-                    0x9a, 0xbb, 0xf6, 0x32, 0x3d, 0x8b, 0x18, 0x55
-                }
-            };
-
-            return { public_key, private_key };
+            return { lesc_vectors::public_b, lesc_vectors::private_b };
         }
 
         bluetoe::details::uint128_t left_shift(const bluetoe::details::uint128_t& input)
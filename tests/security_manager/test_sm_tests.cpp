@@ -265,58 +265,15 @@ BOOST_FIXTURE_TEST_CASE( f4_test, test::lesc_security_functions )
 
 BOOST_FIXTURE_TEST_CASE( p256_tests, test::lesc_security_functions )
 {
-    const bluetoe::details::ecdh_private_key_t Private_A = {{
-        0xbd, 0x1a, 0x3c, 0xcd, 0xa6, 0xb8, 0x99, 0x58,
-        0x99, 0xb7, 0x40, 0xeb, 0x7b, 0x60, 0xff, 0x4a,
-        0x50, 0x3f, 0x10, 0xd2, 0xe3, 0xb3, 0xc9, 0x74,
-        0x38, 0x5f, 0xc5, 0xa3, 0xd4, 0xf6, 0x49, 0x3f
-    }};
-
-    const bluetoe::details::ecdh_private_key_t Private_B = {{
-        0xfd, 0xc5, 0x7f, 0xf4, 0x49, 0xdd, 0x4f, 0x6b,
-        0xfb, 0x7c, 0x9d, 0xf1, 0xc2, 0x9a, 0xcb, 0x59,
-        0x2a, 0xe7, 0xd4, 0xee, 0xfb, 0xfc, 0x0a, 0x90,
-        0x9a, 0xbb, 0xf6, 0x32, 0x3d, 0x8b, 0x18, 0x55
-    }};
-
-    const bluetoe::details::ecdh_public_key_t Public_A = {{
-        0xe6, 0x9d, 0x35, 0x0e, 0x48, 0x01, 0x03, 0xcc,
-        0xdb, 0xfd, 0xf4, 0xac, 0x11, 0x91, 0xf4, 0xef,
-        0xb9, 0xa5, 0xf9, 0xe9, 0xa7, 0x83, 0x2c, 0x5e,
-        0x2c, 0xbe, 0x97, 0xf2, 0xd2, 0x03, 0xb0, 0x20,
-
-        0x8b, 0xd2, 0x89, 0x15, 0xd0, 0x8e, 0x1c, 0x74,
-        0x24, 0x30, 0xed, 0x8f, 0xc2, 0x45, 0x63, 0x76,
-        0x5c, 0x15, 0x52, 0x5a, 0xbf, 0x9a, 0x32, 0x63,
-        0x6d, 0xeb, 0x2a, 0x65, 0x49, 0x9c, 0x80, 0xdc
-    }};
-
-    const bluetoe::details::ecdh_public_key_t Public_B = {{
-        0x90, 0xa1, 0xaa, 0x2f, 0xb2, 0x77, 0x90, 0x55,
-        0x9f, 0xa6, 0x15, 0x86, 0xfd, 0x8a, 0xb5, 0x47,
-        0x00, 0x4c, 0x9e, 0xf1, 0x84, 0x22, 0x59, 0x09,
-        0x96, 0x1d, 0xaf, 0x1f, 0xf0, 0xf0, 0xa1, 0x1e,
-
-        0x4a, 0x21, 0xb1, 0x15, 0xf9, 0xaf, 0x89, 0x5f,
-        0x76, 0x36, 0x8e, 0xe2, 0x30, 0x11, 0x2d, 0x47,
-        0x60, 0x51, 0xb8, 0x9a, 0x3a, 0x70, 0x56, 0x73,
-        0x37, 0xad, 0x9d, 0x42, 0x3e, 0xf3, 0x55, 0x4c
-    }};
-
-    const bluetoe::details::ecdh_shared_secret_t DHKey = {{
-        0x98, 0xa6, 0xbf, 0x73, 0xf3, 0x34, 0x8d, 0x86,
-        0xf1, 0x66, 0xf8, 0xb4, 0x13, 0x6b, 0x79, 0x99,
-        0x9b, 0x7d, 0x39, 0x0a, 0xa6, 0x10, 0x10, 0x34,
-        0x05, 0xad, 0xc8, 0x57, 0xa3, 0x34, 0x02, 0xec
-    }};
+    using namespace test::lesc_vectors;
 
-    const auto shared_a = p256( Private_A.data(), Public_B.data() );
+    const auto shared_a = p256( private_a.data(), public_b.data() );
 
-    BOOST_CHECK_EQUAL_COLLECTIONS( DHKey.begin(), DHKey.end(), shared_a.begin(), shared_a.end() );
+    BOOST_CHECK_EQUAL_COLLECTIONS( dh_key.begin(), dh_key.end(), shared_a.begin(), shared_a.end() );
 
-    const auto shared_b = p256( Private_B.data(), Public_A.data() );
+    const auto shared_b = p256( private_b.data(), public_a.data() );
 
-    BOOST_CHECK_EQUAL_COLLECTIONS( DHKey.begin(), DHKey.end(), shared_b.begin(), shared_b.end() );
+    BOOST_CHECK_EQUAL_COLLECTIONS( dh_key.begin(), dh_key.end(), shared_b.begin(), shared_b.end() );
 }
 
 BOOST_FIXTURE_TEST_CASE( f5_test, test::lesc_security_functions )
@@ -6,6 +6,8 @@
 
 #include <bluetoe/server.hpp>
 #include <bootloader.hpp>
+#include <bootloader_compressor.hpp>
+#include <bootloader_delta_encoder.hpp>
 
 #define BOOST_TEST_MODULE
 #include <boost/test/included/unit_test.hpp>
@@ -1263,3 +1265,910 @@ BOOST_FIXTURE_TEST_CASE( write_page_without_command, all_discovered_and_subscrib
         0x00, 0x01, 0x02, 0x03 },
         0x12, data_char.value_handle, 0x80 );
 }
+
+/*
+ * Start Compressed Flash
+ */
+static constexpr std::size_t compression_window = 64;
+
+using compressed_bootloader_server = bluetoe::server<
+    bluetoe::bootloader_service<
+        bluetoe::bootloader::page_size< block_size >,
+        bluetoe::bootloader::handler< handler >,
+        bluetoe::bootloader::white_list<
+            bluetoe::bootloader::memory_region< flash_start_addr, flash_start_addr + num_blocks * block_size >
+        >,
+        bluetoe::bootloader::compressed_transfer< compression_window >
+    >
+>;
+
+static std::vector< std::uint8_t > firmware_image( std::size_t size )
+{
+    std::mt19937 random;
+    std::vector< std::uint8_t > result;
+
+    while ( result.size() < size )
+    {
+        const std::size_t kind   = random() % 4;
+        const std::size_t length = 32 + random() % 64;
+
+        for ( std::size_t i = 0; i != length; ++i )
+        {
+            if ( kind == 0 )
+                result.push_back( random() & 0xff );
+            else if ( kind == 1 )
+                result.push_back( 0xff );
+            else
+                result.push_back( static_cast< std::uint8_t >( i % ( kind * 3 ) ) );
+        }
+    }
+
+    result.resize( size );
+
+    return result;
+}
+
+template < class Server >
+struct streamed_flash : all_discovered_and_subscribed< Server >
+{
+    streamed_flash()
+        : flashes_ended( 0 )
+    {
+    }
+
+    void start_procedure( std::uint8_t opcode, std::initializer_list< std::uintptr_t > addresses )
+    {
+        std::vector< std::uint8_t > input = {
+            0x12, this->low( this->cp_char.value_handle ), this->high( this->cp_char.value_handle ),
+            opcode };
+
+        for ( const auto address : addresses )
+            this->add_ptr( input, address );
+
+        this->l2cap_input( input, this->connection );
+        this->expected_result( { 0x13 } );
+
+        std::uint8_t buffer[ test_mtu_size ];
+        std::size_t  size = sizeof( buffer );
+        this->l2cap_output( &buffer[ 0 ], size, this->connection );
+
+        BOOST_REQUIRE_EQUAL( size, 9u );
+        BOOST_CHECK_EQUAL( buffer[ 3 ], opcode );
+        BOOST_CHECK_EQUAL( buffer[ 4 ], test_mtu_size );
+        BOOST_CHECK_EQUAL( bluetoe::details::read_32bit( &buffer[ 5 ] ), this->checksum32( *addresses.begin() ) );
+    }
+
+    void write_to_data_char( const std::uint8_t* data, std::size_t size )
+    {
+        std::vector< std::uint8_t > input = {
+            0x12, this->low( this->data_char.value_handle ), this->high( this->data_char.value_handle )
+        };
+        input.insert( input.end(), data, data + size );
+
+        this->l2cap_input( input, this->connection );
+    }
+
+    std::size_t pending_flashs() const
+    {
+        return this->start_flash_content.size() / block_size - flashes_ended;
+    }
+
+    // end the oldest flash operation and return the checksum from the progress notification
+    std::uint32_t end_flash_and_receive_progress()
+    {
+        BOOST_REQUIRE( pending_flashs() );
+
+        end_flash( *this );
+        ++flashes_ended;
+
+        std::uint8_t buffer[ test_mtu_size ];
+        std::size_t  size = sizeof( buffer );
+        this->l2cap_output( &buffer[ 0 ], size, this->connection );
+
+        BOOST_REQUIRE_EQUAL( size, 10u );
+        BOOST_REQUIRE_EQUAL( buffer[ 0 ], 0x1b );
+        BOOST_REQUIRE_EQUAL( bluetoe::details::read_16bit( &buffer[ 1 ] ), this->progress_char.value_handle );
+
+        return bluetoe::details::read_32bit( &buffer[ 3 ] );
+    }
+
+    // writes the chunks, with the flow control of a client; returns the checksum of the last progress notification
+    std::uint32_t write_chunks( const std::vector< bluetoe::bootloader::compressed_chunk >& chunks, std::size_t write_size )
+    {
+        std::size_t   written  = 0;
+        std::size_t   freed    = 0;
+        std::uint32_t checksum = 0;
+
+        for ( const auto& chunk : chunks )
+        {
+            while ( written + chunk.decompressed_size > freed + 2 * block_size )
+            {
+                checksum = end_flash_and_receive_progress();
+                freed   += block_size;
+            }
+
+            for ( std::size_t pos = 0; pos < chunk.data.size(); pos += write_size )
+            {
+                write_to_data_char( &chunk.data[ pos ], std::min( write_size, chunk.data.size() - pos ) );
+                this->expected_result( { 0x13 } );
+            }
+
+            written += chunk.decompressed_size;
+        }
+
+        while ( pending_flashs() )
+            checksum = end_flash_and_receive_progress();
+
+        return checksum;
+    }
+
+    void flush_and_check( const std::vector< std::uint8_t >& image )
+    {
+        flush_and_check( flash_start_addr, image, this->original_device_memory );
+    }
+
+    // flushes the last page and checks that image was flashed to address and the rest of the memory is unchanged
+    void flush_and_check( std::uintptr_t address, const std::vector< std::uint8_t >& image, std::vector< std::uint8_t > expected_memory )
+    {
+        this->l2cap_input( {
+            0x12, this->low( this->cp_char.value_handle ), this->high( this->cp_char.value_handle ),
+            0x05 }, this->connection );
+
+        this->expected_result( { 0x13 } );
+
+        // checksum over the start address and the decompressed image
+        const std::uint32_t expected_checksum = this->checksum32( image.data(), image.size(), this->checksum32( address ) );
+
+        std::uint8_t buffer[ test_mtu_size ];
+        std::size_t  size = sizeof( buffer );
+        this->l2cap_output( &buffer[ 0 ], size, this->connection );
+
+        BOOST_REQUIRE_EQUAL( size, 10u );
+        BOOST_CHECK_EQUAL( buffer[ 3 ], 0x05 );
+        BOOST_CHECK_EQUAL( bluetoe::details::read_32bit( &buffer[ 4 ] ), expected_checksum );
+
+        BOOST_CHECK_EQUAL( end_flash_and_receive_progress(), expected_checksum );
+
+        std::copy( image.begin(), image.end(), expected_memory.begin() + ( address - flash_start_addr ) );
+
+        BOOST_CHECK_EQUAL_COLLECTIONS( expected_memory.begin(), expected_memory.end(), this->device_memory.begin(), this->device_memory.end() );
+    }
+
+    std::size_t flashes_ended;
+};
+
+BOOST_AUTO_TEST_SUITE( compressed_flash )
+
+    BOOST_AUTO_TEST_CASE( compress_and_decompress )
+    {
+        for ( std::size_t window : { 16, 64, 256 } )
+        {
+            const std::vector< std::uint8_t > image = firmware_image( 3000 );
+            const auto chunks = bluetoe::bootloader::compress( image.data(), image.size(), window, 20, block_size );
+
+            bluetoe::bootloader::details::stream_decompressor< 256 > decompressor;
+            std::vector< std::uint8_t > decompressed;
+            std::size_t compressed_size = 0;
+
+            auto sink = [&decompressed]( const std::uint8_t* data, std::size_t size ) -> bool
+            {
+                decompressed.insert( decompressed.end(), data, data + size );
+                return true;
+            };
+
+            for ( const auto& chunk : chunks )
+            {
+                BOOST_CHECK_LE( chunk.data.size(), 20u );
+                BOOST_CHECK_LE( chunk.decompressed_size, block_size );
+
+                const std::size_t expected_size = decompressed.size() + chunk.decompressed_size;
+                BOOST_CHECK( decompressor.decompress( chunk.data.data(), chunk.data.size(), sink ) );
+                BOOST_CHECK( decompressor.at_sequence_boundary() );
+                BOOST_CHECK_EQUAL( decompressed.size(), expected_size );
+
+                compressed_size += chunk.data.size();
+            }
+
+            BOOST_CHECK_LT( compressed_size, image.size() / 2 );
+            BOOST_CHECK_EQUAL_COLLECTIONS( image.begin(), image.end(), decompressed.begin(), decompressed.end() );
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE( incompressible_data )
+    {
+        std::mt19937 random;
+        std::vector< std::uint8_t > image;
+
+        for ( int i = 0; i != 1000; ++i )
+            image.push_back( random() & 0xff );
+
+        const auto chunks = bluetoe::bootloader::compress( image.data(), image.size(), compression_window, 20, block_size );
+
+        bluetoe::bootloader::details::stream_decompressor< compression_window > decompressor;
+        std::vector< std::uint8_t > decompressed;
+
+        auto sink = [&decompressed]( const std::uint8_t* data, std::size_t size ) -> bool
+        {
+            decompressed.insert( decompressed.end(), data, data + size );
+            return true;
+        };
+
+        for ( const auto& chunk : chunks )
+            BOOST_CHECK( decompressor.decompress( chunk.data.data(), chunk.data.size(), sink ) );
+
+        BOOST_CHECK_EQUAL_COLLECTIONS( image.begin(), image.end(), decompressed.begin(), decompressed.end() );
+    }
+
+    BOOST_AUTO_TEST_CASE( back_reference_out_of_the_window )
+    {
+        bluetoe::bootloader::details::stream_decompressor< 16 > decompressor;
+        auto sink = []( const std::uint8_t*, std::size_t ) -> bool { return true; };
+
+        std::vector< std::uint8_t > stream = { 0xf0, 2 };
+        stream.resize( stream.size() + 17, 0x42 );
+        stream.insert( stream.end(), { 0x00, 0x00, 0x00, 17, 0x00 } );
+
+        BOOST_CHECK( !decompressor.decompress( stream.data(), stream.size(), sink ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( back_reference_before_start_of_stream )
+    {
+        bluetoe::bootloader::details::stream_decompressor< 16 > decompressor;
+        auto sink = []( const std::uint8_t*, std::size_t ) -> bool { return true; };
+
+        const std::uint8_t stream[] = { 0x20, 0x01, 0x02, 0x03, 0x00 };
+
+        BOOST_CHECK( !decompressor.decompress( stream, sizeof( stream ), sink ) );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( not_supported_by_default, all_discovered_and_subscribed< bootloader_server > )
+    {
+        std::vector< std::uint8_t > input = {
+            0x12, low( cp_char.value_handle ), high( cp_char.value_handle ),
+            0x09 };
+
+        add_ptr( input, flash_start_addr );
+
+        l2cap_input( input, connection );
+        BOOST_CHECK_EQUAL( response_size, 5u );
+        BOOST_CHECK_EQUAL( response[ 0 ], 0x01 );
+        BOOST_CHECK_EQUAL( response[ 4 ], 0x81 );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( get_sizes_reports_window, all_discovered_and_subscribed< compressed_bootloader_server > )
+    {
+        l2cap_input( {
+            0x12, low( cp_char.value_handle ), high( cp_char.value_handle ),
+            0x02 }, connection );
+
+        expected_result( { 0x13 } );
+
+        expected_output( notification, {
+            0x1b, low( cp_char.value_handle ), high( cp_char.value_handle ),    // notification
+            0x02,                                                               // response code
+            sizeof(std::uint8_t*),                                              // Address size
+            block_size & 0xff, block_size >> 8, 0, 0,                           // Size of a Page
+            0x02, 0, 0, 0,                                                      // Number of pages the bootloader can buffer
+            compression_window, 0, 0, 0                                         // Compression Window
+        } );
+    }
+
+    struct start_compressed_flash : streamed_flash< compressed_bootloader_server >
+    {
+        start_compressed_flash()
+        {
+            start_procedure( 0x09, { flash_start_addr } );
+        }
+    };
+
+    BOOST_FIXTURE_TEST_CASE( flash_compressed_image, start_compressed_flash )
+    {
+        const std::vector< std::uint8_t > image = firmware_image( 1000 );
+        const auto chunks = bluetoe::bootloader::compress( image.data(), image.size(), compression_window, test_mtu_size - 3, block_size );
+
+        const std::uint32_t checksum = write_chunks( chunks, test_mtu_size - 3 );
+
+        // the progress notifications carry the checksum over the decompressed image
+        BOOST_CHECK_EQUAL( checksum, checksum32( image.data(), 3 * block_size, checksum32( flash_start_addr ) ) );
+
+        flush_and_check( image );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( flash_compressed_image_byte_by_byte, start_compressed_flash )
+    {
+        const std::vector< std::uint8_t > image = firmware_image( 1000 );
+        const auto chunks = bluetoe::bootloader::compress( image.data(), image.size(), compression_window, test_mtu_size - 3, block_size );
+
+        write_chunks( chunks, 1 );
+        flush_and_check( image );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( flush_in_the_middle_of_a_sequence, start_compressed_flash )
+    {
+        const std::uint8_t partial_sequence[] = { 0x30, 0x01, 0x02, 0x03, 0x00 };
+        write_to_data_char( partial_sequence, sizeof( partial_sequence ) );
+        expected_result( { 0x13 } );
+
+        check_error_response( {
+            0x12, low( cp_char.value_handle ), high( cp_char.value_handle ),
+            0x05 },
+            0x12, cp_char.value_handle, 0x82 );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( malformed_stream, start_compressed_flash )
+    {
+        // match without preceding data
+        check_error_response( {
+            0x12, low( data_char.value_handle ), high( data_char.value_handle ),
+            0x00, 0x01, 0x00 },
+            0x12, data_char.value_handle, 0x84 );
+
+        // flash mode left
+        check_error_response( {
+            0x12, low( data_char.value_handle ), high( data_char.value_handle ),
+            0x10, 0x01, 0x00, 0x00 },
+            0x12, data_char.value_handle, 0x80 );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( buffer_overrun, start_compressed_flash )
+    {
+        // one literal and a match of 512 bytes: 2 pages and one byte of 0x42
+        const std::uint8_t stream[] = { 0x1f, 0x42, 0x01, 0x00, 0xff, 0xee };
+
+        check_error_response( {
+            0x12, low( data_char.value_handle ), high( data_char.value_handle ),
+            stream[ 0 ], stream[ 1 ], stream[ 2 ], stream[ 3 ], stream[ 4 ], stream[ 5 ] },
+            0x12, data_char.value_handle, 0x83 );
+
+        // flash mode left, as the decompressor can not resume
+        check_error_response( {
+            0x12, low( data_char.value_handle ), high( data_char.value_handle ),
+            0x10, 0x01, 0x00, 0x00 },
+            0x12, data_char.value_handle, 0x80 );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/*
+ * Start Patch
+ */
+using patch_bootloader_server = bluetoe::server<
+    bluetoe::bootloader_service<
+        bluetoe::bootloader::page_size< block_size >,
+        bluetoe::bootloader::handler< handler >,
+        bluetoe::bootloader::white_list<
+            bluetoe::bootloader::memory_region< flash_start_addr, flash_start_addr + num_blocks * block_size >
+        >,
+        bluetoe::bootloader::delta_update
+    >
+>;
+
+static constexpr std::uintptr_t scratch_start = flash_start_addr + 2 * block_size;
+static constexpr std::uintptr_t scratch_end   = flash_start_addr + 4 * block_size;
+
+struct scratch_handler : handler
+{
+    std::pair< std::uintptr_t, std::uintptr_t > scratch_region()
+    {
+        return { scratch_start, scratch_end };
+    }
+};
+
+using scratch_bootloader_server = bluetoe::server<
+    bluetoe::bootloader_service<
+        bluetoe::bootloader::page_size< block_size >,
+        bluetoe::bootloader::handler< scratch_handler >,
+        bluetoe::bootloader::white_list<
+            bluetoe::bootloader::memory_region< flash_start_addr, scratch_start >
+        >,
+        bluetoe::bootloader::delta_update
+    >
+>;
+
+// a new version of old, with changed, inserted and removed bytes
+static std::vector< std::uint8_t > modified_image( const std::vector< std::uint8_t >& old, std::size_t size )
+{
+    std::vector< std::uint8_t > result( old.begin(), old.begin() + 100 );
+
+    for ( std::size_t i = 100; i != 200; ++i )
+        result.push_back( i % 10 == 0 ? old[ i ] ^ 0x55 : old[ i ] );
+
+    for ( std::uint8_t i = 0; i != 20; ++i )
+        result.push_back( 0xa0 + i );
+
+    result.insert( result.end(), old.begin() + 230, old.end() );
+    result.resize( size );
+
+    return result;
+}
+
+static std::size_t patch_size( const std::vector< bluetoe::bootloader::compressed_chunk >& chunks )
+{
+    std::size_t result = 0;
+
+    for ( const auto& chunk : chunks )
+        result += chunk.data.size();
+
+    return result;
+}
+
+BOOST_AUTO_TEST_SUITE( patch_procedure )
+
+    BOOST_AUTO_TEST_CASE( encode_and_apply )
+    {
+        const std::vector< std::uint8_t > old_image = firmware_image( 3000 );
+        const std::vector< std::uint8_t > new_image = modified_image( old_image, 2990 );
+
+        const auto chunks = bluetoe::bootloader::delta_encode( old_image.data(), old_image.size(), new_image.data(), new_image.size(), 20, block_size, 0 );
+
+        bluetoe::bootloader::details::patch_decoder decoder;
+        decoder.reset( old_image.size() );
+
+        std::vector< std::uint8_t > result;
+
+        auto source = [&old_image]( std::size_t offset, std::size_t size, std::uint8_t* output ) -> bool
+        {
+            std::copy( &old_image.at( offset ), &old_image.at( offset + size - 1 ) + 1, output );
+            return true;
+        };
+
+        auto sink = [&result]( const std::uint8_t* data, std::size_t size ) -> bool
+        {
+            result.insert( result.end(), data, data + size );
+            return true;
+        };
+
+        for ( const auto& chunk : chunks )
+        {
+            BOOST_CHECK_LE( chunk.data.size(), 20u );
+            BOOST_CHECK_LE( chunk.decompressed_size, block_size );
+
+            const std::size_t expected_size = result.size() + chunk.decompressed_size;
+            BOOST_CHECK( decoder.apply( chunk.data.data(), chunk.data.size(), source, sink ) );
+            BOOST_CHECK( decoder.at_sequence_boundary() );
+            BOOST_CHECK_EQUAL( result.size(), expected_size );
+        }
+
+        BOOST_CHECK_LT( patch_size( chunks ), new_image.size() / 10 );
+        BOOST_CHECK_EQUAL_COLLECTIONS( new_image.begin(), new_image.end(), result.begin(), result.end() );
+    }
+
+    BOOST_AUTO_TEST_CASE( copy_beyond_old_image )
+    {
+        bluetoe::bootloader::details::patch_decoder decoder;
+        decoder.reset( 16 );
+
+        auto source = []( std::size_t, std::size_t, std::uint8_t* ) -> bool { return true; };
+        auto sink   = []( const std::uint8_t*, std::size_t ) -> bool { return true; };
+
+        // copy 16 bytes from offset 1
+        const std::uint8_t patch[] = { 0x21, 0x02 };
+
+        BOOST_CHECK( !decoder.apply( patch, sizeof( patch ), source, sink ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( copy_before_old_image )
+    {
+        bluetoe::bootloader::details::patch_decoder decoder;
+        decoder.reset( 16 );
+
+        auto source = []( std::size_t, std::size_t, std::uint8_t* ) -> bool { return true; };
+        auto sink   = []( const std::uint8_t*, std::size_t ) -> bool { return true; };
+
+        // copy 4 bytes from offset -1
+        const std::uint8_t patch[] = { 0x09, 0x01 };
+
+        BOOST_CHECK( !decoder.apply( patch, sizeof( patch ), source, sink ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( operation_without_length )
+    {
+        bluetoe::bootloader::details::patch_decoder decoder;
+        decoder.reset( 16 );
+
+        auto source = []( std::size_t, std::size_t, std::uint8_t* ) -> bool { return true; };
+        auto sink   = []( const std::uint8_t*, std::size_t ) -> bool { return true; };
+
+        const std::uint8_t patch[] = { 0x00 };
+
+        BOOST_CHECK( !decoder.apply( patch, sizeof( patch ), source, sink ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( oversized_header )
+    {
+        bluetoe::bootloader::details::patch_decoder decoder;
+        decoder.reset( 16 );
+
+        auto source = []( std::size_t, std::size_t, std::uint8_t* ) -> bool { return true; };
+        auto sink   = []( const std::uint8_t*, std::size_t ) -> bool { return true; };
+
+        // the 5th byte of a LEB128 encoded 32 bit value must not have more than 4 significant bits
+        const std::uint8_t largest[]   = { 0x82, 0x80, 0x80, 0x80, 0x0f };
+        const std::uint8_t too_large[] = { 0x82, 0x80, 0x80, 0x80, 0x10 };
+        const std::uint8_t too_long[]  = { 0x82, 0x80, 0x80, 0x80, 0x80, 0x00 };
+
+        BOOST_CHECK( decoder.apply( largest, sizeof( largest ), source, sink ) );
+
+        decoder.reset( 16 );
+        BOOST_CHECK( !decoder.apply( too_large, sizeof( too_large ), source, sink ) );
+
+        decoder.reset( 16 );
+        BOOST_CHECK( !decoder.apply( too_long, sizeof( too_long ), source, sink ) );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( not_supported_by_default, all_discovered_and_subscribed< bootloader_server > )
+    {
+        std::vector< std::uint8_t > input = {
+            0x12, low( cp_char.value_handle ), high( cp_char.value_handle ),
+            0x0a };
+
+        add_ptr( input, flash_start_addr );
+        add_ptr( input, flash_start_addr );
+        add_ptr( input, flash_start_addr + block_size );
+
+        l2cap_input( input, connection );
+        BOOST_CHECK_EQUAL( response_size, 5u );
+        BOOST_CHECK_EQUAL( response[ 0 ], 0x01 );
+        BOOST_CHECK_EQUAL( response[ 4 ], 0x81 );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( source_out_of_range, all_discovered_and_subscribed< patch_bootloader_server > )
+    {
+        std::vector< std::uint8_t > input = {
+            0x12, low( cp_char.value_handle ), high( cp_char.value_handle ),
+            0x0a };
+
+        add_ptr( input, flash_start_addr );
+        add_ptr( input, flash_start_addr );
+        add_ptr( input, flash_start_addr + num_blocks * block_size + 1 );
+
+        l2cap_input( input, connection );
+        BOOST_CHECK_EQUAL( response_size, 5u );
+        BOOST_CHECK_EQUAL( response[ 0 ], 0x01 );
+        BOOST_CHECK_EQUAL( response[ 4 ], bluetoe::error_codes::invalid_offset );
+    }
+
+    struct old_image_flashed : streamed_flash< patch_bootloader_server >
+    {
+        old_image_flashed()
+            : old_image( firmware_image( num_blocks * block_size ) )
+        {
+            device_memory = old_image;
+        }
+
+        const std::vector< std::uint8_t > old_image;
+    };
+
+    BOOST_FIXTURE_TEST_CASE( patch_in_place, old_image_flashed )
+    {
+        const std::vector< std::uint8_t > new_image = modified_image( old_image, 1000 );
+        const auto chunks = bluetoe::bootloader::delta_encode( old_image.data(), old_image.size(), new_image.data(), new_image.size(),
+            test_mtu_size - 3, block_size, block_size );
+
+        BOOST_CHECK_LT( patch_size( chunks ), new_image.size() / 4 );
+
+        start_procedure( 0x0a, { flash_start_addr, flash_start_addr, flash_start_addr + old_image.size() } );
+        write_chunks( chunks, test_mtu_size - 3 );
+        flush_and_check( flash_start_addr, new_image, old_image );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( patch_in_place_byte_by_byte, old_image_flashed )
+    {
+        const std::vector< std::uint8_t > new_image = modified_image( old_image, 1000 );
+        const auto chunks = bluetoe::bootloader::delta_encode( old_image.data(), old_image.size(), new_image.data(), new_image.size(),
+            test_mtu_size - 3, block_size, block_size );
+
+        start_procedure( 0x0a, { flash_start_addr, flash_start_addr, flash_start_addr + old_image.size() } );
+        write_chunks( chunks, 1 );
+        flush_and_check( flash_start_addr, new_image, old_image );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( copy_from_overwritten_page, old_image_flashed )
+    {
+        start_procedure( 0x0a, { flash_start_addr, flash_start_addr, flash_start_addr + old_image.size() } );
+
+        // insert a full page
+        std::vector< std::uint8_t > patch = { 0x80, 0x04 };
+        patch.insert( patch.end(), block_size, 0x42 );
+
+        for ( std::size_t pos = 0; pos < patch.size(); pos += 20 )
+        {
+            write_to_data_char( &patch[ pos ], std::min< std::size_t >( 20, patch.size() - pos ) );
+            expected_result( { 0x13 } );
+        }
+
+        // copy 4 bytes from the start of the old image, which is already overwritten
+        check_error_response( {
+            0x12, low( data_char.value_handle ), high( data_char.value_handle ),
+            0x09, 0x00 },
+            0x12, data_char.value_handle, 0x85 );
+
+        // flash mode left
+        check_error_response( {
+            0x12, low( data_char.value_handle ), high( data_char.value_handle ),
+            0x02, 0x42 },
+            0x12, data_char.value_handle, 0x80 );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( buffer_overrun_ends_patch, old_image_flashed )
+    {
+        start_procedure( 0x0a, { flash_start_addr, flash_start_addr, flash_start_addr + old_image.size() } );
+
+        // insert 2 pages and one byte, without waiting for the pages to be flashed
+        std::vector< std::uint8_t > patch = { 0x82, 0x08 };
+        patch.insert( patch.end(), 2 * block_size + 1, 0x42 );
+
+        for ( std::size_t pos = 0; pos < patch.size(); pos += 20 )
+        {
+            std::vector< std::uint8_t > request = { 0x12, low( data_char.value_handle ), high( data_char.value_handle ) };
+            request.insert( request.end(), &patch[ pos ], &patch[ std::min< std::size_t >( pos + 20, patch.size() ) ] );
+
+            l2cap_input( request, connection );
+
+            if ( response[ 0 ] != 0x13 )
+                break;
+        }
+
+        BOOST_REQUIRE_EQUAL( response_size, 5u );
+        BOOST_CHECK_EQUAL( response[ 0 ], 0x01 );
+        BOOST_CHECK_EQUAL( response[ 4 ], 0x83 );
+
+        // flash mode left, as the patch decoder can not resume
+        check_error_response( {
+            0x12, low( data_char.value_handle ), high( data_char.value_handle ),
+            0x02, 0x42 },
+            0x12, data_char.value_handle, 0x80 );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( flush_in_the_middle_of_an_operation, old_image_flashed )
+    {
+        start_procedure( 0x0a, { flash_start_addr, flash_start_addr, flash_start_addr + old_image.size() } );
+
+        // insert 4 bytes, but only 2 are written
+        const std::uint8_t partial_operation[] = { 0x08, 0x01, 0x02 };
+        write_to_data_char( partial_operation, sizeof( partial_operation ) );
+        expected_result( { 0x13 } );
+
+        check_error_response( {
+            0x12, low( cp_char.value_handle ), high( cp_char.value_handle ),
+            0x05 },
+            0x12, cp_char.value_handle, 0x82 );
+    }
+
+    struct old_image_in_front_of_scratch : streamed_flash< scratch_bootloader_server >
+    {
+        old_image_in_front_of_scratch()
+            : old_image( firmware_image( 2 * block_size ) )
+        {
+            std::copy( old_image.begin(), old_image.end(), device_memory.begin() );
+        }
+
+        const std::vector< std::uint8_t > old_image;
+    };
+
+    BOOST_FIXTURE_TEST_CASE( patch_via_scratch_region, old_image_in_front_of_scratch )
+    {
+        const std::vector< std::uint8_t > new_image = modified_image( old_image, 500 );
+
+        // reconstruct the new image in the scratch region
+        std::vector< std::uint8_t > memory = device_memory;
+        start_procedure( 0x0a, { scratch_start, flash_start_addr, flash_start_addr + old_image.size() } );
+        write_chunks( bluetoe::bootloader::delta_encode( old_image.data(), old_image.size(), new_image.data(), new_image.size(),
+            test_mtu_size - 3, block_size, 0 ), test_mtu_size - 3 );
+        flush_and_check( scratch_start, new_image, memory );
+
+        // the scratch region can be checked with Get CRC
+        std::vector< std::uint8_t > get_crc = {
+            0x12, low( cp_char.value_handle ), high( cp_char.value_handle ),
+            0x01 };
+
+        add_ptr( get_crc, scratch_start );
+        add_ptr( get_crc, scratch_start + new_image.size() );
+        l2cap_input( get_crc, connection );
+        expected_result( { 0x13 } );
+
+        std::uint8_t buffer[ test_mtu_size ];
+        std::size_t  size = sizeof( buffer );
+        l2cap_output( &buffer[ 0 ], size, connection );
+
+        BOOST_REQUIRE_EQUAL( size, 8u );
+        BOOST_CHECK_EQUAL( bluetoe::details::read_32bit( &buffer[ 4 ] ), checksum32( new_image.data(), new_image.size(), 0 ) );
+
+        // copy the new image to its final location
+        memory = device_memory;
+        start_procedure( 0x0a, { flash_start_addr, scratch_start, scratch_start + new_image.size() } );
+        write_chunks( bluetoe::bootloader::delta_encode( new_image.data(), new_image.size(), new_image.data(), new_image.size(),
+            test_mtu_size - 3, block_size, 0 ), test_mtu_size - 3 );
+        flush_and_check( flash_start_addr, new_image, memory );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( scratch_region_can_not_be_flashed_directly, old_image_in_front_of_scratch )
+    {
+        std::vector< std::uint8_t > input = {
+            0x12, low( cp_char.value_handle ), high( cp_char.value_handle ),
+            0x03 };
+
+        add_ptr( input, scratch_start + block_size );
+
+        l2cap_input( input, connection );
+        BOOST_CHECK_EQUAL( response_size, 5u );
+        BOOST_CHECK_EQUAL( response[ 0 ], 0x01 );
+        BOOST_CHECK_EQUAL( response[ 4 ], bluetoe::error_codes::invalid_offset );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( page_checksums_procedure )
+
+    struct resume_update : streamed_flash< bootloader_server >
+    {
+        resume_update()
+            : image( firmware_image( num_blocks * block_size ) )
+        {
+        }
+
+        // executes the Get Page Checksums procedure and returns the indicated checksums
+        std::vector< std::uint32_t > page_checksums( std::uintptr_t start, std::uintptr_t end )
+        {
+            std::vector< std::uint8_t > input = {
+                0x12, low( cp_char.value_handle ), high( cp_char.value_handle ),
+                0x0b };
+
+            add_ptr( input, start );
+            add_ptr( input, end );
+
+            l2cap_input( input, connection );
+            expected_result( { 0x13 } );
+
+            std::vector< std::uint32_t > result;
+            std::uint8_t buffer[ test_mtu_size ];
+
+            while ( data_indication_requested() )
+            {
+                bootloader_data_indication( *this );
+
+                std::size_t size = sizeof( buffer );
+                l2cap_output( &buffer[ 0 ], size, connection );
+
+                BOOST_REQUIRE_EQUAL( buffer[ 0 ], 0x1d );
+                BOOST_REQUIRE_EQUAL( bluetoe::details::read_16bit( &buffer[ 1 ] ), data_char.value_handle );
+                BOOST_REQUIRE_EQUAL( ( size - 3 ) % 4, 0u );
+
+                for ( std::size_t pos = 3; pos != size; pos += 4 )
+                    result.push_back( bluetoe::details::read_32bit( &buffer[ pos ] ) );
+
+                connection.indication_confirmed();
+            }
+
+            // an empty range is answered without indications
+            if ( !result.empty() )
+            {
+                BOOST_REQUIRE( control_point_notification_requested() );
+                bootloader_control_point_notification( *this );
+            }
+
+            std::size_t size = sizeof( buffer );
+            l2cap_output( &buffer[ 0 ], size, connection );
+
+            BOOST_REQUIRE_EQUAL( size, 8u );
+            BOOST_CHECK_EQUAL( buffer[ 0 ], 0x1b );
+            BOOST_CHECK_EQUAL( buffer[ 3 ], 0x0b );
+            BOOST_CHECK_EQUAL( bluetoe::details::read_32bit( &buffer[ 4 ] ), result.size() );
+
+            return result;
+        }
+
+        // the checksums of the pages of the image at flash_start_addr, that a client would calculate
+        std::vector< std::uint32_t > image_checksums()
+        {
+            std::vector< std::uint32_t > result;
+
+            for ( std::size_t page = 0; page != num_blocks; ++page )
+                result.push_back( checksum32( &image[ page * block_size ], block_size, 0 ) );
+
+            return result;
+        }
+
+        void flash_page( std::size_t page )
+        {
+            start_procedure( 0x03, { flash_start_addr + page * block_size } );
+
+            for ( std::size_t pos = 0; pos < block_size; pos += test_mtu_size - 3 )
+            {
+                write_to_data_char( &image[ page * block_size + pos ], std::min( test_mtu_size - 3, block_size - pos ) );
+                expected_result( { 0x13 } );
+            }
+
+            end_flash_and_receive_progress();
+        }
+
+        const std::vector< std::uint8_t > image;
+    };
+
+    BOOST_FIXTURE_TEST_CASE( checksum_for_every_page, resume_update )
+    {
+        const std::vector< std::uint32_t > checksums = page_checksums( flash_start_addr, flash_start_addr + num_blocks * block_size );
+
+        BOOST_REQUIRE_EQUAL( checksums.size(), num_blocks );
+
+        for ( std::size_t page = 0; page != num_blocks; ++page )
+            BOOST_CHECK_EQUAL( checksums[ page ], checksum32( flash_start_addr + page * block_size, block_size ) );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( first_and_last_page_are_clipped_to_the_range, resume_update )
+    {
+        const std::vector< std::uint32_t > checksums = page_checksums( flash_start_addr + 0x80, flash_start_addr + 0x310 );
+
+        BOOST_REQUIRE_EQUAL( checksums.size(), 4u );
+        BOOST_CHECK_EQUAL( checksums[ 0 ], checksum32( flash_start_addr + 0x80, 0x80 ) );
+        BOOST_CHECK_EQUAL( checksums[ 1 ], checksum32( flash_start_addr + 0x100, 0x100 ) );
+        BOOST_CHECK_EQUAL( checksums[ 2 ], checksum32( flash_start_addr + 0x200, 0x100 ) );
+        BOOST_CHECK_EQUAL( checksums[ 3 ], checksum32( flash_start_addr + 0x300, 0x10 ) );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( empty_range, resume_update )
+    {
+        BOOST_CHECK( page_checksums( flash_start_addr + 0x80, flash_start_addr + 0x80 ).empty() );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( public_checksum_is_used, resume_update )
+    {
+        report_fixed_public_crc( 0x12345678 );
+
+        const std::vector< std::uint32_t > checksums = page_checksums( flash_start_addr, flash_start_addr + 2 * block_size );
+
+        BOOST_REQUIRE_EQUAL( checksums.size(), 2u );
+        BOOST_CHECK_EQUAL( checksums[ 0 ], 0x12345678u );
+        BOOST_CHECK_EQUAL( checksums[ 1 ], 0x12345678u );
+    }
+
+    BOOST_FIXTURE_TEST_CASE( range_out_of_white_list, resume_update )
+    {
+        std::vector< std::uint8_t > input = {
+            0x12, low( cp_char.value_handle ), high( cp_char.value_handle ),
+            0x0b };
+
+        add_ptr( input, flash_start_addr );
+        add_ptr( input, flash_start_addr + num_blocks * block_size + 1 );
+
+        l2cap_input( input, connection );
+        BOOST_CHECK_EQUAL( response_size, 5u );
+        BOOST_CHECK_EQUAL( response[ 0 ], 0x01 );
+        BOOST_CHECK_EQUAL( response[ 4 ], bluetoe::error_codes::invalid_offset );
+    }
+
+    /*
+     * The connection dropped after the first page was flashed and while the second page was written.
+     * After reconnecting, the client resends only the pages, that differ.
+     */
+    BOOST_FIXTURE_TEST_CASE( resume_interrupted_update, resume_update )
+    {
+        std::copy( image.begin(), image.begin() + block_size, device_memory.begin() );
+        std::copy( image.begin() + block_size, image.begin() + block_size + 0x40, device_memory.begin() + block_size );
+        std::copy( image.begin() + 3 * block_size, image.end(), device_memory.begin() + 3 * block_size );
+
+        const std::vector< std::uint32_t > expected  = image_checksums();
+        const std::vector< std::uint32_t > checksums = page_checksums( flash_start_addr, flash_start_addr + image.size() );
+
+        BOOST_REQUIRE_EQUAL( checksums.size(), expected.size() );
+
+        std::vector< std::size_t > resent;
+
+        for ( std::size_t page = 0; page != checksums.size(); ++page )
+        {
+            if ( checksums[ page ] != expected[ page ] )
+            {
+                flash_page( page );
+                resent.push_back( page );
+            }
+        }
+
+        const std::vector< std::size_t > expected_resent = { 1, 2 };
+        BOOST_CHECK_EQUAL_COLLECTIONS( resent.begin(), resent.end(), expected_resent.begin(), expected_resent.end() );
+        BOOST_CHECK_EQUAL_COLLECTIONS( image.begin(), image.end(), device_memory.begin(), device_memory.end() );
+
+        const std::vector< std::uint32_t > after = page_checksums( flash_start_addr, flash_start_addr + image.size() );
+        BOOST_CHECK_EQUAL_COLLECTIONS( after.begin(), after.end(), expected.begin(), expected.end() );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
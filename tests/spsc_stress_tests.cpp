@@ -0,0 +1,149 @@
+#include <bluetoe/ring.hpp>
+#include <bluetoe/ring_buffer.hpp>
+#include <bluetoe/seqlock_value.hpp>
+
+#define BOOST_TEST_MODULE
+#include <boost/test/included/unit_test.hpp>
+
+#include <atomic>
+#include <thread>
+
+/*
+ * Producer and consumer are running in different threads. To find data races, these tests are
+ * build with the ThreadSanitizer.
+ */
+namespace {
+#   if defined( BLUETOE_EXCLUDE_SLOW_TESTS )
+        constexpr unsigned number_of_elements = 10000;
+#   else
+        constexpr unsigned number_of_elements = 200000;
+#   endif
+}
+
+BOOST_AUTO_TEST_CASE( ring_transfers_all_elements_in_order )
+{
+    bluetoe::details::ring< 7u, unsigned > ring;
+    bool in_order = true;
+
+    std::thread consumer( [ &ring, &in_order ]{
+        for ( unsigned expected = 0; expected != number_of_elements; )
+        {
+            unsigned value;
+
+            if ( ring.try_pop( value ) )
+            {
+                in_order = in_order && value == expected;
+                ++expected;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    } );
+
+    for ( unsigned value = 0; value != number_of_elements; )
+    {
+        if ( ring.try_push( value ) )
+            ++value;
+        else
+            std::this_thread::yield();
+    }
+
+    consumer.join();
+
+    BOOST_CHECK( in_order );
+}
+
+BOOST_AUTO_TEST_CASE( pdu_ring_transfers_all_pdus_in_order )
+{
+    static constexpr std::size_t ring_size = 100;
+
+    std::uint8_t buffer[ ring_size ];
+    bluetoe::link_layer::spsc_pdu_ring_buffer< ring_size > ring( &buffer[ 0 ] );
+
+    bool in_order = true;
+
+    // the consumer checks, that every PDU is filled with the lower 8 bits of its sequence number
+    std::thread consumer( [ &ring, &buffer, &in_order ]{
+        for ( unsigned expected = 0; expected != number_of_elements; )
+        {
+            const auto pdu = ring.next_end();
+
+            if ( pdu.size == 0 )
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            in_order = in_order && pdu.size == 2u + pdu.buffer[ 1 ];
+
+            for ( std::size_t i = 2; i != pdu.size; ++i )
+                in_order = in_order && pdu.buffer[ i ] == static_cast< std::uint8_t >( expected );
+
+            ring.pop_end( &buffer[ 0 ] );
+            ++expected;
+        }
+    } );
+
+    for ( unsigned value = 0; value != number_of_elements; )
+    {
+        // sizes from 3 to 40 bytes
+        const std::size_t size = 3 + value % 38;
+        const auto pdu = ring.alloc_front( &buffer[ 0 ], size );
+
+        if ( pdu.size == 0 )
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        pdu.buffer[ 0 ] = 0x02;
+        pdu.buffer[ 1 ] = static_cast< std::uint8_t >( size - 2 );
+        std::fill( &pdu.buffer[ 2 ], &pdu.buffer[ size ], static_cast< std::uint8_t >( value ) );
+
+        ring.push_front( &buffer[ 0 ], pdu );
+        ++value;
+    }
+
+    consumer.join();
+
+    BOOST_CHECK( in_order );
+}
+
+BOOST_AUTO_TEST_CASE( seqlock_value_is_never_observed_torn )
+{
+    struct sample {
+        std::uint32_t values[ 4 ];
+    };
+
+    bluetoe::seqlock_value< sample > value;
+    std::atomic< bool > done( false );
+    bool consistent = true;
+    unsigned distinct_values = 0;
+
+    // the reader checks, that all members of the sample stem from the same update
+    std::thread reader( [ &value, &done, &consistent, &distinct_values ]{
+        std::uint32_t last = 0;
+
+        while ( !done )
+        {
+            const sample s = value.load();
+            consistent = consistent && s.values[ 0 ] == s.values[ 1 ] && s.values[ 0 ] == s.values[ 2 ] && s.values[ 0 ] == s.values[ 3 ];
+
+            if ( s.values[ 0 ] != last )
+                ++distinct_values;
+
+            last = s.values[ 0 ];
+        }
+    } );
+
+    for ( std::uint32_t update = 1; update != number_of_elements; ++update )
+        value.store( sample{ { update, update, update, update } } );
+
+    done = true;
+    reader.join();
+
+    BOOST_CHECK( consistent );
+    BOOST_TEST_MESSAGE( distinct_values << " distinct values observed" );
+}
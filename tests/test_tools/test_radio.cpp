@@ -280,6 +280,7 @@ namespace test {
         , receiving_encoding_( bluetoe::link_layer::phy_ll_encoding::le_1m_phy )
         , transmiting_encoding_( bluetoe::link_layer::phy_ll_encoding::le_1m_phy )
         , eos_( bluetoe::link_layer::delta_time::seconds( 10 ) )
+        , missed_connection_events_( 0 )
     {
     }
 
@@ -709,6 +710,26 @@ namespace test {
         eos_ = eos;
     }
 
+    void radio_base::cpu_load( bluetoe::link_layer::delta_time load )
+    {
+        cpu_load_ += load;
+    }
+
+    void radio_base::connection_event_processing_time( bluetoe::link_layer::delta_time processing_time )
+    {
+        processing_time_ = processing_time;
+    }
+
+    bluetoe::link_layer::delta_time radio_base::time_since_anchor() const
+    {
+        return processing_time_ + cpu_load_;
+    }
+
+    unsigned radio_base::missed_connection_events() const
+    {
+        return missed_connection_events_;
+    }
+
 
     radio_base::lock_guard::lock_guard()
     {
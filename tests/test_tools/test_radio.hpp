@@ -309,6 +309,33 @@ namespace test {
 
         void end_of_simulation( bluetoe::link_layer::delta_time );
 
+        /**
+         * @brief simulates CPU load of the given duration after the current connection event
+         *
+         * If the load, that was added since the last connection event, does not end before the setup of the
+         * next connection event, the next connection event is counted as missed.
+         */
+        void cpu_load( bluetoe::link_layer::delta_time load );
+
+        /**
+         * @brief simulated CPU time, the link layer needs to handle a connection event
+         *
+         * By default, a connection event is handled in no time.
+         */
+        void connection_event_processing_time( bluetoe::link_layer::delta_time processing_time );
+
+        /**
+         * @brief simulated time since the anchor of the current connection event
+         *
+         * That is the connection event processing time plus the CPU load added since the last connection event.
+         */
+        bluetoe::link_layer::delta_time time_since_anchor() const;
+
+        /**
+         * @brief number of connection events, that would have been missed due to simulated CPU load
+         */
+        unsigned missed_connection_events() const;
+
         class lock_guard
         {
         public:
@@ -360,6 +387,11 @@ namespace test {
         // end of simulations
         bluetoe::link_layer::delta_time eos_;
 
+        // CPU load since the last connection event
+        bluetoe::link_layer::delta_time cpu_load_;
+        bluetoe::link_layer::delta_time processing_time_;
+        unsigned                        missed_connection_events_;
+
         advertising_list::const_iterator next( std::vector< advertising_data >::const_iterator, const std::function< bool ( const advertising_data& ) >& filter ) const;
 
         void pair_wise_check(
@@ -370,18 +402,44 @@ namespace test {
         std::pair< bool, advertising_response > find_response( const advertising_data& );
     };
 
+    /**
+     * @brief default encryption policy of the test radio: PDUs are exchanged with the simulated central unchanged
+     *
+     * An encryption policy converts every PDU, that the simulated central sends, into the PDU, that
+     * the link layer receives and every PDU, that the link layer transmits, into the PDU, that the
+     * central receives. PDUs are in the over the air layout. The flag indicates, whether the direction
+     * is currently encrypted.
+     */
+    struct no_link_encryption
+    {
+        static constexpr bool hardware_supports_encryption = false;
+
+    protected:
+        std::vector< std::uint8_t > transmit_to_link_layer( const std::vector< std::uint8_t >& pdu, bool )
+        {
+            return pdu;
+        }
+
+        std::vector< std::uint8_t > receive_from_link_layer( const std::vector< std::uint8_t >& pdu, bool )
+        {
+            return pdu;
+        }
+    };
+
     /**
      * @brief test implementation of the link_layer::scheduled_radio interface, that simulates receiving and transmitted data
      */
     template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack,
         bool Phy2MBitSupported,
-        bool SynchronizedUserTimerSupported >
+        bool SynchronizedUserTimerSupported,
+        typename Encryption = no_link_encryption >
     class radio_impl :
         public radio_base,
+        public Encryption,
         public bluetoe::link_layer::ll_data_pdu_buffer<
             TransmitSize, ReceiveSize,
             radio_impl<
-                TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported
+                TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption
             >
         >
     {
@@ -422,7 +480,7 @@ namespace test {
 
         bool event_cancelation_requested();
 
-        static constexpr bool hardware_supports_encryption = false;
+        static constexpr bool hardware_supports_encryption = Encryption::hardware_supports_encryption;
 
         /**
          * @brief indicates support for 2Mbit
@@ -436,6 +494,11 @@ namespace test {
 
         static constexpr unsigned connection_event_setup_time_us = 100u;
 
+        /**
+         * @brief indicates support for time_since_anchor()
+         */
+        static constexpr bool hardware_supports_time_since_anchor = true;
+
     private:
         // converts from in memory layout to over the air layout
         void copy_memory_to_air( const std::vector< std::uint8_t >& in_memory, bluetoe::link_layer::read_buffer& over_the_air );
@@ -606,8 +669,8 @@ namespace test {
         return start_value;
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::radio_impl()
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::radio_impl()
         : now_( bluetoe::link_layer::delta_time::now() )
         , last_anchor_( bluetoe::link_layer::delta_time::now() )
         , idle_( true )
@@ -622,8 +685,8 @@ namespace test {
     {
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::schedule_advertisment(
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::schedule_advertisment(
             unsigned                                    channel,
             const bluetoe::link_layer::write_buffer&    transmit,
             const bluetoe::link_layer::write_buffer&,
@@ -652,8 +715,8 @@ namespace test {
         advertised_data_.push_back( data );
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    bluetoe::link_layer::delta_time radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::schedule_connection_event(
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    bluetoe::link_layer::delta_time radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::schedule_connection_event(
         unsigned                                    channel,
         bluetoe::link_layer::delta_time             start_receive,
         bluetoe::link_layer::delta_time             end_receive,
@@ -679,12 +742,13 @@ namespace test {
         };
 
         connection_events_.push_back( data );
+        cpu_load_ = bluetoe::link_layer::delta_time();
 
         return bluetoe::link_layer::delta_time();
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    std::pair< bool, bluetoe::link_layer::delta_time > radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::disarm_connection_event()
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    std::pair< bool, bluetoe::link_layer::delta_time > radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::disarm_connection_event()
     {
         assert( !connection_events_.empty() );
         connection_events_.pop_back();
@@ -692,8 +756,8 @@ namespace test {
         return { true, bluetoe::link_layer::delta_time() };
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    bool radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::schedule_synchronized_user_timer(
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    bool radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::schedule_synchronized_user_timer(
         bluetoe::link_layer::delta_time time, bluetoe::link_layer::delta_time )
     {
         assert( !timer_set_ );
@@ -708,8 +772,8 @@ namespace test {
         return true;
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    bool radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::cancel_synchronized_user_timer()
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    bool radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::cancel_synchronized_user_timer()
     {
         const bool result = timer_set_;
 
@@ -722,20 +786,20 @@ namespace test {
         return result;
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::wake_up()
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::wake_up()
     {
         ++wake_ups_;
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::request_event_cancelation()
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::request_event_cancelation()
     {
         request_event_cancelation_ = true;
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    bool radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::event_cancelation_requested()
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    bool radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::event_cancelation_requested()
     {
         const bool result = request_event_cancelation_;
         request_event_cancelation_ = false;
@@ -743,8 +807,8 @@ namespace test {
         return result;
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::run()
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::run()
     {
         bool new_scheduling_added = false;
         central_sequence_number_    = 0;
@@ -775,8 +839,8 @@ namespace test {
             --wake_ups_;
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::simulate_advertising_response()
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::simulate_advertising_response()
     {
         assert( !advertised_data_.empty() );
 
@@ -809,10 +873,10 @@ namespace test {
         }
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::simulate_connection_event_response()
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::simulate_connection_event_response()
     {
-        using layout = typename bluetoe::link_layer::pdu_layout_by_radio< radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported > >::pdu_layout;
+        using layout = typename bluetoe::link_layer::pdu_layout_by_radio< radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption > >::pdu_layout;
 
         connection_event_response response = connection_events_response_.empty()
             ? connection_event_response()
@@ -821,6 +885,13 @@ namespace test {
         assert( !connection_events_.empty() );
         auto& event = connection_events_.back();
 
+        const bluetoe::link_layer::delta_time cpu_time = time_since_anchor();
+
+        if ( !cpu_time.zero() && cpu_time.usec() + connection_event_setup_time_us > event.start_receive.usec() )
+            ++missed_connection_events_;
+
+        cpu_load_ = bluetoe::link_layer::delta_time();
+
         if ( !connection_events_response_.empty() )
         {
             connection_events_response_.erase( connection_events_response_.begin() );
@@ -868,7 +939,7 @@ namespace test {
                         const auto pdu = pdus.front();
                         pdus.erase( pdus.begin() );
 
-                        copy_air_to_memory( pdu.data, receive_buffer );
+                        copy_air_to_memory( this->transmit_to_link_layer( pdu.data, reception_encrypted_ ), receive_buffer );
 
                         more_data = !pdus.empty();
                     }
@@ -896,7 +967,7 @@ namespace test {
                     memory_to_air( bluetoe::link_layer::write_buffer( receive_buffer ) ) );
 
                 event.transmitted_data.push_back(
-                    pdu_t( memory_to_air( response ), transmition_encrypted_ ) );
+                    pdu_t( this->receive_from_link_layer( memory_to_air( response ), transmition_encrypted_ ), transmition_encrypted_ ) );
 
             } while ( more_data );
 
@@ -904,8 +975,8 @@ namespace test {
         }
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    bluetoe::link_layer::delta_time radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::simulate_user_timer_response( bluetoe::link_layer::delta_time /* start */, bluetoe::link_layer::delta_time end )
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    bluetoe::link_layer::delta_time radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::simulate_user_timer_response( bluetoe::link_layer::delta_time /* start */, bluetoe::link_layer::delta_time end )
     {
         while ( timer_set_ && !scheduled_user_timers_.empty() && scheduled_user_timers_.back().current_anchor + scheduled_user_timers_.back().delay < end )
         {
@@ -920,10 +991,10 @@ namespace test {
         return end;
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::copy_memory_to_air( const std::vector< std::uint8_t >& in_memory, bluetoe::link_layer::read_buffer& over_the_air )
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::copy_memory_to_air( const std::vector< std::uint8_t >& in_memory, bluetoe::link_layer::read_buffer& over_the_air )
     {
-        using layout = typename bluetoe::link_layer::pdu_layout_by_radio< radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported > >::pdu_layout;
+        using layout = typename bluetoe::link_layer::pdu_layout_by_radio< radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption > >::pdu_layout;
 
         const auto          body      = layout::body( bluetoe::link_layer::write_buffer( in_memory.data(), in_memory.size() ) );
         const std::uint16_t header    = layout::header( in_memory.data() );
@@ -935,10 +1006,10 @@ namespace test {
         over_the_air.size = body_size + ll_header_size;
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::copy_air_to_memory( const std::vector< std::uint8_t >& over_the_air, bluetoe::link_layer::read_buffer& in_memory )
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    void radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::copy_air_to_memory( const std::vector< std::uint8_t >& over_the_air, bluetoe::link_layer::read_buffer& in_memory )
     {
-        using layout = typename bluetoe::link_layer::pdu_layout_by_radio< radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported > >::pdu_layout;
+        using layout = typename bluetoe::link_layer::pdu_layout_by_radio< radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption > >::pdu_layout;
 
         const std::uint16_t header = bluetoe::details::read_16bit( over_the_air.data() );
         const std::size_t   size   = std::min< std::size_t >( header >> 8, over_the_air.size() - ll_header_size );
@@ -950,10 +1021,10 @@ namespace test {
         in_memory.size = layout::data_channel_pdu_memory_size( size );
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    std::vector< std::uint8_t > radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::air_to_memory( bluetoe::link_layer::write_buffer air )
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    std::vector< std::uint8_t > radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::air_to_memory( bluetoe::link_layer::write_buffer air )
     {
-        using layout = typename bluetoe::link_layer::pdu_layout_by_radio< radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported > >::pdu_layout;
+        using layout = typename bluetoe::link_layer::pdu_layout_by_radio< radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption > >::pdu_layout;
 
         const std::uint16_t header = bluetoe::details::read_16bit( air.buffer );
         const std::size_t   size   = header >> 8;
@@ -968,10 +1039,10 @@ namespace test {
         return result;
     }
 
-    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported >
-    std::vector< std::uint8_t > radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported >::memory_to_air( bluetoe::link_layer::write_buffer memory )
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack, bool Phy2MBitSupported, bool SynchronizedUserTimerSupported, typename Encryption >
+    std::vector< std::uint8_t > radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption >::memory_to_air( bluetoe::link_layer::write_buffer memory )
     {
-        using layout = typename bluetoe::link_layer::pdu_layout_by_radio< radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported > >::pdu_layout;
+        using layout = typename bluetoe::link_layer::pdu_layout_by_radio< radio_impl< TransmitSize, ReceiveSize, CallBack, Phy2MBitSupported, SynchronizedUserTimerSupported, Encryption > >::pdu_layout;
 
         const std::uint16_t header    = layout::header( memory );
         const auto          body      = layout::body( memory );
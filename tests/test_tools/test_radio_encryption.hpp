@@ -0,0 +1,160 @@
+#ifndef BLUETOE_TESTS_LINK_LAYER_TEST_RADIO_ENCRYPTION_HPP
+#define BLUETOE_TESTS_LINK_LAYER_TEST_RADIO_ENCRYPTION_HPP
+
+#include "test_radio.hpp"
+
+#include <bluetoe/host_link_layer_encryption.hpp>
+
+#include <cassert>
+
+namespace test {
+
+    /**
+     * @brief encryption policy of the test radio, that encrypts the link with the software AES-CCM engine
+     *
+     * The link layer side uses bluetoe::host_details::software_radio_encryption, exactly as a host or
+     * software radio would do. The simulated central encrypts the PDUs it sends and decrypts the PDUs
+     * it receives with its own engine and packet counters. So the tests see the plain PDUs, while every
+     * PDU of an encrypted link passes the MIC check of the peer, if both sides agree on the session key
+     * and the packet counters. Failed checks are counted.
+     *
+     * Needs to be linked against bluetoe::bindings::host.
+     */
+    class software_link_encryption : public bluetoe::host_details::software_radio_encryption
+    {
+    public:
+        software_link_encryption()
+            : central_transmit_counter_( 0 )
+            , central_receive_counter_( 0 )
+            , mic_failures_( 0 )
+        {
+        }
+
+        std::pair< std::uint64_t, std::uint32_t > setup_encryption( bluetoe::details::uint128_t key, std::uint64_t skdm, std::uint32_t ivm )
+        {
+            const auto skds_ivs = bluetoe::host_details::software_radio_encryption::setup_encryption( key, skdm, ivm );
+
+            bluetoe::details::uint128_t session_descriminator;
+            bluetoe::details::write_64bit( &session_descriminator[ 0 ], skdm );
+            bluetoe::details::write_64bit( &session_descriminator[ 8 ], skds_ivs.first );
+
+            central_ = bluetoe::host_details::link_layer_ccm(
+                bluetoe::host_details::aes_le( key, session_descriminator ),
+                static_cast< std::uint64_t >( ivm ) | ( static_cast< std::uint64_t >( skds_ivs.second ) << 32 ) );
+
+            central_transmit_counter_ = 0;
+            central_receive_counter_  = 0;
+
+            return skds_ivs;
+        }
+
+        /**
+         * @brief number of PDUs, that failed the MIC check of the link layer or of the simulated central
+         */
+        std::size_t mic_failures() const
+        {
+            return mic_failures_;
+        }
+
+    protected:
+        std::vector< std::uint8_t > transmit_to_link_layer( const std::vector< std::uint8_t >& pdu, bool encrypted )
+        {
+            if ( !encrypted || pdu[ 1 ] == 0 )
+                return pdu;
+
+            assert( pdu.size() == pdu_header_size + pdu[ 1 ] );
+
+            std::vector< std::uint8_t > air( pdu.size() + bluetoe::host_details::link_layer_ccm::mic_size );
+            central_.encrypt( pdu.data(), air.data(), central_transmit_counter_++, true );
+
+            std::vector< std::uint8_t > received( air.size() );
+
+            if ( !this->receive_pdu( air.data(), received.data() ) )
+                ++mic_failures_;
+
+            received.resize( pdu_header_size + received[ 1 ] );
+
+            return received;
+        }
+
+        std::vector< std::uint8_t > receive_from_link_layer( const std::vector< std::uint8_t >& pdu, bool encrypted )
+        {
+            if ( !encrypted || pdu[ 1 ] == 0 )
+                return pdu;
+
+            std::vector< std::uint8_t > air( pdu.size() + bluetoe::host_details::link_layer_ccm::mic_size );
+            air.resize( this->transmit_pdu( pdu.data(), air.data() ) );
+
+            std::vector< std::uint8_t > received( air.size() );
+
+            if ( !central_.decrypt( air.data(), received.data(), central_receive_counter_++, false ) )
+                ++mic_failures_;
+
+            received.resize( pdu_header_size + received[ 1 ] );
+
+            return received;
+        }
+
+    private:
+        static constexpr std::size_t pdu_header_size = 2;
+
+        bluetoe::host_details::link_layer_ccm   central_;
+        std::uint64_t                           central_transmit_counter_;
+        std::uint64_t                           central_receive_counter_;
+        std::size_t                             mic_failures_;
+    };
+
+    /**
+     * @brief test radio with the link encrypted in software
+     *
+     * Other than radio_with_encryption, the PDUs of an encrypted link are really encrypted and
+     * authenticated, so this radio can be used to run encrypted links through the simulation.
+     */
+    template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack >
+    class radio_with_software_encryption : public radio_impl< TransmitSize, ReceiveSize, CallBack, false, false, software_link_encryption >
+    {
+    public:
+        void start_receive_encrypted()
+        {
+            software_link_encryption::start_receive_encrypted();
+            this->reception_encrypted_ = true;
+        }
+
+        void start_transmit_encrypted()
+        {
+            software_link_encryption::start_transmit_encrypted();
+            this->transmition_encrypted_ = true;
+        }
+
+        void stop_receive_encrypted()
+        {
+            software_link_encryption::stop_receive_encrypted();
+            this->reception_encrypted_ = false;
+        }
+
+        void stop_transmit_encrypted()
+        {
+            software_link_encryption::stop_transmit_encrypted();
+            this->transmition_encrypted_ = false;
+        }
+    };
+}
+
+namespace bluetoe {
+    namespace link_layer {
+
+        template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack >
+        struct pdu_layout_by_radio< test::radio_impl< TransmitSize, ReceiveSize, CallBack, false, false, test::software_link_encryption > >
+        {
+            using pdu_layout = test::pdu_layout;
+        };
+
+        template < std::size_t TransmitSize, std::size_t ReceiveSize, typename CallBack >
+        struct pdu_layout_by_radio< test::radio_with_software_encryption< TransmitSize, ReceiveSize, CallBack > >
+        {
+            using pdu_layout = test::pdu_layout;
+        };
+   }
+}
+
+#endif // include guard
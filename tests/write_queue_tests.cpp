@@ -123,3 +123,79 @@ BOOST_FIXTURE_TEST_CASE( can_be_freed_and_allocated_again, locked_by_client1 )
     free_write_queue( client1 );
     BOOST_CHECK( allocate_from_write_queue( 15, client2 ) != nullptr );
 }
+
+typedef bluetoe::pooled_write_queue< 50, 2 > pooled_2x50;
+typedef blued::write_queue< pooled_2x50 > pooled_queue;
+typedef blued::write_queue_client< pooled_2x50 > pooled_client;
+
+struct pooled_clients : pooled_queue
+{
+    pooled_client client1, client2, client3;
+};
+
+BOOST_FIXTURE_TEST_CASE( pooled_can_allocate_48_bytes_but_not_a_single_byte_more, pooled_clients )
+{
+    BOOST_CHECK( allocate_from_write_queue( 48, client1 ) != nullptr );
+    BOOST_CHECK( allocate_from_write_queue( 1, client1 ) == nullptr );
+}
+
+BOOST_FIXTURE_TEST_CASE( pooled_too_large_request_does_not_occupy_a_chunk, pooled_clients )
+{
+    BOOST_CHECK( allocate_from_write_queue( 49, client1 ) == nullptr );
+    BOOST_CHECK( allocate_from_write_queue( 48, client2 ) != nullptr );
+    BOOST_CHECK( allocate_from_write_queue( 48, client3 ) != nullptr );
+}
+
+BOOST_FIXTURE_TEST_CASE( pooled_clients_write_concurrently, pooled_clients )
+{
+    static const std::uint8_t test1[] = { 1, 2, 3, 4, 5 };
+    static const std::uint8_t test2[] = { 6, 7, 8 };
+
+    std::uint8_t* p1 = allocate_from_write_queue( sizeof( test1 ), client1 );
+    BOOST_REQUIRE( p1 != nullptr );
+    std::copy( std::begin( test1 ), std::end( test1 ), p1 );
+
+    std::uint8_t* p2 = allocate_from_write_queue( sizeof( test2 ), client2 );
+    BOOST_REQUIRE( p2 != nullptr );
+    std::copy( std::begin( test2 ), std::end( test2 ), p2 );
+
+    std::uint8_t* p3 = allocate_from_write_queue( sizeof( test2 ), client1 );
+    BOOST_REQUIRE( p3 != nullptr );
+    std::copy( std::begin( test2 ), std::end( test2 ), p3 );
+
+    std::pair< std::uint8_t*, std::size_t > ele = first_write_queue_element( client1 );
+    BOOST_CHECK_EQUAL_COLLECTIONS( ele.first, ele.first + ele.second, std::begin( test1 ), std::end( test1 ) );
+
+    ele = next_write_queue_element( ele.first, client1 );
+    BOOST_CHECK_EQUAL_COLLECTIONS( ele.first, ele.first + ele.second, std::begin( test2 ), std::end( test2 ) );
+    BOOST_CHECK( next_write_queue_element( ele.first, client1 ).first == nullptr );
+
+    ele = first_write_queue_element( client2 );
+    BOOST_CHECK_EQUAL_COLLECTIONS( ele.first, ele.first + ele.second, std::begin( test2 ), std::end( test2 ) );
+    BOOST_CHECK( next_write_queue_element( ele.first, client2 ).first == nullptr );
+
+    BOOST_CHECK( first_write_queue_element( client3 ).first == nullptr );
+}
+
+BOOST_FIXTURE_TEST_CASE( pooled_all_chunks_in_use, pooled_clients )
+{
+    BOOST_CHECK( allocate_from_write_queue( 15, client1 ) != nullptr );
+    BOOST_CHECK( allocate_from_write_queue( 15, client2 ) != nullptr );
+    BOOST_CHECK( allocate_from_write_queue( 15, client3 ) == nullptr );
+}
+
+BOOST_FIXTURE_TEST_CASE( pooled_chunk_can_be_reused_after_being_freed, pooled_clients )
+{
+    allocate_from_write_queue( 48, client1 );
+    allocate_from_write_queue( 48, client2 );
+
+    free_write_queue( client1 );
+    free_write_queue( client3 );
+
+    BOOST_CHECK( first_write_queue_element( client1 ).first == nullptr );
+    BOOST_CHECK( allocate_from_write_queue( 48, client3 ) != nullptr );
+    BOOST_CHECK( allocate_from_write_queue( 1, client1 ) == nullptr );
+
+    free_write_queue( client2 );
+    BOOST_CHECK( allocate_from_write_queue( 48, client1 ) != nullptr );
+}